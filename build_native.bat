@@ -15,7 +15,7 @@ if exist "C:\Program Files\Microsoft Visual Studio\2022\Community\VC\Auxiliary\B
 cd /d "%~dp0native\windows"
 
 :: Compile the DLL
-cl /LD /EHsc /std:c++17 startup_manager.cpp virtual_desktop_manager.cpp process_manager.cpp /Fe:marcha_native.dll user32.lib kernel32.lib shell32.lib advapi32.lib ole32.lib
+cl /LD /EHsc /std:c++17 startup_manager.cpp virtual_desktop_manager.cpp process_manager.cpp conpty.cpp path_resolver.cpp async_dispatch.cpp exit_watcher.cpp process_shutdown.cpp task_container.cpp job_stats.cpp job_control.cpp system_load.cpp readiness_probe.cpp resource_rules.cpp schedule_wheel.cpp io_reactor.cpp vt_screen.cpp scrollback_store.cpp /Fe:marcha_native.dll user32.lib kernel32.lib shell32.lib advapi32.lib ole32.lib psapi.lib pdh.lib ws2_32.lib cabinet.lib
 
 if %ERRORLEVEL% == 0 (
     echo Build successful! marcha_native.dll created.
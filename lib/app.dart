@@ -1,6 +1,7 @@
 import 'package:flutter/material.dart';
 import 'package:window_manager/window_manager.dart';
 import 'core/core.dart';
+import 'services/native_bindings.dart';
 import 'theme/app_theme.dart';
 import 'widgets/app_sidebar.dart';
 import 'widgets/exit_confirmation_dialog.dart';
@@ -22,6 +23,13 @@ class _MarchaAppState extends State<MarchaApp> with WindowListener {
   AppView _currentView = AppView.processManager;
   final GlobalKey<NavigatorState> _navigatorKey = GlobalKey<NavigatorState>();
 
+  // Shorter deadlines than the default so closing the app stays snappy
+  static const _exitShutdownPolicy = ShutdownPolicy(
+    interruptTimeout: Duration(seconds: 2),
+    breakTimeout: Duration(seconds: 1),
+    terminateTimeout: Duration(seconds: 1),
+  );
+
   static const _sidebarItems = [
     SidebarItem(id: 'process', title: 'Process Manager', icon: Icons.terminal),
     SidebarItem(id: 'resources', title: 'Resources', icon: Icons.monitor_heart),
@@ -58,10 +66,11 @@ class _MarchaAppState extends State<MarchaApp> with WindowListener {
     if (shouldExit) {
       // Stop API server before exiting
       await core.api.stop();
-      // Kill all running tasks before exiting
-      for (final task in core.tasks.running) {
-        task.kill();
-      }
+      // Stop all running tasks (Ctrl+C first, then escalate) before exiting
+      await Future.wait([
+        for (final task in core.tasks.running)
+          core.tasks.shutdown(task.id, policy: _exitShutdownPolicy),
+      ]);
       await windowManager.destroy();
     }
   }
@@ -0,0 +1,174 @@
+import 'dart:async';
+
+import '../models/task.dart';
+import '../services/native_bindings.dart';
+import 'core.dart';
+
+/// A created task waiting for admission
+class _PendingLaunch {
+  final Task task;
+  final int weight;
+  final DateTime queuedAt;
+  // true once started, false if cancelled first
+  final Completer<bool> started = Completer<bool>();
+
+  _PendingLaunch(this.task, this.weight) : queuedAt = DateTime.now();
+}
+
+/// An admitted task that is still starting up (holds its weight)
+class _StartingLaunch {
+  final Task task;
+  final int weight;
+  final DateTime admittedAt;
+  Duration? lastCpuTime;
+  DateTime? lastSampleTime;
+
+  _StartingLaunch(this.task, this.weight) : admittedAt = DateTime.now();
+}
+
+/// Extension admitting queued task launches while the machine has headroom
+///
+/// Launching a whole group at once makes every task start slower than a
+/// staggered start would. Queued tasks are started in order while the
+/// weights of tasks still starting up fit the launch budget and the native
+/// load sample (CPU, run queue, memory, hard faults) shows headroom. A task
+/// stops counting as starting once its process tree goes quiet.
+class AdmissionExtension {
+  final Core _core;
+
+  AdmissionExtension(this._core);
+
+  final List<_PendingLaunch> _queue = [];
+  final List<_StartingLaunch> _starting = [];
+  Timer? _timer;
+  SystemLoad? _lastLoad;
+
+  static const _tick = Duration(milliseconds: 250);
+  static const _minStartup = Duration(seconds: 1);
+  static const _maxStartup = Duration(seconds: 20);
+
+  // Headroom thresholds
+  static const double _maxCpuBusy = 0.85;
+  static const int _maxRunQueuePerCpu = 2;
+  static const int _maxMemoryLoadPercent = 90;
+  static const int _maxHardFaultsPerSec = 500;
+  // Tree CPU below this share of one processor counts as settled
+  static const double _settledCpuShare = 0.25;
+
+  /// Task ids waiting for admission, in launch order
+  List<String> get queuedTaskIds => _queue.map((p) => p.task.id).toList();
+
+  bool isQueued(String taskId) => _queue.any((p) => p.task.id == taskId);
+
+  /// Latest load sample (null before the first admission tick)
+  SystemLoad? get lastLoad => _lastLoad;
+
+  /// Queue a created (not yet running) task and start it as headroom allows.
+  /// Completes with true once it has started, false if cancelled first.
+  Future<bool> enqueue(Task task) {
+    final weight = (task.scheduling.launchWeight ?? 1).clamp(1, 100);
+    final pending = _PendingLaunch(task, weight);
+    _queue.add(pending);
+    task.terminal.write('\x1b[90m[Queued - waiting for system headroom]\x1b[0m\r\n');
+
+    _core.notify();
+    _ensureTimer();
+    _admit();
+    return pending.started.future;
+  }
+
+  /// Drop a queued task (it is never started)
+  void cancel(String taskId) {
+    final index = _queue.indexWhere((p) => p.task.id == taskId);
+    if (index < 0) return;
+    final pending = _queue.removeAt(index);
+    if (!pending.started.isCompleted) pending.started.complete(false);
+    _core.notify();
+  }
+
+  void _ensureTimer() {
+    _timer ??= Timer.periodic(_tick, (_) {
+      _updateStarting();
+      _admit();
+      if (_queue.isEmpty && _starting.isEmpty) {
+        _timer?.cancel();
+        _timer = null;
+      }
+    });
+  }
+
+  /// Release the weight of tasks whose process tree has gone quiet
+  void _updateStarting() {
+    final now = DateTime.now();
+    final native = NativeBindings.instance;
+
+    for (final starting in List.of(_starting)) {
+      final task = starting.task;
+      final age = now.difference(starting.admittedAt);
+      // A task that reports ready has finished starting, whatever its CPU
+      var settled = !task.isRunning || task.isReady || age >= _maxStartup;
+
+      final job = task.jobHandle ?? 0;
+      final accounting = job != 0 ? native.jobAccounting(job) : null;
+      if (!settled && accounting != null) {
+        final last = starting.lastCpuTime;
+        final lastTime = starting.lastSampleTime;
+        if (last != null && lastTime != null && age >= _minStartup) {
+          final wall = now.difference(lastTime).inMicroseconds;
+          final cpu = (accounting.cpuTime - last).inMicroseconds;
+          settled = wall > 0 && cpu / wall < _settledCpuShare;
+        }
+        starting.lastCpuTime = accounting.cpuTime;
+        starting.lastSampleTime = now;
+      } else if (!settled && accounting == null) {
+        // No job to measure - fall back to the minimum startup window
+        settled = age >= _minStartup;
+      }
+
+      if (settled) _starting.remove(starting);
+    }
+  }
+
+  bool _hasHeadroom(SystemLoad? load) {
+    if (load == null) return true; // No native signals - budget only
+    if (load.cpuBusy >= _maxCpuBusy) return false;
+    final queue = load.runQueueLength;
+    if (queue != null && queue >= load.processorCount * _maxRunQueuePerCpu) {
+      return false;
+    }
+    if (load.memoryLoadPercent >= _maxMemoryLoadPercent) return false;
+    final faults = load.hardFaultsPerSec;
+    if (faults != null && faults >= _maxHardFaultsPerSec) return false;
+    return true;
+  }
+
+  /// Start queued tasks in order while budget and headroom allow
+  void _admit() {
+    if (_queue.isEmpty) return;
+    _lastLoad = NativeBindings.instance.systemLoad();
+
+    final budget = _core.settings.current.maxConcurrentLaunches;
+    var changed = false;
+    while (_queue.isNotEmpty) {
+      final next = _queue.first;
+      final inFlight = _starting.fold<int>(0, (sum, s) => sum + s.weight);
+      // Something always gets to start, or a heavy task could wait forever
+      if (_starting.isNotEmpty &&
+          (inFlight + next.weight > budget || !_hasHeadroom(_lastLoad))) {
+        break;
+      }
+
+      _queue.removeAt(0);
+      final waited = DateTime.now().difference(next.queuedAt);
+      if (waited >= _tick) {
+        next.task.terminal.write(
+            '\x1b[90m[Admitted after ${(waited.inMilliseconds / 1000).toStringAsFixed(1)}s]\x1b[0m\r\n');
+      }
+      _starting.add(_StartingLaunch(next.task, next.weight));
+      _core.tasks.run(next.task.id);
+      next.started.complete(true);
+      changed = true;
+    }
+    if (changed) _core.notify();
+  }
+}
@@ -82,7 +82,11 @@ class ApiExtension {
     ApiEndpoint('POST', '/api/tasks/:id/run', 'run_task'),
     ApiEndpoint('POST', '/api/tasks/:id/stop', 'stop_task'),
     ApiEndpoint('POST', '/api/tasks/:id/kill', 'kill_task'),
+    ApiEndpoint('POST', '/api/tasks/:id/shutdown', 'shutdown_task'),
+    ApiEndpoint('POST', '/api/tasks/:id/suspend', 'suspend_task'),
+    ApiEndpoint('POST', '/api/tasks/:id/resume', 'resume_task'),
     ApiEndpoint('POST', '/api/tasks/:id/input', 'input_task'),
+    ApiEndpoint('GET', '/api/tasks/:id/screen', 'get_screen'),
     ApiEndpoint('GET', '/api/templates', 'get_templates'),
     ApiEndpoint('POST', '/api/templates/:id/launch', 'launch_template'),
     ApiEndpoint('GET', '/api/layout', 'get_layout'),
@@ -195,6 +199,9 @@ class ApiExtension {
             return;
           }
         }
+      } else {
+        // No auth, GET: query parameters are the request data
+        requestData = Map<String, dynamic>.of(request.uri.queryParameters);
       }
 
       // Route to handler
@@ -300,8 +307,16 @@ class ApiExtension {
         return _stopTask(params['id']!);
       case 'kill_task':
         return _killTask(params['id']!);
+      case 'shutdown_task':
+        return _shutdownTask(params['id']!);
+      case 'suspend_task':
+        return _suspendTask(params['id']!);
+      case 'resume_task':
+        return _resumeTask(params['id']!);
       case 'input_task':
         return _inputTask(params['id']!, data);
+      case 'get_screen':
+        return _getScreen(params['id']!, data);
       case 'get_templates':
         return _getTemplates();
       case 'launch_template':
@@ -377,6 +392,42 @@ class ApiExtension {
     return _HandlerResult.ok({'ok': true, 'taskId': id});
   }
 
+  _HandlerResult _suspendTask(String id) {
+    final task = _core.tasks.getById(id);
+    if (task == null) return _HandlerResult.notFound('Task not found');
+    if (!task.isRunning) return _HandlerResult.conflict('Task not running');
+    if (!_core.tasks.suspend(id)) {
+      return _HandlerResult.conflict('Task already suspended or could not be frozen');
+    }
+    return _HandlerResult.ok({'ok': true, 'taskId': id});
+  }
+
+  _HandlerResult _resumeTask(String id) {
+    final task = _core.tasks.getById(id);
+    if (task == null) return _HandlerResult.notFound('Task not found');
+    if (!task.isSuspended) return _HandlerResult.conflict('Task not suspended');
+    _core.tasks.resume(id);
+    return _HandlerResult.ok({'ok': true, 'taskId': id});
+  }
+
+  Future<_HandlerResult> _shutdownTask(String id) async {
+    final task = _core.tasks.getById(id);
+    if (task == null) return _HandlerResult.notFound('Task not found');
+    if (!task.isRunning) return _HandlerResult.conflict('Task not running');
+    final report = await _core.tasks.shutdown(id);
+    return _HandlerResult.ok({
+      'ok': true,
+      'taskId': id,
+      'processes': report
+          .map((e) => {
+                'pid': e.pid,
+                'exitCode': e.exitCode,
+                'stage': e.stage.name,
+              })
+          .toList(),
+    });
+  }
+
   _HandlerResult _inputTask(String id, Map<String, dynamic> data) {
     final task = _core.tasks.getById(id);
     if (task == null) return _HandlerResult.notFound('Task not found');
@@ -391,6 +442,28 @@ class ApiExtension {
     return _HandlerResult.ok({'ok': true, 'taskId': id});
   }
 
+  /// Screen state sync: a VT patch from the client's last applied frame
+  /// ("frame", 0 or absent for a full redraw) to the current one
+  _HandlerResult _getScreen(String id, Map<String, dynamic> data) {
+    final task = _core.tasks.getById(id);
+    if (task == null) return _HandlerResult.notFound('Task not found');
+    final since = int.tryParse('${data['frame'] ?? 0}');
+    if (since == null || since < 0) {
+      return _HandlerResult.badRequest('"frame" must be a frame number');
+    }
+    final frame = task.terminal.syncFrame(since);
+    if (frame == null) return _HandlerResult.conflict('Screen state unavailable');
+    return _HandlerResult.ok({
+      'taskId': id,
+      'frame': frame.frame,
+      'cols': frame.cols,
+      'rows': frame.rows,
+      'full': frame.full,
+      'rowsSent': frame.rowsSent,
+      'patch': frame.patch,
+    });
+  }
+
   _HandlerResult _getTemplates() {
     return _HandlerResult.ok({
       'templates': _core.templates.all.map((t) => t.toJson()).toList(),
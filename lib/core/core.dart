@@ -8,6 +8,10 @@ import 'settings_extension.dart';
 import 'logs_extension.dart';
 import 'resource_monitor_extension.dart';
 import 'api_extension.dart';
+import 'admission_extension.dart';
+import 'group_launch_extension.dart';
+import 'supervisor_extension.dart';
+import 'resource_rules_extension.dart';
 
 /// Core monolith - single source of truth for all app state
 class Core extends ChangeNotifier {
@@ -23,6 +27,10 @@ class Core extends ChangeNotifier {
     _logs = LogsExtension(this);
     _resourceMonitor = ResourceMonitorExtension(this);
     _api = ApiExtension(this);
+    _admission = AdmissionExtension(this);
+    _groupLaunch = GroupLaunchExtension(this);
+    _supervisor = SupervisorExtension(this);
+    _resourceRules = ResourceRulesExtension(this);
   }
 
   late final TemplatesExtension _templates;
@@ -33,6 +41,10 @@ class Core extends ChangeNotifier {
   late final LogsExtension _logs;
   late final ResourceMonitorExtension _resourceMonitor;
   late final ApiExtension _api;
+  late final AdmissionExtension _admission;
+  late final GroupLaunchExtension _groupLaunch;
+  late final SupervisorExtension _supervisor;
+  late final ResourceRulesExtension _resourceRules;
 
   TemplatesExtension get templates => _templates;
   TasksExtension get tasks => _tasks;
@@ -42,6 +54,10 @@ class Core extends ChangeNotifier {
   LogsExtension get logs => _logs;
   ResourceMonitorExtension get resourceMonitor => _resourceMonitor;
   ApiExtension get api => _api;
+  AdmissionExtension get admission => _admission;
+  GroupLaunchExtension get groupLaunch => _groupLaunch;
+  SupervisorExtension get supervisor => _supervisor;
+  ResourceRulesExtension get resourceRules => _resourceRules;
 
   // Data directory
   static String _dataDir = '';
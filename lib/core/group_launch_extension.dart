@@ -0,0 +1,126 @@
+import 'dart:async';
+
+import 'package:flutter/foundation.dart';
+
+import '../models/group_launch_report.dart';
+import '../models/task.dart';
+import '../models/task_group.dart';
+import 'core.dart';
+
+/// Extension launching task groups along their dependency graph
+///
+/// Every task whose dependencies are ready is handed to admission at once,
+/// so independent branches start in parallel while dependants wait for the
+/// tasks they need. A task whose dependency exits (or is cancelled) before
+/// becoming ready is skipped, along with everything that waits for it.
+class GroupLaunchExtension {
+  final Core _core;
+
+  GroupLaunchExtension(this._core);
+
+  final Map<String, GroupLaunchReport> _lastReports = {};
+
+  /// Report of the most recent launch of a group
+  GroupLaunchReport? lastReport(String groupId) => _lastReports[groupId];
+
+  /// Launch created (not yet running) tasks of [group]. Completes once every
+  /// task is ready or skipped.
+  Future<GroupLaunchReport> launch(TaskGroup group, List<Task> tasks) async {
+    final byTemplate = <String, Task>{
+      for (final task in tasks)
+        if (task.templateId != null) task.templateId!: task,
+    };
+
+    // Only dependencies launched together count; templates the user
+    // skipped in the pane selection are treated as satisfied
+    var deps = <String, List<String>>{
+      for (final id in byTemplate.keys)
+        id: group.dependenciesOf(id).where(byTemplate.containsKey).toList(),
+    };
+    if (_hasCycle(deps)) {
+      debugPrint('GroupLaunchExtension: cycle in ${group.name}, ignoring dependencies');
+      deps = {for (final id in byTemplate.keys) id: <String>[]};
+    }
+
+    final report = GroupLaunchReport(
+      groupId: group.id,
+      launchedAt: DateTime.now(),
+      nodes: [
+        for (final entry in byTemplate.entries)
+          GroupLaunchNode(
+            templateId: entry.key,
+            name: entry.value.name,
+            dependsOn: deps[entry.key]!,
+          ),
+      ],
+    );
+    _lastReports[group.id] = report;
+
+    final ready = {for (final id in byTemplate.keys) id: Completer<bool>()};
+    await Future.wait([
+      for (final node in report.nodes)
+        _launchNode(node, byTemplate[node.templateId]!, ready),
+    ]);
+
+    report.finishedAt = DateTime.now();
+    debugPrint('GroupLaunchExtension: ${group.name} finished in '
+        '${report.total!.inMilliseconds}ms, critical path: ${report.describeCriticalPath()}');
+    return report;
+  }
+
+  Future<void> _launchNode(
+    GroupLaunchNode node,
+    Task task,
+    Map<String, Completer<bool>> ready,
+  ) async {
+    final own = ready[node.templateId]!;
+    try {
+      if (node.dependsOn.isNotEmpty) {
+        task.terminal.write(
+            '\x1b[90m[Waiting for ${node.dependsOn.length} dependenc${node.dependsOn.length == 1 ? 'y' : 'ies'}]\x1b[0m\r\n');
+      }
+      final results = await Future.wait(
+          node.dependsOn.map((id) => ready[id]!.future));
+      if (results.contains(false)) {
+        node.skipped = true;
+        task.terminal.write(
+            '\x1b[33m[Skipped - a dependency did not become ready]\x1b[0m\r\n');
+        own.complete(false);
+        return;
+      }
+
+      node.queuedAt = DateTime.now();
+      final started = await _core.admission.enqueue(task);
+      if (!started) {
+        node.skipped = true;
+        own.complete(false);
+        return;
+      }
+      node.startedAt = task.startedAt ?? DateTime.now();
+
+      final isReady = await task.ready;
+      if (isReady) node.readyAt = task.readyAt;
+      own.complete(isReady);
+    } catch (e) {
+      debugPrint('GroupLaunchExtension: ${node.name} failed: $e');
+      if (!own.isCompleted) own.complete(false);
+    }
+  }
+
+  static bool _hasCycle(Map<String, List<String>> deps) {
+    final state = <String, int>{}; // 1 = visiting, 2 = done
+    bool visit(String id) {
+      final s = state[id];
+      if (s == 1) return true;
+      if (s == 2) return false;
+      state[id] = 1;
+      for (final dep in deps[id] ?? const <String>[]) {
+        if (visit(dep)) return true;
+      }
+      state[id] = 2;
+      return false;
+    }
+
+    return deps.keys.any(visit);
+  }
+}
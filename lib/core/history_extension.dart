@@ -38,7 +38,8 @@ class HistoryExtension {
   }
 
   /// Create a new history entry from a template launch
-  Future<HistoryEntry> add(Template template, String taskId) async {
+  Future<HistoryEntry> add(Template template, String taskId,
+      {int restartAttempt = 0}) async {
     final entry = HistoryEntry(
       id: HistoryEntry.generateId(),
       name: template.name,
@@ -49,6 +50,7 @@ class HistoryExtension {
       taskId: taskId,
       startedAt: DateTime.now(),
       emoji: template.emoji,
+      restartAttempt: restartAttempt,
     );
     _entries.insert(0, entry); // Most recent first
     _core.notify();
@@ -83,12 +85,13 @@ class HistoryExtension {
   }
 
   /// Mark entry as error
-  Future<void> error(String id) async {
+  Future<void> error(String id, {int? exitCode}) async {
     final index = _entries.indexWhere((e) => e.id == id);
     if (index >= 0) {
       _entries[index] = _entries[index].copyWith(
         status: HistoryStatus.error,
         endedAt: DateTime.now(),
+        exitCode: exitCode,
       );
       _core.notify();
       await _save();
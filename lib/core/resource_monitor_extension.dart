@@ -3,6 +3,7 @@ import 'dart:convert';
 import 'dart:io';
 import '../models/process_stats.dart';
 import '../models/task.dart';
+import '../services/native_bindings.dart';
 import 'core.dart';
 
 /// Centralized resource monitoring for all running tasks
@@ -19,7 +20,9 @@ class ResourceMonitorExtension {
 
   // CPU percentage calculation state (track previous sample for delta)
   final Map<int, double> _lastCpuTimes = {}; // PID -> cumulative CPU seconds
+  final Map<int, double> _lastJobCpuTimes = {}; // Root PID -> job CPU seconds
   DateTime? _lastCpuSampleTime;
+  DateTime? _lastJobSampleTime;
 
   bool get isMonitoring => _monitoringTimer != null;
 
@@ -48,7 +51,9 @@ class ResourceMonitorExtension {
     _monitoringTimer?.cancel();
     _monitoringTimer = null;
     _lastCpuTimes.clear();
+    _lastJobCpuTimes.clear();
     _lastCpuSampleTime = null;
+    _lastJobSampleTime = null;
   }
 
   /// Called when a task starts - ensures monitoring is active
@@ -58,6 +63,7 @@ class ResourceMonitorExtension {
 
   /// Called when a task stops - may stop monitoring if no tasks left
   void onTaskStopped(Task task) {
+    _core.resourceRules.release(task.id);
     // Clean up CPU time tracking for this task's processes
     // (will be cleaned up naturally on next collection)
     _ensureMonitoring();
@@ -82,105 +88,38 @@ class ResourceMonitorExtension {
     if (tasksByPid.isEmpty) return;
 
     try {
-      // Step 1: Get ALL processes ONCE to build process trees
-      final processTree = await _getProcessTree();
-      if (processTree == null) return;
-
-      // Step 2: For each task, find its process tree
-      final allPidsToQuery = <int>{};
-      final taskTreePids = <int, List<int>>{}; // rootPid -> list of all PIDs in tree
-
-      for (final rootPid in tasksByPid.keys) {
-        final treePids = _buildProcessTree(rootPid, processTree);
-        if (treePids.isNotEmpty) {
-          taskTreePids[rootPid] = treePids;
-          allPidsToQuery.addAll(treePids);
-        }
-      }
-
-      if (allPidsToQuery.isEmpty) return;
-
-      // Step 3: Get stats for ALL PIDs in ONE query
-      final allStats = await _getProcessStats(allPidsToQuery.toList());
-      if (allStats == null) return;
-
-      // Step 4: Distribute stats to each task
-      final now = DateTime.now();
-      final elapsedSeconds = _lastCpuSampleTime != null
-          ? now.difference(_lastCpuSampleTime!).inMilliseconds / 1000.0
-          : 0.0;
-
       final Map<int, double> currentCpuTimes = {};
 
+      // Tasks contained in a job read their totals from the job itself (exited
+      // children included); only the rest need the process tree queries below
+      final jobSampleTime = DateTime.now();
+      final jobElapsedSeconds = _lastJobSampleTime != null
+          ? jobSampleTime.difference(_lastJobSampleTime!).inMilliseconds / 1000.0
+          : 0.0;
+      final scannedTasks = <int, Task>{};
       for (final entry in tasksByPid.entries) {
-        final rootPid = entry.key;
-        final task = entry.value;
-        final treePids = taskTreePids[rootPid] ?? [];
-
-        if (treePids.isEmpty) continue;
-
-        // Aggregate stats for this task's process tree
-        double totalCpuPercent = 0.0;
-        int totalMemory = 0;
-        int foundCount = 0;
-        final List<ChildProcessStats> children = [];
-
-        for (final pid in treePids) {
-          final procStats = allStats[pid];
-          if (procStats == null) continue;
-
-          final cpuTimeSeconds = ((procStats['CPU'] as num?) ?? 0.0).toDouble();
-          final memory = (procStats['Memory'] as int?) ?? 0;
-          final procName = (procStats['Name'] as String?) ?? 'Unknown';
-
-          // Calculate actual CPU percentage from delta
-          double cpuPercent = 0.0;
-          if (elapsedSeconds > 0) {
-            final lastCpuTime = _lastCpuTimes[pid] ?? cpuTimeSeconds;
-            final deltaCpuTime = cpuTimeSeconds - lastCpuTime;
-            cpuPercent = (deltaCpuTime / elapsedSeconds) * 100.0;
-            if (cpuPercent < 0) cpuPercent = 0.0;
-          }
-          currentCpuTimes[pid] = cpuTimeSeconds;
-
-          totalCpuPercent += cpuPercent;
-          totalMemory += memory;
-          foundCount++;
-
-          children.add(ChildProcessStats(
-            pid: pid,
-            name: procName,
-            cpuUsage: cpuPercent,
-            memoryUsage: memory,
-          ));
+        final jobHandle = entry.value.jobHandle ?? 0;
+        final stats = jobHandle != 0
+            ? _collectJobStats(entry.key, jobHandle, jobSampleTime,
+                jobElapsedSeconds, currentCpuTimes)
+            : null;
+        if (stats != null) {
+          entry.value.updateStats(stats);
+          _core.resourceRules.evaluate(entry.value, stats);
+        } else {
+          scannedTasks[entry.key] = entry.value;
         }
+      }
+      _lastJobSampleTime = jobSampleTime;
+      _lastJobCpuTimes.removeWhere((pid, _) => !tasksByPid.containsKey(pid));
 
-        if (foundCount == 0) continue;
-
-        // Sort children: root process first, then by memory usage descending
-        children.sort((a, b) {
-          if (a.pid == rootPid) return -1;
-          if (b.pid == rootPid) return 1;
-          return b.memoryUsage.compareTo(a.memoryUsage);
-        });
-
-        final stats = ProcessStats(
-          pid: rootPid,
-          cpuUsage: totalCpuPercent,
-          memoryUsage: totalMemory,
-          timestamp: now,
-          processCount: foundCount,
-          children: children,
-        );
-
-        // Send stats to the task
-        task.updateStats(stats);
+      if (scannedTasks.isNotEmpty) {
+        await _collectScannedStats(scannedTasks, currentCpuTimes);
       }
 
       // Update tracking state for next delta calculation
       _lastCpuTimes.clear();
       _lastCpuTimes.addAll(currentCpuTimes);
-      _lastCpuSampleTime = now;
 
       // Notify UI to update
       _core.notify();
@@ -189,6 +128,168 @@ class ResourceMonitorExtension {
     }
   }
 
+  /// Stats of a task contained in a job: totals from one job accounting
+  /// query, the per-process breakdown from the job's own member list.
+  /// Returns null if the job can't be read (the caller falls back to a scan).
+  ProcessStats? _collectJobStats(int rootPid, int jobHandle, DateTime now,
+      double elapsedSeconds, Map<int, double> currentCpuTimes) {
+    final accounting = NativeBindings.instance.jobAccounting(jobHandle);
+    if (accounting == null) return null;
+
+    // Job CPU time includes every process that ever ran in the job, so
+    // short-lived workers between two samples still count
+    final jobCpuSeconds = accounting.cpuTime.inMicroseconds / 1e6;
+    double totalCpuPercent = 0.0;
+    if (elapsedSeconds > 0) {
+      final lastCpuTime = _lastJobCpuTimes[rootPid] ?? jobCpuSeconds;
+      totalCpuPercent = (jobCpuSeconds - lastCpuTime) / elapsedSeconds * 100.0;
+      if (totalCpuPercent < 0) totalCpuPercent = 0.0;
+    }
+    _lastJobCpuTimes[rootPid] = jobCpuSeconds;
+
+    final members = NativeBindings.instance.jobMemberStats(jobHandle);
+    final List<ChildProcessStats> children = [];
+    int totalMemory = 0;
+    for (final member in members) {
+      final cpuTimeSeconds = member.cpuTime.inMicroseconds / 1e6;
+      double cpuPercent = 0.0;
+      if (elapsedSeconds > 0) {
+        final lastCpuTime = _lastCpuTimes[member.pid] ?? cpuTimeSeconds;
+        cpuPercent = (cpuTimeSeconds - lastCpuTime) / elapsedSeconds * 100.0;
+        if (cpuPercent < 0) cpuPercent = 0.0;
+      }
+      currentCpuTimes[member.pid] = cpuTimeSeconds;
+
+      final memory = (member.workingSetBytes / 1024).round();
+      totalMemory += memory;
+      children.add(ChildProcessStats(
+        pid: member.pid,
+        name: member.name.isNotEmpty ? member.name : 'Unknown',
+        cpuUsage: cpuPercent,
+        memoryUsage: memory,
+      ));
+    }
+
+    // Sort children: root process first, then by memory usage descending
+    children.sort((a, b) {
+      if (a.pid == rootPid) return -1;
+      if (b.pid == rootPid) return 1;
+      return b.memoryUsage.compareTo(a.memoryUsage);
+    });
+
+    return ProcessStats(
+      pid: rootPid,
+      cpuUsage: totalCpuPercent,
+      memoryUsage: totalMemory,
+      timestamp: now,
+      processCount: accounting.activeProcesses,
+      children: children,
+      totalProcesses: accounting.totalProcesses,
+      cpuTime: accounting.cpuTime,
+      ioReadBytes: accounting.readBytes,
+      ioWriteBytes: accounting.writeBytes,
+    );
+  }
+
+  /// Stats for tasks without a job: walk the system-wide process tree
+  Future<void> _collectScannedStats(
+      Map<int, Task> tasksByPid, Map<int, double> currentCpuTimes) async {
+    // Step 1: Get ALL processes ONCE to build process trees
+    final processTree = await _getProcessTree();
+    if (processTree == null) return;
+
+    // Step 2: For each task, find its process tree
+    final allPidsToQuery = <int>{};
+    final taskTreePids = <int, List<int>>{}; // rootPid -> list of all PIDs in tree
+
+    for (final rootPid in tasksByPid.keys) {
+      final treePids = _buildProcessTree(rootPid, processTree);
+      if (treePids.isNotEmpty) {
+        taskTreePids[rootPid] = treePids;
+        allPidsToQuery.addAll(treePids);
+      }
+    }
+
+    if (allPidsToQuery.isEmpty) return;
+
+    // Step 3: Get stats for ALL PIDs in ONE query
+    final allStats = await _getProcessStats(allPidsToQuery.toList());
+    if (allStats == null) return;
+
+    // Step 4: Distribute stats to each task
+    final now = DateTime.now();
+    final elapsedSeconds = _lastCpuSampleTime != null
+        ? now.difference(_lastCpuSampleTime!).inMilliseconds / 1000.0
+        : 0.0;
+
+    for (final entry in tasksByPid.entries) {
+      final rootPid = entry.key;
+      final task = entry.value;
+      final treePids = taskTreePids[rootPid] ?? [];
+
+      if (treePids.isEmpty) continue;
+
+      // Aggregate stats for this task's process tree
+      double totalCpuPercent = 0.0;
+      int totalMemory = 0;
+      int foundCount = 0;
+      final List<ChildProcessStats> children = [];
+
+      for (final pid in treePids) {
+        final procStats = allStats[pid];
+        if (procStats == null) continue;
+
+        final cpuTimeSeconds = ((procStats['CPU'] as num?) ?? 0.0).toDouble();
+        final memory = (procStats['Memory'] as int?) ?? 0;
+        final procName = (procStats['Name'] as String?) ?? 'Unknown';
+
+        // Calculate actual CPU percentage from delta
+        double cpuPercent = 0.0;
+        if (elapsedSeconds > 0) {
+          final lastCpuTime = _lastCpuTimes[pid] ?? cpuTimeSeconds;
+          final deltaCpuTime = cpuTimeSeconds - lastCpuTime;
+          cpuPercent = (deltaCpuTime / elapsedSeconds) * 100.0;
+          if (cpuPercent < 0) cpuPercent = 0.0;
+        }
+        currentCpuTimes[pid] = cpuTimeSeconds;
+
+        totalCpuPercent += cpuPercent;
+        totalMemory += memory;
+        foundCount++;
+
+        children.add(ChildProcessStats(
+          pid: pid,
+          name: procName,
+          cpuUsage: cpuPercent,
+          memoryUsage: memory,
+        ));
+      }
+
+      if (foundCount == 0) continue;
+
+      // Sort children: root process first, then by memory usage descending
+      children.sort((a, b) {
+        if (a.pid == rootPid) return -1;
+        if (b.pid == rootPid) return 1;
+        return b.memoryUsage.compareTo(a.memoryUsage);
+      });
+
+      final stats = ProcessStats(
+        pid: rootPid,
+        cpuUsage: totalCpuPercent,
+        memoryUsage: totalMemory,
+        timestamp: now,
+        processCount: foundCount,
+        children: children,
+      );
+
+      // Send stats to the task
+      task.updateStats(stats);
+      _core.resourceRules.evaluate(task, stats);
+    }
+    _lastCpuSampleTime = now;
+  }
+
   /// Get all processes with their parent relationships - ONE query
   Future<Map<int, int>?> _getProcessTree() async {
     try {
@@ -0,0 +1,129 @@
+import 'package:flutter/foundation.dart';
+
+import '../models/process_stats.dart';
+import '../models/resource_rule.dart';
+import '../models/task.dart';
+import '../services/native_bindings.dart';
+import 'core.dart';
+
+/// Native rule set of one task run
+class _RuleSubject {
+  final int subjectId;
+  final Map<int, ResourceRule> rules = {}; // Native rule id -> rule
+  final Set<int> breached = {};
+  bool restarting = false;
+
+  _RuleSubject(this.subjectId);
+}
+
+/// Extension applying templates' [ResourceRule]s to the stats the resource
+/// monitor samples
+///
+/// Rules live natively, grouped per task run: each sample only steps that
+/// task's own rules through their hysteresis state machine and hands back the
+/// few that changed state, so idle rules cost nothing on the Dart side.
+class ResourceRulesExtension {
+  final Core _core;
+
+  ResourceRulesExtension(this._core);
+
+  final Map<String, _RuleSubject> _subjects = {};
+  int _nextSubjectId = 1;
+
+  /// Called by ResourceMonitorExtension for every sample it pushes to a task
+  void evaluate(Task task, ProcessStats stats) {
+    if (task.resourceRules.isEmpty || !task.isRunning) return;
+    final subject = _subjects[task.id] ?? _register(task);
+    if (subject.restarting) return;
+
+    // Order mirrors RuleMetric
+    final transitions = NativeBindings.instance.evaluateRules(
+      subject.subjectId,
+      stats.timestamp,
+      [
+        stats.memoryUsage * 1024.0,
+        stats.cpuUsage,
+        stats.processCount.toDouble(),
+      ],
+    );
+    for (final transition in transitions) {
+      final rule = subject.rules[transition.ruleId];
+      if (rule == null) continue;
+      if (transition.breached) {
+        subject.breached.add(transition.ruleId);
+        _onBreach(task, subject, rule, transition.value);
+      } else {
+        subject.breached.remove(transition.ruleId);
+        task.terminal.write(
+            '\r\n\x1b[32m[Rules] Recovered: ${rule.description} '
+            '(now ${_format(rule.metric, transition.value)})\x1b[0m\r\n');
+      }
+    }
+    if (transitions.isNotEmpty) _updateDegraded(task, subject);
+  }
+
+  /// Forget a task's rule state (its run ended)
+  void release(String taskId) {
+    final subject = _subjects.remove(taskId);
+    if (subject == null) return;
+    NativeBindings.instance.removeRules(subject.subjectId);
+  }
+
+  _RuleSubject _register(Task task) {
+    final subject = _RuleSubject(_nextSubjectId++);
+    for (final rule in task.resourceRules) {
+      // Memory is sampled in bytes, rules are written in MB
+      final scale = rule.metric == RuleMetric.memory ? 1024.0 * 1024.0 : 1.0;
+      final id = NativeBindings.instance.addRule(
+        subjectId: subject.subjectId,
+        metric: rule.metric.index,
+        threshold: rule.threshold * scale,
+        clearThreshold: rule.clearThreshold * scale,
+        sustain: Duration(seconds: rule.sustainSeconds),
+      );
+      if (id != 0) subject.rules[id] = rule;
+    }
+    _subjects[task.id] = subject;
+    return subject;
+  }
+
+  void _onBreach(
+      Task task, _RuleSubject subject, ResourceRule rule, double value) {
+    final reading = _format(rule.metric, value);
+    debugPrint(
+        'ResourceRulesExtension: ${task.name} breached ${rule.description} ($reading)');
+    switch (rule.action) {
+      case RuleAction.degrade:
+        task.terminal.write(
+            '\r\n\x1b[33m[Rules] Degraded: ${rule.description} (now $reading)\x1b[0m\r\n');
+      case RuleAction.restart:
+        task.terminal.write(
+            '\r\n\x1b[33m[Rules] ${rule.description} (now $reading) - restarting\x1b[0m\r\n');
+        subject.restarting = true;
+        _restart(task.id);
+    }
+  }
+
+  /// Graceful shutdown of the whole tree, then a fresh run
+  Future<void> _restart(String taskId) async {
+    await _core.tasks.shutdown(taskId);
+    release(taskId);
+    _core.tasks.run(taskId);
+  }
+
+  void _updateDegraded(Task task, _RuleSubject subject) {
+    final reasons = [
+      for (final id in subject.breached)
+        if (subject.rules[id]?.action == RuleAction.degrade)
+          subject.rules[id]!.description,
+    ];
+    task.setDegraded(reasons.isEmpty ? null : reasons.join('; '));
+    _core.notify();
+  }
+
+  String _format(RuleMetric metric, double value) => switch (metric) {
+        RuleMetric.memory => '${(value / (1024 * 1024)).toStringAsFixed(0)} MB',
+        RuleMetric.cpu => '${value.toStringAsFixed(0)}%',
+        RuleMetric.processes => value.toStringAsFixed(0),
+      };
+}
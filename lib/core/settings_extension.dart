@@ -4,6 +4,7 @@ import 'dart:convert';
 import 'package:flutter/foundation.dart';
 import '../models/app_settings.dart';
 import '../models/ui_sizes.dart';
+import '../services/native_bindings.dart';
 import '../theme/terminal_theme.dart';
 import 'core.dart';
 
@@ -190,9 +191,48 @@ class SettingsExtension {
     await _save();
   }
 
+  /// Update how much launch weight may be starting up at once
+  Future<void> setMaxConcurrentLaunches(int launches) async {
+    final clamped = launches.clamp(1, 20);
+    if (_settings.maxConcurrentLaunches == clamped) return;
+    _settings = _settings.copyWith(maxConcurrentLaunches: clamped);
+    _core.notify();
+    await _save();
+  }
+
+  /// Update how long a task may stay hidden before it is suspended (0 = never)
+  Future<void> setAutoSuspendHiddenMinutes(int minutes) async {
+    final clamped = minutes.clamp(0, 120);
+    if (_settings.autoSuspendHiddenMinutes == clamped) return;
+    _settings = _settings.copyWith(autoSuspendHiddenMinutes: clamped);
+    _core.notify();
+    await _save();
+  }
+
+  /// Update how many idle shells are kept warm per launch configuration
+  Future<void> setShellPoolSize(int size) async {
+    final clamped = size.clamp(0, 4);
+    if (_settings.shellPoolSize == clamped) return;
+    _settings = _settings.copyWith(shellPoolSize: clamped);
+    if (clamped == 0) NativeBindings.instance.clearShellPool();
+    _core.notify();
+    await _save();
+  }
+
+  /// Update how much memory task scrollback may keep before older blocks spill to disk
+  Future<void> setScrollbackMemoryMb(int megabytes) async {
+    final clamped = megabytes.clamp(16, 512);
+    if (_settings.scrollbackMemoryMb == clamped) return;
+    _settings = _settings.copyWith(scrollbackMemoryMb: clamped);
+    NativeBindings.instance.setScrollbackBudget(clamped * 1024 * 1024);
+    _core.notify();
+    await _save();
+  }
+
   /// Reset to defaults
   Future<void> resetToDefaults() async {
     _settings = AppSettings.defaults();
+    NativeBindings.instance.setScrollbackBudget(_settings.scrollbackMemoryMb * 1024 * 1024);
     _core.notify();
     await _save();
   }
@@ -276,6 +316,8 @@ class SettingsExtension {
       _settings = AppSettings.defaults();
     }
 
+    NativeBindings.instance.setScrollbackBudget(_settings.scrollbackMemoryMb * 1024 * 1024);
+
     // Initialize layout from loaded settings
     _core.layout.initFromSettings(_settings);
   }
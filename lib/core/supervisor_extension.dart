@@ -0,0 +1,138 @@
+import 'dart:async';
+import 'dart:math';
+
+import 'package:flutter/foundation.dart';
+
+import '../models/restart_policy.dart';
+import '../models/task.dart';
+import '../services/native_bindings.dart';
+import 'core.dart';
+
+/// Supervision state of one task
+class _Supervision {
+  final Task task;
+  StreamSubscription<int>? commandExits;
+  StreamSubscription<ProbeEvent>? readinessLost;
+  final List<DateTime> failures = []; // Within the policy window
+  int restarts = 0;
+  bool handledRun = false; // An exit of the current run was already acted on
+  bool tripped = false; // Crash-loop breaker open
+  NativeOperation? backoff; // Pending restart delay
+
+  _Supervision(this.task);
+}
+
+/// Extension restarting crashed tasks according to their template's
+/// [RestartPolicy]
+///
+/// Exits come from the native exit watcher (the command's own process, or
+/// the whole tree) and backoff delays run on the native thread-pool timer,
+/// so a task waiting to restart costs nothing on the Dart side. Every
+/// attempt gets its own history entry.
+class SupervisorExtension {
+  final Core _core;
+
+  SupervisorExtension(this._core);
+
+  final Map<String, _Supervision> _supervised = {};
+  final Random _random = Random();
+
+  /// Restarts done since the user last started the task
+  int restartCount(String taskId) => _supervised[taskId]?.restarts ?? 0;
+
+  /// Waiting out a backoff delay
+  bool isRestarting(String taskId) => _supervised[taskId]?.backoff != null;
+
+  /// Gave up after too many failures
+  bool isTripped(String taskId) => _supervised[taskId]?.tripped ?? false;
+
+  /// Called by TasksExtension for every run. [restarted] is false when the
+  /// user started the task, which also resets the crash-loop breaker.
+  void watch(Task task, {required bool restarted}) {
+    if (!task.restartPolicy.isEnabled) return;
+    final s = _supervised.putIfAbsent(task.id, () => _Supervision(task));
+    s.handledRun = false;
+    if (!restarted) {
+      s.failures.clear();
+      s.restarts = 0;
+      s.tripped = false;
+    }
+    s.commandExits ??= task.commandExits
+        .listen((code) => _onExit(s, code, 'Exited with code $code'));
+    s.readinessLost ??= task.readinessLost.listen((_) {
+      if (task.restartPolicy.restartOnProbeFailure) {
+        _onExit(s, null, 'Readiness probe failing');
+      }
+    });
+  }
+
+  /// The task's whole process tree is gone
+  void onTreeExit(Task task) {
+    final s = _supervised[task.id];
+    if (s == null) return;
+    _onExit(s, task.exitCode ?? -1, 'Shell exited with code ${task.exitCode}');
+  }
+
+  /// Stop supervising (the user stopped or removed the task)
+  void release(String taskId) {
+    final s = _supervised.remove(taskId);
+    if (s == null) return;
+    s.backoff?.cancel();
+    s.commandExits?.cancel();
+    s.readinessLost?.cancel();
+  }
+
+  /// [exitCode] null means the command is still running but unhealthy
+  Future<void> _onExit(_Supervision s, int? exitCode, String reason) async {
+    if (s.handledRun || s.tripped) return;
+    final task = s.task;
+    final policy = task.restartPolicy;
+    final failed = exitCode != 0;
+    if (!failed && policy.mode != RestartMode.always) return;
+    s.handledRun = true;
+
+    _core.tasks.recordAttemptEnd(task.id, exitCode: exitCode);
+
+    final now = DateTime.now();
+    if (failed) {
+      s.failures.add(now);
+      final window = Duration(seconds: policy.failureWindowSeconds);
+      s.failures.removeWhere((t) => now.difference(t) > window);
+      if (s.failures.length > policy.maxFailures) {
+        s.tripped = true;
+        task.terminal.write(
+            '\r\n\x1b[31m[Supervisor] $reason - ${s.failures.length} failures in '
+            '${policy.failureWindowSeconds}s, not restarting again. '
+            'Start the task to reset.\x1b[0m\r\n');
+        debugPrint('SupervisorExtension: ${task.name} is crash-looping, giving up');
+        _core.notify();
+        return;
+      }
+    }
+
+    // Exponential in the recent failures, with "equal jitter" so tasks that
+    // crashed together do not come back in lockstep
+    final base = policy.backoff(max(s.failures.length, 1));
+    final half = base.inMilliseconds ~/ 2;
+    final delay = Duration(milliseconds: half + _random.nextInt(half + 1));
+    s.restarts++;
+    task.terminal.write(
+        '\r\n\x1b[33m[Supervisor] $reason - restarting in '
+        '${(delay.inMilliseconds / 1000).toStringAsFixed(1)}s (restart #${s.restarts})\x1b[0m\r\n');
+    _core.notify();
+
+    final backoff = NativeBindings.instance.delay(delay);
+    s.backoff = backoff;
+    final result = await backoff.result;
+    s.backoff = null;
+    if (result == nativeResultCancelled || _supervised[task.id] != s) return;
+
+    // Only the command may have exited - the shell hosting it is still up
+    if (task.isRunning) {
+      await task.shutdown(
+          policy: exitCode != null ? ShutdownPolicy.force : const ShutdownPolicy());
+    }
+    if (_supervised[task.id] != s) return;
+    _core.tasks.run(task.id, restartAttempt: s.restarts);
+  }
+}
@@ -4,6 +4,7 @@ import 'package:flutter/foundation.dart';
 
 import '../models/task.dart';
 import '../models/template.dart';
+import '../services/native_bindings.dart';
 import 'core.dart';
 
 /// A single step in an orchestrated restart sequence
@@ -23,10 +24,18 @@ class RestartStep {
 class TasksExtension {
   final Core _core;
 
-  TasksExtension(this._core);
+  TasksExtension(this._core) {
+    // Thaw auto-suspended tasks as soon as their pane is shown again
+    _core.addListener(_resumeVisibleTasks);
+  }
 
   final List<Task> _tasks = [];
 
+  // Auto-suspend of running tasks that are not shown in any pane
+  Timer? _autoSuspendTimer;
+  final Map<String, DateTime> _hiddenSince = {};
+  final Set<String> _autoSuspended = {};
+
   /// Get all tasks
   List<Task> get all => List.unmodifiable(_tasks);
 
@@ -46,8 +55,17 @@ class TasksExtension {
     return task;
   }
 
+  /// Create a task with placeholder values substituted (does NOT start it)
+  Task createWithValues(Template template, Map<String, String> placeholderValues) {
+    final task = Task.fromTemplateWithValues(template, placeholderValues);
+    _tasks.add(task);
+    _core.notify();
+    return task;
+  }
+
   /// Run a task by id - starts the PTY process
-  void run(String id) {
+  /// [restartAttempt] is set by the supervisor when it restarts a task
+  void run(String id, {int restartAttempt = 0}) {
     final task = getById(id);
     if (task == null || task.isRunning) return;
 
@@ -56,7 +74,10 @@ class TasksExtension {
 
     // Clear previous stats and start
     task.clearStats();
-    task.start();
+    task.start(shellPoolSize: _core.settings.current.shellPoolSize);
+    _core.supervisor.watch(task, restarted: restartAttempt > 0);
+    _autoSuspendTimer ??= Timer.periodic(
+        const Duration(seconds: 30), (_) => _suspendHiddenTasks());
 
     // Notify resource monitor that a task started
     _core.resourceMonitor.onTaskStarted(task);
@@ -66,7 +87,7 @@ class TasksExtension {
         ? _core.templates.getById(task.templateId!)
         : null;
     if (template != null) {
-      _core.history.add(template, task.id);
+      _core.history.add(template, task.id, restartAttempt: restartAttempt);
     }
 
     _core.notify();
@@ -76,6 +97,8 @@ class TasksExtension {
     final task = getById(taskId);
     if (task != null) {
       _core.resourceMonitor.onTaskStopped(task);
+      // Before the history update, so a crash is recorded as one
+      _core.supervisor.onTreeExit(task);
     }
     _updateHistoryOnStop(taskId);
     _core.notify();
@@ -90,22 +113,8 @@ class TasksExtension {
 
   /// Create and run a task with placeholder values substituted
   Task launchWithValues(Template template, Map<String, String> placeholderValues) {
-    final task = Task.fromTemplateWithValues(template, placeholderValues);
-    _tasks.add(task);
-    _core.notify();
-
-    // Set up exit handler and start
-    task.onExit = () => _onTaskExit(task.id);
-    task.clearStats();
-    task.start();
-
-    // Notify resource monitor that a task started
-    _core.resourceMonitor.onTaskStarted(task);
-
-    // Add to history
-    _core.history.add(template, task.id);
-    _core.notify();
-
+    final task = createWithValues(template, placeholderValues);
+    run(task.id);
     return task;
   }
 
@@ -119,6 +128,7 @@ class TasksExtension {
     final task = getById(id);
     if (task == null || !task.isRunning) return;
 
+    _core.supervisor.release(id);
     task.stop();
     _core.notify();
   }
@@ -128,6 +138,8 @@ class TasksExtension {
     final task = getById(id);
     if (task == null) return;
 
+    // Also cancels a restart that is waiting out its backoff
+    _core.supervisor.release(id);
     final wasRunning = task.isRunning;
     task.kill();
 
@@ -138,11 +150,103 @@ class TasksExtension {
     _core.notify();
   }
 
+  /// Freeze a running task's whole process tree
+  bool suspend(String id) {
+    final task = getById(id);
+    if (task == null || !task.suspend()) return false;
+    _autoSuspended.remove(id); // Suspended on purpose - stays frozen when shown
+    _core.notify();
+    return true;
+  }
+
+  /// Thaw a suspended task
+  void resume(String id) {
+    final task = getById(id);
+    if (task == null) return;
+    _autoSuspended.remove(id);
+    _hiddenSince.remove(id); // Restart the hidden clock
+    if (task.resume()) _core.notify();
+  }
+
+  /// Task ids shown in a terminal pane of the current layout
+  Set<String> get _visibleTaskIds => _core.layout.slots
+      .where((s) => s.isTerminal && s.contentId != null)
+      .map((s) => s.contentId!)
+      .toSet();
+
+  /// Suspend tasks hidden for longer than the auto-suspend setting
+  void _suspendHiddenTasks() {
+    final runningTasks = running;
+    if (runningTasks.isEmpty) {
+      _autoSuspendTimer?.cancel();
+      _autoSuspendTimer = null;
+      _hiddenSince.clear();
+      _autoSuspended.clear();
+      return;
+    }
+
+    final minutes = _core.settings.current.autoSuspendHiddenMinutes;
+    final visible = _visibleTaskIds;
+    final now = DateTime.now();
+    var changed = false;
+
+    _hiddenSince.removeWhere((id, _) => visible.contains(id));
+    for (final task in runningTasks) {
+      if (visible.contains(task.id)) continue;
+      final since = _hiddenSince.putIfAbsent(task.id, () => now);
+      if (minutes <= 0 || task.isSuspended) continue;
+      if (now.difference(since) >= Duration(minutes: minutes) &&
+          task.suspend()) {
+        debugPrint('TasksExtension: Auto-suspended hidden task ${task.id}');
+        _autoSuspended.add(task.id);
+        changed = true;
+      }
+    }
+    if (changed) _core.notify();
+  }
+
+  void _resumeVisibleTasks() {
+    if (_autoSuspended.isEmpty) return;
+    final visible = _visibleTaskIds;
+    for (final id in _autoSuspended.where(visible.contains).toList()) {
+      _autoSuspended.remove(id);
+      _hiddenSince.remove(id);
+      // No notify from inside a notification - the pane rebuilds anyway
+      getById(id)?.resume();
+    }
+  }
+
+  /// Graceful-then-forceful stop of the whole process tree
+  /// Completes with the per-process report.
+  Future<List<ShutdownReportEntry>> shutdown(String id,
+      {ShutdownPolicy policy = const ShutdownPolicy()}) async {
+    final task = getById(id);
+    if (task == null || !task.isRunning) return const [];
+    _core.supervisor.release(id);
+
+    final report = await task.shutdown(policy: policy);
+    final forced = report
+        .where((e) =>
+            e.stage == ShutdownStage.terminate ||
+            e.stage == ShutdownStage.survived)
+        .length;
+    debugPrint(
+        'TasksExtension: Shut down $id (${report.length} processes, $forced forced)');
+
+    _core.resourceMonitor.onTaskStopped(task);
+    _updateHistoryOnStop(id);
+    _core.notify();
+    return report;
+  }
+
   /// Remove a task entirely
   void remove(String id) {
     final task = getById(id);
     if (task == null) return;
 
+    _core.admission.cancel(id);
+    _core.supervisor.release(id);
+
     if (task.isRunning) {
       task.kill();
       _core.resourceMonitor.onTaskStopped(task);
@@ -155,11 +259,14 @@ class TasksExtension {
 
   /// Clear all stopped (non-running) tasks
   void clearStopped() {
-    final stopped = _tasks.where((t) => !t.isRunning).toList();
+    // Tasks waiting for admission have not started yet - keep them
+    final stopped = _tasks
+        .where((t) => !t.isRunning && !_core.admission.isQueued(t.id))
+        .toList();
     for (final task in stopped) {
       task.dispose();
     }
-    _tasks.removeWhere((t) => !t.isRunning);
+    _tasks.removeWhere(stopped.contains);
     _core.notify();
   }
 
@@ -180,9 +287,9 @@ class TasksExtension {
       restartInfo.add((templateId: templateId, slotIndex: slotIndex, step: step));
 
       if (task.isRunning) {
-        debugPrint('TasksExtension: Killing ${step.taskId}');
-        kill(step.taskId);
-        await _waitForExit(step.taskId, timeoutMs: 10000);
+        debugPrint('TasksExtension: Stopping ${step.taskId}');
+        await shutdown(step.taskId);
+        await _waitForExit(task, timeoutMs: 10000);
       }
 
       // Fully remove the old task (dispose terminal, remove from list)
@@ -233,21 +340,39 @@ class TasksExtension {
     debugPrint('TasksExtension: Restart sequence complete');
   }
 
-  /// Poll until a task exits or timeout
-  Future<void> _waitForExit(String taskId, {required int timeoutMs}) async {
-    final deadline = DateTime.now().add(Duration(milliseconds: timeoutMs));
-    while (DateTime.now().isBefore(deadline)) {
-      final task = getById(taskId);
-      if (task == null || !task.isRunning) return;
-      await Future.delayed(const Duration(milliseconds: 100));
+  /// Wait until a task's whole process tree has exited (native exit event), or timeout
+  Future<void> _waitForExit(Task task, {required int timeoutMs}) async {
+    try {
+      await task.treeExited.timeout(Duration(milliseconds: timeoutMs));
+    } on TimeoutException {
+      debugPrint('TasksExtension: Timeout waiting for ${task.id} to exit');
+    }
+  }
+
+  /// Close the running history entry of a task whose command exited
+  /// (failed if [exitCode] is non-zero or null)
+  void recordAttemptEnd(String taskId, {int? exitCode}) {
+    final task = getById(taskId);
+    final historyEntry = _core.history.all
+        .where((e) => e.taskId == taskId && e.isRunning)
+        .firstOrNull;
+    if (historyEntry == null) return;
+    if (task != null) {
+      _core.logs.save(historyEntry.id, task);
+    }
+    if (exitCode == 0) {
+      _core.history.complete(historyEntry.id);
+    } else {
+      _core.history.error(historyEntry.id, exitCode: exitCode);
     }
-    debugPrint('TasksExtension: Timeout waiting for $taskId to exit');
   }
 
   void _updateHistoryOnStop(String taskId) {
     final task = getById(taskId);
-    final historyEntry =
-        _core.history.all.where((e) => e.taskId == taskId).firstOrNull;
+    // Earlier attempts of a supervised task are already closed
+    final historyEntry = _core.history.all
+        .where((e) => e.taskId == taskId && e.isRunning)
+        .firstOrNull;
     if (historyEntry != null) {
       // Save log before marking as stopped
       if (task != null) {
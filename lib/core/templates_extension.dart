@@ -83,9 +83,7 @@ class TemplatesExtension {
     // Also remove from any groups
     for (int i = 0; i < _groups.length; i++) {
       if (_groups[i].taskIds.contains(id)) {
-        _groups[i] = _groups[i].copyWith(
-          taskIds: _groups[i].taskIds.where((tid) => tid != id).toList(),
-        );
+        _groups[i] = _groups[i].without(id);
       }
     }
     _core.notify();
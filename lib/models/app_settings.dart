@@ -39,6 +39,10 @@ class AppSettings {
   final TextSizePreset resourcesTextSizePreset;
   final bool isDarkMode;
   final int maxConcurrentTasks;
+  final int autoSuspendHiddenMinutes; // Freeze tasks not shown in any pane (0 = off)
+  final int maxConcurrentLaunches; // Launch weight that may be starting up at once
+  final int shellPoolSize; // Idle prewarmed shells kept per launch configuration (0 = off)
+  final int scrollbackMemoryMb; // Memory all task scrollback may keep before spilling to disk
   final String terminalThemeId;
   final List<TerminalTheme> customTerminalThemes;
 
@@ -63,6 +67,10 @@ class AppSettings {
     this.resourcesTextSizePreset = TextSizePreset.medium,
     this.isDarkMode = true,
     this.maxConcurrentTasks = 10,
+    this.autoSuspendHiddenMinutes = 0,
+    this.maxConcurrentLaunches = 3,
+    this.shellPoolSize = 1,
+    this.scrollbackMemoryMb = 64,
     this.terminalThemeId = 'default_dark',
     this.customTerminalThemes = const [],
     this.layoutTree,
@@ -120,6 +128,10 @@ class AppSettings {
       ),
       isDarkMode: json['isDarkMode'] as bool? ?? true,
       maxConcurrentTasks: json['maxConcurrentTasks'] as int? ?? 10,
+      autoSuspendHiddenMinutes: json['autoSuspendHiddenMinutes'] as int? ?? 0,
+      maxConcurrentLaunches: json['maxConcurrentLaunches'] as int? ?? 3,
+      shellPoolSize: json['shellPoolSize'] as int? ?? 1,
+      scrollbackMemoryMb: json['scrollbackMemoryMb'] as int? ?? 64,
       terminalThemeId: json['terminalThemeId'] as String? ?? 'default_dark',
       customTerminalThemes: customThemesList,
       layoutTree: json['layoutTree'] as Map<String, dynamic>?,
@@ -141,6 +153,10 @@ class AppSettings {
         'resourcesTextSizePreset': resourcesTextSizePreset.name,
         'isDarkMode': isDarkMode,
         'maxConcurrentTasks': maxConcurrentTasks,
+        'autoSuspendHiddenMinutes': autoSuspendHiddenMinutes,
+        'maxConcurrentLaunches': maxConcurrentLaunches,
+        'shellPoolSize': shellPoolSize,
+        'scrollbackMemoryMb': scrollbackMemoryMb,
         'terminalThemeId': terminalThemeId,
         'customTerminalThemes':
             customTerminalThemes.map((t) => t.toJson()).toList(),
@@ -162,6 +178,10 @@ class AppSettings {
     TextSizePreset? resourcesTextSizePreset,
     bool? isDarkMode,
     int? maxConcurrentTasks,
+    int? autoSuspendHiddenMinutes,
+    int? maxConcurrentLaunches,
+    int? shellPoolSize,
+    int? scrollbackMemoryMb,
     String? terminalThemeId,
     List<TerminalTheme>? customTerminalThemes,
     Map<String, dynamic>? layoutTree,
@@ -182,6 +202,12 @@ class AppSettings {
           resourcesTextSizePreset ?? this.resourcesTextSizePreset,
       isDarkMode: isDarkMode ?? this.isDarkMode,
       maxConcurrentTasks: maxConcurrentTasks ?? this.maxConcurrentTasks,
+      autoSuspendHiddenMinutes:
+          autoSuspendHiddenMinutes ?? this.autoSuspendHiddenMinutes,
+      maxConcurrentLaunches:
+          maxConcurrentLaunches ?? this.maxConcurrentLaunches,
+      shellPoolSize: shellPoolSize ?? this.shellPoolSize,
+      scrollbackMemoryMb: scrollbackMemoryMb ?? this.scrollbackMemoryMb,
       terminalThemeId: terminalThemeId ?? this.terminalThemeId,
       customTerminalThemes: customTerminalThemes ?? this.customTerminalThemes,
       layoutTree: layoutTree ?? this.layoutTree,
@@ -206,6 +232,10 @@ class AppSettings {
           resourcesTextSizePreset == other.resourcesTextSizePreset &&
           isDarkMode == other.isDarkMode &&
           maxConcurrentTasks == other.maxConcurrentTasks &&
+          autoSuspendHiddenMinutes == other.autoSuspendHiddenMinutes &&
+          maxConcurrentLaunches == other.maxConcurrentLaunches &&
+          shellPoolSize == other.shellPoolSize &&
+          scrollbackMemoryMb == other.scrollbackMemoryMb &&
           terminalThemeId == other.terminalThemeId &&
           const ListEquality()
               .equals(customTerminalThemes, other.customTerminalThemes) &&
@@ -229,6 +259,10 @@ class AppSettings {
       resourcesTextSizePreset.hashCode ^
       isDarkMode.hashCode ^
       maxConcurrentTasks.hashCode ^
+      autoSuspendHiddenMinutes.hashCode ^
+      maxConcurrentLaunches.hashCode ^
+      shellPoolSize.hashCode ^
+      scrollbackMemoryMb.hashCode ^
       terminalThemeId.hashCode ^
       const ListEquality().hash(customTerminalThemes) ^
       const MapEquality().hash(layoutTree) ^
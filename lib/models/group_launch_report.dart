@@ -0,0 +1,94 @@
+/// Timing of one task in a group launch
+class GroupLaunchNode {
+  final String templateId;
+  final String name;
+  final List<String> dependsOn;
+  DateTime? queuedAt;
+  DateTime? startedAt;
+  DateTime? readyAt;
+  bool skipped = false;
+
+  GroupLaunchNode({
+    required this.templateId,
+    required this.name,
+    required this.dependsOn,
+  });
+
+  /// Time spent waiting for dependencies and admission
+  Duration? get waited =>
+      queuedAt != null && startedAt != null ? startedAt!.difference(queuedAt!) : null;
+
+  /// Time from start to ready
+  Duration? get startup =>
+      startedAt != null && readyAt != null ? readyAt!.difference(startedAt!) : null;
+
+  Map<String, dynamic> toJson() => {
+    'templateId': templateId,
+    'name': name,
+    'dependsOn': dependsOn,
+    if (waited != null) 'waitedMs': waited!.inMilliseconds,
+    if (startup != null) 'startupMs': startup!.inMilliseconds,
+    'skipped': skipped,
+  };
+}
+
+/// Outcome of launching a task group along its dependency graph
+class GroupLaunchReport {
+  final String groupId;
+  final DateTime launchedAt;
+  final List<GroupLaunchNode> nodes;
+  DateTime? finishedAt;
+
+  GroupLaunchReport({
+    required this.groupId,
+    required this.launchedAt,
+    required this.nodes,
+  });
+
+  /// Launch to the last task ready (or skipped/failed)
+  Duration? get total => finishedAt?.difference(launchedAt);
+
+  bool get allReady => nodes.every((n) => n.readyAt != null);
+
+  /// Chain of tasks that determined the total: from the last task ready,
+  /// back through the dependency that became ready last
+  List<GroupLaunchNode> get criticalPath {
+    final byId = {for (final node in nodes) node.templateId: node};
+    GroupLaunchNode? current;
+    for (final node in nodes) {
+      if (node.readyAt == null) continue;
+      if (current == null || node.readyAt!.isAfter(current.readyAt!)) current = node;
+    }
+
+    final path = <GroupLaunchNode>[];
+    while (current != null && !path.contains(current)) {
+      path.insert(0, current);
+      GroupLaunchNode? latest;
+      for (final id in current.dependsOn) {
+        final dep = byId[id];
+        if (dep?.readyAt == null) continue;
+        if (latest == null || dep!.readyAt!.isAfter(latest.readyAt!)) latest = dep;
+      }
+      current = latest;
+    }
+    return path;
+  }
+
+  /// "a 1.2s → b 3.4s"
+  String describeCriticalPath() {
+    return criticalPath
+        .map((n) => '${n.name} ${_seconds(n.startup)}')
+        .join(' → ');
+  }
+
+  static String _seconds(Duration? d) =>
+      d == null ? '-' : '${(d.inMilliseconds / 1000).toStringAsFixed(1)}s';
+
+  Map<String, dynamic> toJson() => {
+    'groupId': groupId,
+    'launchedAt': launchedAt.toIso8601String(),
+    if (total != null) 'totalMs': total!.inMilliseconds,
+    'criticalPath': criticalPath.map((n) => n.templateId).toList(),
+    'nodes': nodes.map((n) => n.toJson()).toList(),
+  };
+}
@@ -20,6 +20,8 @@ class HistoryEntry {
   final DateTime? endedAt;
   final HistoryStatus status;
   final String emoji;
+  final int restartAttempt; // 0 = started by the user, n = n-th supervisor restart
+  final int? exitCode; // Of the command, when it failed
 
   const HistoryEntry({
     required this.id,
@@ -33,6 +35,8 @@ class HistoryEntry {
     this.endedAt,
     this.status = HistoryStatus.running,
     this.emoji = '',
+    this.restartAttempt = 0,
+    this.exitCode,
   });
 
   factory HistoryEntry.fromJson(Map<String, dynamic> json) {
@@ -53,6 +57,8 @@ class HistoryEntry {
         orElse: () => HistoryStatus.stopped,
       ),
       emoji: json['emoji'] ?? '',
+      restartAttempt: json['restartAttempt'] ?? 0,
+      exitCode: json['exitCode'],
     );
   }
 
@@ -68,6 +74,8 @@ class HistoryEntry {
     if (endedAt != null) 'endedAt': endedAt!.toIso8601String(),
     'status': status.name,
     'emoji': emoji,
+    if (restartAttempt > 0) 'restartAttempt': restartAttempt,
+    if (exitCode != null) 'exitCode': exitCode,
   };
 
   HistoryEntry copyWith({
@@ -82,6 +90,8 @@ class HistoryEntry {
     DateTime? endedAt,
     HistoryStatus? status,
     String? emoji,
+    int? restartAttempt,
+    int? exitCode,
   }) {
     return HistoryEntry(
       id: id ?? this.id,
@@ -95,6 +105,8 @@ class HistoryEntry {
       endedAt: endedAt ?? this.endedAt,
       status: status ?? this.status,
       emoji: emoji ?? this.emoji,
+      restartAttempt: restartAttempt ?? this.restartAttempt,
+      exitCode: exitCode ?? this.exitCode,
     );
   }
 
@@ -115,6 +127,13 @@ class HistoryEntry {
     }
   }
 
+  /// " · restart #2 · exit 1", empty for a plain run
+  String get attemptSuffix {
+    final restart = restartAttempt > 0 ? ' · restart #$restartAttempt' : '';
+    final exit = exitCode != null ? ' · exit $exitCode' : '';
+    return '$restart$exit';
+  }
+
   bool get isRunning => status == HistoryStatus.running;
   bool get isArchived => status == HistoryStatus.archived;
 
@@ -0,0 +1,73 @@
+/// How a task's command is started
+enum LaunchMode {
+  auto('Auto'), // Direct unless the command needs the shell
+  shell('Shell'), // Typed into cmd.exe
+  direct('Direct'); // Spawned as the PTY's own process, no cmd.exe
+
+  final String label;
+  const LaunchMode(this.label);
+
+  static LaunchMode fromName(String? name) => LaunchMode.values.firstWhere(
+        (m) => m.name == name,
+        orElse: () => LaunchMode.auto,
+      );
+
+  // cmd.exe builtins have no executable to start
+  static const _builtins = {
+    'assoc', 'break', 'call', 'cd', 'chdir', 'cls', 'color', 'copy', 'date',
+    'del', 'dir', 'echo', 'endlocal', 'erase', 'for', 'ftype', 'goto', 'if',
+    'md', 'mkdir', 'mklink', 'move', 'path', 'pause', 'popd', 'prompt',
+    'pushd', 'rd', 'rem', 'ren', 'rename', 'rmdir', 'set', 'setlocal',
+    'shift', 'start', 'time', 'title', 'type', 'ver', 'verify', 'vol',
+  };
+
+  /// Whether [command] and [arguments] use shell syntax: redirection,
+  /// pipes, command chaining, %VAR% expansion, escapes or a builtin
+  static bool needsShell(String command, List<String> arguments) {
+    final line = [command, ...arguments].join(' ');
+    if (RegExp(r'[&|<>^]|%[^%\s]+%').hasMatch(line)) return true;
+    final first = command.trim().split(RegExp(r'\s+')).first.toLowerCase();
+    return _builtins.contains(first);
+  }
+
+  /// The program [command] starts: its first argument, split with the C
+  /// runtime quoting rules a direct launch uses (so `"C:\Program Files\x.exe"`
+  /// stays whole)
+  static String programName(String command) {
+    final name = StringBuffer();
+    var quoted = false;
+    var i = 0;
+    while (i < command.length && (command[i] == ' ' || command[i] == '\t')) {
+      i++;
+    }
+    while (i < command.length) {
+      if (!quoted && (command[i] == ' ' || command[i] == '\t')) break;
+      var backslashes = 0;
+      while (i < command.length && command[i] == '\\') {
+        backslashes++;
+        i++;
+      }
+      if (i < command.length && command[i] == '"') {
+        name.write('\\' * (backslashes ~/ 2));
+        if (backslashes.isOdd) {
+          name.write('"');
+          i++;
+        } else if (quoted && i + 1 < command.length && command[i + 1] == '"') {
+          name.write('"');
+          i += 2;
+        } else {
+          quoted = !quoted;
+          i++;
+        }
+      } else {
+        name.write('\\' * backslashes);
+        if (i < command.length &&
+            (quoted || (command[i] != ' ' && command[i] != '\t'))) {
+          name.write(command[i]);
+          i++;
+        }
+      }
+    }
+    return name.toString();
+  }
+}
@@ -25,6 +25,13 @@ class ProcessStats {
   final int processCount; // Number of processes in tree (parent + children)
   final List<ChildProcessStats> children; // Individual child process stats
 
+  // Job accounting totals since the task started, exited processes included
+  // (only available for tasks contained in a job, otherwise 0)
+  final int totalProcesses; // Every process the task ever started
+  final Duration cpuTime;
+  final int ioReadBytes;
+  final int ioWriteBytes;
+
   const ProcessStats({
     required this.pid,
     required this.cpuUsage,
@@ -32,8 +39,14 @@ class ProcessStats {
     required this.timestamp,
     this.processCount = 1,
     this.children = const [],
+    this.totalProcesses = 0,
+    this.cpuTime = Duration.zero,
+    this.ioReadBytes = 0,
+    this.ioWriteBytes = 0,
   });
 
+  bool get hasJobAccounting => totalProcesses > 0;
+
   String get memoryMB => '${(memoryUsage / 1024).toStringAsFixed(1)} MB';
   String get cpuPercent => '${cpuUsage.toStringAsFixed(1)}%';
 
@@ -44,6 +57,10 @@ class ProcessStats {
     DateTime? timestamp,
     int? processCount,
     List<ChildProcessStats>? children,
+    int? totalProcesses,
+    Duration? cpuTime,
+    int? ioReadBytes,
+    int? ioWriteBytes,
   }) {
     return ProcessStats(
       pid: pid ?? this.pid,
@@ -52,6 +69,10 @@ class ProcessStats {
       timestamp: timestamp ?? this.timestamp,
       processCount: processCount ?? this.processCount,
       children: children ?? this.children,
+      totalProcesses: totalProcesses ?? this.totalProcesses,
+      cpuTime: cpuTime ?? this.cpuTime,
+      ioReadBytes: ioReadBytes ?? this.ioReadBytes,
+      ioWriteBytes: ioWriteBytes ?? this.ioWriteBytes,
     );
   }
 }
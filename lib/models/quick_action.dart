@@ -1,4 +1,14 @@
-enum ScheduleType { clock, interval, oneShot }
+enum ScheduleType { clock, interval, oneShot, cron }
+
+/// What a schedule does about a fire it missed by more than a minute
+/// (machine asleep, clock changed) - mirrors native MissedFirePolicy
+enum MissedFirePolicy {
+  skip('Skip it'),
+  fireOnce('Run once on wake');
+
+  final String label;
+  const MissedFirePolicy(this.label);
+}
 
 /// A quick action is a user-defined command that can be executed on a running task
 class QuickAction {
@@ -9,6 +19,8 @@ class QuickAction {
   final ScheduleType? scheduleType;
   final String? scheduleValue;
   final bool scheduleEnabled;
+  final bool scheduleUtc; // Clock and cron times are UTC instead of local
+  final MissedFirePolicy missedFire;
 
   const QuickAction({
     required this.id,
@@ -18,6 +30,8 @@ class QuickAction {
     this.scheduleType,
     this.scheduleValue,
     this.scheduleEnabled = true,
+    this.scheduleUtc = false,
+    this.missedFire = MissedFirePolicy.fireOnce,
   });
 
   bool get isScheduled => scheduleType != null && scheduleEnabled;
@@ -25,15 +39,32 @@ class QuickAction {
   /// Human-readable schedule description
   String get scheduleDescription {
     if (scheduleType == null) return 'Manual only';
+    final zone = scheduleUtc ? ' UTC' : '';
     switch (scheduleType!) {
       case ScheduleType.clock:
-        return 'Daily at ${scheduleValue ?? "?"}';
+        return 'Daily at ${scheduleValue ?? "?"}$zone';
       case ScheduleType.interval:
         return 'Every ${scheduleValue ?? "?"} min';
       case ScheduleType.oneShot:
         final v = scheduleValue ?? '';
         return v.contains(':') ? 'Once at $v' : 'Once in ${v}m';
+      case ScheduleType.cron:
+        return 'Cron ${scheduleValue ?? "?"}$zone';
+    }
+  }
+
+  /// Shape check of a cron expression: five fields of numbers, ranges, steps
+  /// and lists, or one of the @hourly/@daily/@weekly/@monthly/@yearly macros.
+  /// The native scheduler validates the values.
+  static bool isValidCron(String expression) {
+    final value = expression.trim();
+    if (const ['@hourly', '@daily', '@midnight', '@weekly', '@monthly',
+        '@yearly', '@annually'].contains(value)) {
+      return true;
     }
+    final fields = value.split(RegExp(r'\s+'));
+    return fields.length == 5 &&
+        fields.every((f) => RegExp(r'^[0-9*,/-]+$').hasMatch(f));
   }
 
   factory QuickAction.fromJson(Map<String, dynamic> json) {
@@ -47,6 +78,11 @@ class QuickAction {
           : null,
       scheduleValue: json['scheduleValue'] as String?,
       scheduleEnabled: json['scheduleEnabled'] ?? true,
+      scheduleUtc: json['scheduleUtc'] as bool? ?? false,
+      missedFire: MissedFirePolicy.values.firstWhere(
+        (p) => p.name == json['missedFire'],
+        orElse: () => MissedFirePolicy.fireOnce,
+      ),
     );
   }
 
@@ -58,6 +94,8 @@ class QuickAction {
         if (scheduleType != null) 'scheduleType': scheduleType!.name,
         if (scheduleValue != null) 'scheduleValue': scheduleValue,
         if (!scheduleEnabled) 'scheduleEnabled': false,
+        if (scheduleUtc) 'scheduleUtc': true,
+        if (missedFire != MissedFirePolicy.fireOnce) 'missedFire': missedFire.name,
       };
 
   QuickAction copyWith({
@@ -68,6 +106,8 @@ class QuickAction {
     ScheduleType? scheduleType,
     String? scheduleValue,
     bool? scheduleEnabled,
+    bool? scheduleUtc,
+    MissedFirePolicy? missedFire,
     bool clearSchedule = false,
   }) {
     return QuickAction(
@@ -81,6 +121,8 @@ class QuickAction {
       scheduleEnabled: clearSchedule
           ? true
           : (scheduleEnabled ?? this.scheduleEnabled),
+      scheduleUtc: clearSchedule ? false : (scheduleUtc ?? this.scheduleUtc),
+      missedFire: missedFire ?? this.missedFire,
     );
   }
 
@@ -0,0 +1,111 @@
+/// What a readiness probe checks (the first three mirror native ProbeKind)
+enum ProbeKind {
+  tcp('TCP port'),
+  http('HTTP endpoint'),
+  file('File exists'),
+  output('Output pattern');
+
+  final String label;
+  const ProbeKind(this.label);
+}
+
+/// How a task proves it is ready, instead of the steps/quiet-output guess.
+/// Network and file probes run natively on one shared thread; the output
+/// probe matches the task's own terminal output.
+class ReadinessProbe {
+  final ProbeKind kind;
+  final String? host; // IP literal or localhost (default; tries 127.0.0.1 and ::1)
+  final int? port; // tcp, http
+  final String? path; // http request path, or the file to wait for
+  final String? pattern; // output: regex
+  final int? expectedStatus; // http: null accepts any 2xx/3xx
+  final int intervalMs;
+  final int timeoutMs;
+  final int successThreshold; // Passes in a row before ready
+  final int failureThreshold; // Failures in a row before a ready task is unready
+
+  const ReadinessProbe({
+    required this.kind,
+    this.host,
+    this.port,
+    this.path,
+    this.pattern,
+    this.expectedStatus,
+    this.intervalMs = 500,
+    this.timeoutMs = 1000,
+    this.successThreshold = 1,
+    this.failureThreshold = 3,
+  });
+
+  /// Whether enough is filled in to run the probe
+  bool get isValid => switch (kind) {
+        ProbeKind.tcp || ProbeKind.http => port != null && port! > 0 && port! <= 65535,
+        ProbeKind.file => path != null && path!.isNotEmpty,
+        ProbeKind.output => pattern != null && pattern!.isNotEmpty,
+      };
+
+  /// Short description for terminal lines, e.g. "HTTP localhost:8080/health"
+  String get description => switch (kind) {
+        ProbeKind.tcp => 'TCP ${host ?? 'localhost'}:$port',
+        ProbeKind.http => 'HTTP ${host ?? 'localhost'}:$port${path ?? '/'}',
+        ProbeKind.file => 'file $path',
+        ProbeKind.output => 'output /$pattern/',
+      };
+
+  factory ReadinessProbe.fromJson(Map<String, dynamic> json) {
+    return ReadinessProbe(
+      kind: ProbeKind.values.firstWhere(
+        (k) => k.name == json['kind'],
+        orElse: () => ProbeKind.tcp,
+      ),
+      host: json['host'] as String?,
+      port: json['port'] as int?,
+      path: json['path'] as String?,
+      pattern: json['pattern'] as String?,
+      expectedStatus: json['expectedStatus'] as int?,
+      intervalMs: json['intervalMs'] as int? ?? 500,
+      timeoutMs: json['timeoutMs'] as int? ?? 1000,
+      successThreshold: json['successThreshold'] as int? ?? 1,
+      failureThreshold: json['failureThreshold'] as int? ?? 3,
+    );
+  }
+
+  Map<String, dynamic> toJson() => {
+        'kind': kind.name,
+        if (host != null) 'host': host,
+        if (port != null) 'port': port,
+        if (path != null) 'path': path,
+        if (pattern != null) 'pattern': pattern,
+        if (expectedStatus != null) 'expectedStatus': expectedStatus,
+        'intervalMs': intervalMs,
+        'timeoutMs': timeoutMs,
+        'successThreshold': successThreshold,
+        'failureThreshold': failureThreshold,
+      };
+
+  ReadinessProbe copyWith({
+    ProbeKind? kind,
+    String? host,
+    int? port,
+    String? path,
+    String? pattern,
+    int? expectedStatus,
+    int? intervalMs,
+    int? timeoutMs,
+    int? successThreshold,
+    int? failureThreshold,
+  }) {
+    return ReadinessProbe(
+      kind: kind ?? this.kind,
+      host: host ?? this.host,
+      port: port ?? this.port,
+      path: path ?? this.path,
+      pattern: pattern ?? this.pattern,
+      expectedStatus: expectedStatus ?? this.expectedStatus,
+      intervalMs: intervalMs ?? this.intervalMs,
+      timeoutMs: timeoutMs ?? this.timeoutMs,
+      successThreshold: successThreshold ?? this.successThreshold,
+      failureThreshold: failureThreshold ?? this.failureThreshold,
+    );
+  }
+}
@@ -0,0 +1,32 @@
+/// Per-task resource limits, enforced natively on the task's job object
+/// (the whole process tree counts, not just the shell)
+class ResourceLimits {
+  final int? maxMemoryMb; // Committed memory of the whole tree
+  final int? cpuRatePercent; // Hard cap, share of total machine CPU (1-99)
+  final int? maxProcesses; // Processes running at the same time
+
+  const ResourceLimits({
+    this.maxMemoryMb,
+    this.cpuRatePercent,
+    this.maxProcesses,
+  });
+
+  static const none = ResourceLimits();
+
+  bool get isEmpty =>
+      maxMemoryMb == null && cpuRatePercent == null && maxProcesses == null;
+
+  factory ResourceLimits.fromJson(Map<String, dynamic> json) {
+    return ResourceLimits(
+      maxMemoryMb: json['maxMemoryMb'] as int?,
+      cpuRatePercent: json['cpuRatePercent'] as int?,
+      maxProcesses: json['maxProcesses'] as int?,
+    );
+  }
+
+  Map<String, dynamic> toJson() => {
+        if (maxMemoryMb != null) 'maxMemoryMb': maxMemoryMb,
+        if (cpuRatePercent != null) 'cpuRatePercent': cpuRatePercent,
+        if (maxProcesses != null) 'maxProcesses': maxProcesses,
+      };
+}
@@ -0,0 +1,75 @@
+/// What a resource rule watches (index mirrors native RuleMetric)
+enum RuleMetric {
+  memory('Memory', 'MB'), // Working set of the whole tree
+  cpu('CPU', '%'), // 100 = one core
+  processes('Processes', '');
+
+  final String label;
+  final String unit;
+  const RuleMetric(this.label, this.unit);
+}
+
+/// What happens when a rule is breached
+enum RuleAction {
+  degrade('Mark degraded'),
+  restart('Graceful restart');
+
+  final String label;
+  const RuleAction(this.label);
+}
+
+/// Per-template threshold rule over the sampled resource stats, e.g.
+/// "memory > 2048 MB for 60 s -> graceful restart". Evaluated natively with
+/// hysteresis: a breached rule recovers only once the value drops below
+/// [clearThreshold] for the same time.
+class ResourceRule {
+  final RuleMetric metric;
+  final double threshold; // In the metric's unit
+  final int sustainSeconds; // Above the threshold this long before acting
+  final RuleAction action;
+
+  const ResourceRule({
+    required this.metric,
+    required this.threshold,
+    this.sustainSeconds = 60,
+    this.action = RuleAction.degrade,
+  });
+
+  /// Recovery level, 10% below the threshold
+  double get clearThreshold => threshold * 0.9;
+
+  /// Short description, e.g. "Memory > 2048 MB for 60s"
+  String get description {
+    final value = threshold == threshold.roundToDouble()
+        ? threshold.toInt().toString()
+        : threshold.toStringAsFixed(1);
+    final unit = metric.unit.isEmpty
+        ? ''
+        : metric.unit == '%'
+            ? '%'
+            : ' ${metric.unit}';
+    return '${metric.label} > $value$unit for ${sustainSeconds}s';
+  }
+
+  factory ResourceRule.fromJson(Map<String, dynamic> json) {
+    return ResourceRule(
+      metric: RuleMetric.values.firstWhere(
+        (m) => m.name == json['metric'],
+        orElse: () => RuleMetric.memory,
+      ),
+      threshold: (json['threshold'] as num?)?.toDouble() ?? 0,
+      sustainSeconds: json['sustainSeconds'] as int? ?? 60,
+      action: RuleAction.values.firstWhere(
+        (a) => a.name == json['action'],
+        orElse: () => RuleAction.degrade,
+      ),
+    );
+  }
+
+  Map<String, dynamic> toJson() => {
+        'metric': metric.name,
+        'threshold': threshold,
+        'sustainSeconds': sustainSeconds,
+        'action': action.name,
+      };
+}
@@ -0,0 +1,63 @@
+/// When the supervisor restarts a task
+enum RestartMode {
+  never('Never'),
+  onFailure('On failure'),
+  always('Always');
+
+  final String label;
+  const RestartMode(this.label);
+}
+
+/// Per-template supervision: restart the task's command when it exits,
+/// with exponential backoff, and give up when it keeps crashing
+class RestartPolicy {
+  final RestartMode mode;
+  final int initialBackoffMs; // Delay before the first restart
+  final int maxBackoffMs; // Backoff doubles per restart up to this
+  final int maxFailures; // Crash-loop breaker: failures allowed...
+  final int failureWindowSeconds; // ...within this many seconds
+  final bool restartOnProbeFailure; // Restart when a ready task's probe keeps failing
+
+  const RestartPolicy({
+    this.mode = RestartMode.never,
+    this.initialBackoffMs = 1000,
+    this.maxBackoffMs = 30000,
+    this.maxFailures = 5,
+    this.failureWindowSeconds = 120,
+    this.restartOnProbeFailure = false,
+  });
+
+  static const none = RestartPolicy();
+
+  bool get isEnabled => mode != RestartMode.never;
+
+  /// Backoff before restart number [attempt] (1-based), without jitter
+  Duration backoff(int attempt) {
+    final shift = (attempt - 1).clamp(0, 20);
+    final ms = initialBackoffMs * (1 << shift);
+    return Duration(milliseconds: ms.clamp(0, maxBackoffMs));
+  }
+
+  factory RestartPolicy.fromJson(Map<String, dynamic> json) {
+    return RestartPolicy(
+      mode: RestartMode.values.firstWhere(
+        (m) => m.name == json['mode'],
+        orElse: () => RestartMode.never,
+      ),
+      initialBackoffMs: json['initialBackoffMs'] as int? ?? 1000,
+      maxBackoffMs: json['maxBackoffMs'] as int? ?? 30000,
+      maxFailures: json['maxFailures'] as int? ?? 5,
+      failureWindowSeconds: json['failureWindowSeconds'] as int? ?? 120,
+      restartOnProbeFailure: json['restartOnProbeFailure'] as bool? ?? false,
+    );
+  }
+
+  Map<String, dynamic> toJson() => {
+        'mode': mode.name,
+        'initialBackoffMs': initialBackoffMs,
+        'maxBackoffMs': maxBackoffMs,
+        'maxFailures': maxFailures,
+        'failureWindowSeconds': failureWindowSeconds,
+        if (restartOnProbeFailure) 'restartOnProbeFailure': true,
+      };
+}
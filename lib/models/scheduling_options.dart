@@ -0,0 +1,105 @@
+/// CPU priority class of a task's process tree (mirrors the Win32 classes)
+enum TaskPriority {
+  idle('Idle', 0x40),
+  belowNormal('Below normal', 0x4000),
+  normal('Normal', 0x20),
+  aboveNormal('Above normal', 0x8000),
+  high('High', 0x80);
+
+  final String label;
+  final int nativeClass; // *_PRIORITY_CLASS
+  const TaskPriority(this.label, this.nativeClass);
+}
+
+/// Disk and network I/O priority of a task's process tree
+enum IoPriority {
+  veryLow('Very low'),
+  low('Low'),
+  normal('Normal');
+
+  final String label;
+  const IoPriority(this.label);
+}
+
+/// Per-task scheduling, applied natively to the whole tree at spawn and
+/// inherited by every process started later. Null fields keep the default.
+class SchedulingOptions {
+  final TaskPriority? priority;
+  final int? affinityMask; // Bit n = logical processor n
+  final IoPriority? ioPriority;
+  final int? launchWeight; // Share of the group launch budget while starting (default 1)
+
+  const SchedulingOptions({
+    this.priority,
+    this.affinityMask,
+    this.ioPriority,
+    this.launchWeight,
+  });
+
+  static const none = SchedulingOptions();
+
+  bool get isEmpty =>
+      priority == null &&
+      affinityMask == null &&
+      ioPriority == null &&
+      launchWeight == null;
+
+  /// True if any setting has to be applied to the process tree
+  bool get affectsProcesses =>
+      priority != null || affinityMask != null || ioPriority != null;
+
+  factory SchedulingOptions.fromJson(Map<String, dynamic> json) {
+    return SchedulingOptions(
+      priority: TaskPriority.values.asNameMap()[json['priority']],
+      affinityMask: json['affinityMask'] as int?,
+      ioPriority: IoPriority.values.asNameMap()[json['ioPriority']],
+      launchWeight: json['launchWeight'] as int?,
+    );
+  }
+
+  Map<String, dynamic> toJson() => {
+        if (priority != null) 'priority': priority!.name,
+        if (affinityMask != null) 'affinityMask': affinityMask,
+        if (ioPriority != null) 'ioPriority': ioPriority!.name,
+        if (launchWeight != null) 'launchWeight': launchWeight,
+      };
+
+  /// Parse a CPU list like "0-3,6" into an affinity mask (null if empty or invalid)
+  static int? parseCpuList(String text) {
+    var mask = 0;
+    for (final part in text.split(',')) {
+      final item = part.trim();
+      if (item.isEmpty) continue;
+      final bounds = item.split('-');
+      final first = int.tryParse(bounds.first.trim());
+      final last = bounds.length == 2 ? int.tryParse(bounds[1].trim()) : first;
+      if (bounds.length > 2 || first == null || last == null ||
+          first < 0 || last < first || last > 63) {
+        return null;
+      }
+      for (var cpu = first; cpu <= last; cpu++) {
+        mask |= 1 << cpu;
+      }
+    }
+    return mask != 0 ? mask : null;
+  }
+
+  /// Format an affinity mask as a CPU list ("0-3,6")
+  static String formatCpuList(int mask) {
+    final ranges = <String>[];
+    var cpu = 0;
+    while (cpu < 64) {
+      if (mask & (1 << cpu) == 0) {
+        cpu++;
+        continue;
+      }
+      final start = cpu;
+      while (cpu + 1 < 64 && mask & (1 << (cpu + 1)) != 0) {
+        cpu++;
+      }
+      ranges.add(start == cpu ? '$start' : '$start-$cpu');
+      cpu++;
+    }
+    return ranges.join(',');
+  }
+}
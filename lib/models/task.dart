@@ -3,13 +3,20 @@ import 'dart:convert';
 import 'dart:io';
 import 'dart:typed_data';
 import 'dart:ui' show VoidCallback;
-import 'package:flutter_pty/flutter_pty.dart';
 import 'package:xterm/xterm.dart' as xterm;
 import 'template.dart';
 import 'task_step.dart';
 import 'quick_action.dart';
 import 'process_stats.dart';
+import 'resource_limits.dart';
+import 'scheduling_options.dart';
+import 'readiness_probe.dart';
+import 'restart_policy.dart';
+import 'resource_rule.dart';
+import 'launch_mode.dart';
+import 'task_terminal.dart';
 import '../services/native_bindings.dart';
+import '../services/task_pty.dart';
 
 enum TaskStatus {
   idle,
@@ -38,19 +45,63 @@ class Task {
   final List<TaskStep> steps; // Automation steps
   final List<QuickAction> quickActions; // Scheduled/manual quick actions
   final Map<String, String> envVars; // Per-task environment variables (merged with system at spawn)
+  final ResourceLimits limits; // Applied to the job at spawn
+  final SchedulingOptions scheduling; // Applied to the job at spawn
+  final ReadinessProbe? probe; // Decides readiness when set
+  final RestartPolicy restartPolicy; // Followed by SupervisorExtension
+  final List<ResourceRule> resourceRules; // Evaluated by ResourceRulesExtension
+  final LaunchMode launchMode; // Through cmd.exe or spawned directly
+  final bool pipeOutput; // Plain pipes instead of a terminal
 
   // Terminal state (lives with the task, survives navigation)
-  final xterm.Terminal terminal;
+  final TaskTerminal terminal;
   final xterm.TerminalController terminalController;
 
   // Runtime process state (not serialized)
-  Pty? _pty;
+  TaskPty? _pty;
   int? _pid;
   int? _jobHandle; // Windows Job Object handle for process tree management
   int? _exitCode;
+  bool _suspended = false; // Tree frozen by suspend()
+  String? _degradedReason; // Breached resource rule, until it recovers
   StreamSubscription<Uint8List>? _outputSubscription;
+  StreamSubscription<Uint8List>? _errorSubscription; // stderr in pipe mode
   VoidCallback? onExit;
 
+  // Native exit watch over the whole process tree (root + job members)
+  int _exitWatchId = 0;
+  StreamSubscription<ProcessExitEvent>? _exitWatchSubscription;
+  StreamSubscription<JobLimitEvent>? _limitSubscription;
+  StreamSubscription<ProcessExitEvent>? _commandExitSubscription;
+  bool _commandRunning = false; // Sent to the shell, its process not yet exited
+  bool _direct = false; // This run's root process is the command itself
+  final StreamController<int> _commandExitController =
+      StreamController<int>.broadcast();
+  Completer<void> _treeExited = Completer<void>()..complete();
+
+  // Limit breaches of this task's job (a runaway tree can hit one thousands of times)
+  final StreamController<JobLimitEvent> _limitController =
+      StreamController<JobLimitEvent>.broadcast();
+  final Map<JobLimitKind, DateTime> _lastLimitNotice = {};
+
+  // Readiness: the probe if there is one, else steps completed or, without
+  // steps, output quiet after the command
+  DateTime? _startedAt;
+  DateTime? _readyAt;
+  Completer<bool> _ready = Completer<bool>()..complete(false);
+  Timer? _quietTimer;
+  static const _outputQuietPeriod = Duration(milliseconds: 1500);
+
+  // Readiness probe state (runtime only)
+  int _probeId = 0; // Native probe, 0 for output probes or none
+  StreamSubscription<ProbeEvent>? _probeSubscription;
+  RegExp? _outputProbe;
+  String _outputProbeBuffer = '';
+  bool _probeActive = false; // A probe is running and decides readiness
+  bool _probeHealthy = false;
+  final StreamController<ProbeEvent> _readinessLostController =
+      StreamController<ProbeEvent>.broadcast();
+
   // Step execution state
   int _currentStepIndex = 0;
   StepExecutionStatus _stepStatus = StepExecutionStatus.idle;
@@ -58,12 +109,27 @@ class Task {
   String _outputBuffer = ''; // Buffer for pattern matching
   VoidCallback? onStepProgress; // Called when step status changes
 
-  // Scheduled quick action timers (runtime only)
+  // Scheduled quick actions (runtime only). Native schedules outlive a run
+  // and are rebound on restart; Dart timers are the fallback without the DLL.
   final List<Timer> _quickActionTimers = [];
+  final Map<String, int> _scheduleIds = {}; // Quick action id -> native schedule
+  final Map<int, QuickAction> _scheduledActions = {};
+  StreamSubscription<ScheduleEvent>? _scheduleSubscription;
+
+  // Terminal throttling: a task gets a budget of characters per display
+  // frame; the rest is left out of xterm, which is then resynced from the
+  // native screen (the log still gets it all)
+  static const _terminalFrameBudget = 16 * 1024;
+  static const _frame = Duration(milliseconds: 16);
+  final Stopwatch _frameClock = Stopwatch();
+  int _frameChars = 0;
+  bool _elided = false; // Output was left out, xterm is stale
+  Timer? _elidedTimer;
 
   // Log buffer to capture terminal output for persistence
   final List<String> _logBuffer = [];
   String _logLineBuffer = ''; // Accumulates partial lines
+  String _errorLineBuffer = ''; // Partial stderr line in pipe mode
   bool _logCaptureStarted = false; // Skip shell init output
 
   // Resource monitoring state (runtime only, not serialized)
@@ -73,8 +139,30 @@ class Task {
       StreamController<ProcessStats>.broadcast();
 
   int? get pid => _pid;
+  /// Windows job holding the process tree (null or 0 without containment)
+  int? get jobHandle => _jobHandle;
   int? get exitCode => _exitCode;
   bool get isRunning => _pid != null && _pty != null;
+  bool get isSuspended => _suspended;
+  bool get isDegraded => _degradedReason != null;
+  String? get degradedReason => _degradedReason;
+
+  /// Completes once the whole process tree is gone (not just the PTY shell)
+  Future<void> get treeExited => _treeExited.future;
+
+  /// Completes with true once the task reports ready, false if it exits first
+  Future<bool> get ready => _ready.future;
+  bool get isReady => _readyAt != null;
+  DateTime? get startedAt => _startedAt;
+  DateTime? get readyAt => _readyAt;
+  Duration? get timeToReady =>
+      _readyAt != null ? _readyAt!.difference(_startedAt!) : null;
+
+  /// Probe failures of a task that was ready (it stopped answering)
+  Stream<ProbeEvent> get readinessLost => _readinessLostController.stream;
+
+  /// Exit code of the task's command, while the shell hosting it lives on
+  Stream<int> get commandExits => _commandExitController.stream;
   TaskStatus get status => isRunning ? TaskStatus.running : TaskStatus.idle;
   List<String> get logBuffer => List.unmodifiable(_logBuffer);
 
@@ -88,6 +176,7 @@ class Task {
 
   // Resource monitoring getters
   Stream<ProcessStats> get statsStream => _statsController.stream;
+  Stream<JobLimitEvent> get limitBreaches => _limitController.stream;
   List<ProcessStats> get statsHistory => List.unmodifiable(_statsHistory);
   ProcessStats? get latestStats =>
       _statsHistory.isNotEmpty ? _statsHistory.last : null;
@@ -103,7 +192,14 @@ class Task {
     this.steps = const [],
     this.quickActions = const [],
     this.envVars = const {},
-  })  : terminal = xterm.Terminal(maxLines: 10000),
+    this.limits = ResourceLimits.none,
+    this.scheduling = SchedulingOptions.none,
+    this.probe,
+    this.restartPolicy = RestartPolicy.none,
+    this.resourceRules = const [],
+    this.launchMode = LaunchMode.auto,
+    this.pipeOutput = false,
+  })  : terminal = TaskTerminal(maxLines: 10000),
         terminalController = xterm.TerminalController() {
     // Wire terminal input to PTY (when PTY is started)
     terminal.onOutput = (data) {
@@ -122,6 +218,13 @@ class Task {
     List<TaskStep>? steps,
     List<QuickAction>? quickActions,
     Map<String, String>? envVars,
+    ResourceLimits? limits,
+    SchedulingOptions? scheduling,
+    ReadinessProbe? probe,
+    RestartPolicy? restartPolicy,
+    List<ResourceRule>? resourceRules,
+    LaunchMode? launchMode,
+    bool? pipeOutput,
   }) {
     return Task(
       id: id ?? this.id,
@@ -134,6 +237,13 @@ class Task {
       steps: steps ?? this.steps,
       quickActions: quickActions ?? this.quickActions,
       envVars: envVars ?? this.envVars,
+      limits: limits ?? this.limits,
+      scheduling: scheduling ?? this.scheduling,
+      probe: probe ?? this.probe,
+      restartPolicy: restartPolicy ?? this.restartPolicy,
+      resourceRules: resourceRules ?? this.resourceRules,
+      launchMode: launchMode ?? this.launchMode,
+      pipeOutput: pipeOutput ?? this.pipeOutput,
     );
   }
 
@@ -150,6 +260,10 @@ class Task {
         'pid': pid,
         'exitCode': exitCode,
         'isRunning': isRunning,
+        'isSuspended': isSuspended,
+        'isReady': isReady,
+        if (_degradedReason != null) 'degraded': _degradedReason,
+        if (timeToReady != null) 'timeToReadyMs': timeToReady!.inMilliseconds,
         'quickActions': quickActions.map((a) => a.toJson()).toList(),
         'hasSteps': hasSteps,
         'currentStepIndex': currentStepIndex,
@@ -174,13 +288,29 @@ class Task {
         .replaceAll('\r', '');
   }
 
-  /// Start the PTY process
-  void start() {
+  /// UTF-8 decoder for one output stream: a character split across two
+  /// chunks is completed with the next one instead of becoming U+FFFD
+  static String Function(Uint8List data) _chunkedDecoder() {
+    final text = StringBuffer();
+    final sink = const Utf8Decoder(allowMalformed: true)
+        .startChunkedConversion(StringConversionSink.fromStringSink(text));
+    return (data) {
+      sink.add(data);
+      final decoded = text.toString();
+      text.clear();
+      return decoded;
+    };
+  }
+
+  /// Start the PTY process. With [shellPoolSize] > 0 the shell may be a
+  /// prewarmed one, and that many are kept warm for the next launch.
+  void start({int shellPoolSize = 0}) {
     if (isRunning) return;
 
     // Clear previous log buffer and reset capture state
     _logBuffer.clear();
     _logLineBuffer = '';
+    _errorLineBuffer = '';
     _logCaptureStarted = false;
 
     // Write launch info to terminal only (not to log - log will have clean header)
@@ -190,6 +320,11 @@ class Task {
 
     terminal.write('\x1b[90m[$timeStr]\x1b[0m Starting: \x1b[36m$name\x1b[0m\r\n');
     terminal.write('\x1b[90m>\x1b[0m \x1b[33m$fullCommand\x1b[0m\r\n');
+    // Show which image PATH resolves to (cached lookup; builtins like `dir` resolve to nothing)
+    final image = NativeBindings.instance.resolveExecutable(LaunchMode.programName(command));
+    if (image != null) {
+      terminal.write('\x1b[90m=\x1b[0m \x1b[90m$image\x1b[0m\r\n');
+    }
     if (workingDirectory != null) {
       terminal.write('\x1b[90m@\x1b[0m \x1b[34m$workingDirectory\x1b[0m\r\n');
     }
@@ -200,87 +335,200 @@ class Task {
     final cols = terminal.viewWidth > 0 ? terminal.viewWidth : 80;
     final rows = terminal.viewHeight > 0 ? terminal.viewHeight : 24;
 
-    // Start shell without command - we'll send it after shell initializes
-    _pty = Pty.start(
+    final environment = {...Platform.environment, ...envVars};
+
+    // Non-interactive tasks can skip the pseudo console, which re-renders
+    // every byte and throttles chatty builds
+    _pty = null;
+    if (pipeOutput) {
+      if (launchMode != LaunchMode.shell &&
+          !LaunchMode.needsShell(command, arguments)) {
+        _pty = TaskPty.pipes(fullCommand,
+            workingDirectory: workingDirectory, environment: environment);
+      }
+      _pty ??= TaskPty.pipes('cmd.exe /d /s /c "$fullCommand"',
+          workingDirectory: workingDirectory,
+          environment: environment,
+          direct: false);
+      if (_pty == null) {
+        terminal.write(
+            '\x1b[33m[Launch] Pipe mode unavailable, using a terminal\x1b[0m\r\n');
+      }
+    }
+
+    // Spawn the command itself when it needs no shell syntax, saving the
+    // cmd.exe process, its echo and its parsing
+    final wantDirect = _pty == null &&
+        (launchMode == LaunchMode.direct ||
+            (launchMode == LaunchMode.auto &&
+                !LaunchMode.needsShell(command, arguments)));
+    if (wantDirect) {
+      // Arguments are stored as typed text, so split the whole line with the
+      // C runtime rules - the argv the command would have got from cmd.exe
+      _pty = TaskPty.exec(
+        fullCommand,
+        const [],
+        workingDirectory: workingDirectory,
+        columns: cols,
+        rows: rows,
+        environment: environment,
+      );
+      if (_pty == null && launchMode == LaunchMode.direct) {
+        terminal.write(
+            '\x1b[33m[Launch] Cannot start directly (not an executable?), using cmd.exe\x1b[0m\r\n');
+      }
+    }
+    _direct = _pty != null;
+
+    // Otherwise start the shell without command - we'll send it once it
+    // shows its prompt
+    _pty ??= TaskPty.start(
       shell,
       workingDirectory: workingDirectory,
       columns: cols,
       rows: rows,
-      environment: {...Platform.environment, ...envVars},
+      environment: environment,
+      poolSize: shellPoolSize,
     );
 
     _pid = _pty!.pid;
+    terminal.attachOutput(_pty!.containerId);
+    _startedAt = DateTime.now();
+    _readyAt = null;
+    _ready = Completer<bool>();
+    _degradedReason = null;
+
+    // Windows Job Object tracking the process tree, so all child processes
+    // are terminated when we kill the task. Native containers start the shell
+    // inside one; otherwise assign the already running shell to a new job.
+    _jobHandle = _pty!.jobHandle != 0
+        ? _pty!.jobHandle
+        : NativeBindings.instance.createJobForProcess(_pid!);
+    _applyLimits();
+    _watchTreeExit();
 
-    // Create a Windows Job Object to track the process tree
-    // This ensures all child processes are terminated when we kill the task
-    _jobHandle = NativeBindings.instance.createJobForProcess(_pid!);
-
-    terminal.write('\x1b[90mPID: $_pid\x1b[0m\r\n\r\n');
+    terminal.write(
+        '\x1b[90mPID: $_pid${!_pty!.isTerminal ? ' (pipes, no terminal)' : _direct ? ' (direct, no shell)' : ''}\x1b[0m\r\n\r\n');
 
-    // Forward PTY output to terminal and log buffer
+    // Forward PTY output to terminal and log buffer. Chunks are views of
+    // the native output ring: decoded once, in the listener, and the
+    // stripped text is shared by the log, steps and probe.
+    final terminalOutput = _pty!.isTerminal;
+    final decodeOutput = _chunkedDecoder();
     _outputSubscription = _pty!.output.listen(
       (data) {
-        final decoded = utf8.decode(data, allowMalformed: true);
-        terminal.write(decoded);
+        final decoded = decodeOutput(data);
+        final shown = terminal.outputText(data, decoded);
+        if (shown != null) {
+          _writeThrottled(terminalOutput ? shown : _toTerminalLines(shown));
+        }
+
+        final matchSteps = hasSteps && !stepsCompleted;
+        final plain = _logCaptureStarted || matchSteps || _outputProbe != null
+            ? _stripAnsi(decoded)
+            : '';
 
         // Only capture to log after command is sent (skip shell init)
         if (_logCaptureStarted) {
-          _appendToLog(_stripAnsi(decoded));
+          _appendToLog(plain);
         }
 
         // Feed output to step executor for pattern matching
-        if (hasSteps && !stepsCompleted) {
-          _processOutputForSteps(_stripAnsi(decoded));
+        if (matchSteps) {
+          _processOutputForSteps(plain);
         }
+
+        // Still printing startup output - not ready yet
+        if (_quietTimer != null) _restartQuietTimer();
+
+        if (_outputProbe != null) _matchOutputProbe(plain);
       },
       onDone: _cleanup,
     );
 
+    // stderr arrives separately in pipe mode: shown in red, tagged in the log
+    if (!terminalOutput) {
+      final decodeErrors = _chunkedDecoder();
+      _errorSubscription = _pty!.errorOutput.listen((data) {
+        final decoded = decodeErrors(data);
+        final shown = terminal.outputText(data, decoded);
+        if (shown != null) {
+          _writeThrottled('\x1b[31m${_toTerminalLines(shown)}\x1b[0m');
+        }
+        if (_logCaptureStarted) _appendErrorToLog(decoded);
+        if (_quietTimer != null) _restartQuietTimer();
+        if (_outputProbe != null) _matchOutputProbe(decoded);
+      });
+    }
+
     // Wire terminal resize to PTY (rows, cols order)
     terminal.onResize = (w, h, pw, ph) {
       _pty?.resize(h, w);
     };
 
     // Listen for exit
-    _pty!.exitCode.then((code) {
+    final pty = _pty!;
+    pty.exitCode.then((code) {
+      // A supervisor restart may already have replaced this PTY
+      if (_pty != null && !identical(_pty, pty)) return;
       _exitCode = code;
       // Flush any remaining buffered content
       if (_logLineBuffer.isNotEmpty) {
         _logBuffer.add(_logLineBuffer);
         _logLineBuffer = '';
       }
+      if (_errorLineBuffer.isNotEmpty) {
+        _logBuffer.add('[stderr] $_errorLineBuffer');
+        _errorLineBuffer = '';
+      }
       _cleanup();
       onExit?.call();
     });
 
-    // Send command after shell initializes
-    Future.delayed(const Duration(milliseconds: 300), () {
-      if (_pty != null) {
-        // Start log capture and add prompt line
-        _logCaptureStarted = true;
-        final promptPath = workingDirectory ?? Directory.current.path;
-        _logBuffer.add('$promptPath> $fullCommand');
+    // A direct command is already running
+    if (_direct) {
+      _onCommandStarted(fullCommand);
+      return;
+    }
 
+    // Send command once the shell is at its prompt (a prewarmed shell already
+    // is); give up waiting if the prompt is never recognised
+    pty.promptReady
+        .timeout(const Duration(seconds: 3), onTimeout: () {})
+        .then((_) {
+      if (identical(_pty, pty)) {
         // Send command with \r\n for Windows cmd.exe
         _pty!.write(Uint8List.fromList(utf8.encode('$fullCommand\r\n')));
+        _commandRunning = true;
+        _onCommandStarted(fullCommand);
+      }
+    });
+  }
 
-        // Start step execution if we have steps
-        if (hasSteps) {
-          _startStepExecution();
-        }
+  /// The command is running: start logging, readiness and automation
+  void _onCommandStarted(String fullCommand) {
+    // Start log capture and add prompt line
+    _logCaptureStarted = true;
+    final promptPath = workingDirectory ?? Directory.current.path;
+    _logBuffer.add('$promptPath> $fullCommand');
+
+    // Start step execution if we have steps; without a probe or steps
+    // the command is ready once its startup output goes quiet
+    if (probe != null && probe!.isValid) _startProbe();
+    if (hasSteps) {
+      _startStepExecution();
+    } else if (!_probeActive) {
+      _restartQuietTimer();
+    }
 
-        // Start scheduled quick actions
-        final scheduled = quickActions.where((a) => a.isScheduled).toList();
-        if (scheduled.isNotEmpty) {
-          for (final action in scheduled) {
-            _startScheduleTimer(action);
-          }
-          terminal.write('\x1b[90m[Schedule] ${scheduled.length} scheduled action(s) active\x1b[0m\r\n');
-        }
+    // Start scheduled quick actions
+    final scheduled = quickActions.where((a) => a.isScheduled).toList();
+    if (scheduled.isNotEmpty) {
+      _startSchedules(scheduled);
+      terminal.write('\x1b[90m[Schedule] ${scheduled.length} scheduled action(s) active\x1b[0m\r\n');
+    }
 
-        // Note: Resource monitoring is handled by the centralized ResourceMonitorExtension
-      }
-    });
+    // Note: Resource monitoring is handled by the centralized ResourceMonitorExtension
   }
 
   /// Start the step execution process
@@ -356,6 +604,7 @@ class Task {
       _stepStatus = StepExecutionStatus.completed;
       terminal.write(
           '\r\n\x1b[32m[Steps] All steps completed. Terminal is now interactive.\x1b[0m\r\n');
+      _markReady();
     } else {
       _stepStatus = StepExecutionStatus.waitingForPattern;
       _startStepTimeout();
@@ -408,6 +657,7 @@ class Task {
       _stepStatus = StepExecutionStatus.completed;
       terminal.write(
           '\r\n\x1b[32m[Steps] All steps completed. Terminal is now interactive.\x1b[0m\r\n');
+      _markReady();
     } else {
       _stepStatus = StepExecutionStatus.waitingForPattern;
       _startStepTimeout();
@@ -416,6 +666,123 @@ class Task {
     onStepProgress?.call();
   }
 
+  // === READINESS ===
+
+  void _restartQuietTimer() {
+    _quietTimer?.cancel();
+    _quietTimer = Timer(_outputQuietPeriod, _markReady);
+  }
+
+  /// Steps and quiet output only count when no probe decides
+  void _markReady({bool fromProbe = false}) {
+    _quietTimer?.cancel();
+    _quietTimer = null;
+    if (_probeActive && !fromProbe) return;
+    if (_ready.isCompleted || _startedAt == null) return;
+    _readyAt = DateTime.now();
+    final via = fromProbe ? ' - ${probe!.description}' : '';
+    terminal.write(
+        '\x1b[90m[Ready in ${(timeToReady!.inMilliseconds / 1000).toStringAsFixed(1)}s$via]\x1b[0m\r\n');
+    _ready.complete(true);
+  }
+
+  void _startProbe() {
+    final p = probe!;
+    _probeHealthy = false;
+    if (p.kind == ProbeKind.output) {
+      try {
+        _outputProbe = RegExp(p.pattern!, caseSensitive: false);
+        _probeActive = true;
+      } catch (e) {
+        terminal.write('\x1b[33m[Probe] Invalid pattern: ${p.pattern}\x1b[0m\r\n');
+      }
+      return;
+    }
+
+    // Relative file probes are relative to the task's directory
+    var path = p.path;
+    if (p.kind == ProbeKind.file && path != null && workingDirectory != null &&
+        !RegExp(r'^([a-zA-Z]:)?[\\/]').hasMatch(path)) {
+      path = '$workingDirectory\\$path';
+    }
+
+    _probeSubscription = NativeBindings.instance.probeEvents
+        .where((e) => e.probeId == _probeId)
+        .listen(_onProbeEvent);
+    _probeId = NativeBindings.instance.startProbe(
+      kind: p.kind.index,
+      host: p.host,
+      port: p.port ?? 0,
+      path: path,
+      expectedStatus: p.expectedStatus ?? 0,
+      interval: Duration(milliseconds: p.intervalMs),
+      timeout: Duration(milliseconds: p.timeoutMs),
+      successThreshold: p.successThreshold,
+      failureThreshold: p.failureThreshold,
+    );
+    if (_probeId == 0) {
+      // Fall back to the steps/quiet output signal
+      _probeSubscription?.cancel();
+      _probeSubscription = null;
+      terminal.write(
+          '\x1b[33m[Probe] Could not start ${p.description}\x1b[0m\r\n');
+      return;
+    }
+    _probeActive = true;
+  }
+
+  void _matchOutputProbe(String text) {
+    _outputProbeBuffer += text;
+    // Patterns can straddle chunks; keep only a recent tail
+    if (_outputProbeBuffer.length > 4096) {
+      _outputProbeBuffer =
+          _outputProbeBuffer.substring(_outputProbeBuffer.length - 4096);
+    }
+    if (_outputProbe!.hasMatch(_outputProbeBuffer)) {
+      _outputProbe = null;
+      _outputProbeBuffer = '';
+      _probeHealthy = true;
+      _markReady(fromProbe: true);
+    }
+  }
+
+  void _onProbeEvent(ProbeEvent event) {
+    if (event.ready) {
+      if (_probeHealthy) return;
+      _probeHealthy = true;
+      if (isReady) {
+        terminal.write('\x1b[32m[Probe] ${probe!.description} is answering again\x1b[0m\r\n');
+        _appendToLog('[Probe] ${probe!.description} is answering again\n');
+      } else {
+        _markReady(fromProbe: true);
+      }
+      return;
+    }
+
+    _probeHealthy = false;
+    final reason = switch (event.failure) {
+      ProbeFailure.timeout => 'timed out',
+      ProbeFailure.refused => 'connection refused',
+      ProbeFailure.badStatus => 'unexpected status',
+      ProbeFailure.missing => 'file missing',
+      null => 'failed',
+    };
+    terminal.write('\r\n\x1b[31m[Probe] ${probe!.description} stopped answering ($reason)\x1b[0m\r\n');
+    _appendToLog('[Probe] ${probe!.description} stopped answering ($reason)\n');
+    _readinessLostController.add(event);
+  }
+
+  void _stopProbe() {
+    NativeBindings.instance.stopProbe(_probeId);
+    _probeId = 0;
+    _probeSubscription?.cancel();
+    _probeSubscription = null;
+    _outputProbe = null;
+    _outputProbeBuffer = '';
+    _probeActive = false;
+    _probeHealthy = false;
+  }
+
   // === RESOURCE MONITORING ===
 
   /// Called by ResourceMonitorExtension to push stats to this task
@@ -433,24 +800,78 @@ class Task {
     _statsHistory.clear();
   }
 
-  /// Append text to log buffer, handling line breaks properly
-  void _appendToLog(String text) {
-    // Add to line buffer
-    _logLineBuffer += text;
+  /// Set by ResourceRulesExtension while a "mark degraded" rule is breached
+  /// (null once it recovers)
+  void setDegraded(String? reason) {
+    _degradedReason = reason;
+  }
 
-    // Process complete lines
-    while (_logLineBuffer.contains('\n')) {
-      final newlineIndex = _logLineBuffer.indexOf('\n');
-      final line = _logLineBuffer.substring(0, newlineIndex);
-      _logLineBuffer = _logLineBuffer.substring(newlineIndex + 1);
+  /// Append text to log buffer, handling line breaks properly. Scans the
+  /// chunk once, so a flood of short lines stays linear.
+  void _appendToLog(String text) {
+    var start = 0;
+    for (var newlineIndex = text.indexOf('\n');
+        newlineIndex >= 0;
+        newlineIndex = text.indexOf('\n', start)) {
+      final line = _logLineBuffer + text.substring(start, newlineIndex);
+      _logLineBuffer = '';
+      start = newlineIndex + 1;
 
       // Add non-empty lines (skip excessive blank lines)
       if (line.trim().isNotEmpty || _logBuffer.isEmpty || _logBuffer.last.trim().isNotEmpty) {
         _logBuffer.add(line);
       }
     }
+    // Keep the partial line
+    _logLineBuffer += text.substring(start);
   }
 
+  /// stderr of a pipe-mode task, logged line by line with a tag
+  void _appendErrorToLog(String text) {
+    _errorLineBuffer += text.replaceAll('\r', '');
+    while (_errorLineBuffer.contains('\n')) {
+      final newlineIndex = _errorLineBuffer.indexOf('\n');
+      _logBuffer.add('[stderr] ${_errorLineBuffer.substring(0, newlineIndex)}');
+      _errorLineBuffer = _errorLineBuffer.substring(newlineIndex + 1);
+    }
+  }
+
+  /// Write process output to the terminal within this task's frame budget.
+  /// Past it, xterm skips the output of the rest of the frame and then
+  /// replays the native screen, so a task printing 100k lines a second
+  /// cannot pin the UI thread. ConPTY output is a stream of screen diffs, so
+  /// skipped output is never papered over: only the snapshot repairs it.
+  void _writeThrottled(String text) {
+    if (!_frameClock.isRunning || _frameClock.elapsed >= _frame) {
+      _frameClock
+        ..reset()
+        ..start();
+      _frameChars = 0;
+    }
+    _frameChars += text.length;
+    if (_frameChars <= _terminalFrameBudget || !terminal.canResync) {
+      // The native screen has already parsed text, so the snapshot shows it
+      if (!_resyncElided()) terminal.writeOutput(text);
+      return;
+    }
+    _elided = true;
+    _elidedTimer ??= Timer(_frame, _resyncElided);
+  }
+
+  /// Replay the native screen into xterm if output was left out of it
+  bool _resyncElided() {
+    _elidedTimer?.cancel();
+    _elidedTimer = null;
+    if (!_elided) return false;
+    _elided = false;
+    terminal.resync();
+    return true;
+  }
+
+  /// Pipe output has bare line feeds; the terminal needs CR LF
+  static String _toTerminalLines(String text) =>
+      text.replaceAll('\r\n', '\n').replaceAll('\n', '\r\n');
+
   /// Send input to the PTY
   void write(String input) {
     _pty?.write(const Utf8Encoder().convert(input));
@@ -469,6 +890,7 @@ class Task {
   /// Graceful stop (send Ctrl+C)
   void stop() {
     if (!isRunning) return;
+    resume(); // A frozen tree cannot handle Ctrl+C
     _pty?.write(Uint8List.fromList([0x03])); // Ctrl+C
   }
 
@@ -476,14 +898,14 @@ class Task {
   void kill() {
     if (!isRunning) return;
 
-    // Kill the entire process tree by PID (walks all descendants)
-    if (_pid != null && _pid != 0) {
-      NativeBindings.instance.killProcessTree(_pid!);
-    }
-
-    // Also terminate the Job Object if available
     if (_jobHandle != null && _jobHandle != 0) {
+      // The job holds the whole tree - terminate it, no process scan needed
       NativeBindings.instance.terminateJob(_jobHandle!);
+      _jobHandle = null; // terminateJob closed it
+    } else if (_pid != null && _pid != 0) {
+      // Kill the entire process tree by PID (walks all descendants); the native
+      // side waits for the processes to die, so keep that off the UI thread
+      NativeBindings.instance.killProcessTreeAsync(_pid!);
     }
 
     // Then kill the PTY process itself as final fallback
@@ -491,8 +913,147 @@ class Task {
     _cleanup();
   }
 
+  /// Staged stop of the whole process tree: Ctrl+C, then Ctrl+Break, then
+  /// terminate, each with its own deadline. Completes with the native
+  /// per-process report once everything is gone (or the last deadline passed).
+  Future<List<ShutdownReportEntry>> shutdown(
+      {ShutdownPolicy policy = const ShutdownPolicy()}) async {
+    if (!isRunning) return const [];
+    resume(); // A frozen tree cannot handle Ctrl+C
+    // The native side needs the job open until it is done, so _cleanup must
+    // not release it meanwhile
+    final pid = _pid!;
+    final job = _jobHandle;
+    _jobHandle = null;
+    final report = await NativeBindings.instance
+        .shutdownTree(pid, jobHandle: job ?? 0, policy: policy);
+    if (isRunning && _pid == pid) {
+      // Release the PTY and terminate the job
+      _jobHandle = job;
+      kill();
+    } else if (job != null) {
+      NativeBindings.instance.releaseJob(job);
+    }
+    return report;
+  }
+
+  /// Freeze the whole process tree so it stops using CPU until [resume].
+  /// Returns false if not running, already suspended or nothing was frozen.
+  bool suspend() {
+    if (!isRunning || _suspended) return false;
+    final count = NativeBindings.instance.suspendTree(_pid!, _jobHandle ?? 0);
+    if (count == 0) return false;
+    _suspended = true;
+    terminal.write('\r\n\x1b[90m[Suspended - $count processes frozen]\x1b[0m\r\n');
+    return true;
+  }
+
+  /// Thaw a tree frozen by [suspend]
+  bool resume() {
+    if (!isRunning || !_suspended) return false;
+    NativeBindings.instance.resumeTree(_pid!, _jobHandle ?? 0);
+    _suspended = false;
+    terminal.write('\x1b[90m[Resumed]\x1b[0m\r\n');
+    return true;
+  }
+
   // === SCHEDULED QUICK ACTIONS ===
 
+  /// Put scheduled actions on the native timer wheel, which writes each fire
+  /// straight to the container's input. A restarted task rebinds the
+  /// schedules it already has, so intervals and one-shots keep their timing.
+  void _startSchedules(List<QuickAction> scheduled) {
+    final native = NativeBindings.instance;
+    final containerId = _pty?.containerId ?? 0;
+    _scheduleSubscription ??= native.scheduleEvents
+        .where((e) => _scheduledActions.containsKey(e.scheduleId))
+        .listen(_onScheduleEvent);
+
+    for (final action in scheduled) {
+      final existing = _scheduleIds[action.id];
+      if (existing != null) {
+        native.bindSchedule(existing, containerId);
+        continue;
+      }
+      final id = _addNativeSchedule(action);
+      if (id == 0) {
+        _startScheduleTimer(action);
+        continue;
+      }
+      _scheduleIds[action.id] = id;
+      _scheduledActions[id] = action;
+      native.bindSchedule(id, containerId);
+    }
+  }
+
+  int _addNativeSchedule(QuickAction action) {
+    final native = NativeBindings.instance;
+    final input = '${action.command}\r\n';
+    final value = action.scheduleValue ?? '';
+    switch (action.scheduleType!) {
+      case ScheduleType.cron:
+        return native.addSchedule(
+          kind: 0,
+          expression: value,
+          utc: action.scheduleUtc,
+          missedFire: action.missedFire.index,
+          input: input,
+        );
+      case ScheduleType.clock:
+        final parts = value.split(':');
+        final hour = int.tryParse(parts[0]) ?? 0;
+        final minute = parts.length > 1 ? (int.tryParse(parts[1]) ?? 0) : 0;
+        return native.addSchedule(
+          kind: 0,
+          expression: '$minute $hour * * *',
+          utc: action.scheduleUtc,
+          missedFire: action.missedFire.index,
+          input: input,
+        );
+      case ScheduleType.interval:
+        final minutes = int.tryParse(value) ?? 1;
+        return native.addSchedule(
+          kind: 1,
+          value: minutes * 60,
+          missedFire: action.missedFire.index,
+          input: input,
+        );
+      case ScheduleType.oneShot:
+        final delay = value.contains(':')
+            ? _delayUntilClockTime(value)
+            : Duration(minutes: int.tryParse(value) ?? 1);
+        return native.addSchedule(
+          kind: 2,
+          value: DateTime.now().add(delay).millisecondsSinceEpoch ~/ 1000,
+          missedFire: action.missedFire.index,
+          input: input,
+        );
+    }
+  }
+
+  void _onScheduleEvent(ScheduleEvent event) {
+    final action = _scheduledActions[event.scheduleId]!;
+    if (action.scheduleType == ScheduleType.oneShot) {
+      _scheduledActions.remove(event.scheduleId); // Dropped natively too
+    }
+    if (!isRunning) return;
+    switch (event.kind) {
+      case ScheduleEventKind.written:
+        _logScheduledFire(action);
+      case ScheduleEventKind.due:
+        _fireScheduledAction(action);
+      case ScheduleEventKind.missed:
+        terminal.write('\x1b[90m[Schedule] Skipped: ${action.name} '
+            '(missed by ${event.late.inMinutes}m)\x1b[0m\r\n');
+    }
+  }
+
+  /// When a scheduled action fires next (native schedules only)
+  DateTime? nextScheduledFire(QuickAction action) {
+    final id = _scheduleIds[action.id];
+    return id != null ? NativeBindings.instance.nextScheduleFire(id) : null;
+  }
+
   void _startScheduleTimer(QuickAction action) {
     switch (action.scheduleType!) {
       case ScheduleType.interval:
@@ -512,15 +1073,22 @@ class Task {
           _fireScheduledAction(action);
         });
         _quickActionTimers.add(timer);
+      case ScheduleType.cron:
+        terminal.write('\x1b[33m[Schedule] ${action.name}: invalid cron expression '
+            '"${action.scheduleValue}" or native scheduler unavailable\x1b[0m\r\n');
     }
   }
 
   void _fireScheduledAction(QuickAction action) {
     if (!isRunning) return;
+    _logScheduledFire(action);
+    write('${action.command}\r\n');
+  }
+
+  void _logScheduledFire(QuickAction action) {
     final now = DateTime.now();
     final ts = '${now.hour.toString().padLeft(2, '0')}:${now.minute.toString().padLeft(2, '0')}';
     terminal.write('\x1b[90m[$ts][Schedule] Firing: ${action.name}\x1b[0m\r\n');
-    write('${action.command}\r\n');
   }
 
   void _scheduleAtClockTime(QuickAction action) {
@@ -552,22 +1120,138 @@ class Task {
       timer.cancel();
     }
     _quickActionTimers.clear();
+    // Native schedules keep running unbound until the task runs again
+    for (final id in _scheduledActions.keys) {
+      NativeBindings.instance.bindSchedule(id, 0);
+    }
+  }
+
+  /// Subscribe to native exit events for this task's process tree
+  void _watchTreeExit() {
+    _treeExited = Completer<void>();
+    _exitWatchId =
+        NativeBindings.instance.watchProcessExit(_pid!, _jobHandle ?? 0);
+    if (_exitWatchId == 0) return; // No watcher - _cleanup completes instead
+
+    final watchId = _exitWatchId;
+    _exitWatchSubscription = NativeBindings.instance.exitEvents
+        .where((e) => e.watchId == watchId && e.kind == ProcessExitKind.tree)
+        .listen((_) => _onTreeExited());
+    _limitSubscription = NativeBindings.instance.limitEvents
+        .where((e) => e.watchId == watchId)
+        .listen(_onLimitBreach);
+    // The first process the shell starts after the command is sent is the command
+    _commandExitSubscription = NativeBindings.instance.exitEvents
+        .where((e) => e.watchId == watchId && e.kind == ProcessExitKind.rootChild)
+        .listen((e) {
+      if (!_commandRunning) return;
+      _commandRunning = false;
+      _commandExitController.add(e.exitCode);
+    });
+  }
+
+  /// Apply the template's resource limits and scheduling to the job
+  /// (the whole tree counts, including processes started later)
+  void _applyLimits() {
+    final job = _jobHandle ?? 0;
+    final reason = job == 0 ? ' (no job)' : '';
+    if (!limits.isEmpty) {
+      final applied = NativeBindings.instance.setJobLimits(
+        job,
+        maxMemoryBytes: limits.maxMemoryMb != null
+            ? limits.maxMemoryMb! * 1024 * 1024
+            : null,
+        cpuRatePercent: limits.cpuRatePercent,
+        maxProcesses: limits.maxProcesses,
+      );
+      if (!applied) {
+        terminal.write(
+            '\x1b[33m[Limit] Resource limits could not be applied$reason\x1b[0m\r\n');
+      }
+    }
+    if (scheduling.affectsProcesses) {
+      final applied = NativeBindings.instance.setJobScheduling(
+        job,
+        priorityClass: scheduling.priority?.nativeClass,
+        affinityMask: scheduling.affinityMask,
+        ioPriority: scheduling.ioPriority?.index,
+      );
+      if (!applied) {
+        terminal.write(
+            '\x1b[33m[Limit] Priority or affinity could not be applied$reason\x1b[0m\r\n');
+      }
+    }
+  }
+
+  void _onLimitBreach(JobLimitEvent event) {
+    _limitController.add(event);
+
+    final now = DateTime.now();
+    final last = _lastLimitNotice[event.kind];
+    if (last != null && now.difference(last) < const Duration(seconds: 5)) {
+      return;
+    }
+    _lastLimitNotice[event.kind] = now;
+
+    final message = switch (event.kind) {
+      JobLimitKind.memory =>
+        'Memory cap of ${limits.maxMemoryMb} MB reached${event.pid != 0 ? ' (PID ${event.pid})' : ''}',
+      JobLimitKind.processCount =>
+        'Process cap of ${limits.maxProcesses} reached, a process was not started',
+    };
+    terminal.write('\r\n\x1b[33m[Limit] $message\x1b[0m\r\n');
+    _appendToLog('[Limit] $message\n');
+  }
+
+  void _onTreeExited() {
+    _exitWatchSubscription?.cancel();
+    _exitWatchSubscription = null;
+    _limitSubscription?.cancel();
+    _limitSubscription = null;
+    _commandExitSubscription?.cancel();
+    _commandExitSubscription = null;
+    _exitWatchId = 0;
+    if (!_treeExited.isCompleted) _treeExited.complete();
   }
 
   void _cleanup() {
+    _resyncElided();
     _stepTimeoutTimer?.cancel();
+    _quietTimer?.cancel();
+    _quietTimer = null;
+    _stopProbe();
+    if (!_ready.isCompleted) _ready.complete(false);
     _cancelQuickActionTimers();
     _outputSubscription?.cancel();
     _outputSubscription = null;
+    _errorSubscription?.cancel();
+    _errorSubscription = null;
     _pty = null;
     _pid = null;
+    // The task owns its job handle; closing it leaves a container's job running
+    if (_jobHandle != null) NativeBindings.instance.releaseJob(_jobHandle!);
     _jobHandle = null;
+    _suspended = false;
+    _commandRunning = false;
+
+    // Without a native watch the PTY going away is the best exit signal we have
+    if (_exitWatchId == 0) _onTreeExited();
   }
 
   /// Dispose resources
   void dispose() {
     kill();
+    NativeBindings.instance.unwatchProcessExit(_exitWatchId);
+    _onTreeExited();
+    for (final id in _scheduleIds.values) {
+      NativeBindings.instance.removeSchedule(id);
+    }
+    _scheduleSubscription?.cancel();
     _statsController.close();
+    _limitController.close();
+    _readinessLostController.close();
+    _commandExitController.close();
+    terminal.dispose();
   }
 
   /// Create a task from a template
@@ -583,6 +1267,13 @@ class Task {
       steps: template.steps,
       quickActions: template.quickActions,
       envVars: template.envVars,
+      limits: template.limits,
+      scheduling: template.scheduling,
+      probe: template.probe,
+      restartPolicy: template.restartPolicy,
+      resourceRules: template.resourceRules,
+      launchMode: template.launchMode,
+      pipeOutput: template.pipeOutput,
     );
   }
 
@@ -622,6 +1313,13 @@ class Task {
       steps: steps,
       quickActions: template.quickActions,
       envVars: envVars,
+      limits: template.limits,
+      scheduling: template.scheduling,
+      probe: template.probe,
+      restartPolicy: template.restartPolicy,
+      resourceRules: template.resourceRules,
+      launchMode: template.launchMode,
+      pipeOutput: template.pipeOutput,
     );
   }
 
@@ -6,12 +6,15 @@ class TaskGroup {
   final String name;
   final List<String> taskIds;
   final String emoji;
+  // Template id -> template ids that must be ready before it starts
+  final Map<String, List<String>> dependsOn;
 
   const TaskGroup({
     required this.id,
     required this.name,
     required this.taskIds,
     this.emoji = '📁',
+    this.dependsOn = const {},
   });
 
   factory TaskGroup.fromJson(Map<String, dynamic> json) {
@@ -20,6 +23,8 @@ class TaskGroup {
       name: json['name'],
       taskIds: List<String>.from(json['taskIds'] ?? []),
       emoji: json['emoji'] ?? '📁',
+      dependsOn: (json['dependsOn'] as Map<String, dynamic>? ?? {}).map(
+          (id, deps) => MapEntry(id, List<String>.from(deps as List))),
     );
   }
 
@@ -28,6 +33,7 @@ class TaskGroup {
     'name': name,
     'taskIds': taskIds,
     'emoji': emoji,
+    if (dependsOn.isNotEmpty) 'dependsOn': dependsOn,
   };
 
   TaskGroup copyWith({
@@ -35,12 +41,45 @@ class TaskGroup {
     String? name,
     List<String>? taskIds,
     String? emoji,
+    Map<String, List<String>>? dependsOn,
   }) {
     return TaskGroup(
       id: id ?? this.id,
       name: name ?? this.name,
       taskIds: taskIds ?? this.taskIds,
       emoji: emoji ?? this.emoji,
+      dependsOn: dependsOn ?? this.dependsOn,
+    );
+  }
+
+  /// Dependencies of a template within this group
+  List<String> dependenciesOf(String templateId) =>
+      (dependsOn[templateId] ?? const [])
+          .where(taskIds.contains)
+          .toList();
+
+  /// True if [templateId] waits, directly or through others, for [otherId]
+  bool dependsTransitively(String templateId, String otherId) {
+    final seen = <String>{};
+    final pending = [templateId];
+    while (pending.isNotEmpty) {
+      for (final dep in dependenciesOf(pending.removeLast())) {
+        if (dep == otherId) return true;
+        if (seen.add(dep)) pending.add(dep);
+      }
+    }
+    return false;
+  }
+
+  /// Copy without [templateId], also dropping it from every dependency list
+  TaskGroup without(String templateId) {
+    return copyWith(
+      taskIds: taskIds.where((id) => id != templateId).toList(),
+      dependsOn: {
+        for (final entry in dependsOn.entries)
+          if (entry.key != templateId)
+            entry.key: entry.value.where((id) => id != templateId).toList(),
+      },
     );
   }
 
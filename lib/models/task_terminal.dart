@@ -0,0 +1,132 @@
+import 'dart:async';
+import 'dart:convert';
+import 'dart:typed_data';
+
+import 'package:xterm/xterm.dart' as xterm;
+
+import '../services/native_bindings.dart';
+
+/// A task's terminal: xterm for the pane that shows it, backed by a native
+/// screen (vt_screen.h) that parses the task's output on the I/O thread.
+///
+/// While no view is attached, task output is only parsed natively. When a
+/// view comes back after output was held back, xterm is cleared and replays
+/// a snapshot of the native screen instead of the whole backlog. A terminal
+/// hidden for [_dropDelay] also drops xterm's buffer, leaving its history to
+/// the native scrollback store (compressed, under one budget for all tasks).
+/// Output of a run without a task container is passed to the native screen
+/// from here. Without the native library xterm gets everything as before.
+class TaskTerminal extends xterm.Terminal {
+  final int _maxLines;
+  final int _screen; // Native screen id, 0 if unavailable
+  bool _native = false; // The current run's output is fed to the screen
+  int _views = 0;
+  bool _withheld = false; // Output skipped while hidden, xterm is stale
+  int _outputReceived = 0; // Task output bytes since attachOutput
+  int _skip = 0; // Upcoming output bytes the last snapshot already showed
+  Timer? _dropTimer;
+
+  static const _dropDelay = Duration(seconds: 30);
+
+  TaskTerminal({int maxLines = 1000})
+      : _maxLines = maxLines,
+        _screen = NativeBindings.instance.createScreen(80, 24, maxLines),
+        super(maxLines: maxLines);
+
+  /// Text from the app itself (launch info, status lines): parsed by both
+  @override
+  void write(String data) {
+    super.write(data);
+    NativeBindings.instance.writeScreen(_screen, data);
+  }
+
+  @override
+  void resize(int newWidth, int newHeight,
+      [int? pixelWidth, int? pixelHeight]) {
+    super.resize(newWidth, newHeight, pixelWidth, pixelHeight);
+    NativeBindings.instance.resizeScreen(_screen, newWidth, newHeight);
+  }
+
+  /// Feed [containerId]'s output to the native screen from now on (0 for a
+  /// PTY without a container)
+  void attachOutput(int containerId) {
+    _outputReceived = 0;
+    _skip = 0;
+    _native = NativeBindings.instance.attachScreen(containerId, _screen);
+  }
+
+  /// The part of task output chunk [data] that xterm still has to parse:
+  /// null while hidden, or when a snapshot already showed it
+  String? outputText(Uint8List data, String decoded) {
+    _outputReceived += data.length;
+    if (_screen == 0) return decoded;
+    if (!_native) NativeBindings.instance.writeScreen(_screen, decoded);
+    if (_views == 0) {
+      _withheld = true;
+      return null;
+    }
+    if (_skip == 0) return decoded;
+    if (data.length <= _skip) {
+      _skip -= data.length;
+      return null;
+    }
+    final rest = Uint8List.sublistView(data, _skip);
+    _skip = 0;
+    return utf8.decode(rest, allowMalformed: true);
+  }
+
+  /// Task output that the native screen already has: xterm only
+  void writeOutput(String text) => super.write(text);
+
+  /// A view started showing this terminal
+  void attachView() {
+    _dropTimer?.cancel();
+    _dropTimer = null;
+    if (_views++ > 0 || !_withheld) return;
+    _replaySnapshot();
+  }
+
+  /// Whether output can be left out of xterm and [resync] repairs it
+  bool get canResync => _screen != 0;
+
+  /// Bring xterm back in line with the native screen after task output was
+  /// left out of it (cursor moves, colours and screen switches included)
+  void resync() {
+    if (_screen == 0) return;
+    if (_views == 0) {
+      _withheld = true; // The next attachView replays
+      return;
+    }
+    _replaySnapshot();
+  }
+
+  void _replaySnapshot() {
+    final snapshot = NativeBindings.instance.screenSnapshot(_screen, _maxLines);
+    if (snapshot == null) return;
+    _withheld = false;
+    // Leave the alternate screen, clear the screen and the scrollback
+    super.write('\x1b[?1049l\x1b[0m\x1b[H\x1b[2J\x1b[3J');
+    super.write(snapshot.text);
+    final ahead = snapshot.outputBytes - _outputReceived;
+    _skip = _native && ahead > 0 ? ahead : 0;
+  }
+
+  void detachView() {
+    if (_views == 0 || --_views > 0 || _screen == 0) return;
+    _dropTimer?.cancel();
+    _dropTimer = Timer(_dropDelay, () {
+      _dropTimer = null;
+      super.write('\x1b[?1049l\x1b[0m\x1b[H\x1b[2J\x1b[3J');
+      _withheld = true;
+    });
+  }
+
+  /// Screen state for a remote viewer that has applied frame [since]
+  ScreenFrame? syncFrame(int since) =>
+      NativeBindings.instance.screenSync(_screen, since);
+
+  void dispose() {
+    _dropTimer?.cancel();
+    NativeBindings.instance.freeScreen(_screen);
+  }
+}
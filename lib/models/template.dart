@@ -1,5 +1,11 @@
 import 'task_step.dart';
 import 'quick_action.dart';
+import 'resource_limits.dart';
+import 'scheduling_options.dart';
+import 'readiness_probe.dart';
+import 'restart_policy.dart';
+import 'resource_rule.dart';
+import 'launch_mode.dart';
 
 /// A template is a saved task configuration that can be launched
 class Template {
@@ -13,6 +19,13 @@ class Template {
   final List<TaskStep> steps; // Automation steps (wait for pattern → send command)
   final List<QuickAction> quickActions; // User-defined quick action commands
   final Map<String, String> envVars; // Per-template environment variables
+  final ResourceLimits limits; // Memory/CPU/process caps for the task's tree
+  final SchedulingOptions scheduling; // Priority, affinity and I/O priority of the tree
+  final ReadinessProbe? probe; // How the task proves it is ready (null = steps/quiet output)
+  final RestartPolicy restartPolicy; // Supervisor restarts after crashes
+  final List<ResourceRule> resourceRules; // Thresholds on sampled memory/CPU
+  final LaunchMode launchMode; // Through cmd.exe or spawned directly
+  final bool pipeOutput; // Non-interactive: plain pipes instead of a terminal
 
   const Template({
     required this.id,
@@ -25,6 +38,13 @@ class Template {
     this.steps = const [],
     this.quickActions = const [],
     this.envVars = const {},
+    this.limits = ResourceLimits.none,
+    this.scheduling = SchedulingOptions.none,
+    this.probe,
+    this.restartPolicy = RestartPolicy.none,
+    this.resourceRules = const [],
+    this.launchMode = LaunchMode.auto,
+    this.pipeOutput = false,
   });
 
   /// Whether this template has automation steps
@@ -65,6 +85,24 @@ class Template {
               .toList() ??
           [],
       envVars: Map<String, String>.from(json['envVars'] ?? {}),
+      limits: json['limits'] != null
+          ? ResourceLimits.fromJson(json['limits'] as Map<String, dynamic>)
+          : ResourceLimits.none,
+      scheduling: json['scheduling'] != null
+          ? SchedulingOptions.fromJson(json['scheduling'] as Map<String, dynamic>)
+          : SchedulingOptions.none,
+      probe: json['readinessProbe'] != null
+          ? ReadinessProbe.fromJson(json['readinessProbe'] as Map<String, dynamic>)
+          : null,
+      restartPolicy: json['restart'] != null
+          ? RestartPolicy.fromJson(json['restart'] as Map<String, dynamic>)
+          : RestartPolicy.none,
+      resourceRules: (json['resourceRules'] as List<dynamic>?)
+              ?.map((r) => ResourceRule.fromJson(r as Map<String, dynamic>))
+              .toList() ??
+          [],
+      launchMode: LaunchMode.fromName(json['launchMode'] as String?),
+      pipeOutput: json['pipeOutput'] as bool? ?? false,
     );
   }
 
@@ -80,6 +118,14 @@ class Template {
         if (quickActions.isNotEmpty)
           'quickActions': quickActions.map((a) => a.toJson()).toList(),
         if (envVars.isNotEmpty) 'envVars': envVars,
+        if (!limits.isEmpty) 'limits': limits.toJson(),
+        if (!scheduling.isEmpty) 'scheduling': scheduling.toJson(),
+        if (probe != null) 'readinessProbe': probe!.toJson(),
+        if (restartPolicy.isEnabled) 'restart': restartPolicy.toJson(),
+        if (resourceRules.isNotEmpty)
+          'resourceRules': resourceRules.map((r) => r.toJson()).toList(),
+        if (launchMode != LaunchMode.auto) 'launchMode': launchMode.name,
+        if (pipeOutput) 'pipeOutput': true,
       };
 
   Template copyWith({
@@ -93,6 +139,13 @@ class Template {
     List<TaskStep>? steps,
     List<QuickAction>? quickActions,
     Map<String, String>? envVars,
+    ResourceLimits? limits,
+    SchedulingOptions? scheduling,
+    ReadinessProbe? probe,
+    RestartPolicy? restartPolicy,
+    List<ResourceRule>? resourceRules,
+    LaunchMode? launchMode,
+    bool? pipeOutput,
   }) {
     return Template(
       id: id ?? this.id,
@@ -105,6 +158,13 @@ class Template {
       steps: steps ?? this.steps,
       quickActions: quickActions ?? this.quickActions,
       envVars: envVars ?? this.envVars,
+      limits: limits ?? this.limits,
+      scheduling: scheduling ?? this.scheduling,
+      probe: probe ?? this.probe,
+      restartPolicy: restartPolicy ?? this.restartPolicy,
+      resourceRules: resourceRules ?? this.resourceRules,
+      launchMode: launchMode ?? this.launchMode,
+      pipeOutput: pipeOutput ?? this.pipeOutput,
     );
   }
 }
@@ -42,6 +42,8 @@ class _QuickActionEditDialogState extends State<QuickActionEditDialog> {
   late String _selectedEmoji;
   ScheduleType? _scheduleType;
   late bool _scheduleEnabled;
+  late bool _scheduleUtc;
+  late MissedFirePolicy _missedFire;
 
   bool get isEditing => widget.action != null;
 
@@ -56,6 +58,8 @@ class _QuickActionEditDialogState extends State<QuickActionEditDialog> {
     _selectedEmoji = a?.emoji ?? '⚡';
     _scheduleType = a?.scheduleType;
     _scheduleEnabled = a?.scheduleEnabled ?? true;
+    _scheduleUtc = a?.scheduleUtc ?? false;
+    _missedFire = a?.missedFire ?? MissedFirePolicy.fireOnce;
   }
 
   @override
@@ -86,6 +90,8 @@ class _QuickActionEditDialogState extends State<QuickActionEditDialog> {
           ? _scheduleValueController.text.trim()
           : null,
       scheduleEnabled: _scheduleEnabled,
+      scheduleUtc: _scheduleUtc,
+      missedFire: _missedFire,
     );
 
     Navigator.pop(context, action);
@@ -99,6 +105,8 @@ class _QuickActionEditDialogState extends State<QuickActionEditDialog> {
         return '30';
       case ScheduleType.oneShot:
         return '15 or 14:30';
+      case ScheduleType.cron:
+        return '*/15 9-17 * * 1-5';
       case null:
         return '';
     }
@@ -303,6 +311,11 @@ class _QuickActionEditDialogState extends State<QuickActionEditDialog> {
                             label: Text('Once', style: TextStyle(fontSize: 12)),
                             icon: Icon(Icons.timer, size: 16),
                           ),
+                          ButtonSegment(
+                            value: ScheduleType.cron,
+                            label: Text('Cron', style: TextStyle(fontSize: 12)),
+                            icon: Icon(Icons.event_repeat, size: 16),
+                          ),
                         ],
                         selected: {_scheduleType!},
                         onSelectionChanged: (s) {
@@ -326,6 +339,10 @@ class _QuickActionEditDialogState extends State<QuickActionEditDialog> {
                               if (v == null || v.trim().isEmpty) {
                                 return 'Required';
                               }
+                              if (_scheduleType == ScheduleType.cron &&
+                                  !QuickAction.isValidCron(v)) {
+                                return 'min hour day month weekday';
+                              }
                               return null;
                             },
                             style: TextStyle(
@@ -357,6 +374,52 @@ class _QuickActionEditDialogState extends State<QuickActionEditDialog> {
                         ),
                       ],
                     ),
+                    const SizedBox(height: 8),
+                    Row(
+                      children: [
+                        if (_scheduleType == ScheduleType.clock ||
+                            _scheduleType == ScheduleType.cron) ...[
+                          Checkbox(
+                            value: _scheduleUtc,
+                            visualDensity: VisualDensity.compact,
+                            onChanged: (v) =>
+                                setState(() => _scheduleUtc = v ?? false),
+                          ),
+                          Text(
+                            'UTC',
+                            style: TextStyle(
+                              fontSize: 12,
+                              color: colors.textSecondary,
+                            ),
+                          ),
+                          const SizedBox(width: 12),
+                        ],
+                        Text(
+                          'If missed:',
+                          style: TextStyle(
+                            fontSize: 12,
+                            color: colors.textSecondary,
+                          ),
+                        ),
+                        const SizedBox(width: 8),
+                        DropdownButton<MissedFirePolicy>(
+                          value: _missedFire,
+                          isDense: true,
+                          underline: const SizedBox.shrink(),
+                          dropdownColor: colors.surface,
+                          style: TextStyle(
+                            fontSize: 12,
+                            color: colors.textPrimary,
+                          ),
+                          onChanged: (p) => setState(() =>
+                              _missedFire = p ?? MissedFirePolicy.fireOnce),
+                          items: [
+                            for (final p in MissedFirePolicy.values)
+                              DropdownMenuItem(value: p, child: Text(p.label)),
+                          ],
+                        ),
+                      ],
+                    ),
                   ],
                   const SizedBox(height: 12),
                   // Help text
@@ -483,12 +483,15 @@ class _ResourcesContentState extends State<ResourcesContent> {
               style: AppTheme.monoSmall.copyWith(color: colors.textSecondary, fontSize: 12 * scale),
             ),
           ),
-          // Children count
+          // Children count (job totals on hover, exited processes included)
           SizedBox(
             width: 80 * scale,
-            child: Text(
-              stats != null ? '${stats.processCount}' : '-',
-              style: AppTheme.monoSmall.copyWith(color: colors.textSecondary, fontSize: 12 * scale),
+            child: _withJobTotals(
+              stats,
+              Text(
+                stats != null ? '${stats.processCount}' : '-',
+                style: AppTheme.monoSmall.copyWith(color: colors.textSecondary, fontSize: 12 * scale),
+              ),
             ),
           ),
           // CPU with sparkline
@@ -702,6 +705,28 @@ class _ResourcesContentState extends State<ResourcesContent> {
       return '${d.inSeconds}s';
     }
   }
+
+  /// Job accounting totals as a tooltip (tasks contained in a job only)
+  Widget _withJobTotals(ProcessStats? stats, Widget child) {
+    if (stats == null || !stats.hasJobAccounting) return child;
+    return Tooltip(
+      message: '${stats.totalProcesses} started in total\n'
+          'CPU time ${_formatDuration(stats.cpuTime)}\n'
+          'Read ${_formatBytes(stats.ioReadBytes)}, '
+          'written ${_formatBytes(stats.ioWriteBytes)}',
+      child: child,
+    );
+  }
+
+  String _formatBytes(int bytes) {
+    if (bytes >= 1024 * 1024 * 1024) {
+      return '${(bytes / (1024 * 1024 * 1024)).toStringAsFixed(1)} GB';
+    } else if (bytes >= 1024 * 1024) {
+      return '${(bytes / (1024 * 1024)).toStringAsFixed(1)} MB';
+    } else {
+      return '${(bytes / 1024).toStringAsFixed(1)} KB';
+    }
+  }
 }
 
 class _SummaryCard extends StatelessWidget {
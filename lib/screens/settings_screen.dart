@@ -269,6 +269,62 @@ class _SettingsScreenState extends State<SettingsScreen> {
                             setState(() {});
                           },
                         ),
+                        const SizedBox(height: 16),
+                        _buildSliderOption(
+                          colors: colors,
+                          label: 'Concurrent Group Launches',
+                          sublabel: 'More start only while CPU and memory have headroom',
+                          value: settings.maxConcurrentLaunches,
+                          min: 1,
+                          max: 20,
+                          onChanged: (v) async {
+                            await core.settings.setMaxConcurrentLaunches(v);
+                            setState(() {});
+                          },
+                        ),
+                        const SizedBox(height: 16),
+                        _buildSliderOption(
+                          colors: colors,
+                          label: 'Suspend Hidden Tasks After (min)',
+                          sublabel: settings.autoSuspendHiddenMinutes == 0
+                              ? 'Off - hidden tasks keep running'
+                              : 'Frozen until their pane is shown again',
+                          value: settings.autoSuspendHiddenMinutes,
+                          min: 0,
+                          max: 120,
+                          onChanged: (v) async {
+                            await core.settings.setAutoSuspendHiddenMinutes(v);
+                            setState(() {});
+                          },
+                        ),
+                        const SizedBox(height: 16),
+                        _buildSliderOption(
+                          colors: colors,
+                          label: 'Prewarmed Shells',
+                          sublabel: settings.shellPoolSize == 0
+                              ? 'Off - every launch starts a fresh shell'
+                              : 'Kept idle per working directory, so relaunches start instantly',
+                          value: settings.shellPoolSize,
+                          min: 0,
+                          max: 4,
+                          onChanged: (v) async {
+                            await core.settings.setShellPoolSize(v);
+                            setState(() {});
+                          },
+                        ),
+                        const SizedBox(height: 16),
+                        _buildSliderOption(
+                          colors: colors,
+                          label: 'Scrollback Memory (MB)',
+                          sublabel: 'Shared by all tasks; older output is compressed, then moved to disk',
+                          value: settings.scrollbackMemoryMb,
+                          min: 16,
+                          max: 512,
+                          onChanged: (v) async {
+                            await core.settings.setScrollbackMemoryMb(v);
+                            setState(() {});
+                          },
+                        ),
                       ],
                     ),
 
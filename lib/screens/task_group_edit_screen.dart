@@ -42,6 +42,7 @@ class _TaskGroupEditScreenState extends State<TaskGroupEditScreen> {
   late final TextEditingController _searchController;
   late String _selectedEmoji;
   late List<String> _selectedTaskIds;
+  late Map<String, List<String>> _dependsOn;
 
   bool get isEditing => widget.group != null;
 
@@ -53,6 +54,10 @@ class _TaskGroupEditScreenState extends State<TaskGroupEditScreen> {
     _searchController = TextEditingController();
     _selectedEmoji = g?.emoji ?? '📁';
     _selectedTaskIds = List<String>.from(g?.taskIds ?? []);
+    _dependsOn = {
+      for (final entry in (g?.dependsOn ?? const <String, List<String>>{}).entries)
+        entry.key: List<String>.from(entry.value),
+    };
   }
 
   @override
@@ -92,7 +97,27 @@ class _TaskGroupEditScreenState extends State<TaskGroupEditScreen> {
   }
 
   void _removeTask(String id) {
-    setState(() => _selectedTaskIds.remove(id));
+    setState(() {
+      final group = _draftGroup.without(id);
+      _selectedTaskIds = group.taskIds;
+      _dependsOn = group.dependsOn;
+    });
+  }
+
+  // Current selection as a group, for dependency checks
+  TaskGroup get _draftGroup => TaskGroup(
+        id: widget.group?.id ?? '',
+        name: _nameController.text.trim(),
+        taskIds: List<String>.from(_selectedTaskIds),
+        dependsOn: _dependsOn,
+      );
+
+  void _toggleDependency(String id, String dependencyId) {
+    setState(() {
+      final deps = _dependsOn.putIfAbsent(id, () => []);
+      if (!deps.remove(dependencyId)) deps.add(dependencyId);
+      if (deps.isEmpty) _dependsOn.remove(id);
+    });
   }
 
   void _reorderTasks(int oldIndex, int newIndex) {
@@ -118,6 +143,7 @@ class _TaskGroupEditScreenState extends State<TaskGroupEditScreen> {
       name: _nameController.text.trim(),
       taskIds: _selectedTaskIds,
       emoji: _selectedEmoji,
+      dependsOn: _dependsOn,
     );
 
     if (isEditing) {
@@ -274,11 +300,18 @@ class _TaskGroupEditScreenState extends State<TaskGroupEditScreen> {
                       itemCount: _selectedTemplates.length,
                       onReorder: _reorderTasks,
                       itemBuilder: (context, index) {
-                        final template = _selectedTemplates[index];
+                        final selected = _selectedTemplates;
+                        final template = selected[index];
+                        final group = _draftGroup;
                         return _SelectedTaskRow(
                           key: ValueKey(template.id),
                           index: index,
                           template: template,
+                          others: selected.where((t) => t.id != template.id).toList(),
+                          dependsOn: group.dependenciesOf(template.id),
+                          // Waiting for a task that already waits for this one would deadlock
+                          canDependOn: (other) => !group.dependsTransitively(other.id, template.id),
+                          onToggleDependency: (other) => _toggleDependency(template.id, other.id),
                           onRemove: () => _removeTask(template.id),
                         );
                       },
@@ -300,7 +333,8 @@ class _TaskGroupEditScreenState extends State<TaskGroupEditScreen> {
                           const SizedBox(width: 8),
                           Expanded(
                             child: Text(
-                              'Tasks will run in this order. Drag to reorder.',
+                              'Tasks will run in this order. Drag to reorder. '
+                              'Use the link button to make a task wait until others are ready.',
                               style: TextStyle(
                                 fontSize: 12,
                                 color: colors.textSecondary,
@@ -431,12 +465,20 @@ class _TaskGroupEditScreenState extends State<TaskGroupEditScreen> {
 class _SelectedTaskRow extends StatelessWidget {
   final int index;
   final Template template;
+  final List<Template> others;
+  final List<String> dependsOn;
+  final bool Function(Template other) canDependOn;
+  final ValueChanged<Template> onToggleDependency;
   final VoidCallback onRemove;
 
   const _SelectedTaskRow({
     super.key,
     required this.index,
     required this.template,
+    required this.others,
+    required this.dependsOn,
+    required this.canDependOn,
+    required this.onToggleDependency,
     required this.onRemove,
   });
 
@@ -476,15 +518,55 @@ class _SelectedTaskRow extends StatelessWidget {
           Text(template.emoji, style: const TextStyle(fontSize: 16)),
           const SizedBox(width: 8),
           Expanded(
-            child: Text(
-              template.name,
-              style: TextStyle(
-                fontSize: 13,
-                color: colors.textPrimary,
-              ),
-              overflow: TextOverflow.ellipsis,
+            child: Column(
+              crossAxisAlignment: CrossAxisAlignment.start,
+              children: [
+                Text(
+                  template.name,
+                  style: TextStyle(
+                    fontSize: 13,
+                    color: colors.textPrimary,
+                  ),
+                  overflow: TextOverflow.ellipsis,
+                ),
+                if (dependsOn.isNotEmpty)
+                  Text(
+                    'waits for ${others.where((t) => dependsOn.contains(t.id)).map((t) => t.name).join(', ')}',
+                    style: TextStyle(
+                      fontSize: 11,
+                      color: colors.textMuted,
+                    ),
+                    overflow: TextOverflow.ellipsis,
+                  ),
+              ],
             ),
           ),
+          if (others.isNotEmpty)
+            PopupMenuButton<Template>(
+              tooltip: 'Waits for',
+              icon: Icon(
+                Icons.link,
+                size: 16,
+                color: dependsOn.isNotEmpty ? AppColors.info : colors.textMuted,
+              ),
+              padding: EdgeInsets.zero,
+              constraints: const BoxConstraints(minWidth: 160),
+              color: colors.surface,
+              onSelected: onToggleDependency,
+              itemBuilder: (context) => [
+                for (final other in others)
+                  CheckedPopupMenuItem<Template>(
+                    value: other,
+                    checked: dependsOn.contains(other.id),
+                    enabled: dependsOn.contains(other.id) || canDependOn(other),
+                    height: 36,
+                    child: Text(
+                      '${other.emoji} ${other.name}',
+                      style: TextStyle(fontSize: 13, color: colors.textPrimary),
+                    ),
+                  ),
+              ],
+            ),
           IconButton(
             icon: const Icon(Icons.close, size: 16),
             onPressed: onRemove,
@@ -2,12 +2,22 @@ import 'package:flutter/material.dart';
 import 'package:flutter/services.dart';
 import 'package:file_picker/file_picker.dart';
 import '../core/core.dart';
+import '../models/launch_mode.dart';
+import '../models/resource_limits.dart';
+import '../models/scheduling_options.dart';
+import '../models/readiness_probe.dart';
+import '../models/restart_policy.dart';
+import '../models/resource_rule.dart';
 import '../models/template.dart';
 import '../models/task_step.dart';
 import '../theme/app_colors.dart';
 import '../theme/app_theme.dart';
 import '../widgets/emoji_picker.dart';
 import '../widgets/env_vars_editor.dart';
+import '../widgets/resource_limits_editor.dart';
+import '../widgets/readiness_probe_editor.dart';
+import '../widgets/restart_policy_editor.dart';
+import '../widgets/resource_rules_editor.dart';
 import '../widgets/steps_editor.dart';
 
 /// Screen for creating or editing a template
@@ -50,6 +60,13 @@ class _TemplateEditScreenState extends State<TemplateEditScreen> {
   late String _selectedEmoji;
   late List<TaskStep> _steps;
   late Map<String, String> _envVars;
+  late ResourceLimits _limits;
+  late SchedulingOptions _scheduling;
+  ReadinessProbe? _probe;
+  late RestartPolicy _restartPolicy;
+  late List<ResourceRule> _resourceRules;
+  late LaunchMode _launchMode;
+  late bool _pipeOutput;
 
   bool get isEditing => widget.template != null;
 
@@ -67,6 +84,13 @@ class _TemplateEditScreenState extends State<TemplateEditScreen> {
     _selectedEmoji = t?.emoji ?? '🚀';
     _steps = List.from(t?.steps ?? []);
     _envVars = Map<String, String>.from(t?.envVars ?? {});
+    _limits = t?.limits ?? ResourceLimits.none;
+    _scheduling = t?.scheduling ?? SchedulingOptions.none;
+    _probe = t?.probe;
+    _restartPolicy = t?.restartPolicy ?? RestartPolicy.none;
+    _resourceRules = t?.resourceRules ?? [];
+    _launchMode = t?.launchMode ?? LaunchMode.auto;
+    _pipeOutput = t?.pipeOutput ?? false;
   }
 
   @override
@@ -125,6 +149,13 @@ class _TemplateEditScreenState extends State<TemplateEditScreen> {
       description: description,
       steps: _steps,
       envVars: _envVars,
+      limits: _limits,
+      scheduling: _scheduling,
+      probe: _probe != null && _probe!.isValid ? _probe : null,
+      restartPolicy: _restartPolicy,
+      resourceRules: _resourceRules,
+      launchMode: _launchMode,
+      pipeOutput: _pipeOutput,
     );
 
     if (isEditing) {
@@ -268,6 +299,9 @@ class _TemplateEditScreenState extends State<TemplateEditScreen> {
                     mono: true,
                   ),
                   const SizedBox(height: 16),
+                  // Launch mode
+                  _buildLaunchMode(colors),
+                  const SizedBox(height: 16),
                   // Working Directory
                   Row(
                     children: [
@@ -312,6 +346,47 @@ class _TemplateEditScreenState extends State<TemplateEditScreen> {
                     initiallyExpanded: _envVars.isNotEmpty,
                   ),
                   const SizedBox(height: 12),
+                  // Resource Limits & Priority
+                  ResourceLimitsEditor(
+                    limits: _limits,
+                    onChanged: (limits) {
+                      setState(() => _limits = limits);
+                    },
+                    scheduling: _scheduling,
+                    onSchedulingChanged: (scheduling) {
+                      setState(() => _scheduling = scheduling);
+                    },
+                    initiallyExpanded:
+                        !_limits.isEmpty || !_scheduling.isEmpty,
+                  ),
+                  const SizedBox(height: 12),
+                  // Readiness Probe
+                  ReadinessProbeEditor(
+                    probe: _probe,
+                    onChanged: (probe) {
+                      setState(() => _probe = probe);
+                    },
+                    initiallyExpanded: _probe != null,
+                  ),
+                  const SizedBox(height: 12),
+                  // Auto Restart
+                  RestartPolicyEditor(
+                    policy: _restartPolicy,
+                    onChanged: (policy) {
+                      setState(() => _restartPolicy = policy);
+                    },
+                    initiallyExpanded: _restartPolicy.isEnabled,
+                  ),
+                  const SizedBox(height: 12),
+                  // Resource Rules
+                  ResourceRulesEditor(
+                    rules: _resourceRules,
+                    onChanged: (rules) {
+                      setState(() => _resourceRules = rules);
+                    },
+                    initiallyExpanded: _resourceRules.isNotEmpty,
+                  ),
+                  const SizedBox(height: 12),
                   // Automation Steps
                   StepsEditor(
                     steps: _steps,
@@ -354,6 +429,73 @@ class _TemplateEditScreenState extends State<TemplateEditScreen> {
     );
   }
 
+  Widget _buildLaunchMode(AppColorScheme colors) {
+    final hint = switch (_launchMode) {
+      LaunchMode.auto =>
+        'Started directly unless it needs cmd.exe (pipes, redirection, %VARS%, builtins, .bat/.cmd)',
+      LaunchMode.shell => 'Typed into cmd.exe, which stays open after the command exits',
+      LaunchMode.direct => 'Started as its own process without cmd.exe; ends when the command exits',
+    };
+
+    return Column(
+      crossAxisAlignment: CrossAxisAlignment.start,
+      children: [
+        DropdownButtonFormField<LaunchMode>(
+          value: _launchMode,
+          onChanged: (m) => setState(() => _launchMode = m ?? LaunchMode.auto),
+          style: TextStyle(fontSize: 13, color: colors.textPrimary),
+          dropdownColor: colors.surface,
+          decoration: InputDecoration(
+            labelText: 'Launch',
+            prefixIcon: Icon(Icons.rocket_launch_outlined,
+                size: 18, color: colors.textMuted),
+            filled: true,
+            fillColor: colors.surfaceLight,
+            border: OutlineInputBorder(
+              borderRadius: BorderRadius.circular(8),
+              borderSide: BorderSide(color: colors.border),
+            ),
+            enabledBorder: OutlineInputBorder(
+              borderRadius: BorderRadius.circular(8),
+              borderSide: BorderSide(color: colors.border),
+            ),
+            contentPadding:
+                const EdgeInsets.symmetric(horizontal: 12, vertical: 14),
+          ),
+          items: [
+            for (final m in LaunchMode.values)
+              DropdownMenuItem<LaunchMode>(value: m, child: Text(m.label)),
+          ],
+        ),
+        const SizedBox(height: 6),
+        Text(
+          hint,
+          style: TextStyle(fontSize: 11, color: colors.textMuted),
+        ),
+        const SizedBox(height: 4),
+        InkWell(
+          onTap: () => setState(() => _pipeOutput = !_pipeOutput),
+          borderRadius: BorderRadius.circular(6),
+          child: Row(
+            children: [
+              Checkbox(
+                value: _pipeOutput,
+                visualDensity: VisualDensity.compact,
+                onChanged: (v) => setState(() => _pipeOutput = v ?? false),
+              ),
+              Expanded(
+                child: Text(
+                  'Non-interactive (no terminal) - much faster output for builds and tests, stderr tagged in logs',
+                  style: TextStyle(fontSize: 12, color: colors.textSecondary),
+                ),
+              ),
+            ],
+          ),
+        ),
+      ],
+    );
+  }
+
   Widget _buildField({
     required AppColorScheme colors,
     required TextEditingController controller,
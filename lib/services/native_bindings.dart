@@ -1,5 +1,10 @@
+import 'dart:async';
+import 'dart:convert';
 import 'dart:ffi';
 import 'dart:io';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
 
 // FFI type definitions
 typedef CreateJobForProcessNative = IntPtr Function(Uint32 processId);
@@ -8,9 +13,741 @@ typedef CreateJobForProcessDart = int Function(int processId);
 typedef TerminateJobNative = Bool Function(IntPtr jobHandle);
 typedef TerminateJobDart = bool Function(int jobHandle);
 
+typedef ReleaseJobNative = Bool Function(IntPtr jobHandle);
+typedef ReleaseJobDart = bool Function(int jobHandle);
+
 typedef KillProcessTreeNative = Bool Function(Uint32 processId);
 typedef KillProcessTreeDart = bool Function(int processId);
 
+typedef ResolveExecutableNative = Int32 Function(
+    Pointer<Utf8> name, Pointer<Utf8> buffer, Int32 maxLength);
+typedef ResolveExecutableDart = int Function(
+    Pointer<Utf8> name, Pointer<Utf8> buffer, int maxLength);
+
+// Async completion API (async_dispatch.h)
+typedef AsyncCompletionNative = Void Function(Int64 requestId, Int64 result);
+
+typedef AsyncSetCompletionCallbackNative = Void Function(
+    Pointer<NativeFunction<AsyncCompletionNative>> callback);
+typedef AsyncSetCompletionCallbackDart = void Function(
+    Pointer<NativeFunction<AsyncCompletionNative>> callback);
+
+typedef AsyncCancelNative = Bool Function(Int64 requestId);
+typedef AsyncCancelDart = bool Function(int requestId);
+
+typedef AsyncDelayNative = Int64 Function(Int32 delayMs);
+typedef AsyncDelayDart = int Function(int delayMs);
+
+typedef ExecuteCommandWithPositioningAsyncNative = Int64 Function(
+    Pointer<Utf8> command,
+    Pointer<Utf8> workingDir,
+    Int32 x,
+    Int32 y,
+    Int32 width,
+    Int32 height,
+    Pointer<Utf8> windowTitleFragment,
+    Int32 timeoutMs);
+typedef ExecuteCommandWithPositioningAsyncDart = int Function(
+    Pointer<Utf8> command,
+    Pointer<Utf8> workingDir,
+    int x,
+    int y,
+    int width,
+    int height,
+    Pointer<Utf8> windowTitleFragment,
+    int timeoutMs);
+
+typedef OpenVscodePositionedAsyncNative = Int64 Function(
+    Pointer<Utf8> directory, Int32 x, Int32 y, Int32 width, Int32 height);
+typedef OpenVscodePositionedAsyncDart = int Function(
+    Pointer<Utf8> directory, int x, int y, int width, int height);
+
+typedef KillProcessTreeAsyncNative = Int64 Function(Uint32 processId);
+typedef KillProcessTreeAsyncDart = int Function(int processId);
+
+typedef ExecuteSshSessionAsyncNative = Int64 Function(
+    Pointer<Utf8> host,
+    Pointer<Utf8> username,
+    Pointer<Utf8> password,
+    Int32 port,
+    Pointer<Utf8> remoteDir,
+    Pointer<Utf8> remoteCommand,
+    Int32 x,
+    Int32 y,
+    Int32 width,
+    Int32 height);
+typedef ExecuteSshSessionAsyncDart = int Function(
+    Pointer<Utf8> host,
+    Pointer<Utf8> username,
+    Pointer<Utf8> password,
+    int port,
+    Pointer<Utf8> remoteDir,
+    Pointer<Utf8> remoteCommand,
+    int x,
+    int y,
+    int width,
+    int height);
+
+// Exit watcher (exit_watcher.h)
+typedef ExitEventNative = Void Function(Int64 watchId, Uint32 processId,
+    Int32 exitCode, Int64 timestampMs, Int32 kind);
+
+typedef ExitWatcherSetCallbackNative = Void Function(
+    Pointer<NativeFunction<ExitEventNative>> callback);
+typedef ExitWatcherSetCallbackDart = void Function(
+    Pointer<NativeFunction<ExitEventNative>> callback);
+
+typedef ExitWatcherWatchNative = Int64 Function(
+    Uint32 processId, IntPtr jobHandle);
+typedef ExitWatcherWatchDart = int Function(int processId, int jobHandle);
+
+typedef ExitWatcherUnwatchNative = Void Function(Int64 watchId);
+typedef ExitWatcherUnwatchDart = void Function(int watchId);
+
+typedef JobLimitNative = Void Function(
+    Int64 watchId, Uint32 processId, Int32 kind);
+
+typedef ExitWatcherSetLimitCallbackNative = Void Function(
+    Pointer<NativeFunction<JobLimitNative>> callback);
+typedef ExitWatcherSetLimitCallbackDart = void Function(
+    Pointer<NativeFunction<JobLimitNative>> callback);
+
+// Job limits (job_control.h)
+typedef JobSetLimitsNative = Bool Function(IntPtr jobHandle,
+    Int64 maxMemoryBytes, Int32 cpuRatePercent, Int32 maxActiveProcesses);
+typedef JobSetLimitsDart = bool Function(int jobHandle, int maxMemoryBytes,
+    int cpuRatePercent, int maxActiveProcesses);
+
+typedef JobSetSchedulingNative = Bool Function(IntPtr jobHandle,
+    Uint32 priorityClass, Uint64 affinityMask, Int32 ioPriority);
+typedef JobSetSchedulingDart = bool Function(
+    int jobHandle, int priorityClass, int affinityMask, int ioPriority);
+
+typedef SuspendTreeNative = Int32 Function(Uint32 processId, IntPtr jobHandle);
+typedef SuspendTreeDart = int Function(int processId, int jobHandle);
+
+// Staged tree shutdown (process_shutdown.h)
+typedef ShutdownTreeAsyncNative = Int64 Function(
+    Uint32 processId,
+    IntPtr jobHandle,
+    Int32 interruptTimeoutMs,
+    Int32 breakTimeoutMs,
+    Int32 terminateTimeoutMs,
+    Pointer<Int32> report,
+    Int32 maxEntries);
+typedef ShutdownTreeAsyncDart = int Function(
+    int processId,
+    int jobHandle,
+    int interruptTimeoutMs,
+    int breakTimeoutMs,
+    int terminateTimeoutMs,
+    Pointer<Int32> report,
+    int maxEntries);
+
+typedef JobProcessIdsNative = Int32 Function(
+    IntPtr jobHandle, Pointer<Uint32> processIds, Int32 maxCount);
+typedef JobProcessIdsDart = int Function(
+    int jobHandle, Pointer<Uint32> processIds, int maxCount);
+
+// Job accounting (job_stats.h) - layouts mirror JobAccounting / JobMemberStats
+final class JobAccountingStruct extends Struct {
+  @Int64()
+  external int userTime100ns;
+  @Int64()
+  external int kernelTime100ns;
+  @Int64()
+  external int readBytes;
+  @Int64()
+  external int writeBytes;
+  @Int64()
+  external int otherBytes;
+  @Int64()
+  external int readOperations;
+  @Int64()
+  external int writeOperations;
+  @Int64()
+  external int commitBytes;
+  @Int64()
+  external int peakCommitBytes;
+  @Int32()
+  external int totalProcesses;
+  @Int32()
+  external int activeProcesses;
+  @Int32()
+  external int terminatedProcesses;
+  @Int32()
+  external int reserved;
+}
+
+final class JobMemberStatsStruct extends Struct {
+  @Uint32()
+  external int processId;
+  @Uint32()
+  external int reserved;
+  @Int64()
+  external int cpuTime100ns;
+  @Int64()
+  external int workingSetBytes;
+  @Array(64)
+  external Array<Uint8> name;
+}
+
+typedef JobAccountingNative = Bool Function(
+    IntPtr jobHandle, Pointer<JobAccountingStruct> out);
+typedef JobAccountingDart = bool Function(
+    int jobHandle, Pointer<JobAccountingStruct> out);
+
+typedef JobMemberStatsNative = Int32 Function(
+    IntPtr jobHandle, Pointer<JobMemberStatsStruct> out, Int32 maxCount);
+typedef JobMemberStatsDart = int Function(
+    int jobHandle, Pointer<JobMemberStatsStruct> out, int maxCount);
+
+// System load (system_load.h) - layout mirrors SystemLoad
+final class SystemLoadStruct extends Struct {
+  @Int32()
+  external int cpuBusyPermille;
+  @Int32()
+  external int processorCount;
+  @Int32()
+  external int runQueueLength;
+  @Int32()
+  external int memoryLoadPercent;
+  @Int64()
+  external int availableBytes;
+  @Int64()
+  external int commitBytes;
+  @Int64()
+  external int commitLimitBytes;
+  @Int32()
+  external int hardFaultsPerSec;
+  @Int32()
+  external int reserved;
+}
+
+typedef SystemLoadNative = Bool Function(Pointer<SystemLoadStruct> out);
+typedef SystemLoadDart = bool Function(Pointer<SystemLoadStruct> out);
+
+// Readiness probes (readiness_probe.h)
+typedef ProbeEventNative = Void Function(Int64 probeId, Int32 kind, Int32 detail);
+
+typedef ProbeSetCallbackNative = Void Function(
+    Pointer<NativeFunction<ProbeEventNative>> callback);
+typedef ProbeSetCallbackDart = void Function(
+    Pointer<NativeFunction<ProbeEventNative>> callback);
+
+typedef ProbeStartNative = Int64 Function(
+    Int32 kind,
+    Pointer<Utf8> host,
+    Int32 port,
+    Pointer<Utf8> path,
+    Int32 expectedStatus,
+    Int32 intervalMs,
+    Int32 timeoutMs,
+    Int32 successThreshold,
+    Int32 failureThreshold);
+typedef ProbeStartDart = int Function(
+    int kind,
+    Pointer<Utf8> host,
+    int port,
+    Pointer<Utf8> path,
+    int expectedStatus,
+    int intervalMs,
+    int timeoutMs,
+    int successThreshold,
+    int failureThreshold);
+
+typedef ProbeStopNative = Void Function(Int64 probeId);
+typedef ProbeStopDart = void Function(int probeId);
+
+// Scheduled fires (schedule_wheel.h)
+typedef ScheduleEventNative = Void Function(
+    Int64 scheduleId, Int32 kind, Int32 lateSeconds);
+
+typedef ScheduleSetCallbackNative = Void Function(
+    Pointer<NativeFunction<ScheduleEventNative>> callback);
+typedef ScheduleSetCallbackDart = void Function(
+    Pointer<NativeFunction<ScheduleEventNative>> callback);
+
+typedef ScheduleAddNative = Int64 Function(Int32 kind, Pointer<Utf8> expression,
+    Int64 value, Bool utc, Int32 missedFire, Pointer<Uint8> input, Int32 length);
+typedef ScheduleAddDart = int Function(int kind, Pointer<Utf8> expression,
+    int value, bool utc, int missedFire, Pointer<Uint8> input, int length);
+
+typedef ScheduleBindNative = Bool Function(Int64 scheduleId, Int32 containerId);
+typedef ScheduleBindDart = bool Function(int scheduleId, int containerId);
+
+typedef ScheduleNextNative = Int64 Function(Int64 scheduleId);
+typedef ScheduleNextDart = int Function(int scheduleId);
+
+typedef ScheduleRemoveNative = Void Function(Int64 scheduleId);
+typedef ScheduleRemoveDart = void Function(int scheduleId);
+
+// Resource rules (resource_rules.h) - layout mirrors RuleTransition
+final class RuleTransitionStruct extends Struct {
+  @Int64()
+  external int ruleId;
+  @Int32()
+  external int breached;
+  @Int32()
+  external int reserved;
+  @Double()
+  external double value;
+}
+
+typedef RulesAddNative = Int64 Function(Int64 subjectId, Int32 metric,
+    Double threshold, Double clearThreshold, Int32 sustainMs);
+typedef RulesAddDart = int Function(int subjectId, int metric,
+    double threshold, double clearThreshold, int sustainMs);
+
+typedef RulesRemoveSubjectNative = Void Function(Int64 subjectId);
+typedef RulesRemoveSubjectDart = void Function(int subjectId);
+
+typedef RulesEvaluateNative = Int32 Function(
+    Int64 subjectId,
+    Int64 timestampMs,
+    Pointer<Double> metrics,
+    Int32 metricCount,
+    Pointer<RuleTransitionStruct> out,
+    Int32 maxCount);
+typedef RulesEvaluateDart = int Function(
+    int subjectId,
+    int timestampMs,
+    Pointer<Double> metrics,
+    int metricCount,
+    Pointer<RuleTransitionStruct> out,
+    int maxCount);
+
+/// Totals of a job since it was created, exited processes included
+class JobAccounting {
+  final Duration cpuTime; // User + kernel
+  final int readBytes;
+  final int writeBytes;
+  final int commitBytes; // 0 if the OS can't tell
+  final int peakCommitBytes;
+  final int totalProcesses;
+  final int activeProcesses;
+
+  const JobAccounting({
+    required this.cpuTime,
+    required this.readBytes,
+    required this.writeBytes,
+    required this.commitBytes,
+    required this.peakCommitBytes,
+    required this.totalProcesses,
+    required this.activeProcesses,
+  });
+}
+
+/// A running job member
+class JobMemberStats {
+  final int pid;
+  final String name;
+  final Duration cpuTime;
+  final int workingSetBytes;
+
+  const JobMemberStats({
+    required this.pid,
+    required this.name,
+    required this.cpuTime,
+    required this.workingSetBytes,
+  });
+}
+
+// Task containers (task_container.h)
+typedef ContainerEventNative = Void Function(
+    Int32 containerId, Pointer<Uint8> data, Int32 length);
+
+typedef TaskContainerSetCallbackNative = Void Function(
+    Pointer<NativeFunction<ContainerEventNative>> callback);
+typedef TaskContainerSetCallbackDart = void Function(
+    Pointer<NativeFunction<ContainerEventNative>> callback);
+
+typedef TaskContainerSpawnNative = Int32 Function(
+    Pointer<Utf8> commandLine,
+    Pointer<Utf8> workingDir,
+    Pointer<Uint16> environment,
+    Int32 cols,
+    Int32 rows);
+typedef TaskContainerSpawnDart = int Function(
+    Pointer<Utf8> commandLine,
+    Pointer<Utf8> workingDir,
+    Pointer<Uint16> environment,
+    int cols,
+    int rows);
+
+typedef TaskContainerExecNative = Int32 Function(
+    Pointer<Utf8> command,
+    Pointer<Pointer<Utf8>> arguments,
+    Int32 argumentCount,
+    Pointer<Utf8> workingDir,
+    Pointer<Uint16> environment,
+    Int32 cols,
+    Int32 rows);
+typedef TaskContainerExecDart = int Function(
+    Pointer<Utf8> command,
+    Pointer<Pointer<Utf8>> arguments,
+    int argumentCount,
+    Pointer<Utf8> workingDir,
+    Pointer<Uint16> environment,
+    int cols,
+    int rows);
+
+typedef TaskContainerSpawnPipesNative = Int32 Function(Pointer<Utf8> commandLine,
+    Pointer<Utf8> workingDir, Pointer<Uint16> environment, Int32 direct);
+typedef TaskContainerSpawnPipesDart = int Function(Pointer<Utf8> commandLine,
+    Pointer<Utf8> workingDir, Pointer<Uint16> environment, int direct);
+
+typedef ContainerPromptNative = Void Function(Int32 containerId);
+
+// I/O reactor (io_reactor.h)
+final class IoRingStruct extends Struct {
+  @Int64()
+  external int head;
+  @Int64()
+  external int tail;
+  external Pointer<Uint8> data;
+  @Int32()
+  external int capacity;
+}
+
+final class IoChunkStruct extends Struct {
+  external Pointer<IoRingStruct> ring;
+  @Int64()
+  external int end;
+  @Int32()
+  external int ownerId;
+  @Int32()
+  external int stream;
+  @Int32()
+  external int last;
+  @Int32()
+  external int reserved;
+}
+
+const int ioStreamError = 1; // IO_STREAM_ERROR: stderr of a pipe-mode task
+
+typedef IoBatchNative = Void Function(
+    Pointer<IoChunkStruct> chunks, Int32 count);
+
+typedef IoReactorSetCallbackNative = Void Function(
+    Pointer<NativeFunction<IoBatchNative>> callback);
+typedef IoReactorSetCallbackDart = void Function(
+    Pointer<NativeFunction<IoBatchNative>> callback);
+
+typedef IoReactorFreeBatchNative = Void Function(
+    Pointer<IoChunkStruct> chunks);
+typedef IoReactorFreeBatchDart = void Function(Pointer<IoChunkStruct> chunks);
+
+typedef IoRingReleaseNative = Void Function(
+    Pointer<IoRingStruct> ring, Int64 tail);
+typedef IoRingReleaseDart = void Function(Pointer<IoRingStruct> ring, int tail);
+
+typedef IoRingFreeNative = Void Function(Pointer<IoRingStruct> ring);
+typedef IoRingFreeDart = void Function(Pointer<IoRingStruct> ring);
+
+typedef TaskContainerSetPromptCallbackNative = Void Function(
+    Pointer<NativeFunction<ContainerPromptNative>> callback);
+typedef TaskContainerSetPromptCallbackDart = void Function(
+    Pointer<NativeFunction<ContainerPromptNative>> callback);
+
+typedef TaskContainerAcquireNative = Int32 Function(
+    Pointer<Utf8> commandLine,
+    Pointer<Utf8> workingDir,
+    Pointer<Uint16> environment,
+    Int32 cols,
+    Int32 rows,
+    Int32 poolSize);
+typedef TaskContainerAcquireDart = int Function(
+    Pointer<Utf8> commandLine,
+    Pointer<Utf8> workingDir,
+    Pointer<Uint16> environment,
+    int cols,
+    int rows,
+    int poolSize);
+
+typedef TaskContainerPoolClearNative = Void Function();
+typedef TaskContainerPoolClearDart = void Function();
+
+typedef TaskContainerPidNative = Int32 Function(Int32 containerId);
+typedef TaskContainerPidDart = int Function(int containerId);
+
+typedef TaskContainerJobNative = IntPtr Function(Int32 containerId);
+typedef TaskContainerJobDart = int Function(int containerId);
+
+typedef TaskContainerWriteNative = Bool Function(
+    Int32 containerId, Pointer<Uint8> data, Int32 length);
+typedef TaskContainerWriteDart = bool Function(
+    int containerId, Pointer<Uint8> data, int length);
+
+typedef TaskContainerResizeNative = Bool Function(
+    Int32 containerId, Int32 cols, Int32 rows);
+typedef TaskContainerResizeDart = bool Function(
+    int containerId, int cols, int rows);
+
+typedef TaskContainerCloseNative = Void Function(Int32 containerId);
+typedef TaskContainerCloseDart = void Function(int containerId);
+
+typedef TaskContainerAttachScreenNative = Bool Function(
+    Int32 containerId, Int32 screenId);
+typedef TaskContainerAttachScreenDart = bool Function(
+    int containerId, int screenId);
+
+typedef TaskContainerFreeOutputNative = Void Function(Pointer<Uint8> data);
+typedef TaskContainerFreeOutputDart = void Function(Pointer<Uint8> data);
+
+// Native terminal screens (vt_screen.h)
+typedef VtScreenCreateNative = Int32 Function(
+    Int32 cols, Int32 rows, Int32 maxLines);
+typedef VtScreenCreateDart = int Function(int cols, int rows, int maxLines);
+
+typedef VtScreenFreeNative = Void Function(Int32 screenId);
+typedef VtScreenFreeDart = void Function(int screenId);
+
+typedef VtScreenWriteNative = Void Function(
+    Int32 screenId, Pointer<Uint8> data, Int32 length);
+typedef VtScreenWriteDart = void Function(
+    int screenId, Pointer<Uint8> data, int length);
+
+typedef VtScreenResizeNative = Void Function(
+    Int32 screenId, Int32 cols, Int32 rows);
+typedef VtScreenResizeDart = void Function(int screenId, int cols, int rows);
+
+typedef VtScreenSnapshotNative = Pointer<Uint8> Function(Int32 screenId,
+    Int32 maxLines, Pointer<Int32> length, Pointer<Int64> outputBytes);
+typedef VtScreenSnapshotDart = Pointer<Uint8> Function(int screenId,
+    int maxLines, Pointer<Int32> length, Pointer<Int64> outputBytes);
+
+// Screen-state sync (vt_screen.h) - layout mirrors VtFrame
+final class VtFrameStruct extends Struct {
+  @Int64()
+  external int frame;
+  @Int32()
+  external int cols;
+  @Int32()
+  external int rows;
+  @Int32()
+  external int full;
+  @Int32()
+  external int rowsSent;
+}
+
+typedef VtScreenSyncNative = Pointer<Uint8> Function(Int32 screenId,
+    Int64 since, Pointer<VtFrameStruct> frame, Pointer<Int32> length);
+typedef VtScreenSyncDart = Pointer<Uint8> Function(int screenId, int since,
+    Pointer<VtFrameStruct> frame, Pointer<Int32> length);
+
+typedef ScrollbackSetBudgetNative = Void Function(Int64 bytes);
+typedef ScrollbackSetBudgetDart = void Function(int bytes);
+
+/// A native screen rendered for a fresh xterm to replay
+class ScreenSnapshot {
+  final String text;
+  final int outputBytes; // Task output it includes since the screen was attached
+
+  const ScreenSnapshot(this.text, this.outputBytes);
+}
+
+/// A VT patch bringing a viewer's terminal from an earlier frame to [frame]
+class ScreenFrame {
+  final int frame;
+  final int cols;
+  final int rows;
+  final bool full; // The patch redraws everything
+  final int rowsSent;
+  final String patch;
+
+  const ScreenFrame({
+    required this.frame,
+    required this.cols,
+    required this.rows,
+    required this.full,
+    required this.rowsSent,
+    required this.patch,
+  });
+}
+
+/// Output (or, with null data, the exit code) of a task container. Output
+/// may be a view of native memory that is only valid during the call.
+typedef ContainerEventHandler = void Function(Uint8List? data, int exitCode);
+
+/// Kind of a native process exit event (mirrors ExitEventKind)
+enum ProcessExitKind {
+  member, // A descendant in the task's job exited
+  root, // The task's root process exited
+  tree, // Nothing of the process tree is left
+  rootChild, // A member started directly by the root exited (a shell's command)
+}
+
+/// A process exit reported by the native exit watcher
+class ProcessExitEvent {
+  final int watchId;
+  final int pid;
+  final int exitCode;
+  final DateTime timestamp;
+  final ProcessExitKind kind;
+
+  const ProcessExitEvent({
+    required this.watchId,
+    required this.pid,
+    required this.exitCode,
+    required this.timestamp,
+    required this.kind,
+  });
+}
+
+/// Machine-wide load signals (averaged since the previous sample)
+class SystemLoad {
+  final double cpuBusy; // 0.0 - 1.0 of all processors
+  final int processorCount;
+  final int? runQueueLength; // Ready threads waiting for a processor
+  final int memoryLoadPercent;
+  final int availableBytes;
+  final int commitBytes;
+  final int commitLimitBytes;
+  final int? hardFaultsPerSec; // Pages read back from disk
+
+  const SystemLoad({
+    required this.cpuBusy,
+    required this.processorCount,
+    required this.runQueueLength,
+    required this.memoryLoadPercent,
+    required this.availableBytes,
+    required this.commitBytes,
+    required this.commitLimitBytes,
+    required this.hardFaultsPerSec,
+  });
+}
+
+/// Why the last attempt of a probe failed (mirrors ProbeFailure)
+enum ProbeFailure {
+  timeout,
+  refused, // Connect failed or the connection closed early
+  badStatus, // HTTP answered with another status
+  missing, // File probe: nothing at the path
+}
+
+/// A readiness transition reported by the native probe thread
+class ProbeEvent {
+  final int probeId;
+  final bool ready;
+  final Duration? latency; // Last attempt, when it became ready
+  final ProbeFailure? failure; // Last failure, when it stopped being ready
+
+  const ProbeEvent({
+    required this.probeId,
+    required this.ready,
+    this.latency,
+    this.failure,
+  });
+}
+
+/// What happened to a scheduled fire (mirrors ScheduleEventKind)
+enum ScheduleEventKind {
+  written, // Input written straight to the task's container
+  due, // No container bound - deliver the input from Dart
+  missed, // Dropped by the skip missed-fire policy
+}
+
+/// A fire of a schedule on the native timer wheel
+class ScheduleEvent {
+  final int scheduleId;
+  final ScheduleEventKind kind;
+  final Duration late; // How far past its due time it was handled
+
+  const ScheduleEvent({
+    required this.scheduleId,
+    required this.kind,
+    required this.late,
+  });
+}
+
+/// A resource rule that was breached or recovered during evaluation
+class RuleTransition {
+  final int ruleId;
+  final bool breached;
+  final double value; // Metric value of the sample that caused it
+
+  const RuleTransition({
+    required this.ruleId,
+    required this.breached,
+    required this.value,
+  });
+}
+
+/// Limit a job ran into (mirrors JobLimitKind)
+enum JobLimitKind {
+  memory, // An allocation failed against the memory cap
+  processCount, // A process could not start against the process cap
+}
+
+/// A limit breach reported by the native exit watcher
+class JobLimitEvent {
+  final int watchId;
+  final int pid; // 0 if not known (process count)
+  final JobLimitKind kind;
+
+  const JobLimitEvent({
+    required this.watchId,
+    required this.pid,
+    required this.kind,
+  });
+}
+
+/// Stage at which a process exited during a staged shutdown (mirrors ShutdownStage)
+enum ShutdownStage {
+  alreadyExited, // Gone before any signal was sent
+  interrupt, // Exited after Ctrl+C
+  breakSignal, // Exited after Ctrl+Break / WM_CLOSE
+  terminate, // Had to be terminated
+  survived, // Still running after the last deadline
+}
+
+/// How long each shutdown stage may take. A zero duration skips the stage.
+class ShutdownPolicy {
+  final Duration interruptTimeout;
+  final Duration breakTimeout;
+  final Duration terminateTimeout;
+
+  const ShutdownPolicy({
+    this.interruptTimeout = const Duration(seconds: 3),
+    this.breakTimeout = const Duration(seconds: 2),
+    this.terminateTimeout = const Duration(seconds: 2),
+  });
+
+  /// Skip the graceful stages
+  static const force = ShutdownPolicy(
+    interruptTimeout: Duration.zero,
+    breakTimeout: Duration.zero,
+  );
+}
+
+/// One process of a shut down tree
+class ShutdownReportEntry {
+  final int pid;
+  final int exitCode; // -1 if unknown or still running
+  final ShutdownStage stage;
+
+  const ShutdownReportEntry({
+    required this.pid,
+    required this.exitCode,
+    required this.stage,
+  });
+}
+
+/// Result posted by native for a cancelled request (ASYNC_RESULT_CANCELLED)
+const int nativeResultCancelled = -1;
+
+/// Handle to a long-running native call executing on the native worker pool
+class NativeOperation {
+  final int id;
+  final Future<int> result;
+
+  NativeOperation._(this.id, this.result);
+
+  /// Ask native to stop waiting. [result] completes with [nativeResultCancelled].
+  void cancel() => NativeBindings.instance._cancel(id);
+}
+
 class NativeBindings {
   static NativeBindings? _instance;
   static NativeBindings get instance => _instance ??= NativeBindings._();
@@ -18,7 +755,89 @@ class NativeBindings {
   late final DynamicLibrary _lib;
   late final CreateJobForProcessDart _createJobForProcess;
   late final TerminateJobDart _terminateJob;
+  late final ReleaseJobDart _releaseJob;
   late final KillProcessTreeDart _killProcessTree;
+  late final ResolveExecutableDart _resolveExecutable;
+  late final AsyncCancelDart _asyncCancel;
+  late final AsyncDelayDart _asyncDelay;
+  late final ExecuteCommandWithPositioningAsyncDart
+      _executeCommandWithPositioningAsync;
+  late final OpenVscodePositionedAsyncDart _openVscodePositionedAsync;
+  late final KillProcessTreeAsyncDart _killProcessTreeAsync;
+  late final ExecuteSshSessionAsyncDart _executeSshSessionAsync;
+  late final ExitWatcherWatchDart _exitWatcherWatch;
+  late final ShutdownTreeAsyncDart _shutdownTreeAsync;
+  late final JobProcessIdsDart _jobProcessIds;
+  late final JobAccountingDart _jobAccounting;
+  late final JobMemberStatsDart _jobMemberStats;
+  late final JobSetLimitsDart _jobSetLimits;
+  late final JobSetSchedulingDart _jobSetScheduling;
+  late final SuspendTreeDart _suspendTree;
+  late final SuspendTreeDart _resumeTree;
+  late final SystemLoadDart _systemLoad;
+  late final ProbeStartDart _probeStart;
+  late final ProbeStopDart _probeStop;
+  late final RulesAddDart _rulesAdd;
+  late final RulesRemoveSubjectDart _rulesRemoveSubject;
+  late final RulesEvaluateDart _rulesEvaluate;
+  late final ScheduleAddDart _scheduleAdd;
+  late final ScheduleBindDart _scheduleBind;
+  late final ScheduleNextDart _scheduleNext;
+  late final ScheduleRemoveDart _scheduleRemove;
+  late final TaskContainerSpawnDart _taskContainerSpawn;
+  late final TaskContainerPidDart _taskContainerPid;
+  late final TaskContainerJobDart _taskContainerJob;
+  late final TaskContainerWriteDart _taskContainerWrite;
+  late final TaskContainerResizeDart _taskContainerResize;
+  late final TaskContainerCloseDart _taskContainerClose;
+  late final TaskContainerAttachScreenDart _taskContainerAttachScreen;
+  late final VtScreenCreateDart _vtScreenCreate;
+  late final VtScreenFreeDart _vtScreenFree;
+  late final VtScreenWriteDart _vtScreenWrite;
+  late final VtScreenResizeDart _vtScreenResize;
+  late final VtScreenSnapshotDart _vtScreenSnapshot;
+  late final VtScreenSyncDart _vtScreenSync;
+  late final ScrollbackSetBudgetDart _scrollbackSetBudget;
+  late final TaskContainerFreeOutputDart _freeOutput;
+  late final TaskContainerAcquireDart _taskContainerAcquire;
+  late final TaskContainerExecDart _taskContainerExec;
+  late final TaskContainerSpawnPipesDart _taskContainerSpawnPipes;
+  // Lets output chunks be handed to Dart without a copy: the typed list
+  // frees the native buffer when it is collected
+  late final Pointer<NativeFinalizerFunction> _freeOutputFinalizer;
+  late final TaskContainerPoolClearDart _taskContainerPoolClear;
+  late final ExitWatcherUnwatchDart _exitWatcherUnwatch;
+
+  // Completion callback shared by every async native call
+  NativeCallable<AsyncCompletionNative>? _completionCallable;
+  final Map<int, Completer<int>> _pending = {};
+
+  NativeCallable<ContainerEventNative>? _containerCallable;
+  final Map<int, ContainerEventHandler> _containerHandlers = {};
+  final Map<int, void Function(Uint8List data)> _errorHandlers = {};
+  NativeCallable<IoBatchNative>? _ioBatchCallable;
+  late final IoReactorFreeBatchDart _ioReactorFreeBatch;
+  late final IoRingReleaseDart _ioRingRelease;
+  late final IoRingFreeDart _ioRingFree;
+  final Map<int, Uint8List> _ringViews = {}; // Ring address -> view of its data
+  NativeCallable<ContainerPromptNative>? _promptCallable;
+  final Map<int, void Function()> _promptHandlers = {};
+
+  NativeCallable<ExitEventNative>? _exitCallable;
+  final StreamController<ProcessExitEvent> _exitEvents =
+      StreamController<ProcessExitEvent>.broadcast();
+
+  NativeCallable<JobLimitNative>? _limitCallable;
+  final StreamController<JobLimitEvent> _limitEvents =
+      StreamController<JobLimitEvent>.broadcast();
+
+  NativeCallable<ProbeEventNative>? _probeCallable;
+  final StreamController<ProbeEvent> _probeEvents =
+      StreamController<ProbeEvent>.broadcast();
+
+  NativeCallable<ScheduleEventNative>? _scheduleCallable;
+  final StreamController<ScheduleEvent> _scheduleEvents =
+      StreamController<ScheduleEvent>.broadcast();
 
   bool _loaded = false;
 
@@ -48,11 +867,207 @@ class NativeBindings {
       _terminateJob =
           _lib.lookupFunction<TerminateJobNative, TerminateJobDart>(
               'terminate_job');
+      _releaseJob =
+          _lib.lookupFunction<ReleaseJobNative, ReleaseJobDart>('release_job');
 
       _killProcessTree =
           _lib.lookupFunction<KillProcessTreeNative, KillProcessTreeDart>(
               'kill_process_tree');
 
+      _resolveExecutable =
+          _lib.lookupFunction<ResolveExecutableNative, ResolveExecutableDart>(
+              'resolve_executable');
+
+      _asyncCancel = _lib
+          .lookupFunction<AsyncCancelNative, AsyncCancelDart>('async_cancel');
+      _asyncDelay =
+          _lib.lookupFunction<AsyncDelayNative, AsyncDelayDart>('async_delay');
+
+      _executeCommandWithPositioningAsync = _lib.lookupFunction<
+              ExecuteCommandWithPositioningAsyncNative,
+              ExecuteCommandWithPositioningAsyncDart>(
+          'execute_command_with_positioning_async');
+
+      _openVscodePositionedAsync = _lib.lookupFunction<
+          OpenVscodePositionedAsyncNative,
+          OpenVscodePositionedAsyncDart>('open_vscode_positioned_async');
+
+      _killProcessTreeAsync = _lib.lookupFunction<KillProcessTreeAsyncNative,
+          KillProcessTreeAsyncDart>('kill_process_tree_async');
+
+      _executeSshSessionAsync = _lib.lookupFunction<
+          ExecuteSshSessionAsyncNative,
+          ExecuteSshSessionAsyncDart>('execute_ssh_session_async');
+
+      // Native worker threads post completions through a listener callable,
+      // which runs _onAsyncComplete on this isolate's event loop
+      _completionCallable =
+          NativeCallable<AsyncCompletionNative>.listener(_onAsyncComplete);
+      _lib
+          .lookupFunction<AsyncSetCompletionCallbackNative,
+                  AsyncSetCompletionCallbackDart>(
+              'async_set_completion_callback')
+          .call(_completionCallable!.nativeFunction);
+
+      _exitWatcherWatch =
+          _lib.lookupFunction<ExitWatcherWatchNative, ExitWatcherWatchDart>(
+              'exit_watcher_watch');
+
+      _exitWatcherUnwatch = _lib.lookupFunction<ExitWatcherUnwatchNative,
+          ExitWatcherUnwatchDart>('exit_watcher_unwatch');
+
+      _shutdownTreeAsync =
+          _lib.lookupFunction<ShutdownTreeAsyncNative, ShutdownTreeAsyncDart>(
+              'shutdown_tree_async');
+
+      _jobProcessIds =
+          _lib.lookupFunction<JobProcessIdsNative, JobProcessIdsDart>(
+              'job_process_ids');
+
+      _jobAccounting =
+          _lib.lookupFunction<JobAccountingNative, JobAccountingDart>(
+              'job_accounting');
+      _jobMemberStats =
+          _lib.lookupFunction<JobMemberStatsNative, JobMemberStatsDart>(
+              'job_member_stats');
+
+      _jobSetLimits =
+          _lib.lookupFunction<JobSetLimitsNative, JobSetLimitsDart>(
+              'job_set_limits');
+      _jobSetScheduling =
+          _lib.lookupFunction<JobSetSchedulingNative, JobSetSchedulingDart>(
+              'job_set_scheduling');
+      _suspendTree = _lib.lookupFunction<SuspendTreeNative, SuspendTreeDart>(
+          'suspend_tree');
+      _resumeTree = _lib.lookupFunction<SuspendTreeNative, SuspendTreeDart>(
+          'resume_tree');
+
+      _systemLoad =
+          _lib.lookupFunction<SystemLoadNative, SystemLoadDart>('system_load');
+
+      _taskContainerSpawn = _lib.lookupFunction<TaskContainerSpawnNative,
+          TaskContainerSpawnDart>('task_container_spawn');
+      _taskContainerPid =
+          _lib.lookupFunction<TaskContainerPidNative, TaskContainerPidDart>(
+              'task_container_pid');
+      _taskContainerJob =
+          _lib.lookupFunction<TaskContainerJobNative, TaskContainerJobDart>(
+              'task_container_job');
+      _taskContainerWrite = _lib.lookupFunction<TaskContainerWriteNative,
+          TaskContainerWriteDart>('task_container_write');
+      _taskContainerResize = _lib.lookupFunction<TaskContainerResizeNative,
+          TaskContainerResizeDart>('task_container_resize');
+      _taskContainerClose = _lib.lookupFunction<TaskContainerCloseNative,
+          TaskContainerCloseDart>('task_container_close_async');
+      _taskContainerAcquire = _lib.lookupFunction<TaskContainerAcquireNative,
+          TaskContainerAcquireDart>('task_container_acquire');
+      _taskContainerExec = _lib.lookupFunction<TaskContainerExecNative,
+          TaskContainerExecDart>('task_container_exec');
+      _taskContainerSpawnPipes = _lib.lookupFunction<
+          TaskContainerSpawnPipesNative,
+          TaskContainerSpawnPipesDart>('task_container_spawn_pipes');
+      _freeOutputFinalizer = _lib.lookup<NativeFinalizerFunction>(
+          'task_container_free_output');
+      _taskContainerPoolClear = _lib.lookupFunction<
+          TaskContainerPoolClearNative,
+          TaskContainerPoolClearDart>('task_container_pool_clear');
+      _taskContainerAttachScreen = _lib.lookupFunction<
+          TaskContainerAttachScreenNative,
+          TaskContainerAttachScreenDart>('task_container_attach_screen');
+      _freeOutput = _lib.lookupFunction<TaskContainerFreeOutputNative,
+          TaskContainerFreeOutputDart>('task_container_free_output');
+
+      _vtScreenCreate = _lib.lookupFunction<VtScreenCreateNative,
+          VtScreenCreateDart>('vt_screen_create');
+      _vtScreenFree =
+          _lib.lookupFunction<VtScreenFreeNative, VtScreenFreeDart>(
+              'vt_screen_free');
+      _vtScreenWrite =
+          _lib.lookupFunction<VtScreenWriteNative, VtScreenWriteDart>(
+              'vt_screen_write');
+      _vtScreenResize =
+          _lib.lookupFunction<VtScreenResizeNative, VtScreenResizeDart>(
+              'vt_screen_resize');
+      _vtScreenSnapshot = _lib.lookupFunction<VtScreenSnapshotNative,
+          VtScreenSnapshotDart>('vt_screen_snapshot');
+      _vtScreenSync = _lib.lookupFunction<VtScreenSyncNative,
+          VtScreenSyncDart>('vt_screen_sync');
+      _scrollbackSetBudget = _lib.lookupFunction<ScrollbackSetBudgetNative,
+          ScrollbackSetBudgetDart>('scrollback_set_budget');
+
+      _containerCallable =
+          NativeCallable<ContainerEventNative>.listener(_onContainerEvent);
+      _lib
+          .lookupFunction<TaskContainerSetCallbackNative,
+              TaskContainerSetCallbackDart>('task_container_set_callback')
+          .call(_containerCallable!.nativeFunction);
+
+      // Container output arrives in per-frame batches from the I/O reactor
+      _ioReactorFreeBatch = _lib.lookupFunction<IoReactorFreeBatchNative,
+          IoReactorFreeBatchDart>('io_reactor_free_batch');
+      _ioRingRelease = _lib.lookupFunction<IoRingReleaseNative,
+          IoRingReleaseDart>('io_ring_release');
+      _ioRingFree =
+          _lib.lookupFunction<IoRingFreeNative, IoRingFreeDart>('io_ring_free');
+      _ioBatchCallable = NativeCallable<IoBatchNative>.listener(_onIoBatch);
+      _lib
+          .lookupFunction<IoReactorSetCallbackNative,
+              IoReactorSetCallbackDart>('io_reactor_set_callback')
+          .call(_ioBatchCallable!.nativeFunction);
+
+      _promptCallable =
+          NativeCallable<ContainerPromptNative>.listener(_onContainerPrompt);
+      _lib
+          .lookupFunction<TaskContainerSetPromptCallbackNative,
+                  TaskContainerSetPromptCallbackDart>(
+              'task_container_set_prompt_callback')
+          .call(_promptCallable!.nativeFunction);
+
+      _exitCallable = NativeCallable<ExitEventNative>.listener(_onExitEvent);
+      _lib
+          .lookupFunction<ExitWatcherSetCallbackNative,
+              ExitWatcherSetCallbackDart>('exit_watcher_set_callback')
+          .call(_exitCallable!.nativeFunction);
+
+      _limitCallable = NativeCallable<JobLimitNative>.listener(_onLimitEvent);
+      _lib
+          .lookupFunction<ExitWatcherSetLimitCallbackNative,
+                  ExitWatcherSetLimitCallbackDart>(
+              'exit_watcher_set_limit_callback')
+          .call(_limitCallable!.nativeFunction);
+
+      _probeStart =
+          _lib.lookupFunction<ProbeStartNative, ProbeStartDart>('probe_start');
+      _probeStop =
+          _lib.lookupFunction<ProbeStopNative, ProbeStopDart>('probe_stop');
+      _probeCallable = NativeCallable<ProbeEventNative>.listener(_onProbeEvent);
+      _lib
+          .lookupFunction<ProbeSetCallbackNative, ProbeSetCallbackDart>(
+              'probe_set_callback')
+          .call(_probeCallable!.nativeFunction);
+
+      _rulesAdd = _lib.lookupFunction<RulesAddNative, RulesAddDart>('rules_add');
+      _rulesRemoveSubject =
+          _lib.lookupFunction<RulesRemoveSubjectNative, RulesRemoveSubjectDart>(
+              'rules_remove_subject');
+      _rulesEvaluate = _lib
+          .lookupFunction<RulesEvaluateNative, RulesEvaluateDart>('rules_evaluate');
+
+      _scheduleAdd = _lib
+          .lookupFunction<ScheduleAddNative, ScheduleAddDart>('schedule_add');
+      _scheduleBind = _lib
+          .lookupFunction<ScheduleBindNative, ScheduleBindDart>('schedule_bind');
+      _scheduleNext = _lib
+          .lookupFunction<ScheduleNextNative, ScheduleNextDart>('schedule_next');
+      _scheduleRemove = _lib.lookupFunction<ScheduleRemoveNative,
+          ScheduleRemoveDart>('schedule_remove');
+      _scheduleCallable =
+          NativeCallable<ScheduleEventNative>.listener(_onScheduleEvent);
+      _lib
+          .lookupFunction<ScheduleSetCallbackNative, ScheduleSetCallbackDart>(
+              'schedule_set_callback')
+          .call(_scheduleCallable!.nativeFunction);
+
       _loaded = true;
     } catch (e) {
       // DLL not available - functions will return safe defaults
@@ -74,6 +1089,13 @@ class NativeBindings {
     return _terminateJob(jobHandle);
   }
 
+  /// Close a job handle without terminating the job (see [terminateJob]).
+  /// The last handle of a [createJobForProcess] job still ends its processes.
+  bool releaseJob(int jobHandle) {
+    if (!_loaded || jobHandle == 0) return false;
+    return _releaseJob(jobHandle);
+  }
+
   /// Kill a process and all its descendants by walking the process tree.
   /// Returns false if DLL not loaded or kill failed.
   bool killProcessTree(int pid) {
@@ -81,6 +1103,827 @@ class NativeBindings {
     return _killProcessTree(pid);
   }
 
+  /// Process ids currently in a job (empty if DLL not loaded or no job).
+  /// Reads the job's own member list - no system-wide process scan.
+  List<int> jobProcessIds(int jobHandle) {
+    if (!_loaded || jobHandle == 0) return const [];
+    const maxCount = 1024;
+    final ids = calloc<Uint32>(maxCount);
+    try {
+      final count = _jobProcessIds(jobHandle, ids, maxCount);
+      return [for (var i = 0; i < count; i++) ids[i]];
+    } finally {
+      calloc.free(ids);
+    }
+  }
+
+  /// CPU, I/O and process totals of a job in one query - processes that
+  /// already exited are included. Null if DLL not loaded or no job.
+  JobAccounting? jobAccounting(int jobHandle) {
+    if (!_loaded || jobHandle == 0) return null;
+    final out = calloc<JobAccountingStruct>();
+    try {
+      if (!_jobAccounting(jobHandle, out)) return null;
+      final a = out.ref;
+      return JobAccounting(
+        // 100 ns units
+        cpuTime: Duration(
+            microseconds: (a.userTime100ns + a.kernelTime100ns) ~/ 10),
+        readBytes: a.readBytes,
+        writeBytes: a.writeBytes,
+        commitBytes: a.commitBytes,
+        peakCommitBytes: a.peakCommitBytes,
+        totalProcesses: a.totalProcesses,
+        activeProcesses: a.activeProcesses,
+      );
+    } finally {
+      calloc.free(out);
+    }
+  }
+
+  /// Stats of the processes currently in a job (empty if unavailable)
+  List<JobMemberStats> jobMemberStats(int jobHandle) {
+    if (!_loaded || jobHandle == 0) return const [];
+    const maxCount = 512;
+    final out = calloc<JobMemberStatsStruct>(maxCount);
+    try {
+      final count = _jobMemberStats(jobHandle, out, maxCount);
+      return [
+        for (var i = 0; i < count; i++)
+          JobMemberStats(
+            pid: out[i].processId,
+            name: _cString(out[i].name, 64),
+            cpuTime: Duration(microseconds: out[i].cpuTime100ns ~/ 10),
+            workingSetBytes: out[i].workingSetBytes,
+          ),
+      ];
+    } finally {
+      calloc.free(out);
+    }
+  }
+
+  String _cString(Array<Uint8> chars, int maxLength) {
+    final bytes = <int>[];
+    for (var i = 0; i < maxLength && chars[i] != 0; i++) {
+      bytes.add(chars[i]);
+    }
+    return String.fromCharCodes(bytes);
+  }
+
+  /// Resolve an executable name through PATH/PATHEXT.
+  /// Returns the absolute path, or null if not found or DLL not loaded.
+  /// Results are cached natively and invalidated when PATH directories change.
+  String? resolveExecutable(String name) {
+    if (!_loaded || name.isEmpty) return null;
+    final namePtr = name.toNativeUtf8();
+    final buffer = calloc<Uint8>(1024).cast<Utf8>();
+    try {
+      final length = _resolveExecutable(namePtr, buffer, 1024);
+      return length > 0 ? buffer.toDartString(length: length) : null;
+    } finally {
+      calloc.free(namePtr);
+      calloc.free(buffer);
+    }
+  }
+
+  // === ASYNC (NON-BLOCKING) CALLS ===
+
+  void _onAsyncComplete(int requestId, int result) {
+    _pending.remove(requestId)?.complete(result);
+  }
+
+  void _cancel(int requestId) {
+    if (_loaded) _asyncCancel(requestId);
+  }
+
+  /// Track a request id returned by an *_async export
+  NativeOperation _track(int requestId) {
+    if (requestId == 0) {
+      return NativeOperation._(0, Future.value(0));
+    }
+    final completer = Completer<int>();
+    _pending[requestId] = completer;
+    return NativeOperation._(requestId, completer.future);
+  }
+
+  /// Timer on the OS thread pool. Completes with 0 once [delay] has passed,
+  /// or [nativeResultCancelled] if cancelled first.
+  NativeOperation delay(Duration delay) {
+    if (!_loaded) {
+      return NativeOperation._(0, Future.delayed(delay, () => 0));
+    }
+    final id = _asyncDelay(delay.inMilliseconds);
+    if (id == 0) return NativeOperation._(0, Future.delayed(delay, () => 0));
+    return _track(id);
+  }
+
+  /// Launch a command and position its window without blocking the UI.
+  /// Completes with the process id (0 on failure).
+  NativeOperation executeCommandWithPositioning(
+    String command, {
+    String? workingDirectory,
+    int x = -1,
+    int y = -1,
+    int width = -1,
+    int height = -1,
+    String? windowTitleFragment,
+    int timeoutMs = 5000,
+  }) {
+    if (!_loaded) return NativeOperation._(0, Future.value(0));
+    final commandPtr = command.toNativeUtf8();
+    final dirPtr = workingDirectory?.toNativeUtf8() ?? nullptr;
+    final fragmentPtr = windowTitleFragment?.toNativeUtf8() ?? nullptr;
+    try {
+      return _track(_executeCommandWithPositioningAsync(commandPtr, dirPtr, x,
+          y, width, height, fragmentPtr, timeoutMs));
+    } finally {
+      calloc.free(commandPtr);
+      if (dirPtr != nullptr) calloc.free(dirPtr);
+      if (fragmentPtr != nullptr) calloc.free(fragmentPtr);
+    }
+  }
+
+  /// Open VS Code in a directory and position its window without blocking.
+  /// Completes with the process id (0 on failure).
+  NativeOperation openVscodePositioned(
+      String directory, int x, int y, int width, int height) {
+    if (!_loaded) return NativeOperation._(0, Future.value(0));
+    final dirPtr = directory.toNativeUtf8();
+    try {
+      return _track(_openVscodePositionedAsync(dirPtr, x, y, width, height));
+    } finally {
+      calloc.free(dirPtr);
+    }
+  }
+
+  /// Kill a process tree on the native worker pool.
+  /// Completes with 1 on success, 0 on failure.
+  NativeOperation killProcessTreeAsync(int pid) {
+    if (!_loaded || pid == 0) return NativeOperation._(0, Future.value(0));
+    return _track(_killProcessTreeAsync(pid));
+  }
+
+  /// Open ssh in a positioned CMD window and type the password, cd and
+  /// command into it, without blocking. Completes with the CMD process id
+  /// (0 on failure).
+  NativeOperation executeSshSession({
+    required String host,
+    required String username,
+    required String password,
+    int port = 22,
+    String? remoteDir,
+    String? remoteCommand,
+    int x = -1,
+    int y = -1,
+    int width = -1,
+    int height = -1,
+  }) {
+    if (!_loaded) return NativeOperation._(0, Future.value(0));
+    final hostPtr = host.toNativeUtf8();
+    final userPtr = username.toNativeUtf8();
+    final passwordPtr = password.toNativeUtf8();
+    final dirPtr = remoteDir?.toNativeUtf8() ?? nullptr;
+    final commandPtr = remoteCommand?.toNativeUtf8() ?? nullptr;
+    try {
+      return _track(_executeSshSessionAsync(hostPtr, userPtr, passwordPtr,
+          port, dirPtr, commandPtr, x, y, width, height));
+    } finally {
+      calloc.free(hostPtr);
+      calloc.free(userPtr);
+      calloc.free(passwordPtr);
+      if (dirPtr != nullptr) calloc.free(dirPtr);
+      if (commandPtr != nullptr) calloc.free(commandPtr);
+    }
+  }
+
+  /// Shut down a process tree in stages (Ctrl+C, Ctrl+Break, terminate),
+  /// waiting on all members at once. Completes with one entry per process.
+  /// [jobHandle] must stay open until the returned future completes.
+  Future<List<ShutdownReportEntry>> shutdownTree(
+    int pid, {
+    int jobHandle = 0,
+    ShutdownPolicy policy = const ShutdownPolicy(),
+  }) async {
+    if (!_loaded || pid == 0) return const [];
+    const maxEntries = 1024;
+    const fields = 3; // ShutdownReportEntry: processId, exitCode, stage
+    final report = calloc<Int32>(maxEntries * fields);
+    try {
+      final count = await _track(_shutdownTreeAsync(
+        pid,
+        jobHandle,
+        policy.interruptTimeout.inMilliseconds,
+        policy.breakTimeout.inMilliseconds,
+        policy.terminateTimeout.inMilliseconds,
+        report,
+        maxEntries,
+      )).result;
+      if (count <= 0) return const [];
+      return [
+        for (var i = 0; i < count && i < maxEntries; i++)
+          ShutdownReportEntry(
+            pid: report[i * fields] & 0xFFFFFFFF,
+            exitCode: report[i * fields + 1],
+            stage: ShutdownStage.values[report[i * fields + 2]],
+          ),
+      ];
+    } finally {
+      calloc.free(report);
+    }
+  }
+
+  // === TASK CONTAINERS ===
+
+  void _onContainerEvent(int containerId, Pointer<Uint8> data, int length) {
+    if (data == nullptr) {
+      _promptHandlers.remove(containerId);
+      _errorHandlers.remove(containerId);
+      _containerHandlers.remove(containerId)?.call(null, length);
+      return;
+    }
+    _containerHandlers[containerId]?.call(_adoptOutput(data, length), 0);
+  }
+
+  /// One reactor batch: the output of every container that printed during
+  /// the last frame, one entry per container and stream.
+  ///
+  /// The bytes are handed to the handlers as views of the native ring, at
+  /// most two per entry (when the data wraps around), and the ring space is
+  /// given back as soon as the handlers return - they must not keep the
+  /// views.
+  void _onIoBatch(Pointer<IoChunkStruct> chunks, int count) {
+    for (var i = 0; i < count; i++) {
+      final chunk = chunks[i];
+      final ring = chunk.ring;
+      final capacity = ring.ref.capacity;
+      final view = _ringViews[ring.address] ??=
+          ring.ref.data.asTypedList(capacity);
+      final error = chunk.stream == ioStreamError;
+      var start = ring.ref.tail;
+      while (start < chunk.end) {
+        final offset = start & (capacity - 1);
+        final contiguous = capacity - offset;
+        final length = chunk.end - start < contiguous
+            ? chunk.end - start
+            : contiguous;
+        final bytes = Uint8List.sublistView(view, offset, offset + length);
+        if (error) {
+          _errorHandlers[chunk.ownerId]?.call(bytes);
+        } else {
+          _containerHandlers[chunk.ownerId]?.call(bytes, 0);
+        }
+        start += length;
+      }
+      _ioRingRelease(ring, chunk.end);
+      if (chunk.last != 0) {
+        _ringViews.remove(ring.address);
+        _ioRingFree(ring);
+      }
+    }
+    _ioReactorFreeBatch(chunks);
+  }
+
+  /// View a native output chunk without copying it; it is freed once the
+  /// list is unreachable
+  Uint8List _adoptOutput(Pointer<Uint8> data, int length) {
+    return data.asTypedList(length,
+        finalizer: _freeOutputFinalizer, token: data.cast());
+  }
+
+  void _onContainerPrompt(int containerId) {
+    _promptHandlers.remove(containerId)?.call();
+  }
+
+  /// Start [commandLine] in a pseudo console inside its own job object.
+  /// The process is created suspended and only resumed once it is in the
+  /// job, so no descendant can escape. [onEvent] receives output, then the
+  /// exit code (with null data) exactly once.
+  ///
+  /// With [poolSize] > 0 an idle prewarmed shell with the same command line,
+  /// directory and environment is taken when there is one, and [poolSize]
+  /// more are kept starting in the background. [onPrompt] runs once, when
+  /// the shell first shows its prompt and is ready for input.
+  /// Returns the container id (0 if unavailable or the job could not be set up).
+  int spawnTaskContainer(
+    String commandLine, {
+    String? workingDirectory,
+    Map<String, String>? environment,
+    int cols = 80,
+    int rows = 24,
+    int poolSize = 0,
+    required ContainerEventHandler onEvent,
+    void Function()? onPrompt,
+  }) {
+    if (!_loaded) return 0;
+    final commandPtr = commandLine.toNativeUtf8();
+    final dirPtr = workingDirectory?.toNativeUtf8() ?? nullptr;
+    final envPtr =
+        environment != null ? _environmentBlock(environment) : nullptr;
+    try {
+      final id = poolSize > 0
+          ? _taskContainerAcquire(
+              commandPtr, dirPtr, envPtr, cols, rows, poolSize)
+          : _taskContainerSpawn(commandPtr, dirPtr, envPtr, cols, rows);
+      if (id != 0) {
+        _containerHandlers[id] = onEvent;
+        if (onPrompt != null) _promptHandlers[id] = onPrompt;
+      }
+      return id;
+    } finally {
+      calloc.free(commandPtr);
+      if (dirPtr != nullptr) calloc.free(dirPtr);
+      if (envPtr != nullptr) calloc.free(envPtr);
+    }
+  }
+
+  /// Start [command] directly in a task container, without cmd.exe.
+  /// [command] is split with the Windows C runtime rules and [arguments]
+  /// are passed verbatim; native code re-quotes the whole argv. Returns 0
+  /// when the executable cannot be resolved or is a batch file (those need
+  /// the shell), or when the library is unavailable.
+  int execTaskContainer(
+    String command,
+    List<String> arguments, {
+    String? workingDirectory,
+    Map<String, String>? environment,
+    int cols = 80,
+    int rows = 24,
+    required ContainerEventHandler onEvent,
+  }) {
+    if (!_loaded) return 0;
+    final commandPtr = command.toNativeUtf8();
+    final argPtrs = calloc<Pointer<Utf8>>(arguments.isEmpty ? 1 : arguments.length);
+    for (var i = 0; i < arguments.length; i++) {
+      argPtrs[i] = arguments[i].toNativeUtf8();
+    }
+    final dirPtr = workingDirectory?.toNativeUtf8() ?? nullptr;
+    final envPtr =
+        environment != null ? _environmentBlock(environment) : nullptr;
+    try {
+      final id = _taskContainerExec(commandPtr, argPtrs, arguments.length,
+          dirPtr, envPtr, cols, rows);
+      if (id != 0) _containerHandlers[id] = onEvent;
+      return id;
+    } finally {
+      calloc.free(commandPtr);
+      for (var i = 0; i < arguments.length; i++) {
+        calloc.free(argPtrs[i]);
+      }
+      calloc.free(argPtrs);
+      if (dirPtr != nullptr) calloc.free(dirPtr);
+      if (envPtr != nullptr) calloc.free(envPtr);
+    }
+  }
+
+  /// Start [commandLine] with plain pipes instead of a pseudo console, for
+  /// tasks that need no terminal. [onEvent] gets stdout and then the exit
+  /// code, [onError] gets stderr. With [direct] the command line is split,
+  /// resolved and re-quoted like [execTaskContainer] (0 if that is not
+  /// possible); otherwise it is run as is.
+  int spawnPipeContainer(
+    String commandLine, {
+    String? workingDirectory,
+    Map<String, String>? environment,
+    bool direct = true,
+    required ContainerEventHandler onEvent,
+    required void Function(Uint8List data) onError,
+  }) {
+    if (!_loaded) return 0;
+    final commandPtr = commandLine.toNativeUtf8();
+    final dirPtr = workingDirectory?.toNativeUtf8() ?? nullptr;
+    final envPtr =
+        environment != null ? _environmentBlock(environment) : nullptr;
+    try {
+      final id = _taskContainerSpawnPipes(
+          commandPtr, dirPtr, envPtr, direct ? 1 : 0);
+      if (id != 0) {
+        _containerHandlers[id] = onEvent;
+        _errorHandlers[id] = onError;
+      }
+      return id;
+    } finally {
+      calloc.free(commandPtr);
+      if (dirPtr != nullptr) calloc.free(dirPtr);
+      if (envPtr != nullptr) calloc.free(envPtr);
+    }
+  }
+
+  /// UTF-16 "KEY=VALUE\0...\0\0" block, sorted as CreateProcess expects
+  Pointer<Uint16> _environmentBlock(Map<String, String> environment) {
+    final keys = environment.keys.toList()
+      ..sort((a, b) => a.toUpperCase().compareTo(b.toUpperCase()));
+    final units = <int>[];
+    for (final key in keys) {
+      units
+        ..addAll('$key=${environment[key]}'.codeUnits)
+        ..add(0);
+    }
+    units.add(0);
+    final block = calloc<Uint16>(units.length);
+    block.asTypedList(units.length).setAll(0, units);
+    return block;
+  }
+
+  /// Close all idle prewarmed shells (e.g. when the pool is switched off)
+  void clearShellPool() {
+    if (!_loaded) return;
+    _taskContainerPoolClear();
+  }
+
+  int taskContainerPid(int containerId) {
+    if (!_loaded || containerId == 0) return 0;
+    return _taskContainerPid(containerId);
+  }
+
+  /// A job handle for the container, owned by the caller (see [terminateJob])
+  int taskContainerJob(int containerId) {
+    if (!_loaded || containerId == 0) return 0;
+    return _taskContainerJob(containerId);
+  }
+
+  bool writeTaskContainer(int containerId, List<int> data) {
+    if (!_loaded || containerId == 0 || data.isEmpty) return false;
+    final buffer = calloc<Uint8>(data.length);
+    try {
+      buffer.asTypedList(data.length).setAll(0, data);
+      return _taskContainerWrite(containerId, buffer, data.length);
+    } finally {
+      calloc.free(buffer);
+    }
+  }
+
+  bool resizeTaskContainer(int containerId, int cols, int rows) {
+    if (!_loaded || containerId == 0) return false;
+    return _taskContainerResize(containerId, cols, rows);
+  }
+
+  /// Kill everything in the container and release it, off the UI thread:
+  /// returns at once. The exit event is still delivered if the process had
+  /// not exited yet, once the container is released.
+  void closeTaskContainer(int containerId) {
+    if (!_loaded || containerId == 0) return;
+    _taskContainerClose(containerId);
+  }
+
+  /// Parse the container's output into native screen [screenId] from now
+  /// on, starting with what it printed so far
+  bool attachScreen(int containerId, int screenId) {
+    if (!_loaded || containerId == 0 || screenId == 0) return false;
+    return _taskContainerAttachScreen(containerId, screenId);
+  }
+
+  // === TERMINAL SCREENS ===
+
+  /// A native VT screen with [maxLines] of scrollback. Returns its id, 0 if
+  /// unavailable.
+  int createScreen(int cols, int rows, int maxLines) {
+    if (!_loaded) return 0;
+    return _vtScreenCreate(cols, rows, maxLines);
+  }
+
+  void freeScreen(int screenId) {
+    if (!_loaded || screenId == 0) return;
+    _vtScreenFree(screenId);
+  }
+
+  /// Parse [text] written by the app itself (not task output)
+  void writeScreen(int screenId, String text) {
+    if (!_loaded || screenId == 0 || text.isEmpty) return;
+    final bytes = utf8.encode(text);
+    final buffer = calloc<Uint8>(bytes.length);
+    try {
+      buffer.asTypedList(bytes.length).setAll(0, bytes);
+      _vtScreenWrite(screenId, buffer, bytes.length);
+    } finally {
+      calloc.free(buffer);
+    }
+  }
+
+  void resizeScreen(int screenId, int cols, int rows) {
+    if (!_loaded || screenId == 0) return;
+    _vtScreenResize(screenId, cols, rows);
+  }
+
+  /// The last [maxLines] of scrollback plus the screen, as text for xterm
+  ScreenSnapshot? screenSnapshot(int screenId, int maxLines) {
+    if (!_loaded || screenId == 0) return null;
+    final length = calloc<Int32>();
+    final outputBytes = calloc<Int64>();
+    try {
+      final data = _vtScreenSnapshot(screenId, maxLines, length, outputBytes);
+      if (data == nullptr) return null;
+      final text =
+          utf8.decode(data.asTypedList(length.value), allowMalformed: true);
+      _freeOutput(data);
+      return ScreenSnapshot(text, outputBytes.value);
+    } finally {
+      calloc.free(length);
+      calloc.free(outputBytes);
+    }
+  }
+
+  /// What changed on the screen since frame [since] (0 for everything), for a
+  /// remote viewer
+  ScreenFrame? screenSync(int screenId, int since) {
+    if (!_loaded || screenId == 0) return null;
+    final frame = calloc<VtFrameStruct>();
+    final length = calloc<Int32>();
+    try {
+      final data = _vtScreenSync(screenId, since, frame, length);
+      if (data == nullptr) return null;
+      final patch =
+          utf8.decode(data.asTypedList(length.value), allowMalformed: true);
+      _freeOutput(data);
+      return ScreenFrame(
+        frame: frame.ref.frame,
+        cols: frame.ref.cols,
+        rows: frame.ref.rows,
+        full: frame.ref.full != 0,
+        rowsSent: frame.ref.rowsSent,
+        patch: patch,
+      );
+    } finally {
+      calloc.free(frame);
+      calloc.free(length);
+    }
+  }
+
+  /// Memory all screens' scrollback may keep; older blocks spill to disk past it
+  void setScrollbackBudget(int bytes) {
+    if (!_loaded) return;
+    _scrollbackSetBudget(bytes);
+  }
+
+  // === EXIT WATCHER ===
+
+  void _onExitEvent(
+      int watchId, int processId, int exitCode, int timestampMs, int kind) {
+    _exitEvents.add(ProcessExitEvent(
+      watchId: watchId,
+      pid: processId,
+      exitCode: exitCode,
+      timestamp: DateTime.fromMillisecondsSinceEpoch(timestampMs),
+      kind: ProcessExitKind.values[kind],
+    ));
+  }
+
+  /// Exit events for every watched process tree
+  Stream<ProcessExitEvent> get exitEvents => _exitEvents.stream;
+
+  /// Watch a root process and its job members for exit.
+  /// Returns a watch id (0 if unavailable). The watch ends after the
+  /// [ProcessExitKind.tree] event.
+  int watchProcessExit(int pid, int jobHandle) {
+    if (!_loaded || pid == 0) return 0;
+    return _exitWatcherWatch(pid, jobHandle);
+  }
+
+  /// Stop watching a process tree.
+  void unwatchProcessExit(int watchId) {
+    if (!_loaded || watchId == 0) return;
+    _exitWatcherUnwatch(watchId);
+  }
+
+  void _onLimitEvent(int watchId, int processId, int kind) {
+    _limitEvents.add(JobLimitEvent(
+      watchId: watchId,
+      pid: processId,
+      kind: JobLimitKind.values[kind],
+    ));
+  }
+
+  /// Limit breaches of watched jobs (see [setJobLimits])
+  Stream<JobLimitEvent> get limitEvents => _limitEvents.stream;
+
+  // === JOB LIMITS ===
+
+  /// Apply memory, CPU rate and process count caps to a whole job.
+  /// Null clears a limit. Returns false if DLL not loaded, no job, or a
+  /// limit was rejected.
+  bool setJobLimits(int jobHandle,
+      {int? maxMemoryBytes, int? cpuRatePercent, int? maxProcesses}) {
+    if (!_loaded || jobHandle == 0) return false;
+    return _jobSetLimits(
+        jobHandle, maxMemoryBytes ?? 0, cpuRatePercent ?? 0, maxProcesses ?? 0);
+  }
+
+  /// Set the priority class, affinity mask and I/O priority (0 very low,
+  /// 1 low, 2 normal) of every process in a job; the first two also bind
+  /// processes started later. Null leaves a setting at its default.
+  /// Returns false if DLL not loaded, no job, or a setting was rejected.
+  bool setJobScheduling(int jobHandle,
+      {int? priorityClass, int? affinityMask, int? ioPriority}) {
+    if (!_loaded || jobHandle == 0) return false;
+    return _jobSetScheduling(
+        jobHandle, priorityClass ?? 0, affinityMask ?? 0, ioPriority ?? -1);
+  }
+
+  /// Freeze every process of a tree (job members, or descendants of [pid]
+  /// without a job). Returns the number of processes suspended (0 if DLL
+  /// not loaded). Each call must be matched by one [resumeTree].
+  int suspendTree(int pid, int jobHandle) {
+    if (!_loaded || (pid == 0 && jobHandle == 0)) return 0;
+    return _suspendTree(pid, jobHandle);
+  }
+
+  /// Thaw a tree frozen by [suspendTree]. Returns the number resumed.
+  int resumeTree(int pid, int jobHandle) {
+    if (!_loaded || (pid == 0 && jobHandle == 0)) return 0;
+    return _resumeTree(pid, jobHandle);
+  }
+
+  // === SYSTEM LOAD ===
+
+  /// Sample CPU, run queue and memory pressure. CPU and fault rate are
+  /// averaged since the previous call. Null if DLL not loaded.
+  SystemLoad? systemLoad() {
+    if (!_loaded) return null;
+    final out = calloc<SystemLoadStruct>();
+    try {
+      if (!_systemLoad(out)) return null;
+      final l = out.ref;
+      return SystemLoad(
+        cpuBusy: l.cpuBusyPermille / 1000,
+        processorCount: l.processorCount,
+        runQueueLength: l.runQueueLength >= 0 ? l.runQueueLength : null,
+        memoryLoadPercent: l.memoryLoadPercent,
+        availableBytes: l.availableBytes,
+        commitBytes: l.commitBytes,
+        commitLimitBytes: l.commitLimitBytes,
+        hardFaultsPerSec: l.hardFaultsPerSec >= 0 ? l.hardFaultsPerSec : null,
+      );
+    } finally {
+      calloc.free(out);
+    }
+  }
+
+  // === READINESS PROBES ===
+
+  void _onProbeEvent(int probeId, int kind, int detail) {
+    final ready = kind == 0;
+    _probeEvents.add(ProbeEvent(
+      probeId: probeId,
+      ready: ready,
+      latency: ready ? Duration(milliseconds: detail) : null,
+      failure: ready ? null : ProbeFailure.values[detail],
+    ));
+  }
+
+  /// Ready/not-ready transitions of every running probe
+  Stream<ProbeEvent> get probeEvents => _probeEvents.stream;
+
+  /// Start a network or file probe ([kind]: 0 TCP, 1 HTTP, 2 file) on the
+  /// shared native probe thread. [host] must be an IP literal or localhost.
+  /// Returns a probe id (0 if DLL not loaded or the arguments are invalid).
+  int startProbe({
+    required int kind,
+    String? host,
+    int port = 0,
+    String? path,
+    int expectedStatus = 0,
+    required Duration interval,
+    required Duration timeout,
+    int successThreshold = 1,
+    int failureThreshold = 3,
+  }) {
+    if (!_loaded) return 0;
+    final hostPtr = host?.toNativeUtf8() ?? nullptr;
+    final pathPtr = path?.toNativeUtf8() ?? nullptr;
+    try {
+      return _probeStart(
+        kind,
+        hostPtr,
+        port,
+        pathPtr,
+        expectedStatus,
+        interval.inMilliseconds,
+        timeout.inMilliseconds,
+        successThreshold,
+        failureThreshold,
+      );
+    } finally {
+      if (hostPtr != nullptr) calloc.free(hostPtr);
+      if (pathPtr != nullptr) calloc.free(pathPtr);
+    }
+  }
+
+  /// Stop a probe started with [startProbe].
+  void stopProbe(int probeId) {
+    if (!_loaded || probeId == 0) return;
+    _probeStop(probeId);
+  }
+
+  // === SCHEDULES ===
+
+  void _onScheduleEvent(int scheduleId, int kind, int lateSeconds) {
+    _scheduleEvents.add(ScheduleEvent(
+      scheduleId: scheduleId,
+      kind: ScheduleEventKind.values[kind],
+      late: Duration(seconds: lateSeconds),
+    ));
+  }
+
+  /// Fires of every schedule on the timer wheel
+  Stream<ScheduleEvent> get scheduleEvents => _scheduleEvents.stream;
+
+  /// Add a schedule to the shared native timer wheel ([kind]: 0 cron
+  /// [expression], 1 every [value] seconds, 2 once at Unix time [value]).
+  /// [input] is written to the bound container on each fire. Returns a
+  /// schedule id (0 if DLL not loaded or the expression is invalid).
+  int addSchedule({
+    required int kind,
+    String? expression,
+    int value = 0,
+    bool utc = false,
+    int missedFire = 1,
+    required String input,
+  }) {
+    if (!_loaded) return 0;
+    final expressionPtr = expression?.toNativeUtf8() ?? nullptr;
+    final bytes = utf8.encode(input);
+    final inputPtr = calloc<Uint8>(bytes.isEmpty ? 1 : bytes.length);
+    try {
+      inputPtr.asTypedList(bytes.length).setAll(0, bytes);
+      return _scheduleAdd(kind, expressionPtr, value, utc, missedFire,
+          inputPtr, bytes.length);
+    } finally {
+      if (expressionPtr != nullptr) calloc.free(expressionPtr);
+      calloc.free(inputPtr);
+    }
+  }
+
+  /// Route a schedule's fires to a task container (0 = post them only).
+  bool bindSchedule(int scheduleId, int containerId) {
+    if (!_loaded || scheduleId == 0) return false;
+    return _scheduleBind(scheduleId, containerId);
+  }
+
+  /// When a schedule fires next (null if unknown or DLL not loaded).
+  DateTime? nextScheduleFire(int scheduleId) {
+    if (!_loaded || scheduleId == 0) return null;
+    final seconds = _scheduleNext(scheduleId);
+    return seconds > 0
+        ? DateTime.fromMillisecondsSinceEpoch(seconds * 1000)
+        : null;
+  }
+
+  /// Drop a schedule added with [addSchedule].
+  void removeSchedule(int scheduleId) {
+    if (!_loaded || scheduleId == 0) return;
+    _scheduleRemove(scheduleId);
+  }
+
+  // === RESOURCE RULES ===
+
+  /// Add a threshold rule with hysteresis for [subjectId] ([metric] indexes
+  /// the values passed to [evaluateRules]). Returns a rule id, 0 if DLL not
+  /// loaded or the arguments are invalid.
+  int addRule({
+    required int subjectId,
+    required int metric,
+    required double threshold,
+    required double clearThreshold,
+    required Duration sustain,
+  }) {
+    if (!_loaded) return 0;
+    return _rulesAdd(
+        subjectId, metric, threshold, clearThreshold, sustain.inMilliseconds);
+  }
+
+  /// Drop every rule of [subjectId].
+  void removeRules(int subjectId) {
+    if (!_loaded) return;
+    _rulesRemoveSubject(subjectId);
+  }
+
+  /// Feed one sample of [subjectId]'s metrics through its rules. Returns the
+  /// rules that became breached or recovered (empty if DLL not loaded).
+  List<RuleTransition> evaluateRules(
+      int subjectId, DateTime timestamp, List<double> metrics) {
+    if (!_loaded || metrics.isEmpty) return const [];
+    const maxCount = 64;
+    final values = calloc<Double>(metrics.length);
+    final out = calloc<RuleTransitionStruct>(maxCount);
+    try {
+      for (var i = 0; i < metrics.length; i++) {
+        values[i] = metrics[i];
+      }
+      final count = _rulesEvaluate(subjectId,
+          timestamp.millisecondsSinceEpoch, values, metrics.length, out, maxCount);
+      return [
+        for (var i = 0; i < count; i++)
+          RuleTransition(
+            ruleId: out[i].ruleId,
+            breached: out[i].breached != 0,
+            value: out[i].value,
+          ),
+      ];
+    } finally {
+      calloc.free(values);
+      calloc.free(out);
+    }
+  }
+
   /// Check if native bindings are available.
   bool get isAvailable => _loaded;
 }
@@ -0,0 +1,271 @@
+import 'dart:async';
+import 'dart:typed_data';
+
+import 'package:flutter_pty/flutter_pty.dart';
+
+import 'native_bindings.dart';
+
+/// The process side of a task: a shell hosted in a pseudo console.
+///
+/// Prefers a native task container (process created suspended inside its own
+/// job, so every descendant is contained from the first instruction) and
+/// falls back to flutter_pty when the native library is unavailable.
+abstract class TaskPty {
+  int get pid;
+
+  /// Job handle owned by the caller, 0 if the PTY brings no containment
+  int get jobHandle;
+
+  /// Native task container id, so native code can write input directly
+  /// (0 for the fallback)
+  int get containerId;
+
+  /// Output chunks of a native container are views of its output ring and
+  /// are delivered synchronously: read them in the listener, copy what has
+  /// to be kept
+  Stream<Uint8List> get output;
+  Future<int> get exitCode;
+
+  /// stderr, kept apart from [output] only in pipe mode (empty otherwise)
+  Stream<Uint8List> get errorOutput;
+
+  /// False in pipe mode: output has bare line feeds and no escape
+  /// sequences, and resizing does nothing
+  bool get isTerminal;
+
+  /// Completes when the shell is ready for input: when native code has seen
+  /// its prompt, or after a fixed delay for the fallback
+  Future<void> get promptReady;
+
+  void write(Uint8List data);
+  void resize(int rows, int cols);
+  void kill();
+
+  factory TaskPty.start(
+    String executable, {
+    String? workingDirectory,
+    Map<String, String>? environment,
+    int columns = 80,
+    int rows = 24,
+    int poolSize = 0,
+  }) {
+    return _ContainedPty.start(
+          executable,
+          workingDirectory: workingDirectory,
+          environment: environment,
+          columns: columns,
+          rows: rows,
+          poolSize: poolSize,
+        ) ??
+        _FlutterPty(Pty.start(
+          executable,
+          workingDirectory: workingDirectory,
+          environment: environment,
+          columns: columns,
+          rows: rows,
+        ));
+  }
+
+  /// Start [command] plus [arguments] directly, without a shell in between.
+  /// Null when that is not possible (no native library, the executable
+  /// cannot be resolved, or it is a batch file) - use [TaskPty.start].
+  static TaskPty? exec(
+    String command,
+    List<String> arguments, {
+    String? workingDirectory,
+    Map<String, String>? environment,
+    int columns = 80,
+    int rows = 24,
+  }) {
+    return _ContainedPty._spawn((onEvent, onPrompt, onError) =>
+        NativeBindings.instance.execTaskContainer(
+          command,
+          arguments,
+          workingDirectory: workingDirectory,
+          environment: environment,
+          cols: columns,
+          rows: rows,
+          onEvent: onEvent,
+        ));
+  }
+
+  /// Start [commandLine] with plain pipes instead of a pseudo console, for
+  /// tasks that need no terminal: much higher output throughput, stderr
+  /// separate. [direct] as for [TaskPty.exec]; otherwise the line is run
+  /// as is (e.g. through `cmd.exe /c`). Null if not possible.
+  static TaskPty? pipes(
+    String commandLine, {
+    String? workingDirectory,
+    Map<String, String>? environment,
+    bool direct = true,
+  }) {
+    return _ContainedPty._spawn(
+        (onEvent, onPrompt, onError) =>
+            NativeBindings.instance.spawnPipeContainer(
+              commandLine,
+              workingDirectory: workingDirectory,
+              environment: environment,
+              direct: direct,
+              onEvent: onEvent,
+              onError: onError,
+            ),
+        isTerminal: false);
+  }
+}
+
+/// Native task container (task_container.h)
+class _ContainedPty implements TaskPty {
+  @override
+  final int containerId;
+  @override
+  final int pid;
+  @override
+  final int jobHandle;
+
+  @override
+  final bool isTerminal;
+
+  final StreamController<Uint8List> _output;
+  final StreamController<Uint8List> _errors;
+  final Completer<int> _exitCode;
+  final Completer<void> _prompt;
+
+  _ContainedPty._(this.containerId, this.pid, this.jobHandle, this.isTerminal,
+      this._output, this._errors, this._exitCode, this._prompt);
+
+  static _ContainedPty? start(
+    String executable, {
+    String? workingDirectory,
+    Map<String, String>? environment,
+    required int columns,
+    required int rows,
+    required int poolSize,
+  }) {
+    return _spawn((onEvent, onPrompt, onError) =>
+        NativeBindings.instance.spawnTaskContainer(
+          executable,
+          workingDirectory: workingDirectory,
+          environment: environment,
+          cols: columns,
+          rows: rows,
+          poolSize: poolSize,
+          onEvent: onEvent,
+          onPrompt: onPrompt,
+        ));
+  }
+
+  /// [spawn] starts the container with these handlers and returns its id
+  /// (0 on failure)
+  static _ContainedPty? _spawn(
+      int Function(ContainerEventHandler onEvent, void Function() onPrompt,
+              void Function(Uint8List data) onError)
+          spawn,
+      {bool isTerminal = true}) {
+    final native = NativeBindings.instance;
+    // Synchronous, so the ring views are read before native reuses the space
+    final output = StreamController<Uint8List>(sync: true);
+    final errors = StreamController<Uint8List>(sync: true);
+    final exitCode = Completer<int>();
+    final prompt = Completer<void>();
+
+    late final int id;
+    id = spawn(
+      (data, code) {
+        if (data != null) {
+          _deliver(output, data);
+          return;
+        }
+        // Native delivers the last output before the exit event
+        output.close();
+        errors.close();
+        native.closeTaskContainer(id);
+        if (!exitCode.isCompleted) exitCode.complete(code);
+        if (!prompt.isCompleted) prompt.complete();
+      },
+      () {
+        if (!prompt.isCompleted) prompt.complete();
+      },
+      (data) => _deliver(errors, data),
+    );
+    if (id == 0) return null;
+
+    return _ContainedPty._(id, native.taskContainerPid(id),
+        native.taskContainerJob(id), isTerminal, output, errors, exitCode,
+        prompt);
+  }
+
+  /// Events wait in the controller until there is an active listener, so
+  /// those get their own copy
+  static void _deliver(StreamController<Uint8List> to, Uint8List data) {
+    to.add(to.hasListener && !to.isPaused ? data : Uint8List.fromList(data));
+  }
+
+  @override
+  Stream<Uint8List> get output => _output.stream;
+
+  @override
+  Future<int> get exitCode => _exitCode.future;
+
+  @override
+  Future<void> get promptReady => _prompt.future;
+
+  @override
+  Stream<Uint8List> get errorOutput => _errors.stream;
+
+  @override
+  void write(Uint8List data) {
+    NativeBindings.instance.writeTaskContainer(containerId, data);
+  }
+
+  @override
+  void resize(int rows, int cols) {
+    NativeBindings.instance.resizeTaskContainer(containerId, cols, rows);
+  }
+
+  /// Returns at once; [exitCode] completes when native code is done
+  @override
+  void kill() {
+    NativeBindings.instance.closeTaskContainer(containerId);
+  }
+}
+
+/// flutter_pty fallback - the caller has to set up its own job
+class _FlutterPty implements TaskPty {
+  final Pty _pty;
+
+  _FlutterPty(this._pty);
+
+  @override
+  int get pid => _pty.pid;
+
+  @override
+  int get jobHandle => 0;
+
+  @override
+  int get containerId => 0;
+
+  @override
+  Stream<Uint8List> get output => _pty.output;
+
+  @override
+  Future<int> get exitCode => _pty.exitCode;
+
+  @override
+  Future<void> get promptReady =>
+      Future.delayed(const Duration(milliseconds: 300));
+
+  @override
+  Stream<Uint8List> get errorOutput => const Stream.empty();
+
+  @override
+  bool get isTerminal => true;
+
+  @override
+  void write(Uint8List data) => _pty.write(data);
+
+  @override
+  void resize(int rows, int cols) => _pty.resize(rows, cols);
+
+  @override
+  void kill() => _pty.kill();
+}
@@ -4,6 +4,7 @@ import '../core/core.dart';
 import '../core/templates_extension.dart';
 import '../models/layout_node.dart';
 import '../models/slot_assignment.dart';
+import '../models/task.dart';
 import '../models/template.dart';
 import '../models/task_group.dart';
 import '../models/history_entry.dart';
@@ -327,14 +328,26 @@ class _GroupRowState extends State<_GroupRow> {
 
   Future<void> _runAllTasks() async {
     final templates = widget.group.getOrderedTemplates(core.templates.all);
+    final tasks = <Task>[];
     for (final template in templates) {
-      if (!mounted) return;
+      if (!mounted) break;
       final targetSlot = await PaneTargetSelector.show(context, title: 'Select Pane for ${template.name}', subtitle: '${templates.indexOf(template) + 1} of ${templates.length}');
       if (targetSlot == null || !mounted) break; // User cancelled
-      final task = await PlaceholderInputDialog.launchTemplate(context, template);
-      if (task == null || !mounted) break; // User cancelled placeholder input
+      final task = await PlaceholderInputDialog.createTemplateTask(context, template);
+      if (task == null) break; // User cancelled placeholder input
       core.layout.assignTerminal(targetSlot, task.id);
+      tasks.add(task);
     }
+    if (tasks.isEmpty) return;
+
+    // Start the ones set up so far along the group's dependencies
+    final report = await core.groupLaunch.launch(widget.group, tasks);
+    if (!mounted || report.total == null) return;
+    ScaffoldMessenger.of(context).showSnackBar(SnackBar(
+      content: Text('${widget.group.name} ${report.allReady ? 'ready' : 'finished'} in '
+          '${(report.total!.inMilliseconds / 1000).toStringAsFixed(1)}s — critical path: ${report.describeCriticalPath()}'),
+      duration: const Duration(seconds: 4),
+    ));
   }
 
   @override
@@ -745,7 +758,7 @@ class _HistoryRowState extends State<_HistoryRow> {
                         Text(_formatTime(widget.entry.startedAt), style: AppTheme.monoSmall.copyWith(color: colors.textMuted, fontSize: sizes.historyTimeFontSize)),
                         Flexible(
                           child: Text(
-                            ' · ${widget.entry.durationString}',
+                            ' · ${widget.entry.durationString}${widget.entry.attemptSuffix}',
                             style: AppTheme.monoSmall.copyWith(color: colors.textMuted, fontSize: sizes.historyTimeFontSize),
                             overflow: TextOverflow.ellipsis,
                           ),
@@ -2,6 +2,7 @@ import 'package:flutter/material.dart';
 import '../core/core.dart';
 import '../core/templates_extension.dart';
 import '../models/slot_assignment.dart';
+import '../models/task.dart';
 import '../models/template.dart';
 import '../models/task_group.dart';
 import '../models/history_entry.dart';
@@ -400,14 +401,25 @@ class _DropdownGroupRowState extends State<_DropdownGroupRow> {
     if (!ctx.mounted) return;
 
     final templates = widget.group.getOrderedTemplates(core.templates.all);
+    final tasks = <Task>[];
     for (final template in templates) {
-      if (!ctx.mounted) return;
+      if (!ctx.mounted) break;
       final targetSlot = await PaneTargetSelector.show(ctx, title: 'Select Pane for ${template.name}', subtitle: '${templates.indexOf(template) + 1} of ${templates.length}');
       if (targetSlot == null || !ctx.mounted) break;
-      final task = await PlaceholderInputDialog.launchTemplate(ctx, template);
-      if (task == null || !ctx.mounted) break;
+      final task = await PlaceholderInputDialog.createTemplateTask(ctx, template);
+      if (task == null) break;
       core.layout.assignTerminal(targetSlot, task.id);
+      tasks.add(task);
     }
+    if (tasks.isEmpty) return;
+
+    final report = await core.groupLaunch.launch(widget.group, tasks);
+    if (!ctx.mounted || report.total == null) return;
+    ScaffoldMessenger.of(ctx).showSnackBar(SnackBar(
+      content: Text('${widget.group.name} ${report.allReady ? 'ready' : 'finished'} in '
+          '${(report.total!.inMilliseconds / 1000).toStringAsFixed(1)}s — critical path: ${report.describeCriticalPath()}'),
+      duration: const Duration(seconds: 4),
+    ));
   }
 
   @override
@@ -772,7 +784,7 @@ class _DropdownHistoryRowState extends State<_DropdownHistoryRow> {
                         ),
                         Flexible(
                           child: Text(
-                            ' · ${widget.entry.durationString}',
+                            ' · ${widget.entry.durationString}${widget.entry.attemptSuffix}',
                             style: AppTheme.monoSmall.copyWith(color: colors.textMuted, fontSize: sizes.historyTimeFontSize),
                             overflow: TextOverflow.ellipsis,
                           ),
@@ -72,6 +72,26 @@ class PlaceholderInputDialog extends StatefulWidget {
     return core.tasks.launchWithValues(template, values);
   }
 
+  /// Create a task for a template without starting it, prompting for
+  /// placeholders if needed. Returns null if user cancelled the dialog.
+  static Future<Task?> createTemplateTask(
+    BuildContext context,
+    Template template,
+  ) async {
+    final placeholders = template.placeholders;
+    if (placeholders.isEmpty) {
+      return core.tasks.create(template);
+    }
+
+    final values = await show(
+      context,
+      template: template,
+      placeholders: placeholders,
+    );
+    if (values == null) return null;
+    return core.tasks.createWithValues(template, values);
+  }
+
   @override
   State<PlaceholderInputDialog> createState() => _PlaceholderInputDialogState();
 }
@@ -0,0 +1,473 @@
+import 'package:flutter/material.dart';
+import 'package:flutter/services.dart';
+import '../models/readiness_probe.dart';
+import '../theme/app_colors.dart';
+import '../theme/app_theme.dart';
+
+/// Widget for editing a template's readiness probe
+class ReadinessProbeEditor extends StatefulWidget {
+  final ReadinessProbe? probe;
+  final ValueChanged<ReadinessProbe?> onChanged;
+  final bool initiallyExpanded;
+
+  const ReadinessProbeEditor({
+    super.key,
+    required this.probe,
+    required this.onChanged,
+    this.initiallyExpanded = false,
+  });
+
+  @override
+  State<ReadinessProbeEditor> createState() => _ReadinessProbeEditorState();
+}
+
+class _ReadinessProbeEditorState extends State<ReadinessProbeEditor>
+    with SingleTickerProviderStateMixin {
+  late bool _isExpanded;
+  ProbeKind? _kind;
+  late final TextEditingController _hostController;
+  late final TextEditingController _portController;
+  late final TextEditingController _pathController;
+  late final TextEditingController _patternController;
+  late final TextEditingController _statusController;
+  late final TextEditingController _intervalController;
+  late final TextEditingController _timeoutController;
+  late final TextEditingController _successController;
+  late final TextEditingController _failureController;
+  late AnimationController _expandController;
+  late Animation<double> _expandAnimation;
+
+  @override
+  void initState() {
+    super.initState();
+    final p = widget.probe;
+    _isExpanded = widget.initiallyExpanded || p != null;
+    _kind = p?.kind;
+    _hostController = TextEditingController(text: p?.host ?? '');
+    _portController = TextEditingController(text: p?.port?.toString() ?? '');
+    _pathController = TextEditingController(text: p?.path ?? '');
+    _patternController = TextEditingController(text: p?.pattern ?? '');
+    _statusController =
+        TextEditingController(text: p?.expectedStatus?.toString() ?? '');
+    _intervalController =
+        TextEditingController(text: p != null ? '${p.intervalMs}' : '');
+    _timeoutController =
+        TextEditingController(text: p != null ? '${p.timeoutMs}' : '');
+    _successController =
+        TextEditingController(text: p != null ? '${p.successThreshold}' : '');
+    _failureController =
+        TextEditingController(text: p != null ? '${p.failureThreshold}' : '');
+
+    _expandController = AnimationController(
+      duration: const Duration(milliseconds: 200),
+      vsync: this,
+    );
+    _expandAnimation = CurvedAnimation(
+      parent: _expandController,
+      curve: Curves.easeOutCubic,
+    );
+
+    if (_isExpanded) {
+      _expandController.value = 1.0;
+    }
+  }
+
+  @override
+  void dispose() {
+    _expandController.dispose();
+    _hostController.dispose();
+    _portController.dispose();
+    _pathController.dispose();
+    _patternController.dispose();
+    _statusController.dispose();
+    _intervalController.dispose();
+    _timeoutController.dispose();
+    _successController.dispose();
+    _failureController.dispose();
+    super.dispose();
+  }
+
+  void _toggleExpanded() {
+    setState(() {
+      _isExpanded = !_isExpanded;
+      if (_isExpanded) {
+        _expandController.forward();
+      } else {
+        _expandController.reverse();
+      }
+    });
+  }
+
+  int? _parse(TextEditingController controller) {
+    final value = int.tryParse(controller.text.trim());
+    return value == null || value <= 0 ? null : value;
+  }
+
+  String? _text(TextEditingController controller) {
+    final value = controller.text.trim();
+    return value.isEmpty ? null : value;
+  }
+
+  void _notifyChange() {
+    setState(() {});
+    final kind = _kind;
+    if (kind == null) {
+      widget.onChanged(null);
+      return;
+    }
+    widget.onChanged(ReadinessProbe(
+      kind: kind,
+      host: kind == ProbeKind.tcp || kind == ProbeKind.http
+          ? _text(_hostController)
+          : null,
+      port: kind == ProbeKind.tcp || kind == ProbeKind.http
+          ? _parse(_portController)
+          : null,
+      path: kind == ProbeKind.http || kind == ProbeKind.file
+          ? _text(_pathController)
+          : null,
+      pattern: kind == ProbeKind.output ? _text(_patternController) : null,
+      expectedStatus: kind == ProbeKind.http ? _parse(_statusController) : null,
+      intervalMs: _parse(_intervalController) ?? 500,
+      timeoutMs: _parse(_timeoutController) ?? 1000,
+      successThreshold: _parse(_successController) ?? 1,
+      failureThreshold: _parse(_failureController) ?? 3,
+    ));
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    final colors = AppColorsExtension.of(context);
+    final kind = _kind;
+
+    return Container(
+      decoration: BoxDecoration(
+        color: colors.surface,
+        borderRadius: BorderRadius.circular(10),
+        border: Border.all(color: colors.border),
+      ),
+      child: Column(
+        crossAxisAlignment: CrossAxisAlignment.start,
+        children: [
+          _buildHeader(colors),
+          SizeTransition(
+            sizeFactor: _expandAnimation,
+            child: Padding(
+              padding: const EdgeInsets.all(12),
+              child: Column(
+                crossAxisAlignment: CrossAxisAlignment.start,
+                children: [
+                  Text(
+                    'Decides when the task counts as ready for tasks that wait '
+                    'for it. Without a probe, ready means steps completed or '
+                    'startup output gone quiet.',
+                    style: TextStyle(
+                      fontSize: 11,
+                      color: colors.textSecondary,
+                      height: 1.5,
+                    ),
+                  ),
+                  const SizedBox(height: 12),
+                  DropdownButtonFormField<ProbeKind?>(
+                    value: kind,
+                    isDense: true,
+                    onChanged: (k) {
+                      _kind = k;
+                      _notifyChange();
+                    },
+                    style: TextStyle(fontSize: 12, color: colors.textPrimary),
+                    dropdownColor: colors.surface,
+                    decoration: _inputDecoration(colors: colors, label: 'Probe'),
+                    items: [
+                      DropdownMenuItem<ProbeKind?>(
+                        value: null,
+                        child: Text('None', style: TextStyle(color: colors.textMuted)),
+                      ),
+                      for (final k in ProbeKind.values)
+                        DropdownMenuItem<ProbeKind?>(value: k, child: Text(k.label)),
+                    ],
+                  ),
+                  if (kind == ProbeKind.tcp || kind == ProbeKind.http) ...[
+                    const SizedBox(height: 10),
+                    Row(
+                      children: [
+                        Expanded(
+                          flex: 2,
+                          child: _buildTextField(
+                            colors: colors,
+                            controller: _hostController,
+                            label: 'Host',
+                            hint: '127.0.0.1',
+                          ),
+                        ),
+                        const SizedBox(width: 10),
+                        Expanded(
+                          child: _buildNumberField(
+                            colors: colors,
+                            controller: _portController,
+                            label: 'Port',
+                            hint: '8080',
+                          ),
+                        ),
+                        if (kind == ProbeKind.http) ...[
+                          const SizedBox(width: 10),
+                          Expanded(
+                            flex: 2,
+                            child: _buildTextField(
+                              colors: colors,
+                              controller: _pathController,
+                              label: 'Path',
+                              hint: '/health',
+                            ),
+                          ),
+                          const SizedBox(width: 10),
+                          Expanded(
+                            child: _buildNumberField(
+                              colors: colors,
+                              controller: _statusController,
+                              label: 'Status',
+                              hint: '2xx/3xx',
+                            ),
+                          ),
+                        ],
+                      ],
+                    ),
+                  ],
+                  if (kind == ProbeKind.file) ...[
+                    const SizedBox(height: 10),
+                    _buildTextField(
+                      colors: colors,
+                      controller: _pathController,
+                      label: 'File',
+                      hint: r'dist\index.html (relative to the working directory)',
+                    ),
+                  ],
+                  if (kind == ProbeKind.output) ...[
+                    const SizedBox(height: 10),
+                    _buildTextField(
+                      colors: colors,
+                      controller: _patternController,
+                      label: 'Output pattern (regex)',
+                      hint: r'listening on .*:\d+',
+                    ),
+                  ],
+                  if (kind != null && kind != ProbeKind.output) ...[
+                    const SizedBox(height: 10),
+                    Row(
+                      children: [
+                        Expanded(
+                          child: _buildNumberField(
+                            colors: colors,
+                            controller: _intervalController,
+                            label: 'Interval',
+                            hint: '500',
+                            suffix: 'ms',
+                          ),
+                        ),
+                        const SizedBox(width: 10),
+                        Expanded(
+                          child: _buildNumberField(
+                            colors: colors,
+                            controller: _timeoutController,
+                            label: 'Timeout',
+                            hint: '1000',
+                            suffix: 'ms',
+                          ),
+                        ),
+                        const SizedBox(width: 10),
+                        Expanded(
+                          child: Tooltip(
+                            message: 'Passes in a row before the task is ready',
+                            child: _buildNumberField(
+                              colors: colors,
+                              controller: _successController,
+                              label: 'Passes',
+                              hint: '1',
+                            ),
+                          ),
+                        ),
+                        const SizedBox(width: 10),
+                        Expanded(
+                          child: Tooltip(
+                            message:
+                                'Failures in a row before a ready task is reported as not answering',
+                            child: _buildNumberField(
+                              colors: colors,
+                              controller: _failureController,
+                              label: 'Failures',
+                              hint: '3',
+                            ),
+                          ),
+                        ),
+                      ],
+                    ),
+                  ],
+                ],
+              ),
+            ),
+          ),
+        ],
+      ),
+    );
+  }
+
+  Widget _buildHeader(AppColorScheme colors) {
+    final active = _kind != null;
+
+    return InkWell(
+      onTap: _toggleExpanded,
+      borderRadius: BorderRadius.vertical(
+        top: const Radius.circular(10),
+        bottom: _isExpanded ? Radius.zero : const Radius.circular(10),
+      ),
+      child: Container(
+        padding: const EdgeInsets.symmetric(horizontal: 14, vertical: 12),
+        decoration: BoxDecoration(
+          color: colors.surfaceLight,
+          borderRadius: BorderRadius.vertical(
+            top: const Radius.circular(10),
+            bottom: _isExpanded ? Radius.zero : const Radius.circular(10),
+          ),
+        ),
+        child: Row(
+          children: [
+            Container(
+              padding: const EdgeInsets.all(6),
+              decoration: BoxDecoration(
+                color: active
+                    ? AppColors.success.withValues(alpha: 0.15)
+                    : colors.surface,
+                borderRadius: BorderRadius.circular(6),
+                border: Border.all(
+                  color: active
+                      ? AppColors.success.withValues(alpha: 0.3)
+                      : colors.border,
+                ),
+              ),
+              child: Icon(
+                Icons.health_and_safety_outlined,
+                size: 16,
+                color: active ? AppColors.success : colors.textMuted,
+              ),
+            ),
+            const SizedBox(width: 12),
+            Expanded(
+              child: Column(
+                crossAxisAlignment: CrossAxisAlignment.start,
+                children: [
+                  Text(
+                    'Readiness Probe',
+                    style: TextStyle(
+                      fontSize: 13,
+                      fontWeight: FontWeight.w600,
+                      color: colors.textPrimary,
+                    ),
+                  ),
+                  Text(
+                    active
+                        ? _kind!.label
+                        : 'Optional - wait for a port, endpoint, file or output',
+                    style: TextStyle(
+                      fontSize: 11,
+                      color: colors.textMuted,
+                    ),
+                  ),
+                ],
+              ),
+            ),
+            AnimatedRotation(
+              turns: _isExpanded ? 0.5 : 0,
+              duration: const Duration(milliseconds: 200),
+              child: Icon(
+                Icons.keyboard_arrow_down,
+                size: 20,
+                color: colors.textMuted,
+              ),
+            ),
+          ],
+        ),
+      ),
+    );
+  }
+
+  Widget _buildTextField({
+    required AppColorScheme colors,
+    required TextEditingController controller,
+    required String label,
+    String? hint,
+  }) {
+    return TextField(
+      controller: controller,
+      onChanged: (_) => _notifyChange(),
+      style: TextStyle(
+        fontFamily: 'Consolas',
+        fontSize: 12,
+        color: colors.textPrimary,
+      ),
+      decoration: _inputDecoration(colors: colors, label: label, hint: hint),
+    );
+  }
+
+  Widget _buildNumberField({
+    required AppColorScheme colors,
+    required TextEditingController controller,
+    required String label,
+    String? hint,
+    String? suffix,
+  }) {
+    return TextField(
+      controller: controller,
+      onChanged: (_) => _notifyChange(),
+      keyboardType: TextInputType.number,
+      inputFormatters: [FilteringTextInputFormatter.digitsOnly],
+      style: TextStyle(
+        fontFamily: 'Consolas',
+        fontSize: 12,
+        color: colors.textPrimary,
+      ),
+      decoration: _inputDecoration(
+        colors: colors,
+        label: label,
+        hint: hint,
+        suffix: suffix,
+      ),
+    );
+  }
+
+  InputDecoration _inputDecoration({
+    required AppColorScheme colors,
+    required String label,
+    String? hint,
+    String? suffix,
+  }) {
+    return InputDecoration(
+      labelText: label,
+      labelStyle: TextStyle(fontSize: 12, color: colors.textMuted),
+      hintText: hint,
+      hintStyle: TextStyle(
+        fontFamily: 'Consolas',
+        fontSize: 12,
+        color: colors.textMuted,
+      ),
+      suffixText: suffix,
+      suffixStyle: TextStyle(fontSize: 11, color: colors.textMuted),
+      filled: true,
+      fillColor: colors.surfaceLight,
+      isDense: true,
+      contentPadding:
+          const EdgeInsets.symmetric(horizontal: 10, vertical: 10),
+      border: OutlineInputBorder(
+        borderRadius: BorderRadius.circular(6),
+        borderSide: BorderSide(color: colors.border),
+      ),
+      enabledBorder: OutlineInputBorder(
+        borderRadius: BorderRadius.circular(6),
+        borderSide: BorderSide(color: colors.border),
+      ),
+      focusedBorder: OutlineInputBorder(
+        borderRadius: BorderRadius.circular(6),
+        borderSide: const BorderSide(color: AppColors.info, width: 1.5),
+      ),
+    );
+  }
+}
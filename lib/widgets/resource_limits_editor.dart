@@ -0,0 +1,462 @@
+import 'package:flutter/material.dart';
+import 'package:flutter/services.dart';
+import '../models/resource_limits.dart';
+import '../models/scheduling_options.dart';
+import '../theme/app_colors.dart';
+import '../theme/app_theme.dart';
+
+/// Widget for editing per-template resource limits and scheduling
+class ResourceLimitsEditor extends StatefulWidget {
+  final ResourceLimits limits;
+  final ValueChanged<ResourceLimits> onChanged;
+  final SchedulingOptions scheduling;
+  final ValueChanged<SchedulingOptions>? onSchedulingChanged;
+  final bool initiallyExpanded;
+
+  const ResourceLimitsEditor({
+    super.key,
+    required this.limits,
+    required this.onChanged,
+    this.scheduling = SchedulingOptions.none,
+    this.onSchedulingChanged,
+    this.initiallyExpanded = false,
+  });
+
+  @override
+  State<ResourceLimitsEditor> createState() => _ResourceLimitsEditorState();
+}
+
+class _ResourceLimitsEditorState extends State<ResourceLimitsEditor>
+    with SingleTickerProviderStateMixin {
+  late bool _isExpanded;
+  late final TextEditingController _memoryController;
+  late final TextEditingController _cpuController;
+  late final TextEditingController _processesController;
+  late final TextEditingController _cpusController;
+  late final TextEditingController _weightController;
+  TaskPriority? _priority;
+  IoPriority? _ioPriority;
+  late AnimationController _expandController;
+  late Animation<double> _expandAnimation;
+
+  @override
+  void initState() {
+    super.initState();
+    _isExpanded = widget.initiallyExpanded ||
+        !widget.limits.isEmpty ||
+        !widget.scheduling.isEmpty;
+    _memoryController =
+        TextEditingController(text: widget.limits.maxMemoryMb?.toString() ?? '');
+    _cpuController = TextEditingController(
+        text: widget.limits.cpuRatePercent?.toString() ?? '');
+    _processesController = TextEditingController(
+        text: widget.limits.maxProcesses?.toString() ?? '');
+    final mask = widget.scheduling.affinityMask;
+    _cpusController = TextEditingController(
+        text: mask != null ? SchedulingOptions.formatCpuList(mask) : '');
+    _weightController = TextEditingController(
+        text: widget.scheduling.launchWeight?.toString() ?? '');
+    _priority = widget.scheduling.priority;
+    _ioPriority = widget.scheduling.ioPriority;
+
+    _expandController = AnimationController(
+      duration: const Duration(milliseconds: 200),
+      vsync: this,
+    );
+    _expandAnimation = CurvedAnimation(
+      parent: _expandController,
+      curve: Curves.easeOutCubic,
+    );
+
+    if (_isExpanded) {
+      _expandController.value = 1.0;
+    }
+  }
+
+  @override
+  void dispose() {
+    _expandController.dispose();
+    _memoryController.dispose();
+    _cpuController.dispose();
+    _processesController.dispose();
+    _cpusController.dispose();
+    _weightController.dispose();
+    super.dispose();
+  }
+
+  void _toggleExpanded() {
+    setState(() {
+      _isExpanded = !_isExpanded;
+      if (_isExpanded) {
+        _expandController.forward();
+      } else {
+        _expandController.reverse();
+      }
+    });
+  }
+
+  /// Empty or zero means "no limit"
+  int? _parse(TextEditingController controller, {int? max}) {
+    final value = int.tryParse(controller.text.trim());
+    if (value == null || value <= 0) return null;
+    return max != null && value > max ? max : value;
+  }
+
+  void _notifyChange() {
+    setState(() {}); // Refresh the header count
+    widget.onChanged(ResourceLimits(
+      maxMemoryMb: _parse(_memoryController),
+      // 100% of the machine is the same as no cap
+      cpuRatePercent: _parse(_cpuController, max: 99),
+      maxProcesses: _parse(_processesController),
+    ));
+  }
+
+  void _notifySchedulingChange() {
+    setState(() {});
+    widget.onSchedulingChanged?.call(SchedulingOptions(
+      priority: _priority,
+      affinityMask: SchedulingOptions.parseCpuList(_cpusController.text),
+      ioPriority: _ioPriority,
+      launchWeight: _parse(_weightController, max: 100),
+    ));
+  }
+
+  int get _activeCount => [
+        _parse(_memoryController),
+        _parse(_cpuController),
+        _parse(_processesController),
+        _priority,
+        SchedulingOptions.parseCpuList(_cpusController.text),
+        _ioPriority,
+        _parse(_weightController),
+      ].where((v) => v != null).length;
+
+  @override
+  Widget build(BuildContext context) {
+    final colors = AppColorsExtension.of(context);
+
+    return Container(
+      decoration: BoxDecoration(
+        color: colors.surface,
+        borderRadius: BorderRadius.circular(10),
+        border: Border.all(color: colors.border),
+      ),
+      child: Column(
+        crossAxisAlignment: CrossAxisAlignment.start,
+        children: [
+          _buildHeader(colors),
+          SizeTransition(
+            sizeFactor: _expandAnimation,
+            child: Padding(
+              padding: const EdgeInsets.all(12),
+              child: Column(
+                crossAxisAlignment: CrossAxisAlignment.start,
+                children: [
+                  Text(
+                    'Applied to the whole process tree when the task starts, '
+                    'including processes it starts later. '
+                    'Leave a field empty for no limit.',
+                    style: TextStyle(
+                      fontSize: 11,
+                      color: colors.textSecondary,
+                      height: 1.5,
+                    ),
+                  ),
+                  const SizedBox(height: 12),
+                  Row(
+                    children: [
+                      Expanded(
+                        child: _buildNumberField(
+                          colors: colors,
+                          controller: _memoryController,
+                          label: 'Max memory',
+                          suffix: 'MB',
+                        ),
+                      ),
+                      const SizedBox(width: 10),
+                      Expanded(
+                        child: _buildNumberField(
+                          colors: colors,
+                          controller: _cpuController,
+                          label: 'CPU rate',
+                          suffix: '%',
+                        ),
+                      ),
+                      const SizedBox(width: 10),
+                      Expanded(
+                        child: _buildNumberField(
+                          colors: colors,
+                          controller: _processesController,
+                          label: 'Max processes',
+                        ),
+                      ),
+                    ],
+                  ),
+                  if (widget.onSchedulingChanged != null) ...[
+                    const SizedBox(height: 10),
+                    Row(
+                      children: [
+                        Expanded(
+                          child: _buildDropdown<TaskPriority>(
+                            colors: colors,
+                            label: 'CPU priority',
+                            value: _priority,
+                            values: TaskPriority.values,
+                            labelOf: (p) => p.label,
+                            onChanged: (p) {
+                              _priority = p;
+                              _notifySchedulingChange();
+                            },
+                          ),
+                        ),
+                        const SizedBox(width: 10),
+                        Expanded(
+                          child: _buildDropdown<IoPriority>(
+                            colors: colors,
+                            label: 'I/O priority',
+                            value: _ioPriority,
+                            values: IoPriority.values,
+                            labelOf: (p) => p.label,
+                            onChanged: (p) {
+                              _ioPriority = p;
+                              _notifySchedulingChange();
+                            },
+                          ),
+                        ),
+                        const SizedBox(width: 10),
+                        Expanded(
+                          child: TextField(
+                            controller: _cpusController,
+                            onChanged: (_) => _notifySchedulingChange(),
+                            inputFormatters: [
+                              FilteringTextInputFormatter.allow(
+                                  RegExp(r'[0-9,\- ]')),
+                            ],
+                            style: TextStyle(
+                              fontFamily: 'Consolas',
+                              fontSize: 12,
+                              color: colors.textPrimary,
+                            ),
+                            decoration: _inputDecoration(
+                              colors: colors,
+                              label: 'CPUs',
+                              hint: 'all (e.g. 0-3,6)',
+                            ),
+                          ),
+                        ),
+                        const SizedBox(width: 10),
+                        Expanded(
+                          child: Tooltip(
+                            message:
+                                'How much of the group launch budget this task '
+                                'takes while it is starting up',
+                            child: _buildNumberField(
+                              colors: colors,
+                              controller: _weightController,
+                              label: 'Launch weight',
+                              hint: '1',
+                              onChanged: _notifySchedulingChange,
+                            ),
+                          ),
+                        ),
+                      ],
+                    ),
+                  ],
+                ],
+              ),
+            ),
+          ),
+        ],
+      ),
+    );
+  }
+
+  Widget _buildDropdown<T>({
+    required AppColorScheme colors,
+    required String label,
+    required T? value,
+    required List<T> values,
+    required String Function(T) labelOf,
+    required ValueChanged<T?> onChanged,
+  }) {
+    return DropdownButtonFormField<T?>(
+      value: value,
+      isDense: true,
+      onChanged: onChanged,
+      style: TextStyle(fontSize: 12, color: colors.textPrimary),
+      dropdownColor: colors.surface,
+      decoration: _inputDecoration(colors: colors, label: label),
+      items: [
+        DropdownMenuItem<T?>(
+          value: null,
+          child: Text('Default', style: TextStyle(color: colors.textMuted)),
+        ),
+        for (final v in values)
+          DropdownMenuItem<T?>(value: v, child: Text(labelOf(v))),
+      ],
+    );
+  }
+
+  Widget _buildHeader(AppColorScheme colors) {
+    final active = _activeCount;
+
+    return InkWell(
+      onTap: _toggleExpanded,
+      borderRadius: BorderRadius.vertical(
+        top: const Radius.circular(10),
+        bottom: _isExpanded ? Radius.zero : const Radius.circular(10),
+      ),
+      child: Container(
+        padding: const EdgeInsets.symmetric(horizontal: 14, vertical: 12),
+        decoration: BoxDecoration(
+          color: colors.surfaceLight,
+          borderRadius: BorderRadius.vertical(
+            top: const Radius.circular(10),
+            bottom: _isExpanded ? Radius.zero : const Radius.circular(10),
+          ),
+        ),
+        child: Row(
+          children: [
+            Container(
+              padding: const EdgeInsets.all(6),
+              decoration: BoxDecoration(
+                color: active > 0
+                    ? AppColors.info.withValues(alpha: 0.15)
+                    : colors.surface,
+                borderRadius: BorderRadius.circular(6),
+                border: Border.all(
+                  color: active > 0
+                      ? AppColors.info.withValues(alpha: 0.3)
+                      : colors.border,
+                ),
+              ),
+              child: Icon(
+                Icons.speed_outlined,
+                size: 16,
+                color: active > 0 ? AppColors.info : colors.textMuted,
+              ),
+            ),
+            const SizedBox(width: 12),
+            Expanded(
+              child: Column(
+                crossAxisAlignment: CrossAxisAlignment.start,
+                children: [
+                  Text(
+                    'Resources & Priority',
+                    style: TextStyle(
+                      fontSize: 13,
+                      fontWeight: FontWeight.w600,
+                      color: colors.textPrimary,
+                    ),
+                  ),
+                  if (active == 0)
+                    Text(
+                      'Optional - cap memory, CPU and processes, set priority',
+                      style: TextStyle(
+                        fontSize: 11,
+                        color: colors.textMuted,
+                      ),
+                    ),
+                ],
+              ),
+            ),
+            if (active > 0) ...[
+              Container(
+                padding:
+                    const EdgeInsets.symmetric(horizontal: 8, vertical: 4),
+                decoration: BoxDecoration(
+                  color: AppColors.info.withValues(alpha: 0.15),
+                  borderRadius: BorderRadius.circular(12),
+                ),
+                child: Text(
+                  '$active',
+                  style: TextStyle(
+                    fontSize: 11,
+                    fontWeight: FontWeight.w600,
+                    color: AppColors.info,
+                    fontFamily: 'Consolas',
+                  ),
+                ),
+              ),
+              const SizedBox(width: 8),
+            ],
+            AnimatedRotation(
+              turns: _isExpanded ? 0.5 : 0,
+              duration: const Duration(milliseconds: 200),
+              child: Icon(
+                Icons.keyboard_arrow_down,
+                size: 20,
+                color: colors.textMuted,
+              ),
+            ),
+          ],
+        ),
+      ),
+    );
+  }
+
+  Widget _buildNumberField({
+    required AppColorScheme colors,
+    required TextEditingController controller,
+    required String label,
+    String? suffix,
+    String hint = 'none',
+    VoidCallback? onChanged,
+  }) {
+    return TextField(
+      controller: controller,
+      onChanged: (_) => (onChanged ?? _notifyChange)(),
+      keyboardType: TextInputType.number,
+      inputFormatters: [FilteringTextInputFormatter.digitsOnly],
+      style: TextStyle(
+        fontFamily: 'Consolas',
+        fontSize: 12,
+        color: colors.textPrimary,
+      ),
+      decoration: _inputDecoration(
+        colors: colors,
+        label: label,
+        hint: hint,
+        suffix: suffix,
+      ),
+    );
+  }
+
+  InputDecoration _inputDecoration({
+    required AppColorScheme colors,
+    required String label,
+    String? hint,
+    String? suffix,
+  }) {
+    return InputDecoration(
+      labelText: label,
+      labelStyle: TextStyle(fontSize: 12, color: colors.textMuted),
+      hintText: hint,
+      hintStyle: TextStyle(
+        fontFamily: 'Consolas',
+        fontSize: 12,
+        color: colors.textMuted,
+      ),
+      suffixText: suffix,
+      suffixStyle: TextStyle(fontSize: 11, color: colors.textMuted),
+      filled: true,
+      fillColor: colors.surfaceLight,
+      isDense: true,
+      contentPadding:
+          const EdgeInsets.symmetric(horizontal: 10, vertical: 10),
+      border: OutlineInputBorder(
+        borderRadius: BorderRadius.circular(6),
+        borderSide: BorderSide(color: colors.border),
+      ),
+      enabledBorder: OutlineInputBorder(
+        borderRadius: BorderRadius.circular(6),
+        borderSide: BorderSide(color: colors.border),
+      ),
+      focusedBorder: OutlineInputBorder(
+        borderRadius: BorderRadius.circular(6),
+        borderSide: const BorderSide(color: AppColors.info, width: 1.5),
+      ),
+    );
+  }
+}
@@ -0,0 +1,482 @@
+import 'package:flutter/material.dart';
+import 'package:flutter/services.dart';
+import '../models/resource_rule.dart';
+import '../theme/app_colors.dart';
+import '../theme/app_theme.dart';
+
+/// Widget for editing per-template resource threshold rules
+class ResourceRulesEditor extends StatefulWidget {
+  final List<ResourceRule> rules;
+  final ValueChanged<List<ResourceRule>> onChanged;
+  final bool initiallyExpanded;
+
+  const ResourceRulesEditor({
+    super.key,
+    required this.rules,
+    required this.onChanged,
+    this.initiallyExpanded = false,
+  });
+
+  @override
+  State<ResourceRulesEditor> createState() => _ResourceRulesEditorState();
+}
+
+class _ResourceRulesEditorState extends State<ResourceRulesEditor>
+    with SingleTickerProviderStateMixin {
+  late bool _isExpanded;
+  late List<_RuleEditData> _entries;
+  late AnimationController _expandController;
+  late Animation<double> _expandAnimation;
+
+  @override
+  void initState() {
+    super.initState();
+    _isExpanded = widget.initiallyExpanded || widget.rules.isNotEmpty;
+    _entries = [
+      for (var i = 0; i < widget.rules.length; i++)
+        _RuleEditData.from(
+          DateTime.now().microsecondsSinceEpoch.toRadixString(36) + '$i',
+          widget.rules[i],
+        ),
+    ];
+
+    _expandController = AnimationController(
+      duration: const Duration(milliseconds: 200),
+      vsync: this,
+    );
+    _expandAnimation = CurvedAnimation(
+      parent: _expandController,
+      curve: Curves.easeOutCubic,
+    );
+
+    if (_isExpanded) {
+      _expandController.value = 1.0;
+    }
+  }
+
+  @override
+  void dispose() {
+    _expandController.dispose();
+    for (final entry in _entries) {
+      entry.dispose();
+    }
+    super.dispose();
+  }
+
+  void _toggleExpanded() {
+    setState(() {
+      _isExpanded = !_isExpanded;
+      if (_isExpanded) {
+        _expandController.forward();
+      } else {
+        _expandController.reverse();
+      }
+    });
+  }
+
+  void _notifyChange() {
+    final rules = <ResourceRule>[];
+    for (final entry in _entries) {
+      final threshold = double.tryParse(entry.thresholdController.text.trim());
+      if (threshold == null || threshold <= 0) continue;
+      rules.add(ResourceRule(
+        metric: entry.metric,
+        threshold: threshold,
+        sustainSeconds:
+            int.tryParse(entry.sustainController.text.trim()) ?? 60,
+        action: entry.action,
+      ));
+    }
+    widget.onChanged(rules);
+  }
+
+  void _addEntry() {
+    setState(() {
+      _entries.add(_RuleEditData.from(
+        DateTime.now().microsecondsSinceEpoch.toRadixString(36),
+        const ResourceRule(metric: RuleMetric.memory, threshold: 2048),
+      ));
+    });
+    _notifyChange();
+  }
+
+  void _removeEntry(int index) {
+    setState(() {
+      _entries[index].dispose();
+      _entries.removeAt(index);
+    });
+    _notifyChange();
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    final colors = AppColorsExtension.of(context);
+
+    return Container(
+      decoration: BoxDecoration(
+        color: colors.surface,
+        borderRadius: BorderRadius.circular(10),
+        border: Border.all(color: colors.border),
+      ),
+      child: Column(
+        crossAxisAlignment: CrossAxisAlignment.start,
+        children: [
+          _buildHeader(colors),
+          SizeTransition(
+            sizeFactor: _expandAnimation,
+            child: Column(
+              crossAxisAlignment: CrossAxisAlignment.start,
+              children: [
+                Padding(
+                  padding: const EdgeInsets.fromLTRB(12, 12, 12, 0),
+                  child: Text(
+                    'Checked on every resource sample (5s). A rule acts once the '
+                    'value stays above the threshold for the given time, and '
+                    'recovers once it stays 10% below it for as long.',
+                    style: TextStyle(
+                      fontSize: 11,
+                      color: colors.textSecondary,
+                      height: 1.5,
+                    ),
+                  ),
+                ),
+                if (_entries.isNotEmpty)
+                  Padding(
+                    padding: const EdgeInsets.fromLTRB(12, 12, 12, 0),
+                    child: Column(
+                      children: [
+                        for (int i = 0; i < _entries.length; i++)
+                          _buildEntryItem(i, colors),
+                      ],
+                    ),
+                  ),
+                _buildAddButton(colors),
+              ],
+            ),
+          ),
+        ],
+      ),
+    );
+  }
+
+  Widget _buildHeader(AppColorScheme colors) {
+    final active = _entries.isNotEmpty;
+
+    return InkWell(
+      onTap: _toggleExpanded,
+      borderRadius: BorderRadius.vertical(
+        top: const Radius.circular(10),
+        bottom: _isExpanded ? Radius.zero : const Radius.circular(10),
+      ),
+      child: Container(
+        padding: const EdgeInsets.symmetric(horizontal: 14, vertical: 12),
+        decoration: BoxDecoration(
+          color: colors.surfaceLight,
+          borderRadius: BorderRadius.vertical(
+            top: const Radius.circular(10),
+            bottom: _isExpanded ? Radius.zero : const Radius.circular(10),
+          ),
+        ),
+        child: Row(
+          children: [
+            Container(
+              padding: const EdgeInsets.all(6),
+              decoration: BoxDecoration(
+                color: active
+                    ? AppColors.warning.withValues(alpha: 0.15)
+                    : colors.surface,
+                borderRadius: BorderRadius.circular(6),
+                border: Border.all(
+                  color: active
+                      ? AppColors.warning.withValues(alpha: 0.3)
+                      : colors.border,
+                ),
+              ),
+              child: Icon(
+                Icons.rule,
+                size: 16,
+                color: active ? AppColors.warning : colors.textMuted,
+              ),
+            ),
+            const SizedBox(width: 12),
+            Expanded(
+              child: Column(
+                crossAxisAlignment: CrossAxisAlignment.start,
+                children: [
+                  Text(
+                    'Resource Rules',
+                    style: TextStyle(
+                      fontSize: 13,
+                      fontWeight: FontWeight.w600,
+                      color: colors.textPrimary,
+                    ),
+                  ),
+                  if (!active)
+                    Text(
+                      'Optional - restart or flag the task on high memory/CPU',
+                      style: TextStyle(
+                        fontSize: 11,
+                        color: colors.textMuted,
+                      ),
+                    ),
+                ],
+              ),
+            ),
+            if (active) ...[
+              Container(
+                padding:
+                    const EdgeInsets.symmetric(horizontal: 8, vertical: 4),
+                decoration: BoxDecoration(
+                  color: AppColors.warning.withValues(alpha: 0.15),
+                  borderRadius: BorderRadius.circular(12),
+                ),
+                child: Text(
+                  '${_entries.length}',
+                  style: TextStyle(
+                    fontSize: 11,
+                    fontWeight: FontWeight.w600,
+                    color: AppColors.warning,
+                    fontFamily: 'Consolas',
+                  ),
+                ),
+              ),
+              const SizedBox(width: 8),
+            ],
+            AnimatedRotation(
+              turns: _isExpanded ? 0.5 : 0,
+              duration: const Duration(milliseconds: 200),
+              child: Icon(
+                Icons.keyboard_arrow_down,
+                size: 20,
+                color: colors.textMuted,
+              ),
+            ),
+          ],
+        ),
+      ),
+    );
+  }
+
+  Widget _buildEntryItem(int index, AppColorScheme colors) {
+    final data = _entries[index];
+
+    return Container(
+      key: ValueKey(data.id),
+      margin: const EdgeInsets.only(bottom: 10),
+      padding: const EdgeInsets.all(10),
+      decoration: BoxDecoration(
+        color: colors.surfaceLight,
+        borderRadius: BorderRadius.circular(8),
+        border: Border.all(color: colors.border),
+      ),
+      child: Row(
+        children: [
+          Expanded(
+            flex: 3,
+            child: DropdownButtonFormField<RuleMetric>(
+              value: data.metric,
+              isDense: true,
+              onChanged: (m) {
+                setState(() => data.metric = m ?? RuleMetric.memory);
+                _notifyChange();
+              },
+              style: TextStyle(fontSize: 12, color: colors.textPrimary),
+              dropdownColor: colors.surface,
+              decoration: _inputDecoration(colors: colors, label: 'When'),
+              items: [
+                for (final m in RuleMetric.values)
+                  DropdownMenuItem<RuleMetric>(value: m, child: Text(m.label)),
+              ],
+            ),
+          ),
+          const SizedBox(width: 8),
+          Expanded(
+            flex: 2,
+            child: _buildNumberField(
+              colors: colors,
+              controller: data.thresholdController,
+              label: 'Above',
+              suffix: data.metric.unit,
+              decimals: true,
+            ),
+          ),
+          const SizedBox(width: 8),
+          Expanded(
+            flex: 2,
+            child: _buildNumberField(
+              colors: colors,
+              controller: data.sustainController,
+              label: 'For',
+              suffix: 's',
+            ),
+          ),
+          const SizedBox(width: 8),
+          Expanded(
+            flex: 4,
+            child: DropdownButtonFormField<RuleAction>(
+              value: data.action,
+              isDense: true,
+              onChanged: (a) {
+                setState(() => data.action = a ?? RuleAction.degrade);
+                _notifyChange();
+              },
+              style: TextStyle(fontSize: 12, color: colors.textPrimary),
+              dropdownColor: colors.surface,
+              decoration: _inputDecoration(colors: colors, label: 'Then'),
+              items: [
+                for (final a in RuleAction.values)
+                  DropdownMenuItem<RuleAction>(value: a, child: Text(a.label)),
+              ],
+            ),
+          ),
+          const SizedBox(width: 4),
+          IconButton(
+            icon: const Icon(Icons.close, size: 16),
+            onPressed: () => _removeEntry(index),
+            color: colors.textMuted,
+            style: IconButton.styleFrom(
+              padding: const EdgeInsets.all(4),
+              minimumSize: const Size(28, 28),
+            ),
+            tooltip: 'Remove rule',
+          ),
+        ],
+      ),
+    );
+  }
+
+  Widget _buildAddButton(AppColorScheme colors) {
+    return Padding(
+      padding: const EdgeInsets.all(12),
+      child: InkWell(
+        onTap: _addEntry,
+        borderRadius: BorderRadius.circular(8),
+        child: Container(
+          padding: const EdgeInsets.symmetric(vertical: 12),
+          decoration: BoxDecoration(
+            color: colors.surfaceLight.withValues(alpha: 0.5),
+            borderRadius: BorderRadius.circular(8),
+            border: Border.all(color: colors.border),
+          ),
+          child: Row(
+            mainAxisAlignment: MainAxisAlignment.center,
+            children: [
+              Container(
+                padding: const EdgeInsets.all(4),
+                decoration: BoxDecoration(
+                  color: AppColors.warning.withValues(alpha: 0.1),
+                  borderRadius: BorderRadius.circular(4),
+                ),
+                child: Icon(
+                  Icons.add,
+                  size: 16,
+                  color: AppColors.warning,
+                ),
+              ),
+              const SizedBox(width: 8),
+              Text(
+                'Add Rule',
+                style: TextStyle(
+                  fontSize: 12,
+                  fontWeight: FontWeight.w500,
+                  color: AppColors.warning,
+                ),
+              ),
+            ],
+          ),
+        ),
+      ),
+    );
+  }
+
+  Widget _buildNumberField({
+    required AppColorScheme colors,
+    required TextEditingController controller,
+    required String label,
+    String? suffix,
+    bool decimals = false,
+  }) {
+    return TextField(
+      controller: controller,
+      onChanged: (_) => _notifyChange(),
+      keyboardType: TextInputType.numberWithOptions(decimal: decimals),
+      inputFormatters: [
+        decimals
+            ? FilteringTextInputFormatter.allow(RegExp(r'[0-9.]'))
+            : FilteringTextInputFormatter.digitsOnly,
+      ],
+      style: TextStyle(
+        fontFamily: 'Consolas',
+        fontSize: 12,
+        color: colors.textPrimary,
+      ),
+      decoration: _inputDecoration(colors: colors, label: label, suffix: suffix),
+    );
+  }
+
+  InputDecoration _inputDecoration({
+    required AppColorScheme colors,
+    required String label,
+    String? suffix,
+  }) {
+    return InputDecoration(
+      labelText: label,
+      labelStyle: TextStyle(fontSize: 12, color: colors.textMuted),
+      suffixText: suffix == null || suffix.isEmpty ? null : suffix,
+      suffixStyle: TextStyle(fontSize: 11, color: colors.textMuted),
+      filled: true,
+      fillColor: colors.surface,
+      isDense: true,
+      contentPadding:
+          const EdgeInsets.symmetric(horizontal: 10, vertical: 10),
+      border: OutlineInputBorder(
+        borderRadius: BorderRadius.circular(6),
+        borderSide: BorderSide(color: colors.border),
+      ),
+      enabledBorder: OutlineInputBorder(
+        borderRadius: BorderRadius.circular(6),
+        borderSide: BorderSide(color: colors.border),
+      ),
+      focusedBorder: OutlineInputBorder(
+        borderRadius: BorderRadius.circular(6),
+        borderSide: const BorderSide(color: AppColors.info, width: 1.5),
+      ),
+    );
+  }
+}
+
+/// Editable state of one rule row
+class _RuleEditData {
+  final String id;
+  RuleMetric metric;
+  RuleAction action;
+  final TextEditingController thresholdController;
+  final TextEditingController sustainController;
+
+  _RuleEditData({
+    required this.id,
+    required this.metric,
+    required this.action,
+    required this.thresholdController,
+    required this.sustainController,
+  });
+
+  factory _RuleEditData.from(String id, ResourceRule rule) {
+    final threshold = rule.threshold == rule.threshold.roundToDouble()
+        ? rule.threshold.toInt().toString()
+        : rule.threshold.toString();
+    return _RuleEditData(
+      id: id,
+      metric: rule.metric,
+      action: rule.action,
+      thresholdController: TextEditingController(text: threshold),
+      sustainController:
+          TextEditingController(text: '${rule.sustainSeconds}'),
+    );
+  }
+
+  void dispose() {
+    thresholdController.dispose();
+    sustainController.dispose();
+  }
+}
@@ -0,0 +1,356 @@
+import 'package:flutter/material.dart';
+import 'package:flutter/services.dart';
+import '../models/restart_policy.dart';
+import '../theme/app_colors.dart';
+import '../theme/app_theme.dart';
+
+/// Widget for editing a template's supervisor restart policy
+class RestartPolicyEditor extends StatefulWidget {
+  final RestartPolicy policy;
+  final ValueChanged<RestartPolicy> onChanged;
+  final bool initiallyExpanded;
+
+  const RestartPolicyEditor({
+    super.key,
+    required this.policy,
+    required this.onChanged,
+    this.initiallyExpanded = false,
+  });
+
+  @override
+  State<RestartPolicyEditor> createState() => _RestartPolicyEditorState();
+}
+
+class _RestartPolicyEditorState extends State<RestartPolicyEditor>
+    with SingleTickerProviderStateMixin {
+  late bool _isExpanded;
+  late RestartMode _mode;
+  late bool _restartOnProbeFailure;
+  late final TextEditingController _initialController;
+  late final TextEditingController _maxController;
+  late final TextEditingController _failuresController;
+  late final TextEditingController _windowController;
+  late AnimationController _expandController;
+  late Animation<double> _expandAnimation;
+
+  @override
+  void initState() {
+    super.initState();
+    final p = widget.policy;
+    _isExpanded = widget.initiallyExpanded || p.isEnabled;
+    _mode = p.mode;
+    _restartOnProbeFailure = p.restartOnProbeFailure;
+    _initialController = TextEditingController(text: '${p.initialBackoffMs}');
+    _maxController = TextEditingController(text: '${p.maxBackoffMs}');
+    _failuresController = TextEditingController(text: '${p.maxFailures}');
+    _windowController = TextEditingController(text: '${p.failureWindowSeconds}');
+
+    _expandController = AnimationController(
+      duration: const Duration(milliseconds: 200),
+      vsync: this,
+    );
+    _expandAnimation = CurvedAnimation(
+      parent: _expandController,
+      curve: Curves.easeOutCubic,
+    );
+
+    if (_isExpanded) {
+      _expandController.value = 1.0;
+    }
+  }
+
+  @override
+  void dispose() {
+    _expandController.dispose();
+    _initialController.dispose();
+    _maxController.dispose();
+    _failuresController.dispose();
+    _windowController.dispose();
+    super.dispose();
+  }
+
+  void _toggleExpanded() {
+    setState(() {
+      _isExpanded = !_isExpanded;
+      if (_isExpanded) {
+        _expandController.forward();
+      } else {
+        _expandController.reverse();
+      }
+    });
+  }
+
+  int _parse(TextEditingController controller, int fallback) {
+    final value = int.tryParse(controller.text.trim());
+    return value == null || value <= 0 ? fallback : value;
+  }
+
+  void _notifyChange() {
+    setState(() {});
+    const defaults = RestartPolicy.none;
+    widget.onChanged(RestartPolicy(
+      mode: _mode,
+      initialBackoffMs: _parse(_initialController, defaults.initialBackoffMs),
+      maxBackoffMs: _parse(_maxController, defaults.maxBackoffMs),
+      maxFailures: _parse(_failuresController, defaults.maxFailures),
+      failureWindowSeconds:
+          _parse(_windowController, defaults.failureWindowSeconds),
+      restartOnProbeFailure: _restartOnProbeFailure,
+    ));
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    final colors = AppColorsExtension.of(context);
+    final enabled = _mode != RestartMode.never;
+
+    return Container(
+      decoration: BoxDecoration(
+        color: colors.surface,
+        borderRadius: BorderRadius.circular(10),
+        border: Border.all(color: colors.border),
+      ),
+      child: Column(
+        crossAxisAlignment: CrossAxisAlignment.start,
+        children: [
+          _buildHeader(colors),
+          SizeTransition(
+            sizeFactor: _expandAnimation,
+            child: Padding(
+              padding: const EdgeInsets.all(12),
+              child: Column(
+                crossAxisAlignment: CrossAxisAlignment.start,
+                children: [
+                  Text(
+                    'Restart the command when it exits. The delay doubles with '
+                    'each recent failure; after too many failures in the window '
+                    'the task is left stopped.',
+                    style: TextStyle(
+                      fontSize: 11,
+                      color: colors.textSecondary,
+                      height: 1.5,
+                    ),
+                  ),
+                  const SizedBox(height: 12),
+                  DropdownButtonFormField<RestartMode>(
+                    value: _mode,
+                    isDense: true,
+                    onChanged: (m) {
+                      _mode = m ?? RestartMode.never;
+                      _notifyChange();
+                    },
+                    style: TextStyle(fontSize: 12, color: colors.textPrimary),
+                    dropdownColor: colors.surface,
+                    decoration: _inputDecoration(colors: colors, label: 'Restart'),
+                    items: [
+                      for (final m in RestartMode.values)
+                        DropdownMenuItem<RestartMode>(value: m, child: Text(m.label)),
+                    ],
+                  ),
+                  if (enabled) ...[
+                    const SizedBox(height: 10),
+                    Row(
+                      children: [
+                        Expanded(
+                          child: _buildNumberField(
+                            colors: colors,
+                            controller: _initialController,
+                            label: 'First delay',
+                            suffix: 'ms',
+                          ),
+                        ),
+                        const SizedBox(width: 10),
+                        Expanded(
+                          child: _buildNumberField(
+                            colors: colors,
+                            controller: _maxController,
+                            label: 'Max delay',
+                            suffix: 'ms',
+                          ),
+                        ),
+                        const SizedBox(width: 10),
+                        Expanded(
+                          child: _buildNumberField(
+                            colors: colors,
+                            controller: _failuresController,
+                            label: 'Give up after',
+                            suffix: 'failures',
+                          ),
+                        ),
+                        const SizedBox(width: 10),
+                        Expanded(
+                          child: _buildNumberField(
+                            colors: colors,
+                            controller: _windowController,
+                            label: 'Within',
+                            suffix: 's',
+                          ),
+                        ),
+                      ],
+                    ),
+                    const SizedBox(height: 6),
+                    InkWell(
+                      onTap: () {
+                        _restartOnProbeFailure = !_restartOnProbeFailure;
+                        _notifyChange();
+                      },
+                      borderRadius: BorderRadius.circular(6),
+                      child: Row(
+                        children: [
+                          Checkbox(
+                            value: _restartOnProbeFailure,
+                            visualDensity: VisualDensity.compact,
+                            onChanged: (v) {
+                              _restartOnProbeFailure = v ?? false;
+                              _notifyChange();
+                            },
+                          ),
+                          Text(
+                            'Also restart when the readiness probe stops answering',
+                            style: TextStyle(
+                              fontSize: 12,
+                              color: colors.textSecondary,
+                            ),
+                          ),
+                        ],
+                      ),
+                    ),
+                  ],
+                ],
+              ),
+            ),
+          ),
+        ],
+      ),
+    );
+  }
+
+  Widget _buildHeader(AppColorScheme colors) {
+    final active = _mode != RestartMode.never;
+
+    return InkWell(
+      onTap: _toggleExpanded,
+      borderRadius: BorderRadius.vertical(
+        top: const Radius.circular(10),
+        bottom: _isExpanded ? Radius.zero : const Radius.circular(10),
+      ),
+      child: Container(
+        padding: const EdgeInsets.symmetric(horizontal: 14, vertical: 12),
+        decoration: BoxDecoration(
+          color: colors.surfaceLight,
+          borderRadius: BorderRadius.vertical(
+            top: const Radius.circular(10),
+            bottom: _isExpanded ? Radius.zero : const Radius.circular(10),
+          ),
+        ),
+        child: Row(
+          children: [
+            Container(
+              padding: const EdgeInsets.all(6),
+              decoration: BoxDecoration(
+                color: active
+                    ? AppColors.warning.withValues(alpha: 0.15)
+                    : colors.surface,
+                borderRadius: BorderRadius.circular(6),
+                border: Border.all(
+                  color: active
+                      ? AppColors.warning.withValues(alpha: 0.3)
+                      : colors.border,
+                ),
+              ),
+              child: Icon(
+                Icons.restart_alt,
+                size: 16,
+                color: active ? AppColors.warning : colors.textMuted,
+              ),
+            ),
+            const SizedBox(width: 12),
+            Expanded(
+              child: Column(
+                crossAxisAlignment: CrossAxisAlignment.start,
+                children: [
+                  Text(
+                    'Auto Restart',
+                    style: TextStyle(
+                      fontSize: 13,
+                      fontWeight: FontWeight.w600,
+                      color: colors.textPrimary,
+                    ),
+                  ),
+                  Text(
+                    active
+                        ? _mode.label
+                        : 'Optional - restart the command when it crashes',
+                    style: TextStyle(
+                      fontSize: 11,
+                      color: colors.textMuted,
+                    ),
+                  ),
+                ],
+              ),
+            ),
+            AnimatedRotation(
+              turns: _isExpanded ? 0.5 : 0,
+              duration: const Duration(milliseconds: 200),
+              child: Icon(
+                Icons.keyboard_arrow_down,
+                size: 20,
+                color: colors.textMuted,
+              ),
+            ),
+          ],
+        ),
+      ),
+    );
+  }
+
+  Widget _buildNumberField({
+    required AppColorScheme colors,
+    required TextEditingController controller,
+    required String label,
+    String? suffix,
+  }) {
+    return TextField(
+      controller: controller,
+      onChanged: (_) => _notifyChange(),
+      keyboardType: TextInputType.number,
+      inputFormatters: [FilteringTextInputFormatter.digitsOnly],
+      style: TextStyle(
+        fontFamily: 'Consolas',
+        fontSize: 12,
+        color: colors.textPrimary,
+      ),
+      decoration: _inputDecoration(colors: colors, label: label, suffix: suffix),
+    );
+  }
+
+  InputDecoration _inputDecoration({
+    required AppColorScheme colors,
+    required String label,
+    String? suffix,
+  }) {
+    return InputDecoration(
+      labelText: label,
+      labelStyle: TextStyle(fontSize: 12, color: colors.textMuted),
+      suffixText: suffix,
+      suffixStyle: TextStyle(fontSize: 11, color: colors.textMuted),
+      filled: true,
+      fillColor: colors.surfaceLight,
+      isDense: true,
+      contentPadding:
+          const EdgeInsets.symmetric(horizontal: 10, vertical: 10),
+      border: OutlineInputBorder(
+        borderRadius: BorderRadius.circular(6),
+        borderSide: BorderSide(color: colors.border),
+      ),
+      enabledBorder: OutlineInputBorder(
+        borderRadius: BorderRadius.circular(6),
+        borderSide: BorderSide(color: colors.border),
+      ),
+      focusedBorder: OutlineInputBorder(
+        borderRadius: BorderRadius.circular(6),
+        borderSide: const BorderSide(color: AppColors.info, width: 1.5),
+      ),
+    );
+  }
+}
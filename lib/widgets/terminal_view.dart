@@ -31,6 +31,29 @@ class TerminalView extends StatefulWidget {
 }
 
 class _TerminalViewState extends State<TerminalView> {
+  // While attached, xterm parses the task's output; hidden tasks are only
+  // parsed natively and catch up from a snapshot when shown again
+  @override
+  void initState() {
+    super.initState();
+    widget.task.terminal.attachView();
+  }
+
+  @override
+  void didUpdateWidget(TerminalView oldWidget) {
+    super.didUpdateWidget(oldWidget);
+    if (!identical(oldWidget.task, widget.task)) {
+      oldWidget.task.terminal.detachView();
+      widget.task.terminal.attachView();
+    }
+  }
+
+  @override
+  void dispose() {
+    widget.task.terminal.detachView();
+    super.dispose();
+  }
+
   /// Get the template associated with this task
   Template? get _template {
     final templateId = widget.task.templateId;
@@ -227,6 +250,7 @@ class _TerminalViewState extends State<TerminalView> {
             for (final action in quickActions) ...[
               _QuickActionButton(
                 action: action,
+                nextFire: widget.task.nextScheduledFire(action),
                 theme: theme,
                 onTap: () => _executeQuickAction(action),
                 onSecondaryTap: _manageQuickActions,
@@ -247,6 +271,28 @@ class _TerminalViewState extends State<TerminalView> {
             ),
             SizedBox(width: sizes.terminalDragIconSize / 3),
           ],
+          // Degraded badge (a resource rule is breached)
+          if (widget.task.isDegraded) ...[
+            Tooltip(
+              message: widget.task.degradedReason!,
+              child: Container(
+                padding: EdgeInsets.symmetric(horizontal: sizes.terminalPidFontSize * 0.6, vertical: sizes.terminalPidFontSize * 0.2),
+                decoration: BoxDecoration(
+                  color: AppColors.warning.withValues(alpha: 0.15),
+                  borderRadius: BorderRadius.circular(4),
+                ),
+                child: Text(
+                  'DEGRADED',
+                  style: TextStyle(
+                    color: AppColors.warning,
+                    fontSize: sizes.terminalPidFontSize,
+                    fontWeight: FontWeight.w600,
+                  ),
+                ),
+              ),
+            ),
+            SizedBox(width: sizes.terminalHeaderHeight / 3.5),
+          ],
           // PID badge
           if (widget.task.pid != null) ...[
             GestureDetector(
@@ -285,6 +331,24 @@ class _TerminalViewState extends State<TerminalView> {
           SizedBox(width: sizes.terminalDragIconSize / 3),
           // Action buttons
           if (widget.task.isRunning) ...[
+            _HeaderIconButton(
+              icon: widget.task.isSuspended ? Icons.play_arrow : Icons.pause,
+              tooltip: widget.task.isSuspended
+                  ? 'Resume process tree'
+                  : 'Suspend process tree',
+              color: widget.task.isSuspended
+                  ? AppColors.info
+                  : theme.foreground.withValues(alpha: 0.5),
+              onTap: () {
+                if (widget.task.isSuspended) {
+                  core.tasks.resume(widget.task.id);
+                } else {
+                  core.tasks.suspend(widget.task.id);
+                }
+              },
+              iconSize: sizes.terminalActionIconSize,
+            ),
+            SizedBox(width: sizes.terminalDragIconSize / 3),
             _HeaderIconButton(
               icon: Icons.stop,
               tooltip: 'Stop (Ctrl+C)',
@@ -358,6 +422,7 @@ class _HeaderIconButton extends StatelessWidget {
 /// Button for quick actions showing emoji only
 class _QuickActionButton extends StatelessWidget {
   final QuickAction action;
+  final DateTime? nextFire; // Next scheduled run, while the schedule is active
   final TerminalTheme theme;
   final VoidCallback onTap;
   final VoidCallback onSecondaryTap;
@@ -365,6 +430,7 @@ class _QuickActionButton extends StatelessWidget {
 
   const _QuickActionButton({
     required this.action,
+    this.nextFire,
     required this.theme,
     required this.onTap,
     required this.onSecondaryTap,
@@ -374,8 +440,10 @@ class _QuickActionButton extends StatelessWidget {
   @override
   Widget build(BuildContext context) {
     final size = emojiSize ?? 12.0;
+    final next = nextFire;
     final tooltip = action.isScheduled
         ? '${action.name}: ${action.command}\n${action.scheduleDescription}'
+            '${next != null ? '\nNext: ${next.month}/${next.day} ${next.hour.toString().padLeft(2, '0')}:${next.minute.toString().padLeft(2, '0')}' : ''}'
         : '${action.name}: ${action.command}';
     return Tooltip(
       message: tooltip,
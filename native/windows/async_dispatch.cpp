@@ -0,0 +1,163 @@
+#include "async_dispatch.h"
+#include <windows.h>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+struct AsyncRequest {
+    int64_t id = 0;
+    AsyncToken token;
+    std::function<int64_t(const AsyncToken&)> work;
+    HANDLE delayWait = NULL; // async_delay: wait on the cancel event, timing out when due
+
+    ~AsyncRequest() {
+        if (token.cancelEvent != NULL) {
+            CloseHandle(token.cancelEvent);
+        }
+    }
+};
+
+std::mutex g_mutex;
+std::map<int64_t, std::shared_ptr<AsyncRequest>> g_requests; // Submitted or running
+std::atomic<AsyncCompletionCallback> g_callback(nullptr);
+int64_t g_nextRequestId = 1;
+
+void Complete(int64_t requestId, int64_t result) {
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_requests.erase(requestId);
+    }
+    AsyncCompletionCallback callback = g_callback.load();
+    if (callback != nullptr) {
+        callback(requestId, result);
+    }
+}
+
+// Runs one request on the OS thread pool. Jobs mostly wait on processes and
+// deadlines, so each tells the pool it may run long: the pool then adds
+// threads instead of queueing the next job behind it.
+void CALLBACK RunRequest(PTP_CALLBACK_INSTANCE instance, PVOID context) {
+    int64_t requestId = (int64_t)(intptr_t)context;
+    std::shared_ptr<AsyncRequest> request;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto it = g_requests.find(requestId);
+        if (it == g_requests.end()) {
+            return;
+        }
+        request = it->second;
+    }
+    CallbackMayRunLong(instance);
+
+    // Cancelled before it started: nothing to run
+    int64_t result = request->token.cancelled ? ASYNC_RESULT_CANCELLED : request->work(request->token);
+    if (request->token.cancelled) {
+        result = ASYNC_RESULT_CANCELLED;
+    }
+    Complete(requestId, result);
+}
+
+// Fires once: timedOut when the delay elapsed, otherwise the request was cancelled
+void CALLBACK OnDelayElapsed(PVOID context, BOOLEAN timedOut) {
+    int64_t requestId = (int64_t)(intptr_t)context;
+    std::shared_ptr<AsyncRequest> request;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto it = g_requests.find(requestId);
+        if (it == g_requests.end()) {
+            return;
+        }
+        request = it->second;
+    }
+    UnregisterWait(request->delayWait); // Non-blocking form, we are inside the callback
+    Complete(requestId, timedOut ? 0 : ASYNC_RESULT_CANCELLED);
+}
+
+} // namespace
+
+bool async_wait_cancelled(const AsyncToken& token, DWORD ms) {
+    if (token.cancelled) {
+        return true;
+    }
+    WaitForSingleObject(token.cancelEvent, ms);
+    return token.cancelled;
+}
+
+int64_t async_submit(std::function<int64_t(const AsyncToken&)> work) {
+    if (g_callback.load() == nullptr) {
+        return 0;
+    }
+
+    auto request = std::make_shared<AsyncRequest>();
+    request->token.cancelEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+    if (request->token.cancelEvent == NULL) {
+        return 0;
+    }
+    request->work = std::move(work);
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+    request->id = g_nextRequestId++;
+    g_requests[request->id] = request;
+    // Submitted under the lock so the callback cannot run before the request is findable
+    if (!TrySubmitThreadpoolCallback(RunRequest, (PVOID)(intptr_t)request->id, NULL)) {
+        g_requests.erase(request->id);
+        return 0;
+    }
+    return request->id;
+}
+
+extern "C" {
+
+// Register the Dart completion callback (NULL to detach)
+__declspec(dllexport) void async_set_completion_callback(AsyncCompletionCallback callback) {
+    g_callback.store(callback);
+}
+
+// Cancel a submitted or running request
+__declspec(dllexport) bool async_cancel(int64_t requestId) {
+    std::shared_ptr<AsyncRequest> request;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto it = g_requests.find(requestId);
+        if (it == g_requests.end()) {
+            return false;
+        }
+        request = it->second;
+    }
+
+    request->token.cancelled = true;
+    SetEvent(request->token.cancelEvent);
+    return true;
+}
+
+// Complete after delayMs without occupying a worker (posts 0, or ASYNC_RESULT_CANCELLED)
+__declspec(dllexport) int64_t async_delay(int32_t delayMs) {
+    if (g_callback.load() == nullptr) {
+        return 0;
+    }
+    auto request = std::make_shared<AsyncRequest>();
+    request->token.cancelEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+    if (request->token.cancelEvent == NULL) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+    request->id = g_nextRequestId++;
+    // Registered under the lock so the callback cannot run before the request is findable
+    if (!RegisterWaitForSingleObject(&request->delayWait, request->token.cancelEvent, OnDelayElapsed,
+            (PVOID)(intptr_t)request->id, (DWORD)max(delayMs, 0), WT_EXECUTEONLYONCE)) {
+        return 0;
+    }
+    g_requests[request->id] = request;
+    return request->id;
+}
+
+// Number of requests submitted or running
+__declspec(dllexport) int async_pending_count() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    return (int)g_requests.size();
+}
+
+}
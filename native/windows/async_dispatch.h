@@ -0,0 +1,41 @@
+#ifndef ASYNC_DISPATCH_H
+#define ASYNC_DISPATCH_H
+
+#include <windows.h>
+#include <stdint.h>
+#include <atomic>
+#include <functional>
+
+// Completion callback registered from Dart (a NativeCallable.listener), invoked on a worker thread
+typedef void (*AsyncCompletionCallback)(int64_t requestId, int64_t result);
+
+// Result posted for a request that was cancelled before it finished
+#define ASYNC_RESULT_CANCELLED (-1)
+
+extern "C" {
+    __declspec(dllexport) void async_set_completion_callback(AsyncCompletionCallback callback);
+    // Request cancellation. Requests that have not started complete with
+    // ASYNC_RESULT_CANCELLED without running; running ones stop at their next wait.
+    // Returns false if the request is unknown or finished.
+    __declspec(dllexport) bool async_cancel(int64_t requestId);
+    __declspec(dllexport) int async_pending_count();
+    // Cancellable timer on the OS thread pool: completes with 0 after delayMs.
+    // Returns the request id (0 if no callback is registered).
+    __declspec(dllexport) int64_t async_delay(int32_t delayMs);
+}
+
+// Internal: cancellation state handed to every job
+struct AsyncToken {
+    std::atomic<bool> cancelled{false};
+    HANDLE cancelEvent = NULL; // Manual-reset, signalled on cancel
+};
+
+// Wait up to ms. Returns true if the request was cancelled meanwhile.
+bool async_wait_cancelled(const AsyncToken& token, DWORD ms);
+
+// Run work on the OS thread pool, which adds threads as jobs block, so long waits
+// run side by side instead of queueing behind each other. Returns the request id
+// (0 if no callback is registered).
+int64_t async_submit(std::function<int64_t(const AsyncToken&)> work);
+
+#endif // ASYNC_DISPATCH_H
@@ -0,0 +1,159 @@
+#include "conpty.h"
+#include "io_reactor.h"
+#include <windows.h>
+#include <string>
+#include <vector>
+
+static std::wstring Utf8ToWide(const char* text) {
+    int length = MultiByteToWideChar(CP_UTF8, 0, text, -1, NULL, 0);
+    if (length <= 0) {
+        return std::wstring();
+    }
+    std::wstring wide(length, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, text, -1, &wide[0], length);
+    wide.resize(length - 1); // Drop the terminator counted by -1
+    return wide;
+}
+
+bool conpty_spawn(const std::string& commandLine, const char* working_dir,
+    short cols, short rows, DWORD creationFlags, ConPtyProcess* out, const void* environment,
+    const char* application, bool overlappedOutput) {
+
+    HANDLE inputRead = NULL, inputWrite = NULL;
+    HANDLE outputRead = NULL, outputWrite = NULL;
+
+    if (!CreatePipe(&inputRead, &inputWrite, NULL, 0)) {
+        return false;
+    }
+    bool created = overlappedOutput
+        ? io_create_pipe(&outputRead, &outputWrite, false, 0)
+        : CreatePipe(&outputRead, &outputWrite, NULL, 0) != FALSE;
+    if (!created) {
+        CloseHandle(inputRead);
+        CloseHandle(inputWrite);
+        return false;
+    }
+
+    COORD size = { cols > 0 ? cols : (short)80, rows > 0 ? rows : (short)24 };
+    HPCON hpc = NULL;
+    HRESULT hr = CreatePseudoConsole(size, inputRead, outputWrite, 0, &hpc);
+
+    // The pseudo console duplicates its ends of the pipes
+    CloseHandle(inputRead);
+    CloseHandle(outputWrite);
+
+    if (FAILED(hr)) {
+        CloseHandle(inputWrite);
+        CloseHandle(outputRead);
+        return false;
+    }
+
+    // Build the attribute list that attaches the child to the pseudo console
+    SIZE_T attrSize = 0;
+    InitializeProcThreadAttributeList(NULL, 1, 0, &attrSize);
+    std::vector<BYTE> attrBuffer(attrSize);
+    LPPROC_THREAD_ATTRIBUTE_LIST attrList =
+        reinterpret_cast<LPPROC_THREAD_ATTRIBUTE_LIST>(attrBuffer.data());
+
+    if (!InitializeProcThreadAttributeList(attrList, 1, 0, &attrSize) ||
+        !UpdateProcThreadAttribute(attrList, 0, PROC_THREAD_ATTRIBUTE_PSEUDOCONSOLE,
+            hpc, sizeof(hpc), NULL, NULL)) {
+        ClosePseudoConsole(hpc);
+        CloseHandle(inputWrite);
+        CloseHandle(outputRead);
+        return false;
+    }
+
+    STARTUPINFOEXW si;
+    ZeroMemory(&si, sizeof(si));
+    si.StartupInfo.cb = sizeof(si);
+    si.lpAttributeList = attrList;
+
+    PROCESS_INFORMATION pi;
+    ZeroMemory(&pi, sizeof(pi));
+
+    // Mutable wide copy of the command (CreateProcessW may modify it)
+    std::wstring cmd = Utf8ToWide(commandLine.c_str());
+    std::wstring dir = working_dir != nullptr ? Utf8ToWide(working_dir) : std::wstring();
+    std::wstring image = application != nullptr ? Utf8ToWide(application) : std::wstring();
+
+    BOOL result = CreateProcessW(
+        image.empty() ? NULL : image.c_str(),
+        &cmd[0],
+        NULL,
+        NULL,
+        FALSE,
+        EXTENDED_STARTUPINFO_PRESENT | creationFlags,
+        const_cast<void*>(environment),
+        dir.empty() ? NULL : dir.c_str(),
+        &si.StartupInfo,
+        &pi
+    );
+
+    DeleteProcThreadAttributeList(attrList);
+
+    if (!result) {
+        ClosePseudoConsole(hpc);
+        CloseHandle(inputWrite);
+        CloseHandle(outputRead);
+        return false;
+    }
+
+    out->hpc = hpc;
+    out->inputWrite = inputWrite;
+    out->outputRead = outputRead;
+    out->hProcess = pi.hProcess;
+    out->hThread = pi.hThread;
+    out->processId = pi.dwProcessId;
+    return true;
+}
+
+bool conpty_write(ConPtyProcess* proc, const char* data, DWORD length) {
+    if (proc == nullptr || proc->inputWrite == NULL) {
+        return false;
+    }
+
+    DWORD written = 0;
+    while (length > 0) {
+        if (!WriteFile(proc->inputWrite, data, length, &written, NULL)) {
+            return false;
+        }
+        data += written;
+        length -= written;
+    }
+    return true;
+}
+
+void conpty_close_console(ConPtyProcess* proc) {
+    if (proc == nullptr || proc->hpc == NULL) {
+        return;
+    }
+
+    // Closing the pseudo console terminates attached clients and breaks the output pipe
+    ClosePseudoConsole(proc->hpc);
+    proc->hpc = NULL;
+}
+
+void conpty_release(ConPtyProcess* proc) {
+    if (proc == nullptr) {
+        return;
+    }
+
+    conpty_close_console(proc);
+    if (proc->inputWrite != NULL) {
+        CloseHandle(proc->inputWrite);
+        proc->inputWrite = NULL;
+    }
+    if (proc->outputRead != NULL) {
+        CloseHandle(proc->outputRead);
+        proc->outputRead = NULL;
+    }
+    if (proc->hThread != NULL) {
+        CloseHandle(proc->hThread);
+        proc->hThread = NULL;
+    }
+    if (proc->hProcess != NULL) {
+        CloseHandle(proc->hProcess);
+        proc->hProcess = NULL;
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef CONPTY_H
+#define CONPTY_H
+
+#include <windows.h>
+#include <string>
+
+// Internal helper (not exported): a child process hosted in a Windows pseudo console.
+// Requires Windows 10 1809+ (CreatePseudoConsole).
+struct ConPtyProcess {
+    HPCON hpc = NULL;
+    HANDLE inputWrite = NULL;   // Write end of the child's console input
+    HANDLE outputRead = NULL;   // Read end of the child's console output
+    HANDLE hProcess = NULL;
+    HANDLE hThread = NULL;
+    DWORD processId = 0;
+};
+
+// Spawn commandLine attached to a new pseudo console of cols x rows.
+// commandLine and working_dir are UTF-8. creationFlags is OR-ed into the
+// CreateProcess flags (e.g. CREATE_SUSPENDED). environment is an optional
+// environment block; pass CREATE_UNICODE_ENVIRONMENT if it is UTF-16.
+// application is an optional UTF-8 image path; when set, no search is done
+// and commandLine is passed to the child verbatim as its argv.
+// overlappedOutput makes outputRead an overlapped handle (for the I/O
+// reactor); it must then not be read synchronously.
+bool conpty_spawn(const std::string& commandLine, const char* working_dir,
+    short cols, short rows, DWORD creationFlags, ConPtyProcess* out,
+    const void* environment = NULL, const char* application = NULL,
+    bool overlappedOutput = false);
+
+// Write raw bytes to the child's console input
+bool conpty_write(ConPtyProcess* proc, const char* data, DWORD length);
+
+// Close the pseudo console. Attached clients are terminated and any reader
+// blocked on outputRead receives EOF, so it can be joined afterwards.
+void conpty_close_console(ConPtyProcess* proc);
+
+// Close the pseudo console (if still open) and release all handles.
+// Must not be called while another thread is still reading outputRead.
+void conpty_release(ConPtyProcess* proc);
+
+#endif // CONPTY_H
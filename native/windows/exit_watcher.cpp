@@ -0,0 +1,419 @@
+#include "exit_watcher.h"
+#include "job_stats.h"
+#include <windows.h>
+#include <map>
+#include <memory>
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <vector>
+
+namespace {
+
+struct ExitWatch {
+    int64_t id = 0;
+    int64_t jobKey = 0; // Route of the watched job, 0 without one
+    DWORD rootProcessId = 0;
+    HANDLE hRoot = NULL;
+    HANDLE rootWait = NULL;
+    bool jobAssociated = false;
+    bool treeExited = false;
+    std::map<DWORD, HANDLE> members; // Open handles so exit codes survive the exit
+    std::set<DWORD> rootChildren;    // Members whose parent is the root
+};
+
+// A job keeps the first completion port it is associated with for life, so each job
+// is associated once and its notifications are fanned out to every watch of it
+struct JobRoute {
+    std::set<int64_t> watchIds;
+    std::set<DWORD> processes; // Active members, kept while the job outlives its watches
+};
+
+// Leading fields of PROCESS_BASIC_INFORMATION (winternl.h hides the parent id)
+struct BasicProcessInfo {
+    LONG exitStatus;
+    PVOID pebBaseAddress;
+    ULONG_PTR affinityMask;
+    LONG basePriority;
+    ULONG_PTR uniqueProcessId;
+    ULONG_PTR inheritedFromUniqueProcessId;
+};
+typedef LONG (NTAPI *NtQueryInformationProcessFn)(HANDLE, ULONG, PVOID, ULONG, PULONG);
+
+std::mutex g_mutex;
+std::map<int64_t, std::shared_ptr<ExitWatch>> g_watches;
+int64_t g_nextWatchId = 1;
+std::map<int64_t, JobRoute> g_routes; // By completion key
+int64_t g_nextJobKey = 1;
+std::atomic<ExitEventCallback> g_callback(nullptr);
+std::atomic<JobLimitCallback> g_limitCallback(nullptr);
+HANDLE g_port = NULL; // Completion port shared by every watched job
+
+int64_t FileTimeToUnixMs(const FILETIME& time) {
+    ULARGE_INTEGER value;
+    value.LowPart = time.dwLowDateTime;
+    value.HighPart = time.dwHighDateTime;
+    // FILETIME counts 100 ns intervals since 1601-01-01
+    return (int64_t)((value.QuadPart - 116444736000000000ULL) / 10000ULL);
+}
+
+int64_t NowUnixMs() {
+    FILETIME now;
+    GetSystemTimeAsFileTime(&now);
+    return FileTimeToUnixMs(now);
+}
+
+// Exit code and exit time of a finished process (falls back to "now" if unavailable)
+void ReadExit(HANDLE hProcess, int32_t* exitCode, int64_t* timestampMs) {
+    DWORD code = 0;
+    *exitCode = (hProcess != NULL && GetExitCodeProcess(hProcess, &code)) ? (int32_t)code : -1;
+
+    FILETIME creation, exit, kernel, user;
+    if (hProcess != NULL && GetProcessTimes(hProcess, &creation, &exit, &kernel, &user)) {
+        *timestampMs = FileTimeToUnixMs(exit);
+    } else {
+        *timestampMs = NowUnixMs();
+    }
+}
+
+void Post(int64_t watchId, DWORD processId, int32_t exitCode, int64_t timestampMs, ExitEventKind kind) {
+    ExitEventCallback callback = g_callback.load();
+    if (callback != nullptr) {
+        callback(watchId, processId, exitCode, timestampMs, kind);
+    }
+}
+
+void PostLimit(int64_t watchId, DWORD processId, JobLimitKind kind) {
+    JobLimitCallback callback = g_limitCallback.load();
+    if (callback != nullptr) {
+        callback(watchId, processId, kind);
+    }
+}
+
+std::shared_ptr<ExitWatch> FindWatch(int64_t watchId) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    auto it = g_watches.find(watchId);
+    return it != g_watches.end() ? it->second : nullptr;
+}
+
+// Forget a watch and release its handles. fromRootCallback must be true when called
+// from the root wait callback itself, where a blocking unregister would deadlock.
+void RemoveWatch(int64_t watchId, bool fromRootCallback) {
+    std::shared_ptr<ExitWatch> watch;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto it = g_watches.find(watchId);
+        if (it == g_watches.end()) {
+            return;
+        }
+        watch = it->second;
+        g_watches.erase(it);
+
+        auto route = g_routes.find(watch->jobKey);
+        if (route != g_routes.end()) {
+            route->second.watchIds.erase(watchId);
+            if (route->second.watchIds.empty() && route->second.processes.empty()) {
+                g_routes.erase(route);
+            }
+        }
+    }
+
+    if (watch->rootWait != NULL) {
+        if (fromRootCallback) {
+            UnregisterWait(watch->rootWait);
+        } else {
+            UnregisterWaitEx(watch->rootWait, INVALID_HANDLE_VALUE);
+        }
+    }
+    if (watch->hRoot != NULL) {
+        CloseHandle(watch->hRoot);
+    }
+    for (auto& member : watch->members) {
+        CloseHandle(member.second);
+    }
+}
+
+// Post the tree-exit event once
+void TreeExited(const std::shared_ptr<ExitWatch>& watch, int32_t exitCode, int64_t timestampMs, bool fromRootCallback) {
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        if (watch->treeExited) {
+            return;
+        }
+        watch->treeExited = true;
+    }
+    Post(watch->id, watch->rootProcessId, exitCode, timestampMs, EXIT_EVENT_TREE);
+    RemoveWatch(watch->id, fromRootCallback);
+}
+
+void CALLBACK OnRootExit(PVOID context, BOOLEAN) {
+    auto watch = FindWatch((int64_t)(intptr_t)context);
+    if (!watch) {
+        return;
+    }
+
+    int32_t exitCode;
+    int64_t timestampMs;
+    ReadExit(watch->hRoot, &exitCode, &timestampMs);
+    Post(watch->id, watch->rootProcessId, exitCode, timestampMs, EXIT_EVENT_ROOT);
+
+    // Without a job the root is the only thing we can observe
+    if (!watch->jobAssociated) {
+        TreeExited(watch, exitCode, timestampMs, true);
+    }
+}
+
+DWORD ParentProcessId(HANDLE hProcess) {
+    static auto query = reinterpret_cast<NtQueryInformationProcessFn>(
+        GetProcAddress(GetModuleHandleA("ntdll.dll"), "NtQueryInformationProcess"));
+    BasicProcessInfo info = {};
+    if (query == nullptr || query(hProcess, 0 /* ProcessBasicInformation */, &info, sizeof(info), NULL) < 0) {
+        return 0;
+    }
+    return (DWORD)info.inheritedFromUniqueProcessId;
+}
+
+void TrackMember(const std::shared_ptr<ExitWatch>& watch, DWORD processId) {
+    if (processId == watch->rootProcessId) {
+        return; // Root has its own wait
+    }
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (watch->members.count(processId)) {
+        return;
+    }
+    HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+    if (hProcess != NULL) {
+        watch->members[processId] = hProcess;
+        if (ParentProcessId(hProcess) == watch->rootProcessId) {
+            watch->rootChildren.insert(processId);
+        }
+    }
+}
+
+void HandleMessage(const std::shared_ptr<ExitWatch>& watch, DWORD message, DWORD processId) {
+    switch (message) {
+        case JOB_OBJECT_MSG_NEW_PROCESS:
+            TrackMember(watch, processId);
+            break;
+
+        case JOB_OBJECT_MSG_EXIT_PROCESS:
+        case JOB_OBJECT_MSG_ABNORMAL_EXIT_PROCESS: {
+            if (processId == watch->rootProcessId) {
+                break;
+            }
+            HANDLE hProcess = NULL;
+            bool rootChild = false;
+            {
+                std::lock_guard<std::mutex> lock(g_mutex);
+                auto it = watch->members.find(processId);
+                if (it != watch->members.end()) {
+                    hProcess = it->second;
+                    watch->members.erase(it);
+                }
+                rootChild = watch->rootChildren.erase(processId) > 0;
+            }
+            int32_t exitCode;
+            int64_t timestampMs;
+            ReadExit(hProcess, &exitCode, &timestampMs);
+            if (hProcess != NULL) {
+                CloseHandle(hProcess);
+            }
+            Post(watch->id, processId, exitCode, timestampMs,
+                rootChild ? EXIT_EVENT_ROOT_CHILD : EXIT_EVENT_MEMBER);
+            break;
+        }
+
+        case JOB_OBJECT_MSG_ACTIVE_PROCESS_ZERO:
+            TreeExited(watch, 0, NowUnixMs(), false);
+            break;
+
+        case JOB_OBJECT_MSG_JOB_MEMORY_LIMIT:
+        case JOB_OBJECT_MSG_PROCESS_MEMORY_LIMIT:
+            PostLimit(watch->id, processId, JOB_LIMIT_MEMORY);
+            break;
+
+        case JOB_OBJECT_MSG_ACTIVE_PROCESS_LIMIT:
+            PostLimit(watch->id, 0, JOB_LIMIT_PROCESS_COUNT);
+            break;
+    }
+}
+
+// Job notifications for every watched job arrive on one completion port
+DWORD WINAPI PortThread(LPVOID) {
+    for (;;) {
+        DWORD message = 0;
+        ULONG_PTR key = 0;
+        LPOVERLAPPED overlapped = NULL;
+        if (!GetQueuedCompletionStatus(g_port, &message, &key, &overlapped, INFINITE)) {
+            continue;
+        }
+        DWORD processId = (DWORD)(ULONG_PTR)overlapped;
+
+        std::vector<std::shared_ptr<ExitWatch>> watches;
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            // Brings back the route of a job that emptied and was reused after its watches ended
+            JobRoute& route = g_routes[(int64_t)key];
+            switch (message) {
+                case JOB_OBJECT_MSG_NEW_PROCESS:
+                    route.processes.insert(processId);
+                    break;
+                case JOB_OBJECT_MSG_EXIT_PROCESS:
+                case JOB_OBJECT_MSG_ABNORMAL_EXIT_PROCESS:
+                    route.processes.erase(processId);
+                    break;
+                case JOB_OBJECT_MSG_ACTIVE_PROCESS_ZERO:
+                    route.processes.clear();
+                    break;
+            }
+            for (int64_t watchId : route.watchIds) {
+                auto it = g_watches.find(watchId);
+                if (it != g_watches.end()) {
+                    watches.push_back(it->second);
+                }
+            }
+            if (route.watchIds.empty() && route.processes.empty()) {
+                g_routes.erase((int64_t)key);
+            }
+        }
+
+        for (auto& watch : watches) {
+            HandleMessage(watch, message, processId);
+        }
+    }
+}
+
+// Route the job's notifications to the watch: associate the job with our port, or
+// share the route of an earlier watch that already did. False if the job reports
+// to another port, so the tree can't be watched.
+bool RouteJob(const std::shared_ptr<ExitWatch>& watch, HANDLE hJob) {
+    int64_t key;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        key = g_nextJobKey++;
+        g_routes[key].watchIds.insert(watch->id);
+        watch->jobKey = key;
+    }
+
+    std::vector<DWORD> ids;
+    JOBOBJECT_ASSOCIATE_COMPLETION_PORT port;
+    port.CompletionKey = (PVOID)(intptr_t)key;
+    port.CompletionPort = g_port;
+    if (!SetInformationJobObject(hJob, JobObjectAssociateCompletionPortInformation, &port, sizeof(port))) {
+        // Already associated - find the route by the members it tracks
+        bool listed = job_member_pids(hJob, &ids);
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_routes.erase(key);
+        watch->jobKey = 0;
+        for (auto& route : g_routes) {
+            for (DWORD processId : ids) {
+                if (route.second.processes.count(processId)) {
+                    watch->jobKey = route.first;
+                    break;
+                }
+            }
+            if (watch->jobKey != 0) {
+                route.second.watchIds.insert(watch->id);
+                break;
+            }
+        }
+        if (watch->jobKey == 0) {
+            // An empty job has nothing to report beyond the root
+            return listed && ids.empty();
+        }
+        key = watch->jobKey;
+    }
+
+    // Members that joined before the watch did
+    if (job_member_pids(hJob, &ids)) {
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            auto route = g_routes.find(key);
+            if (route != g_routes.end()) {
+                route->second.processes.insert(ids.begin(), ids.end());
+            }
+        }
+        for (DWORD processId : ids) {
+            TrackMember(watch, processId);
+        }
+        // An empty job (assignment failed) never reports ACTIVE_PROCESS_ZERO -
+        // fall back to the root process alone
+        watch->jobAssociated = !ids.empty();
+    }
+    return true;
+}
+
+bool EnsurePort() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (g_port != NULL) {
+        return true;
+    }
+    g_port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+    if (g_port == NULL) {
+        return false;
+    }
+    HANDLE thread = CreateThread(NULL, 0, PortThread, NULL, 0, NULL);
+    if (thread == NULL) {
+        CloseHandle(g_port);
+        g_port = NULL;
+        return false;
+    }
+    CloseHandle(thread);
+    return true;
+}
+
+} // namespace
+
+extern "C" {
+
+// Register the Dart exit event callback (NULL to detach)
+__declspec(dllexport) void exit_watcher_set_callback(ExitEventCallback callback) {
+    g_callback.store(callback);
+}
+
+// Register the Dart limit breach callback (NULL to detach)
+__declspec(dllexport) void exit_watcher_set_limit_callback(JobLimitCallback callback) {
+    g_limitCallback.store(callback);
+}
+
+// Start watching a process tree
+__declspec(dllexport) int64_t exit_watcher_watch(DWORD rootProcessId, intptr_t jobHandle) {
+    if (rootProcessId == 0 || !EnsurePort()) {
+        return 0;
+    }
+
+    auto watch = std::make_shared<ExitWatch>();
+    watch->rootProcessId = rootProcessId;
+    watch->hRoot = OpenProcess(SYNCHRONIZE | PROCESS_QUERY_LIMITED_INFORMATION, FALSE, rootProcessId);
+    if (watch->hRoot == NULL) {
+        return 0;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        watch->id = g_nextWatchId++;
+        g_watches[watch->id] = watch;
+    }
+
+    HANDLE hJob = reinterpret_cast<HANDLE>(jobHandle);
+    if (hJob != NULL && !RouteJob(watch, hJob)) {
+        RemoveWatch(watch->id, false);
+        return 0;
+    }
+
+    if (!RegisterWaitForSingleObject(&watch->rootWait, watch->hRoot, OnRootExit,
+            (PVOID)(intptr_t)watch->id, INFINITE, WT_EXECUTEONLYONCE)) {
+        watch->rootWait = NULL;
+        RemoveWatch(watch->id, false);
+        return 0;
+    }
+
+    return watch->id;
+}
+
+// Stop watching (no further events are posted for this id)
+__declspec(dllexport) void exit_watcher_unwatch(int64_t watchId) {
+    RemoveWatch(watchId, false);
+}
+
+}
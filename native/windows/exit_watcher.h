@@ -0,0 +1,42 @@
+#ifndef EXIT_WATCHER_H
+#define EXIT_WATCHER_H
+
+#include <windows.h>
+#include <stdint.h>
+
+// Event kinds posted to the exit callback
+enum ExitEventKind {
+    EXIT_EVENT_MEMBER = 0, // A job member (descendant) exited
+    EXIT_EVENT_ROOT = 1,   // The watched root process exited
+    EXIT_EVENT_TREE = 2,   // No process of the tree is left (job empty, or root gone when there is no job)
+    EXIT_EVENT_ROOT_CHILD = 3, // A job member started directly by the root exited (posted instead of
+                               // EXIT_EVENT_MEMBER) - for a shell root, a command it ran
+};
+
+// Called from native threads; register a NativeCallable.listener from Dart.
+// timestampMs is the process exit time in milliseconds since the Unix epoch.
+typedef void (*ExitEventCallback)(int64_t watchId, uint32_t processId, int32_t exitCode,
+    int64_t timestampMs, int32_t kind);
+
+// Job limit breaches (see job_set_limits) - the job's notifications all arrive on
+// the watcher's completion port, so they are reported from here too
+enum JobLimitKind {
+    JOB_LIMIT_MEMORY = 0,        // A commit was refused by the job memory limit
+    JOB_LIMIT_PROCESS_COUNT = 1, // A process could not start: active process limit reached
+};
+
+// processId is the offending process (0 if the OS doesn't say)
+typedef void (*JobLimitCallback)(int64_t watchId, uint32_t processId, int32_t kind);
+
+extern "C" {
+    __declspec(dllexport) void exit_watcher_set_callback(ExitEventCallback callback);
+    __declspec(dllexport) void exit_watcher_set_limit_callback(JobLimitCallback callback);
+    // Watch a root process and, if jobHandle is non-zero, every member of its job.
+    // Returns a watch id (0 on failure). The watch ends by itself after EXIT_EVENT_TREE.
+    // A job may be watched again (or by several watches at once); it fails only if the
+    // job already reports to a completion port outside this module.
+    __declspec(dllexport) int64_t exit_watcher_watch(DWORD rootProcessId, intptr_t jobHandle);
+    __declspec(dllexport) void exit_watcher_unwatch(int64_t watchId);
+}
+
+#endif // EXIT_WATCHER_H
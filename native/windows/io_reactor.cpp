@@ -0,0 +1,354 @@
+#include "io_reactor.h"
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+const DWORD kReadSize = 64 * 1024;    // Largest single read
+const int32_t kRingSize = 1024 * 1024; // Per source; pages are committed as they are touched
+const DWORD kFrameMs = 16; // Dart is woken at most once per display frame
+const ULONG_PTR kReadKey = 0;
+const ULONG_PTR kStartKey = 1;  // Posted by io_reactor_add: queue the first read
+const ULONG_PTR kResumeKey = 2; // Posted when a stalled ring got room, or on cancel
+const ULONG_PTR kRemoveKey = 3; // Posted by io_reactor_remove: retire the source
+const ULONG kMaxEntries = 64;
+
+struct Source {
+    OVERLAPPED overlapped = {}; // Completions map back to their source through this
+    int id = 0;
+    HANDLE handle = NULL;
+    int32_t ownerId = 0;
+    int32_t stream = 0;
+    IoFilter filter;
+    HANDLE drained = NULL; // Set once reading ended and everything was handed over
+    IoRing* ring = nullptr;
+    int64_t reported = 0;  // Ring head at the last batch (reactor thread only)
+    volatile LONG cancelled = 0;
+};
+
+std::mutex g_mutex;
+std::map<int, std::unique_ptr<Source>> g_sources;
+int g_nextSourceId = 1;
+HANDLE g_port = NULL;
+std::atomic<IoBatchCallback> g_callback(nullptr);
+volatile LONG g_pipeSerial = 0;
+
+// Reactor thread only
+std::vector<Source*> g_dirty;   // Sources with unreported data, in order of their first byte
+std::vector<Source*> g_retired; // Removed sources whose ring still has to reach Dart
+DWORD g_lastFlush = 0;
+
+IoRing* NewRing(Source* source) {
+    auto ring = new IoRing();
+    ring->data = static_cast<uint8_t*>(VirtualAlloc(NULL, kRingSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+    if (ring->data == NULL) {
+        delete ring;
+        return nullptr;
+    }
+    ring->capacity = kRingSize;
+    ring->source = source;
+    return ring;
+}
+
+void FreeRing(IoRing* ring) {
+    VirtualFree(ring->data, 0, MEM_RELEASE);
+    delete ring;
+}
+
+// Report every ring that got data, and every retired one, to Dart in one call.
+// Nothing is copied: Dart reads the rings in place.
+void Flush() {
+    g_lastFlush = GetTickCount();
+    if (g_dirty.empty() && g_retired.empty()) {
+        return;
+    }
+    IoBatchCallback callback = g_callback.load();
+    auto chunks = callback != nullptr
+        ? static_cast<IoChunk*>(malloc(sizeof(IoChunk) * (g_dirty.size() + g_retired.size())))
+        : nullptr;
+    int32_t count = 0;
+    for (Source* source : g_dirty) {
+        IoRing* ring = source->ring;
+        source->reported = ring->head;
+        if (chunks != nullptr) {
+            chunks[count++] = { ring, ring->head, source->ownerId, source->stream, 0, 0 };
+        } else {
+            io_ring_release(ring, ring->head); // Nobody listening
+        }
+    }
+    for (Source* source : g_retired) {
+        IoRing* ring = source->ring;
+        ring->source = nullptr;
+        if (chunks != nullptr) {
+            chunks[count++] = { ring, ring->head, source->ownerId, source->stream, 1, 0 };
+        } else {
+            FreeRing(ring);
+        }
+        delete source;
+    }
+    g_dirty.clear();
+    g_retired.clear();
+    if (count > 0) {
+        callback(chunks, count);
+    } else {
+        free(chunks);
+    }
+}
+
+// Queue the next read into the ring's free space; false if the handle is done.
+// A full ring parks the source until io_ring_release posts kResumeKey.
+bool Read(Source* source) {
+    IoRing* ring = source->ring;
+    for (;;) {
+        if (source->cancelled) {
+            return false;
+        }
+        int64_t head = ring->head;
+        int64_t room = ring->capacity - (head - ring->tail);
+        if (room > 0) {
+            int32_t offset = (int32_t)(head & (ring->capacity - 1));
+            int64_t length = ring->capacity - offset;
+            length = length < room ? length : room;
+            length = length < kReadSize ? length : kReadSize;
+            ZeroMemory(&source->overlapped, sizeof(OVERLAPPED));
+            // Completes through the port even when it succeeds at once
+            return ReadFile(source->handle, ring->data + offset, (DWORD)length, NULL, &source->overlapped) ||
+                GetLastError() == ERROR_IO_PENDING;
+        }
+        // Full: the frame's flush hands it over; a flood is paced to one
+        // ring per frame rather than flushed early
+        InterlockedExchange(&ring->stalled, 1);
+        if (ring->capacity - (ring->head - ring->tail) == 0 && !source->cancelled) {
+            return true;
+        }
+        // Released (or cancelled) in between; whoever clears the flag continues
+        if (InterlockedExchange(&ring->stalled, 0) == 0) {
+            return true;
+        }
+    }
+}
+
+// The source will not be touched again by this thread until it is removed
+void Finish(Source* source) {
+    Flush(); // Its last output goes out before anyone waiting sees the end
+    SetEvent(source->drained);
+}
+
+void OnRead(Source* source) {
+    DWORD bytesRead = 0;
+    if (!GetOverlappedResult(source->handle, &source->overlapped, &bytesRead, FALSE) || bytesRead == 0) {
+        Finish(source);
+        return;
+    }
+    IoRing* ring = source->ring;
+    auto data = reinterpret_cast<const char*>(ring->data + (ring->head & (ring->capacity - 1)));
+    if (!source->filter || source->filter(data, bytesRead)) {
+        if (source->reported == ring->head) {
+            g_dirty.push_back(source);
+        }
+        ring->head += bytesRead; // Commit
+    }
+    if (!Read(source)) {
+        Finish(source);
+    }
+}
+
+DWORD WINAPI ReactorThread(LPVOID) {
+    OVERLAPPED_ENTRY entries[kMaxEntries];
+    for (;;) {
+        // Output that arrives after a quiet spell goes out at once; a burst
+        // is collected until the frame is over
+        DWORD timeout = INFINITE;
+        if (!g_dirty.empty()) {
+            DWORD elapsed = GetTickCount() - g_lastFlush;
+            if (elapsed >= kFrameMs) {
+                Flush();
+            } else {
+                timeout = kFrameMs - elapsed;
+            }
+        }
+
+        ULONG count = 0;
+        if (!GetQueuedCompletionStatusEx(g_port, entries, kMaxEntries, &count, timeout, FALSE)) {
+            continue; // Frame over
+        }
+        for (ULONG i = 0; i < count; i++) {
+            auto source = reinterpret_cast<Source*>(entries[i].lpOverlapped);
+            switch (entries[i].lpCompletionKey) {
+            case kStartKey:
+            case kResumeKey:
+                if (!Read(source)) {
+                    Finish(source);
+                }
+                break;
+            case kRemoveKey:
+                g_retired.push_back(source);
+                Flush();
+                break;
+            default:
+                OnRead(source);
+                break;
+            }
+        }
+    }
+    return 0;
+}
+
+bool EnsurePort() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (g_port != NULL) {
+        return true;
+    }
+    g_port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+    if (g_port == NULL) {
+        return false;
+    }
+    HANDLE thread = CreateThread(NULL, 0, ReactorThread, NULL, 0, NULL);
+    if (thread == NULL) {
+        CloseHandle(g_port);
+        g_port = NULL;
+        return false;
+    }
+    CloseHandle(thread);
+    return true;
+}
+
+Source* FindSource(int sourceId) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    auto it = g_sources.find(sourceId);
+    return it != g_sources.end() ? it->second.get() : nullptr;
+}
+
+// Continue a parked source, unless someone else already did
+void Wake(IoRing* ring) {
+    if (InterlockedExchange(&ring->stalled, 0) == 1) {
+        PostQueuedCompletionStatus(g_port, 0, kResumeKey, &static_cast<Source*>(ring->source)->overlapped);
+    }
+}
+
+} // namespace
+
+bool io_create_pipe(HANDLE* readEnd, HANDLE* writeEnd, bool inheritWrite, DWORD bufferSize) {
+    char name[80];
+    sprintf_s(name, sizeof(name), "\\\\.\\pipe\\marcha-io-%lu-%ld",
+        GetCurrentProcessId(), InterlockedIncrement(&g_pipeSerial));
+    HANDLE read = CreateNamedPipeA(name,
+        PIPE_ACCESS_INBOUND | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE,
+        PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+        1, 0, bufferSize, 0, NULL);
+    if (read == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    SECURITY_ATTRIBUTES attributes = { sizeof(SECURITY_ATTRIBUTES), NULL, inheritWrite ? TRUE : FALSE };
+    HANDLE write = CreateFileA(name, GENERIC_WRITE, 0, &attributes, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (write == INVALID_HANDLE_VALUE) {
+        CloseHandle(read);
+        return false;
+    }
+    *readEnd = read;
+    *writeEnd = write;
+    return true;
+}
+
+int io_reactor_add(HANDLE handle, int32_t ownerId, int32_t stream, IoFilter filter) {
+    if (handle == NULL || !EnsurePort()) {
+        return 0;
+    }
+    auto source = std::make_unique<Source>();
+    source->handle = handle;
+    source->ownerId = ownerId;
+    source->stream = stream;
+    source->filter = std::move(filter);
+    source->ring = NewRing(source.get());
+    if (source->ring == nullptr) {
+        return 0;
+    }
+    source->drained = CreateEventA(NULL, TRUE, FALSE, NULL);
+    if (source->drained == NULL) {
+        FreeRing(source->ring);
+        return 0;
+    }
+    if (CreateIoCompletionPort(handle, g_port, kReadKey, 0) == NULL) {
+        CloseHandle(source->drained);
+        FreeRing(source->ring);
+        return 0;
+    }
+
+    Source* raw = source.get();
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        raw->id = g_nextSourceId++;
+        g_sources[raw->id] = std::move(source);
+    }
+    // The reactor thread issues every read, including the first
+    if (!PostQueuedCompletionStatus(g_port, 0, kStartKey, &raw->overlapped)) {
+        SetEvent(raw->drained);
+    }
+    return raw->id;
+}
+
+bool io_reactor_wait(int sourceId, DWORD timeoutMs) {
+    Source* source = FindSource(sourceId);
+    return source == nullptr || WaitForSingleObject(source->drained, timeoutMs) == WAIT_OBJECT_0;
+}
+
+void io_reactor_cancel(int sourceId) {
+    Source* source = FindSource(sourceId);
+    if (source != nullptr) {
+        InterlockedExchange(&source->cancelled, 1);
+        CancelIoEx(source->handle, &source->overlapped);
+        Wake(source->ring); // A parked source has no read to cancel
+    }
+}
+
+void io_reactor_remove(int sourceId) {
+    std::unique_ptr<Source> source;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto it = g_sources.find(sourceId);
+        if (it == g_sources.end()) {
+            return;
+        }
+        source = std::move(it->second);
+        g_sources.erase(it);
+    }
+    CloseHandle(source->drained);
+    source->drained = NULL;
+    // The reactor passes the ring on to Dart, behind any batch still on its way
+    if (PostQueuedCompletionStatus(g_port, 0, kRemoveKey, &source->overlapped)) {
+        source.release();
+    } else {
+        FreeRing(source->ring);
+    }
+}
+
+extern "C" {
+
+// Register the Dart batch callback (NULL to detach)
+__declspec(dllexport) void io_reactor_set_callback(IoBatchCallback callback) {
+    g_callback.store(callback);
+}
+
+// Release a batch array (the rings stay)
+__declspec(dllexport) void io_reactor_free_batch(IoChunk* chunks) {
+    free(chunks);
+}
+
+// Hand consumed ring space back; resumes a source that was waiting for it
+__declspec(dllexport) void io_ring_release(IoRing* ring, int64_t tail) {
+    InterlockedExchange64(&ring->tail, tail);
+    Wake(ring);
+}
+
+// Free a ring after its last batch entry (IoChunk.last)
+__declspec(dllexport) void io_ring_free(IoRing* ring) {
+    FreeRing(ring);
+}
+
+}
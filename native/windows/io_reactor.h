@@ -0,0 +1,75 @@
+#ifndef IO_REACTOR_H
+#define IO_REACTOR_H
+
+#include <windows.h>
+#include <stdint.h>
+#include <functional>
+
+// Streams of a source
+enum IoStream {
+    IO_STREAM_OUTPUT = 0, // Terminal output, or stdout in pipe mode
+    IO_STREAM_ERROR = 1,  // stderr in pipe mode
+};
+
+// Output ring of a source, shared with Dart. The reactor reads straight into
+// data at head; the consumer reads [tail, head) in place and hands tail back with
+// io_ring_release. Cursors count bytes since the start and never wrap; the byte
+// at cursor c is data[c & (capacity - 1)]. A full ring stops reading the source
+// (its writer blocks) until the consumer catches up.
+struct IoRing {
+    volatile int64_t head; // Producer cursor (reactor thread)
+    volatile int64_t tail; // Consumer cursor
+    uint8_t* data;
+    int32_t capacity;      // Power of two
+    volatile LONG stalled; // Internal: waiting for room
+    void* source;          // Internal
+};
+
+// One entry of a batch: the ring's bytes from its tail up to end
+struct IoChunk {
+    IoRing* ring;
+    int64_t end;
+    int32_t ownerId; // Task container id
+    int32_t stream;  // IoStream
+    int32_t last;    // The source is gone: release the ring with io_ring_free after reading
+    int32_t reserved;
+};
+
+// Called from the reactor thread at most once per display frame, plus once when a
+// source ends, with one entry per source that has new data; register a NativeCallable.listener from Dart
+// and release the array with io_reactor_free_batch. Entries of one ring arrive in
+// order, each continuing where the previous one ended.
+typedef void (*IoBatchCallback)(IoChunk* chunks, int32_t count);
+
+extern "C" {
+    __declspec(dllexport) void io_reactor_set_callback(IoBatchCallback callback);
+    __declspec(dllexport) void io_reactor_free_batch(IoChunk* chunks);
+    // Everything before tail has been consumed; the reactor may overwrite it
+    __declspec(dllexport) void io_ring_release(IoRing* ring, int64_t tail);
+    __declspec(dllexport) void io_ring_free(IoRing* ring);
+}
+
+// Internal: every task container's output handles are read by one thread on one
+// completion port, instead of a blocking reader thread per handle.
+
+// Sees each read (in the ring) on the reactor thread before it is committed;
+// return false to drop it from the ring (the owner keeps a copy if it needs one).
+typedef std::function<bool(const char* data, DWORD length)> IoFilter;
+
+// An anonymous-style pipe whose read end supports overlapped I/O (CreatePipe's does not)
+bool io_create_pipe(HANDLE* readEnd, HANDLE* writeEnd, bool inheritWrite, DWORD bufferSize);
+
+// Start reading handle (from io_create_pipe). Returns a source id, 0 on failure.
+// The handle stays owned by the caller and must outlive the source.
+int io_reactor_add(HANDLE handle, int32_t ownerId, int32_t stream, IoFilter filter);
+// Wait until the source has hit EOF (or was cancelled) and everything read was
+// handed to Dart. False on timeout.
+bool io_reactor_wait(int sourceId, DWORD timeoutMs);
+// Stop reading now: the pending read is cancelled and no further one is issued.
+// Wait for the source afterwards.
+void io_reactor_cancel(int sourceId);
+// Forget a finished source (after io_reactor_wait succeeded). Its ring is handed
+// to Dart for release in a final batch entry.
+void io_reactor_remove(int sourceId);
+
+#endif // IO_REACTOR_H
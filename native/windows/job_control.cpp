@@ -0,0 +1,232 @@
+#include "job_control.h"
+#include "job_stats.h"
+#include <windows.h>
+#include <tlhelp32.h>
+#include <set>
+#include <vector>
+
+namespace {
+
+// Not in the SDK headers; NtSetInformationProcess(ProcessIoPriority) has been stable since Vista
+const ULONG kProcessIoPriority = 33;
+typedef LONG (NTAPI *NtSetInformationProcessFn)(HANDLE, ULONG, PVOID, ULONG);
+typedef LONG (NTAPI *NtSuspendResumeFn)(HANDLE);
+
+bool IsPriorityClass(uint32_t priorityClass) {
+    switch (priorityClass) {
+        case IDLE_PRIORITY_CLASS:
+        case BELOW_NORMAL_PRIORITY_CLASS:
+        case NORMAL_PRIORITY_CLASS:
+        case ABOVE_NORMAL_PRIORITY_CLASS:
+        case HIGH_PRIORITY_CLASS:
+            return true; // Realtime would starve the machine, including us
+    }
+    return false;
+}
+
+bool SetIoPriority(HANDLE hJob, int ioPriority) {
+    static auto setInformation = reinterpret_cast<NtSetInformationProcessFn>(
+        GetProcAddress(GetModuleHandleA("ntdll.dll"), "NtSetInformationProcess"));
+    if (setInformation == nullptr) {
+        return false;
+    }
+
+    std::vector<DWORD> ids;
+    if (!job_member_pids(hJob, &ids)) {
+        return false;
+    }
+
+    bool applied = true;
+    for (DWORD processId : ids) {
+        HANDLE hProcess = OpenProcess(PROCESS_SET_INFORMATION, FALSE, processId);
+        if (hProcess == NULL) {
+            continue; // Exited since the list was taken
+        }
+        ULONG value = (ULONG)ioPriority;
+        if (setInformation(hProcess, kProcessIoPriority, &value, sizeof(value)) < 0) {
+            applied = false;
+        }
+        CloseHandle(hProcess);
+    }
+    return applied;
+}
+
+// Every process of a tree: the job's member list when there is a job (descendants
+// cannot leave it), otherwise a walk by parent PID from the root
+std::vector<DWORD> TreeProcessIds(DWORD rootProcessId, HANDLE hJob) {
+    std::vector<DWORD> ids;
+    if (hJob != NULL && job_member_pids(hJob, &ids)) {
+        return ids;
+    }
+    if (rootProcessId == 0) {
+        return ids;
+    }
+
+    std::vector<PROCESSENTRY32> entries;
+    HANDLE snap = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (snap != INVALID_HANDLE_VALUE) {
+        PROCESSENTRY32 pe;
+        pe.dwSize = sizeof(pe);
+        if (Process32First(snap, &pe)) {
+            do {
+                entries.push_back(pe);
+            } while (Process32Next(snap, &pe));
+        }
+        CloseHandle(snap);
+    }
+
+    std::set<DWORD> known = { rootProcessId };
+    ids.push_back(rootProcessId);
+    bool added = true;
+    while (added) {
+        added = false;
+        for (const auto& entry : entries) {
+            if (!known.count(entry.th32ProcessID) && known.count(entry.th32ParentProcessID)) {
+                known.insert(entry.th32ProcessID);
+                ids.push_back(entry.th32ProcessID);
+                added = true;
+            }
+        }
+    }
+    return ids;
+}
+
+// Suspend (or resume) every member not in done, adding them to done.
+// Returns the number of processes handled in this pass.
+int SuspendResumePass(DWORD rootProcessId, HANDLE hJob, NtSuspendResumeFn call, std::set<DWORD>& done) {
+    int count = 0;
+    for (DWORD processId : TreeProcessIds(rootProcessId, hJob)) {
+        if (!done.insert(processId).second || processId == GetCurrentProcessId()) {
+            continue;
+        }
+        HANDLE hProcess = OpenProcess(PROCESS_SUSPEND_RESUME, FALSE, processId);
+        if (hProcess == NULL) {
+            continue; // Already gone
+        }
+        if (call(hProcess) >= 0) {
+            count++;
+        }
+        CloseHandle(hProcess);
+    }
+    return count;
+}
+
+int SuspendResumeTree(DWORD rootProcessId, intptr_t jobHandle, const char* function) {
+    auto call = reinterpret_cast<NtSuspendResumeFn>(
+        GetProcAddress(GetModuleHandleA("ntdll.dll"), function));
+    if (call == nullptr || (rootProcessId == 0 && jobHandle == 0)) {
+        return 0;
+    }
+    HANDLE hJob = reinterpret_cast<HANDLE>(jobHandle);
+
+    // A member may start a child between listing and suspending; another pass picks
+    // it up. Once a pass adds nothing, every remaining member is frozen and cannot
+    // start anything new. Bounded in case the tree keeps spawning faster than us.
+    std::set<DWORD> done;
+    int total = 0;
+    for (int pass = 0; pass < 8; pass++) {
+        int count = SuspendResumePass(rootProcessId, hJob, call, done);
+        total += count;
+        if (count == 0) {
+            break;
+        }
+    }
+    return total;
+}
+
+} // namespace
+
+extern "C" {
+
+// Apply memory, CPU rate and process count limits to a job
+__declspec(dllexport) bool job_set_limits(intptr_t jobHandle, int64_t maxMemoryBytes,
+        int cpuRatePercent, int maxActiveProcesses) {
+    if (jobHandle == 0) {
+        return false;
+    }
+    HANDLE hJob = reinterpret_cast<HANDLE>(jobHandle);
+
+    // Keep the flags set when the job was created (KILL_ON_JOB_CLOSE)
+    JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits;
+    if (!QueryInformationJobObject(hJob, JobObjectExtendedLimitInformation, &limits, sizeof(limits), NULL)) {
+        return false;
+    }
+    limits.BasicLimitInformation.LimitFlags &= ~(JOB_OBJECT_LIMIT_JOB_MEMORY | JOB_OBJECT_LIMIT_ACTIVE_PROCESS);
+    if (maxMemoryBytes > 0) {
+        limits.BasicLimitInformation.LimitFlags |= JOB_OBJECT_LIMIT_JOB_MEMORY;
+        limits.JobMemoryLimit = (SIZE_T)maxMemoryBytes;
+    }
+    if (maxActiveProcesses > 0) {
+        limits.BasicLimitInformation.LimitFlags |= JOB_OBJECT_LIMIT_ACTIVE_PROCESS;
+        limits.BasicLimitInformation.ActiveProcessLimit = (DWORD)maxActiveProcesses;
+    }
+    bool applied = SetInformationJobObject(hJob, JobObjectExtendedLimitInformation, &limits, sizeof(limits)) != FALSE;
+
+    // CpuRate is in 1/100 of a percent of all processors
+    JOBOBJECT_CPU_RATE_CONTROL_INFORMATION cpu;
+    ZeroMemory(&cpu, sizeof(cpu));
+    if (cpuRatePercent > 0 && cpuRatePercent < 100) {
+        cpu.ControlFlags = JOB_OBJECT_CPU_RATE_CONTROL_ENABLE | JOB_OBJECT_CPU_RATE_CONTROL_HARD_CAP;
+        cpu.CpuRate = (DWORD)cpuRatePercent * 100;
+    }
+    if (!SetInformationJobObject(hJob, JobObjectCpuRateControlInformation, &cpu, sizeof(cpu))) {
+        // Clearing a cap that was never set may fail on older systems - only report real attempts
+        if (cpu.ControlFlags != 0) {
+            applied = false;
+        }
+    }
+    return applied;
+}
+
+// Apply priority class, affinity and I/O priority to a job
+__declspec(dllexport) bool job_set_scheduling(intptr_t jobHandle, uint32_t priorityClass,
+        uint64_t affinityMask, int ioPriority) {
+    if (jobHandle == 0 || (priorityClass != 0 && !IsPriorityClass(priorityClass))) {
+        return false;
+    }
+    HANDLE hJob = reinterpret_cast<HANDLE>(jobHandle);
+
+    DWORD_PTR processMask = 0, systemMask = 0;
+    if (affinityMask != 0) {
+        if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+            return false;
+        }
+        affinityMask &= processMask;
+        if (affinityMask == 0) {
+            return false; // None of the requested processors is available
+        }
+    }
+
+    // Job-wide limits also bind processes that join the job later
+    JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits;
+    if (!QueryInformationJobObject(hJob, JobObjectExtendedLimitInformation, &limits, sizeof(limits), NULL)) {
+        return false;
+    }
+    limits.BasicLimitInformation.LimitFlags &= ~(JOB_OBJECT_LIMIT_PRIORITY_CLASS | JOB_OBJECT_LIMIT_AFFINITY);
+    if (priorityClass != 0) {
+        limits.BasicLimitInformation.LimitFlags |= JOB_OBJECT_LIMIT_PRIORITY_CLASS;
+        limits.BasicLimitInformation.PriorityClass = priorityClass;
+    }
+    if (affinityMask != 0) {
+        limits.BasicLimitInformation.LimitFlags |= JOB_OBJECT_LIMIT_AFFINITY;
+        limits.BasicLimitInformation.Affinity = (ULONG_PTR)affinityMask;
+    }
+    bool applied = SetInformationJobObject(hJob, JobObjectExtendedLimitInformation, &limits, sizeof(limits)) != FALSE;
+
+    if (ioPriority >= 0 && ioPriority <= 2) {
+        applied = SetIoPriority(hJob, ioPriority) && applied;
+    }
+    return applied;
+}
+
+// Freeze a process tree (see job_control.h)
+__declspec(dllexport) int suspend_tree(DWORD rootProcessId, intptr_t jobHandle) {
+    return SuspendResumeTree(rootProcessId, jobHandle, "NtSuspendProcess");
+}
+
+// Thaw a process tree frozen by suspend_tree
+__declspec(dllexport) int resume_tree(DWORD rootProcessId, intptr_t jobHandle) {
+    return SuspendResumeTree(rootProcessId, jobHandle, "NtResumeProcess");
+}
+
+}
@@ -0,0 +1,32 @@
+#ifndef JOB_CONTROL_H
+#define JOB_CONTROL_H
+
+#include <windows.h>
+#include <stdint.h>
+
+extern "C" {
+    // Limits for the whole job; 0 clears a limit. Exceeding maxMemoryBytes makes further
+    // commits fail, exceeding maxActiveProcesses makes new processes fail to start; both
+    // are reported through the exit watcher's limit callback. cpuRatePercent is a hard cap
+    // on the share of total machine CPU (1-99; 0 or 100 removes it).
+    // Returns false if any of the limits could not be applied.
+    __declspec(dllexport) bool job_set_limits(intptr_t jobHandle, int64_t maxMemoryBytes,
+        int cpuRatePercent, int maxActiveProcesses);
+    // Scheduling for every member of the job, including processes started later.
+    // priorityClass is a Win32 priority class (IDLE_PRIORITY_CLASS ... HIGH_PRIORITY_CLASS),
+    // affinityMask a set of logical processors (clipped to the ones we may use);
+    // 0 leaves either unrestricted. ioPriority: -1 unchanged, 0 very low, 1 low, 2 normal -
+    // applied to the current members, descendants inherit it from their parent.
+    // Returns false if any of the settings could not be applied.
+    __declspec(dllexport) bool job_set_scheduling(intptr_t jobHandle, uint32_t priorityClass,
+        uint64_t affinityMask, int ioPriority);
+    // Freeze every process of a tree (job members, or descendants by parent PID when
+    // jobHandle is 0). Repeats until a pass finds no new member, so a process started
+    // while the tree was being suspended is caught too. Returns the number suspended.
+    // Suspension nests: every suspend_tree needs one resume_tree.
+    __declspec(dllexport) int suspend_tree(DWORD rootProcessId, intptr_t jobHandle);
+    // Thaw a tree frozen by suspend_tree. Returns the number of processes resumed.
+    __declspec(dllexport) int resume_tree(DWORD rootProcessId, intptr_t jobHandle);
+}
+
+#endif // JOB_CONTROL_H
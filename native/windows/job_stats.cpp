@@ -0,0 +1,145 @@
+#include "job_stats.h"
+#include <windows.h>
+#include <psapi.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+// JobObjectMemoryUsageInformation (Windows 10+), not declared by older SDKs
+const JOBOBJECTINFOCLASS kJobObjectMemoryUsageInformation = (JOBOBJECTINFOCLASS)28;
+struct JobMemoryUsageInformation {
+    ULONG64 JobMemory;
+    ULONG64 PeakJobMemoryUsed;
+};
+
+int64_t FileTimeTo100ns(const FILETIME& time) {
+    ULARGE_INTEGER value;
+    value.LowPart = time.dwLowDateTime;
+    value.HighPart = time.dwHighDateTime;
+    return (int64_t)value.QuadPart;
+}
+
+// "C:\...\node.exe" -> "node" (the name Get-Process reports)
+void CopyImageName(HANDLE hProcess, char* name, size_t size) {
+    name[0] = '\0';
+    char path[MAX_PATH];
+    DWORD length = MAX_PATH;
+    if (!QueryFullProcessImageNameA(hProcess, 0, path, &length)) {
+        return;
+    }
+    std::string image(path, length);
+    size_t slash = image.find_last_of("\\/");
+    if (slash != std::string::npos) {
+        image = image.substr(slash + 1);
+    }
+    if (image.size() > 4 && _stricmp(image.c_str() + image.size() - 4, ".exe") == 0) {
+        image.resize(image.size() - 4);
+    }
+    strncpy_s(name, size, image.c_str(), _TRUNCATE);
+}
+
+} // namespace
+
+bool job_member_pids(HANDLE hJob, std::vector<DWORD>* ids) {
+    ids->clear();
+    DWORD capacity = 256;
+    // Members may join between two queries, so give up growing after a few rounds
+    for (int round = 0;; round++) {
+        std::vector<BYTE> buffer(sizeof(JOBOBJECT_BASIC_PROCESS_ID_LIST) + capacity * sizeof(ULONG_PTR));
+        auto list = reinterpret_cast<JOBOBJECT_BASIC_PROCESS_ID_LIST*>(buffer.data());
+        bool listed = QueryInformationJobObject(hJob, JobObjectBasicProcessIdList, list,
+            (DWORD)buffer.size(), NULL) != FALSE;
+        if (!listed && GetLastError() != ERROR_MORE_DATA) {
+            return false;
+        }
+        // A list cut short either fails with ERROR_MORE_DATA or holds fewer ids than assigned
+        bool complete = listed && list->NumberOfProcessIdsInList >= list->NumberOfAssignedProcesses;
+        if (complete || round == 7) {
+            for (DWORD i = 0; i < list->NumberOfProcessIdsInList; i++) {
+                ids->push_back((DWORD)list->ProcessIdList[i]);
+            }
+            return true;
+        }
+        capacity = max(capacity * 2, list->NumberOfAssignedProcesses + 64);
+    }
+}
+
+extern "C" {
+
+// Job-wide CPU, I/O, process count and memory totals
+__declspec(dllexport) bool job_accounting(intptr_t jobHandle, JobAccounting* out) {
+    if (jobHandle == 0 || out == nullptr) {
+        return false;
+    }
+    HANDLE hJob = reinterpret_cast<HANDLE>(jobHandle);
+    ZeroMemory(out, sizeof(*out));
+
+    JOBOBJECT_BASIC_AND_IO_ACCOUNTING_INFORMATION accounting;
+    if (!QueryInformationJobObject(hJob, JobObjectBasicAndIoAccountingInformation,
+            &accounting, sizeof(accounting), NULL)) {
+        return false;
+    }
+    out->userTime100ns = accounting.BasicInfo.TotalUserTime.QuadPart;
+    out->kernelTime100ns = accounting.BasicInfo.TotalKernelTime.QuadPart;
+    out->totalProcesses = (int32_t)accounting.BasicInfo.TotalProcesses;
+    out->activeProcesses = (int32_t)accounting.BasicInfo.ActiveProcesses;
+    out->terminatedProcesses = (int32_t)accounting.BasicInfo.TotalTerminatedProcesses;
+    out->readBytes = (int64_t)accounting.IoInfo.ReadTransferCount;
+    out->writeBytes = (int64_t)accounting.IoInfo.WriteTransferCount;
+    out->otherBytes = (int64_t)accounting.IoInfo.OtherTransferCount;
+    out->readOperations = (int64_t)accounting.IoInfo.ReadOperationCount;
+    out->writeOperations = (int64_t)accounting.IoInfo.WriteOperationCount;
+
+    JobMemoryUsageInformation memory;
+    if (QueryInformationJobObject(hJob, kJobObjectMemoryUsageInformation, &memory, sizeof(memory), NULL)) {
+        out->commitBytes = (int64_t)memory.JobMemory;
+        out->peakCommitBytes = (int64_t)memory.PeakJobMemoryUsed;
+    } else {
+        JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits;
+        if (QueryInformationJobObject(hJob, JobObjectExtendedLimitInformation, &limits, sizeof(limits), NULL)) {
+            out->peakCommitBytes = (int64_t)limits.PeakJobMemoryUsed;
+        }
+    }
+    return true;
+}
+
+// CPU time, working set and image name of every running job member
+__declspec(dllexport) int job_member_stats(intptr_t jobHandle, JobMemberStats* out, int maxCount) {
+    if (jobHandle == 0 || out == nullptr || maxCount <= 0) {
+        return 0;
+    }
+
+    std::vector<DWORD> ids;
+    if (!job_member_pids(reinterpret_cast<HANDLE>(jobHandle), &ids)) {
+        return 0;
+    }
+
+    int count = 0;
+    for (size_t i = 0; i < ids.size() && count < maxCount; i++) {
+        DWORD processId = ids[i];
+        HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+        if (hProcess == NULL) {
+            continue; // Exited since the list was taken
+        }
+
+        JobMemberStats& stats = out[count++];
+        ZeroMemory(&stats, sizeof(stats));
+        stats.processId = processId;
+
+        FILETIME creation, exit, kernel, user;
+        if (GetProcessTimes(hProcess, &creation, &exit, &kernel, &user)) {
+            stats.cpuTime100ns = FileTimeTo100ns(kernel) + FileTimeTo100ns(user);
+        }
+        PROCESS_MEMORY_COUNTERS memory;
+        if (GetProcessMemoryInfo(hProcess, &memory, sizeof(memory))) {
+            stats.workingSetBytes = (int64_t)memory.WorkingSetSize;
+        }
+        CopyImageName(hProcess, stats.name, sizeof(stats.name));
+        CloseHandle(hProcess);
+    }
+    return count;
+}
+
+}
@@ -0,0 +1,45 @@
+#ifndef JOB_STATS_H
+#define JOB_STATS_H
+
+#include <windows.h>
+#include <stdint.h>
+#include <vector>
+
+// Job-wide totals. Times, process counts and I/O include processes that already exited.
+struct JobAccounting {
+    int64_t userTime100ns;
+    int64_t kernelTime100ns;
+    int64_t readBytes;
+    int64_t writeBytes;
+    int64_t otherBytes;
+    int64_t readOperations;
+    int64_t writeOperations;
+    int64_t commitBytes;       // Committed memory of the job right now (0 if the OS can't tell)
+    int64_t peakCommitBytes;   // Highest committed memory of the job as a whole
+    int32_t totalProcesses;    // Every process that was ever in the job
+    int32_t activeProcesses;
+    int32_t terminatedProcesses; // Killed by a job limit or TerminateJobObject
+    int32_t reserved;
+};
+
+// One running job member
+struct JobMemberStats {
+    uint32_t processId;
+    uint32_t reserved;
+    int64_t cpuTime100ns;   // User + kernel
+    int64_t workingSetBytes;
+    char name[64];          // Image name without directory and .exe
+};
+
+extern "C" {
+    // Read accounting for a whole job - no per-process work. Returns false if the handle is not a job.
+    __declspec(dllexport) bool job_accounting(intptr_t jobHandle, JobAccounting* out);
+    // Per-member stats of the processes currently in a job. Returns the number written.
+    __declspec(dllexport) int job_member_stats(intptr_t jobHandle, JobMemberStats* out, int maxCount);
+}
+
+// Internal: ids of the processes currently in a job, however many there are.
+// False if they can't be listed.
+bool job_member_pids(HANDLE hJob, std::vector<DWORD>* ids);
+
+#endif // JOB_STATS_H
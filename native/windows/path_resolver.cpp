@@ -0,0 +1,383 @@
+#include "path_resolver.h"
+#include <windows.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <cctype>
+
+namespace {
+
+// FindFirstChangeNotification handles per watcher thread (one slot is the stop event)
+const size_t kMaxWatchedDirs = MAXIMUM_WAIT_OBJECTS - 1;
+
+struct SearchDir {
+    std::string path;
+    FILETIME lastWrite;
+    bool watched;
+};
+
+std::mutex g_mutex;
+std::string g_pathEnv;
+std::string g_pathExtEnv;
+std::vector<SearchDir> g_dirs;
+std::vector<std::string> g_extensions;
+// lower-case name -> path ("" = not found). Image lookups are keyed with a leading '>',
+// which no file name can contain.
+std::unordered_map<std::string, std::string> g_cache;
+
+HANDLE g_watcherThread = NULL;
+HANDLE g_stopEvent = NULL;
+std::vector<HANDLE> g_notifications;
+std::atomic<unsigned> g_changeCount(0);   // Bumped by the watcher thread
+unsigned g_seenChangeCount = 0;           // Value at the last cache flush
+
+std::string ToLower(const std::string& text) {
+    std::string lower(text);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+        [](unsigned char c) { return (char)tolower(c); });
+    return lower;
+}
+
+std::string ReadEnv(const char* name) {
+    DWORD size = GetEnvironmentVariableA(name, NULL, 0);
+    if (size == 0) {
+        return std::string();
+    }
+    std::string value(size, '\0');
+    DWORD length = GetEnvironmentVariableA(name, &value[0], size);
+    value.resize(length);
+    return value;
+}
+
+std::vector<std::string> Split(const std::string& text, char separator) {
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t end = text.find(separator, start);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        std::string part = text.substr(start, end - start);
+        // PATH entries may be quoted
+        part.erase(std::remove(part.begin(), part.end(), '"'), part.end());
+        while (!part.empty() && (part.back() == '\\' || part.back() == '/')) {
+            part.pop_back();
+        }
+        if (!part.empty()) {
+            parts.push_back(part);
+        }
+        start = end + 1;
+    }
+    return parts;
+}
+
+FILETIME DirWriteTime(const std::string& path) {
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &data)) {
+        return data.ftLastWriteTime;
+    }
+    FILETIME none = {0, 0};
+    return none;
+}
+
+bool SameTime(const FILETIME& a, const FILETIME& b) {
+    return a.dwLowDateTime == b.dwLowDateTime && a.dwHighDateTime == b.dwHighDateTime;
+}
+
+bool IsFile(const std::string& path) {
+    DWORD attributes = GetFileAttributesA(path.c_str());
+    return attributes != INVALID_FILE_ATTRIBUTES && !(attributes & FILE_ATTRIBUTE_DIRECTORY);
+}
+
+// Watcher thread: any file added/removed/renamed in a PATH directory bumps g_changeCount,
+// which makes the next lookup drop the cache. It never takes g_mutex, so the rebuild path
+// can stop it while holding the lock.
+DWORD WINAPI WatcherThread(LPVOID param) {
+    std::vector<HANDLE>* waitHandles = static_cast<std::vector<HANDLE>*>(param);
+
+    for (;;) {
+        DWORD result = WaitForMultipleObjects((DWORD)waitHandles->size(), waitHandles->data(), FALSE, INFINITE);
+        if (result == WAIT_OBJECT_0 || result == WAIT_FAILED) {
+            break;
+        }
+
+        g_changeCount++;
+        FindNextChangeNotification((*waitHandles)[result - WAIT_OBJECT_0]);
+    }
+
+    delete waitHandles;
+    return 0;
+}
+
+void StopWatcher() {
+    if (g_watcherThread != NULL) {
+        SetEvent(g_stopEvent);
+        WaitForSingleObject(g_watcherThread, INFINITE);
+        CloseHandle(g_watcherThread);
+        g_watcherThread = NULL;
+    }
+    for (HANDLE notification : g_notifications) {
+        FindCloseChangeNotification(notification);
+    }
+    g_notifications.clear();
+}
+
+// Rebuild search directories and watchers after PATH/PATHEXT changed.
+// Called with g_mutex held; the watcher thread is stopped first so it never sees a half-built list.
+void RebuildSearchDirs(const std::string& pathEnv, const std::string& pathExtEnv) {
+    StopWatcher();
+
+    g_pathEnv = pathEnv;
+    g_pathExtEnv = pathExtEnv;
+    g_cache.clear();
+    g_dirs.clear();
+
+    // Same order CreateProcess uses: system directories before PATH
+    std::vector<std::string> paths;
+    char buffer[MAX_PATH];
+    if (GetSystemDirectoryA(buffer, MAX_PATH) > 0) {
+        paths.push_back(buffer);
+    }
+    if (GetWindowsDirectoryA(buffer, MAX_PATH) > 0) {
+        paths.push_back(buffer);
+    }
+    for (const std::string& dir : Split(pathEnv, ';')) {
+        paths.push_back(dir);
+    }
+
+    std::vector<std::string> seen;
+    for (const std::string& path : paths) {
+        std::string lower = ToLower(path);
+        if (std::find(seen.begin(), seen.end(), lower) != seen.end()) {
+            continue;
+        }
+        seen.push_back(lower);
+
+        SearchDir dir = { path, DirWriteTime(path), false };
+        if (g_notifications.size() < kMaxWatchedDirs) {
+            HANDLE notification = FindFirstChangeNotificationA(path.c_str(), FALSE,
+                FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME);
+            if (notification != INVALID_HANDLE_VALUE) {
+                dir.watched = true;
+                g_notifications.push_back(notification);
+            }
+        }
+        g_dirs.push_back(dir);
+    }
+
+    g_extensions.clear();
+    for (const std::string& ext : Split(pathExtEnv.empty() ? ".COM;.EXE;.BAT;.CMD" : pathExtEnv, ';')) {
+        g_extensions.push_back(ToLower(ext));
+    }
+
+    if (g_stopEvent == NULL) {
+        g_stopEvent = CreateEventA(NULL, FALSE, FALSE, NULL);
+    }
+    if (!g_notifications.empty() && g_stopEvent != NULL) {
+        std::vector<HANDLE>* waitHandles = new std::vector<HANDLE>();
+        waitHandles->push_back(g_stopEvent);
+        waitHandles->insert(waitHandles->end(), g_notifications.begin(), g_notifications.end());
+        g_watcherThread = CreateThread(NULL, 0, WatcherThread, waitHandles, 0, NULL);
+        if (g_watcherThread == NULL) {
+            delete waitHandles;
+        }
+    }
+}
+
+// Apply watcher notifications; directories we could not watch are validated by mtime
+void CheckSearchDirs() {
+    unsigned changes = g_changeCount.load();
+    if (changes != g_seenChangeCount) {
+        g_seenChangeCount = changes;
+        g_cache.clear();
+    }
+
+    for (SearchDir& dir : g_dirs) {
+        if (dir.watched) {
+            continue;
+        }
+        FILETIME current = DirWriteTime(dir.path);
+        if (!SameTime(current, dir.lastWrite)) {
+            dir.lastWrite = current;
+            g_cache.clear();
+        }
+    }
+}
+
+bool HasExtension(const std::string& name) {
+    size_t dot = name.find_last_of('.');
+    size_t separator = name.find_last_of("\\/");
+    return dot != std::string::npos && (separator == std::string::npos || dot > separator);
+}
+
+bool HasPath(const std::string& name) {
+    return name.find_first_of("\\/:") != std::string::npos;
+}
+
+std::string FullPath(const std::string& path) {
+    char full[MAX_PATH];
+    DWORD length = GetFullPathNameA(path.c_str(), MAX_PATH, full, NULL);
+    return (length > 0 && length < MAX_PATH) ? std::string(full, length) : path;
+}
+
+// What CreateProcess appends to a name it searches for: .exe, and only without an extension
+std::string ImageName(const std::string& name) {
+    return HasExtension(name) ? name : name + ".exe";
+}
+
+// Directories CreateProcess searches before the system ones. Not cached: the
+// current directory can change between calls.
+std::string SearchLeadingDirs(const std::string& image) {
+    char buffer[MAX_PATH];
+    DWORD length = GetModuleFileNameA(NULL, buffer, MAX_PATH);
+    if (length > 0 && length < MAX_PATH) {
+        std::string dir(buffer, length);
+        std::string path = dir.substr(0, dir.find_last_of('\\') + 1) + image;
+        if (IsFile(path)) {
+            return path;
+        }
+    }
+    length = GetCurrentDirectoryA(MAX_PATH, buffer);
+    if (length > 0 && length < MAX_PATH) {
+        std::string path = std::string(buffer, length);
+        if (path.back() != '\\') {
+            path.push_back('\\');
+        }
+        path += image;
+        if (IsFile(path)) {
+            return path;
+        }
+    }
+    return std::string();
+}
+
+// The system directories, then PATH, for one exact file name
+std::string SearchImage(const std::string& image) {
+    for (const SearchDir& dir : g_dirs) {
+        std::string path = dir.path + "\\" + image;
+        if (IsFile(path)) {
+            return path;
+        }
+    }
+    return std::string();
+}
+
+std::string Search(const std::string& name) {
+    std::vector<std::string> candidates;
+    if (HasExtension(name)) {
+        candidates.push_back(name);
+    }
+    for (const std::string& ext : g_extensions) {
+        candidates.push_back(name + ext);
+    }
+
+    // Explicit path: no PATH search
+    if (HasPath(name)) {
+        for (const std::string& candidate : candidates) {
+            if (IsFile(candidate)) {
+                return FullPath(candidate);
+            }
+        }
+        return std::string();
+    }
+
+    for (const SearchDir& dir : g_dirs) {
+        for (const std::string& candidate : candidates) {
+            std::string path = dir.path + "\\" + candidate;
+            if (IsFile(path)) {
+                return path;
+            }
+        }
+    }
+    return std::string();
+}
+
+// Cached lookup of name through search, with the search directories brought up to date
+std::string CachedSearch(const std::string& name, const std::string& key,
+        std::string (*search)(const std::string&)) {
+    std::string pathEnv = ReadEnv("PATH");
+    std::string pathExtEnv = ReadEnv("PATHEXT");
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (pathEnv != g_pathEnv || pathExtEnv != g_pathExtEnv || g_dirs.empty()) {
+        RebuildSearchDirs(pathEnv, pathExtEnv);
+    }
+    CheckSearchDirs();
+
+    auto it = g_cache.find(key);
+    if (it != g_cache.end()) {
+        return it->second;
+    }
+
+    std::string resolved = search(name);
+    g_cache[key] = resolved;
+    return resolved;
+}
+
+std::string StripQuotes(const std::string& rawName) {
+    std::string name = rawName;
+    name.erase(std::remove(name.begin(), name.end(), '"'), name.end());
+    return name;
+}
+
+} // namespace
+
+std::string resolve_executable_path(const std::string& rawName) {
+    std::string name = StripQuotes(rawName);
+    if (name.empty()) {
+        return std::string();
+    }
+    return CachedSearch(name, ToLower(name), Search);
+}
+
+std::string resolve_image_path(const std::string& rawName) {
+    std::string name = StripQuotes(rawName);
+    if (name.empty()) {
+        return std::string();
+    }
+    std::string image = ImageName(name);
+    if (HasPath(name)) {
+        return IsFile(image) ? FullPath(image) : std::string();
+    }
+    std::string leading = SearchLeadingDirs(image);
+    if (!leading.empty()) {
+        return leading;
+    }
+    return CachedSearch(image, ">" + ToLower(image), SearchImage);
+}
+
+extern "C" {
+
+// Resolve an executable name through PATH/PATHEXT (cached)
+__declspec(dllexport) int resolve_executable(const char* name, char* buffer, int maxLength) {
+    if (name == nullptr || buffer == nullptr || maxLength <= 0) {
+        return 0;
+    }
+
+    std::string path = resolve_executable_path(name);
+    if (path.empty() || (int)path.size() >= maxLength) {
+        return 0;
+    }
+
+    memcpy(buffer, path.c_str(), path.size() + 1);
+    return (int)path.size();
+}
+
+// Check whether an executable can be found
+__declspec(dllexport) int is_executable_available(const char* name) {
+    if (name == nullptr) {
+        return 0;
+    }
+    return resolve_executable_path(name).empty() ? 0 : 1;
+}
+
+// Drop all cached resolutions
+__declspec(dllexport) void invalidate_executable_cache() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_cache.clear();
+}
+
+}
@@ -0,0 +1,23 @@
+#ifndef PATH_RESOLVER_H
+#define PATH_RESOLVER_H
+
+#include <string>
+
+extern "C" {
+    // Resolve an executable name the way the shell would (PATH + PATHEXT).
+    // Copies the absolute path into buffer and returns its length, 0 if not found.
+    __declspec(dllexport) int resolve_executable(const char* name, char* buffer, int maxLength);
+    // 1 if the executable can be found, 0 otherwise
+    __declspec(dllexport) int is_executable_available(const char* name);
+    // Drop all cached resolutions (the cache also invalidates itself on PATH directory changes)
+    __declspec(dllexport) void invalidate_executable_cache();
+}
+
+// Internal: cached resolution, empty string if not found
+std::string resolve_executable_path(const std::string& name);
+// Internal: the image CreateProcess would start for name with no application name -
+// the application directory, the current directory, the system directories, then
+// PATH, and only .exe appended. Use this for a name that is executed directly.
+std::string resolve_image_path(const std::string& name);
+
+#endif // PATH_RESOLVER_H
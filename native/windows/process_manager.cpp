@@ -1,8 +1,11 @@
 #include "process_manager.h"
+#include "path_resolver.h"
+#include "async_dispatch.h"
+#include "process_shutdown.h"
+#include "job_stats.h"
 #include <windows.h>
 #include <string>
 #include <vector>
-#include <tlhelp32.h>
 
 extern "C" {
 
@@ -51,6 +54,20 @@ static HWND FindWindowByProcessAndTitle(DWORD processId, const char* titleFragme
     return data.foundWindow;
 }
 
+// First token of a command line (the program), without surrounding quotes
+static std::string FirstCommandToken(const std::string& command) {
+    size_t start = command.find_first_not_of(" \t");
+    if (start == std::string::npos) {
+        return std::string();
+    }
+    if (command[start] == '"') {
+        size_t end = command.find('"', start + 1);
+        return command.substr(start + 1, end == std::string::npos ? std::string::npos : end - start - 1);
+    }
+    size_t end = command.find_first_of(" \t", start);
+    return command.substr(start, end == std::string::npos ? std::string::npos : end - start);
+}
+
 // Execute a command and return process ID
 __declspec(dllexport) int execute_command(const char* command, const char* working_dir, int x, int y, int width, int height) {
     STARTUPINFOA si;
@@ -62,9 +79,16 @@ __declspec(dllexport) int execute_command(const char* command, const char* worki
     
     // Create mutable copy of command
     std::string cmd(command);
+
+    // Resolve the image as CreateProcess would, through the cached lookup, so it does not search again.
+    // Scripts (.bat/.cmd) still go through the command line, since they need cmd.exe.
+    std::string image = resolve_image_path(FirstCommandToken(cmd));
+    size_t extPos = image.find_last_of('.');
+    std::string ext = extPos != std::string::npos ? image.substr(extPos) : std::string();
+    bool directImage = _stricmp(ext.c_str(), ".exe") == 0 || _stricmp(ext.c_str(), ".com") == 0;
     
     BOOL result = CreateProcessA(
-        NULL,                   // No module name (use command line)
+        directImage ? image.c_str() : NULL, // Resolved module name, or search the command line
         &cmd[0],               // Command line
         NULL,                   // Process handle not inheritable
         NULL,                   // Thread handle not inheritable
@@ -85,9 +109,10 @@ __declspec(dllexport) int execute_command(const char* command, const char* worki
     return 0;
 }
 
-// Execute command and position the resulting window
-__declspec(dllexport) int execute_command_with_positioning(const char* command, const char* working_dir, 
-    int x, int y, int width, int height, const char* windowTitleFragment, int timeoutMs) {
+// Launch a command, then poll for its window and position it.
+// With a token, the polling stops early when the async request is cancelled.
+static int LaunchAndPosition(const char* command, const char* working_dir,
+    int x, int y, int width, int height, const char* windowTitleFragment, int timeoutMs, const AsyncToken* token) {
     
     // Launch the process first
     DWORD processId = execute_command(command, working_dir, -1, -1, -1, -1);
@@ -101,7 +126,13 @@ __declspec(dllexport) int execute_command_with_positioning(const char* command,
     int maxAttempts = timeoutMs / 100; // Check every 100ms
     
     while (attempts < maxAttempts && targetWindow == NULL) {
-        Sleep(100);
+        if (token != nullptr) {
+            if (async_wait_cancelled(*token, 100)) {
+                return processId;
+            }
+        } else {
+            Sleep(100);
+        }
         targetWindow = FindWindowByProcessAndTitle(processId, windowTitleFragment);
         attempts++;
     }
@@ -114,6 +145,40 @@ __declspec(dllexport) int execute_command_with_positioning(const char* command,
     return processId;
 }
 
+// Window title fragment VS Code uses for a directory
+static std::string VscodeTitleFragment(const char* directory) {
+    std::string dirName = std::string(directory);
+    size_t lastSlash = dirName.find_last_of("\\");
+    if (lastSlash != std::string::npos) {
+        dirName = dirName.substr(lastSlash + 1);
+    }
+    return dirName;
+}
+
+// Execute command and position the resulting window
+__declspec(dllexport) int execute_command_with_positioning(const char* command, const char* working_dir, 
+    int x, int y, int width, int height, const char* windowTitleFragment, int timeoutMs) {
+    return LaunchAndPosition(command, working_dir, x, y, width, height, windowTitleFragment, timeoutMs, nullptr);
+}
+
+// Non-blocking execute_command_with_positioning: returns a request id, the process id
+// is posted to the async completion callback
+__declspec(dllexport) int64_t execute_command_with_positioning_async(const char* command, const char* working_dir,
+    int x, int y, int width, int height, const char* windowTitleFragment, int timeoutMs) {
+
+    // Copy arguments - the caller frees them as soon as we return
+    std::string cmd(command);
+    bool hasDir = working_dir != nullptr;
+    std::string dir = hasDir ? working_dir : "";
+    bool hasFragment = windowTitleFragment != nullptr;
+    std::string fragment = hasFragment ? windowTitleFragment : "";
+
+    return async_submit([=](const AsyncToken& token) -> int64_t {
+        return LaunchAndPosition(cmd.c_str(), hasDir ? dir.c_str() : nullptr, x, y, width, height,
+            hasFragment ? fragment.c_str() : nullptr, timeoutMs, &token);
+    });
+}
+
 // Open VS Code in a specific directory
 __declspec(dllexport) int open_vscode(const char* directory) {
     std::string command = "code \"" + std::string(directory) + "\"";
@@ -124,16 +189,23 @@ __declspec(dllexport) int open_vscode(const char* directory) {
 __declspec(dllexport) int open_vscode_positioned(const char* directory, int x, int y, int width, int height) {
     std::string command = "code \"" + std::string(directory) + "\"";
     // Use directory name as window title fragment to identify the correct VS Code window
-    std::string dirName = std::string(directory);
-    size_t lastSlash = dirName.find_last_of("\\");
-    if (lastSlash != std::string::npos) {
-        dirName = dirName.substr(lastSlash + 1);
-    }
+    std::string dirName = VscodeTitleFragment(directory);
     
     return execute_command_with_positioning(command.c_str(), directory, x, y, width, height, 
         dirName.c_str(), 5000); // 5 second timeout
 }
 
+// Non-blocking open_vscode_positioned (result posted to the async completion callback)
+__declspec(dllexport) int64_t open_vscode_positioned_async(const char* directory, int x, int y, int width, int height) {
+    std::string command = "code \"" + std::string(directory) + "\"";
+    std::string dir(directory);
+    std::string dirName = VscodeTitleFragment(directory);
+
+    return async_submit([=](const AsyncToken& token) -> int64_t {
+        return LaunchAndPosition(command.c_str(), dir.c_str(), x, y, width, height, dirName.c_str(), 5000, &token);
+    });
+}
+
 // Execute command in existing VS Code terminal
 __declspec(dllexport) int execute_in_vscode_terminal(const char* command, const char* directory) {
     std::string cmd = "code \"" + std::string(directory) + "\" --command \"workbench.action.terminal.sendSequence\" --args=\"" + std::string(command) + "\\r\"";
@@ -234,9 +306,22 @@ __declspec(dllexport) HWND find_cmd_window_by_title_fragment(const char* fragmen
     return data.foundWindow;
 }
 
-// Execute SSH session with automated password input and command execution
-__declspec(dllexport) int execute_ssh_session(const char* host, const char* username, const char* password,
-    int port, const char* remote_dir, const char* remote_command, int x, int y, int width, int height) {
+// Sleep for ms, or with a token until the async request is cancelled.
+// Returns true if it was cancelled.
+static bool WaitOrCancelled(const AsyncToken* token, DWORD ms) {
+    if (token != nullptr) {
+        return async_wait_cancelled(*token, ms);
+    }
+    Sleep(ms);
+    return false;
+}
+
+// Launch ssh in a visible CMD window and type the password, cd and command into it
+// after fixed delays. With a token, the delays end early when the async request is
+// cancelled, and nothing more is typed.
+static int RunSshSession(const char* host, const char* username, const char* password,
+    int port, const char* remote_dir, const char* remote_command, int x, int y, int width, int height,
+    const AsyncToken* token) {
 
     // Build the SSH command
     std::string sshCommand = "ssh ";
@@ -254,7 +339,9 @@ __declspec(dllexport) int execute_ssh_session(const char* host, const char* user
     }
 
     // Wait for CMD window to appear
-    Sleep(1000);
+    if (WaitOrCancelled(token, 1000)) {
+        return processId;
+    }
 
     // Find the CMD window
     HWND cmdWindow = NULL;
@@ -262,7 +349,9 @@ __declspec(dllexport) int execute_ssh_session(const char* host, const char* user
     while (attempts < 50 && cmdWindow == NULL) { // 5 second timeout
         cmdWindow = find_cmd_window_by_title_fragment("cmd");
         if (cmdWindow == NULL) {
-            Sleep(100);
+            if (WaitOrCancelled(token, 100)) {
+                return processId;
+            }
             attempts++;
         }
     }
@@ -277,20 +366,26 @@ __declspec(dllexport) int execute_ssh_session(const char* host, const char* user
     }
 
     // Wait for SSH to prompt for password (usually takes 2-3 seconds)
-    Sleep(3000);
+    if (WaitOrCancelled(token, 3000)) {
+        return processId;
+    }
 
     // Send the password
     std::string passwordWithEnter = std::string(password) + "\r";
     send_text_to_window(cmdWindow, passwordWithEnter.c_str());
 
     // Wait for login to complete
-    Sleep(2000);
+    if (WaitOrCancelled(token, 2000)) {
+        return processId;
+    }
 
     // Navigate to remote directory if specified
     if (remote_dir != nullptr && strlen(remote_dir) > 0) {
         std::string cdCommand = "cd " + std::string(remote_dir) + "\r";
         send_text_to_window(cmdWindow, cdCommand.c_str());
-        Sleep(500);
+        if (WaitOrCancelled(token, 500)) {
+            return processId;
+        }
     }
 
     // Execute remote command if specified
@@ -302,6 +397,34 @@ __declspec(dllexport) int execute_ssh_session(const char* host, const char* user
     return processId;
 }
 
+// Execute SSH session with automated password input and command execution, in a
+// visible CMD window. Returns the CMD process id. Blocks for about 6.5 seconds;
+// use execute_ssh_session_async from the UI isolate.
+__declspec(dllexport) int execute_ssh_session(const char* host, const char* username, const char* password,
+    int port, const char* remote_dir, const char* remote_command, int x, int y, int width, int height) {
+    return RunSshSession(host, username, password, port, remote_dir, remote_command, x, y, width, height, nullptr);
+}
+
+// Non-blocking execute_ssh_session: returns a request id, the CMD process id is posted
+// to the async completion callback
+__declspec(dllexport) int64_t execute_ssh_session_async(const char* host, const char* username, const char* password,
+    int port, const char* remote_dir, const char* remote_command, int x, int y, int width, int height) {
+
+    // Copy arguments - the caller frees them as soon as we return
+    std::string hostCopy(host);
+    std::string user(username);
+    std::string pass(password);
+    bool hasDir = remote_dir != nullptr;
+    std::string dir = hasDir ? remote_dir : "";
+    bool hasCommand = remote_command != nullptr;
+    std::string command = hasCommand ? remote_command : "";
+
+    return async_submit([=](const AsyncToken& token) -> int64_t {
+        return RunSshSession(hostCopy.c_str(), user.c_str(), pass.c_str(), port, hasDir ? dir.c_str() : nullptr,
+            hasCommand ? command.c_str() : nullptr, x, y, width, height, &token);
+    });
+}
+
 // Test basic CMD window opening
 __declspec(dllexport) int test_cmd_window() {
     // Try to open a simple CMD window
@@ -339,14 +462,34 @@ __declspec(dllexport) intptr_t create_job_for_process(DWORD processId) {
     CloseHandle(hProcess); // We no longer need the process handle
 
     if (!assigned) {
-        // Process might already be in a job - this is not fatal
-        // The job object will still work for any new child processes
-        // that aren't breaking away from the job
+        // An empty job contains nothing - report no containment so callers
+        // fall back to walking the process tree
+        CloseHandle(hJob);
+        return 0;
     }
 
     return reinterpret_cast<intptr_t>(hJob);
 }
 
+// List the processes currently in a job (no system-wide process scan)
+// Returns the number of ids written to processIds
+__declspec(dllexport) int job_process_ids(intptr_t jobHandle, uint32_t* processIds, int maxCount) {
+    if (jobHandle == 0 || processIds == nullptr || maxCount <= 0) {
+        return 0;
+    }
+
+    std::vector<DWORD> ids;
+    if (!job_member_pids(reinterpret_cast<HANDLE>(jobHandle), &ids)) {
+        return 0;
+    }
+
+    int count = min((int)ids.size(), maxCount);
+    for (int i = 0; i < count; i++) {
+        processIds[i] = (uint32_t)ids[i];
+    }
+    return count;
+}
+
 // Terminate all processes in the job and close the handle
 __declspec(dllexport) bool terminate_job(intptr_t jobHandle) {
     if (jobHandle == 0) {
@@ -362,114 +505,42 @@ __declspec(dllexport) bool terminate_job(intptr_t jobHandle) {
     return CloseHandle(hJob) != FALSE;
 }
 
-// Kill a process and all its descendants by walking the process tree
-__declspec(dllexport) bool kill_process_tree(DWORD rootProcessId) {
-    if (rootProcessId == 0) {
+// Close a job handle (e.g. a task_container_job duplicate) once the task is done with it
+__declspec(dllexport) bool release_job(intptr_t jobHandle) {
+    if (jobHandle == 0) {
         return false;
     }
+    return CloseHandle(reinterpret_cast<HANDLE>(jobHandle)) != FALSE;
+}
 
-    // Snapshot all processes
-    HANDLE snap = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
-    if (snap == INVALID_HANDLE_VALUE) {
-        // Fallback: just kill the root process
-        HANDLE hProc = OpenProcess(PROCESS_TERMINATE, FALSE, rootProcessId);
-        if (hProc) {
-            TerminateProcess(hProc, 1);
-            CloseHandle(hProc);
-        }
+// Kill a process and all its descendants by walking the process tree.
+// Everything is terminated at once, then waited on until it is really gone.
+__declspec(dllexport) bool kill_process_tree(DWORD rootProcessId) {
+    if (rootProcessId == 0) {
         return false;
     }
 
-    // Collect all descendant PIDs (breadth-first)
-    std::vector<DWORD> toVisit;
-    std::vector<DWORD> allPids;
-    toVisit.push_back(rootProcessId);
-
-    while (!toVisit.empty()) {
-        DWORD parentPid = toVisit.back();
-        toVisit.pop_back();
-
-        PROCESSENTRY32 pe;
-        pe.dwSize = sizeof(pe);
-
-        if (Process32First(snap, &pe)) {
-            do {
-                if (pe.th32ParentProcessID == parentPid && pe.th32ProcessID != rootProcessId) {
-                    allPids.push_back(pe.th32ProcessID);
-                    toVisit.push_back(pe.th32ProcessID);
-                }
-            } while (Process32Next(snap, &pe));
+    std::vector<ShutdownReportEntry> report(1024);
+    int count = shutdown_tree_cancellable(rootProcessId, NULL, 0, 0, 2000,
+        report.data(), (int)report.size(), NULL);
+    for (int i = 0; i < count && i < (int)report.size(); i++) {
+        if (report[i].stage == SHUTDOWN_STAGE_SURVIVED) {
+            return false;
         }
     }
-
-    CloseHandle(snap);
-
-    // Kill children first (deepest last in the list, kill in reverse)
-    for (int i = (int)allPids.size() - 1; i >= 0; i--) {
-        HANDLE hProc = OpenProcess(PROCESS_TERMINATE, FALSE, allPids[i]);
-        if (hProc) {
-            TerminateProcess(hProc, 1);
-            CloseHandle(hProc);
-        }
-    }
-
-    // Kill the root process last
-    HANDLE hRoot = OpenProcess(PROCESS_TERMINATE, FALSE, rootProcessId);
-    if (hRoot) {
-        TerminateProcess(hRoot, 1);
-        CloseHandle(hRoot);
-    }
-
     return true;
 }
 
-// Check if SSH is available in the system
-__declspec(dllexport) int check_ssh_available() {
-    // Try to execute ssh with no arguments to see if it's available
-    STARTUPINFOA si;
-    PROCESS_INFORMATION pi;
-
-    ZeroMemory(&si, sizeof(si));
-    si.cb = sizeof(si);
-    si.dwFlags = STARTF_USESHOWWINDOW;
-    si.wShowWindow = SW_HIDE; // Hide the window
-    ZeroMemory(&pi, sizeof(pi));
-
-    // Create a command to test SSH availability - use ssh with no args
-    // This will show usage and exit with 255, but it means SSH is available
-    std::string testCommand = "ssh";
-
-    BOOL result = CreateProcessA(
-        NULL,
-        &testCommand[0],
-        NULL,
-        NULL,
-        FALSE,
-        CREATE_NO_WINDOW, // Don't create a window
-        NULL,
-        NULL,
-        &si,
-        &pi
-    );
-
-    if (result) {
-        // Wait for the process to complete (with timeout)
-        DWORD waitResult = WaitForSingleObject(pi.hProcess, 5000); // 5 second timeout
-
-        DWORD exitCode = 1; // Default to error
-        if (waitResult == WAIT_OBJECT_0) {
-            GetExitCodeProcess(pi.hProcess, &exitCode);
-        }
-
-        CloseHandle(pi.hProcess);
-        CloseHandle(pi.hThread);
-
-        // SSH returns 255 when run with no args (showing usage), which means it's available
-        // Only return 0 (not available) if the process couldn't be created or timed out
-        return (waitResult == WAIT_OBJECT_0) ? 1 : 0;
-    }
+// Non-blocking kill_process_tree (1/0 posted to the async completion callback)
+__declspec(dllexport) int64_t kill_process_tree_async(DWORD rootProcessId) {
+    return async_submit([=](const AsyncToken&) -> int64_t {
+        return kill_process_tree(rootProcessId) ? 1 : 0;
+    });
+}
 
-    return 0; // SSH not available
+// Check if SSH is available in the system (cached PATH lookup, no process launch)
+__declspec(dllexport) int check_ssh_available() {
+    return is_executable_available("ssh");
 }
 
 }
\ No newline at end of file
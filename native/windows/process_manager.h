@@ -2,6 +2,7 @@
 #define PROCESS_MANAGER_H
 
 #include <windows.h>
+#include <stdint.h>
 
 extern "C" {
     __declspec(dllexport) int execute_command(const char* command, const char* working_dir, int x, int y, int width, int height);
@@ -11,20 +12,33 @@ extern "C" {
     __declspec(dllexport) int execute_in_vscode_terminal(const char* command, const char* directory);
     __declspec(dllexport) bool position_window_by_hwnd(HWND hwnd, int x, int y, int width, int height);
 
-    // SSH automation functions
+    // Non-blocking variants: return a request id (0 on failure) and post the result
+    // to the callback registered with async_set_completion_callback (see async_dispatch.h)
+    __declspec(dllexport) int64_t execute_command_with_positioning_async(const char* command, const char* working_dir, int x, int y, int width, int height, const char* windowTitleFragment, int timeoutMs);
+    __declspec(dllexport) int64_t open_vscode_positioned_async(const char* directory, int x, int y, int width, int height);
+    __declspec(dllexport) int64_t kill_process_tree_async(DWORD rootProcessId);
+    __declspec(dllexport) int64_t execute_ssh_session_async(const char* host, const char* username, const char* password, int port, const char* remote_dir, const char* remote_command, int x, int y, int width, int height);
+
+    // SSH automation functions (execute_ssh_session returns the CMD process id)
     __declspec(dllexport) int execute_ssh_session(const char* host, const char* username, const char* password, int port, const char* remote_dir, const char* remote_command, int x, int y, int width, int height);
     __declspec(dllexport) bool send_text_to_window(HWND hwnd, const char* text);
     __declspec(dllexport) HWND find_cmd_window_by_title_fragment(const char* fragment);
 
     // Debug functions
     __declspec(dllexport) int test_cmd_window();
-    __declspec(dllexport) int check_ssh_available();
+    __declspec(dllexport) int check_ssh_available(); // Cached PATH lookup, see path_resolver.h
 
     // Job object functions for process tree management
     __declspec(dllexport) intptr_t create_job_for_process(DWORD processId);
     __declspec(dllexport) bool terminate_job(intptr_t jobHandle);
+    // Close a job handle without terminating the job. Closing the last handle of a
+    // create_job_for_process job still ends its processes (kill on job close).
+    __declspec(dllexport) bool release_job(intptr_t jobHandle);
+    // Process ids currently in the job (task containers: see task_container.h)
+    __declspec(dllexport) int job_process_ids(intptr_t jobHandle, uint32_t* processIds, int maxCount);
 
-    // Process tree kill - walks the process tree and terminates all descendants
+    // Process tree kill - terminates all descendants at once and waits for them
+    // (graceful, staged shutdown: see process_shutdown.h)
     __declspec(dllexport) bool kill_process_tree(DWORD rootProcessId);
 }
 
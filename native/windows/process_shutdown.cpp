@@ -0,0 +1,325 @@
+#include "process_shutdown.h"
+#include "async_dispatch.h"
+#include "job_stats.h"
+#include <windows.h>
+#include <tlhelp32.h>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace {
+
+struct Member {
+    DWORD processId = 0;
+    HANDLE hProcess = NULL;
+    bool exited = false;
+    int32_t exitCode = -1;
+    int32_t stage = SHUTDOWN_STAGE_SURVIVED;
+};
+
+// The console is process-wide: every FreeConsole/AttachConsole in the library
+// happens in SendConsoleCtrl under this lock, one shutdown at a time
+std::mutex g_consoleMutex;
+bool g_ctrlHandlerInstalled = false;
+
+// Swallow the control events we generate ourselves while attached to a task's console.
+// A handler routine (unlike SetConsoleCtrlHandler(NULL, TRUE)) is not inherited by
+// processes we launch later, so their Ctrl+C keeps working.
+BOOL WINAPI IgnoreCtrlEvent(DWORD ctrlType) {
+    return ctrlType == CTRL_C_EVENT || ctrlType == CTRL_BREAK_EVENT;
+}
+
+void AddMember(std::vector<Member>& members, DWORD processId) {
+    for (const auto& member : members) {
+        if (member.processId == processId) {
+            return;
+        }
+    }
+    HANDLE hProcess = OpenProcess(SYNCHRONIZE | PROCESS_TERMINATE | PROCESS_QUERY_LIMITED_INFORMATION,
+        FALSE, processId);
+    if (hProcess == NULL) {
+        return; // Already gone
+    }
+    Member member;
+    member.processId = processId;
+    member.hProcess = hProcess;
+    members.push_back(member);
+}
+
+// Add the root, every job member and, without a job, every descendant (by parent PID)
+// of a known process. Runs again before each stage so children started by shutdown
+// handlers are caught too.
+void CollectMembers(std::vector<Member>& members, DWORD rootProcessId, HANDLE hJob) {
+    AddMember(members, rootProcessId);
+
+    std::vector<DWORD> ids;
+    if (hJob != NULL && job_member_pids(hJob, &ids)) {
+        for (DWORD processId : ids) {
+            AddMember(members, processId);
+        }
+        // Descendants cannot leave the job, so the list is the whole tree
+        if (!ids.empty()) {
+            return;
+        }
+    }
+
+    HANDLE snap = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (snap == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    std::vector<PROCESSENTRY32> entries;
+    PROCESSENTRY32 pe;
+    pe.dwSize = sizeof(pe);
+    if (Process32First(snap, &pe)) {
+        do {
+            entries.push_back(pe);
+        } while (Process32Next(snap, &pe));
+    }
+    CloseHandle(snap);
+
+    // Orphans still carry their dead parent's PID, so exited members stay in the set
+    std::set<DWORD> known;
+    known.insert(rootProcessId);
+    for (const auto& member : members) {
+        known.insert(member.processId);
+    }
+    bool added = true;
+    while (added) {
+        added = false;
+        for (const auto& entry : entries) {
+            if (known.count(entry.th32ProcessID) || !known.count(entry.th32ParentProcessID)) {
+                continue;
+            }
+            known.insert(entry.th32ProcessID);
+            AddMember(members, entry.th32ProcessID);
+            added = true;
+        }
+    }
+}
+
+void MarkExited(Member& member, int32_t stage) {
+    DWORD code = 0;
+    member.exited = true;
+    member.exitCode = GetExitCodeProcess(member.hProcess, &code) ? (int32_t)code : -1;
+    member.stage = stage;
+}
+
+// Wait on every running member at once until all have exited, the timeout passes or
+// cancelEvent is signalled. Returns true if nothing is left running.
+bool WaitForMembers(std::vector<Member>& members, DWORD timeoutMs, int32_t stage, HANDLE cancelEvent) {
+    ULONGLONG deadline = GetTickCount64() + timeoutMs;
+    for (;;) {
+        std::vector<HANDLE> handles;
+        std::vector<size_t> indexes;
+        if (cancelEvent != NULL) {
+            handles.push_back(cancelEvent);
+        }
+        for (size_t i = 0; i < members.size() && handles.size() < MAXIMUM_WAIT_OBJECTS; i++) {
+            if (!members[i].exited) {
+                handles.push_back(members[i].hProcess);
+                indexes.push_back(i);
+            }
+        }
+        if (indexes.empty()) {
+            return true;
+        }
+
+        ULONGLONG now = GetTickCount64();
+        DWORD remaining = now < deadline ? (DWORD)(deadline - now) : 0;
+        DWORD result = WaitForMultipleObjects((DWORD)handles.size(), handles.data(), FALSE, remaining);
+        if (result >= WAIT_OBJECT_0 && result < WAIT_OBJECT_0 + handles.size()) {
+            size_t slot = result - WAIT_OBJECT_0;
+            if (cancelEvent != NULL) {
+                if (slot == 0) {
+                    return false;
+                }
+                slot--;
+            }
+            MarkExited(members[indexes[slot]], stage);
+            continue;
+        }
+        break; // Deadline passed
+    }
+
+    // Trees wider than one wait call: pick up members beyond the first batch
+    bool allExited = true;
+    for (auto& member : members) {
+        if (member.exited) {
+            continue;
+        }
+        if (WaitForSingleObject(member.hProcess, 0) == WAIT_OBJECT_0) {
+            MarkExited(member, stage);
+        } else {
+            allExited = false;
+        }
+    }
+    return allExited;
+}
+
+// Whether we have a console; *peer is another process attached to it to attach
+// back through, 0 if there is none (the console would close with FreeConsole)
+bool ConsolePeer(DWORD* peer) {
+    *peer = 0;
+    std::vector<DWORD> ids(16);
+    DWORD count = GetConsoleProcessList(ids.data(), (DWORD)ids.size());
+    if (count > ids.size()) {
+        ids.resize(count + 16);
+        count = GetConsoleProcessList(ids.data(), (DWORD)ids.size());
+    }
+    for (DWORD i = 0; i < count && i < ids.size() && *peer == 0; i++) {
+        if (ids[i] != GetCurrentProcessId()) {
+            *peer = ids[i];
+        }
+    }
+    return count > 0;
+}
+
+// Raise a console control event in every console a running member is attached to.
+// ConPTY tasks share one pseudo console, so this is usually a single event.
+void SendConsoleCtrl(const std::vector<Member>& members, DWORD ctrlEvent) {
+    std::lock_guard<std::mutex> lock(g_consoleMutex);
+    if (!g_ctrlHandlerInstalled) {
+        g_ctrlHandlerInstalled = SetConsoleCtrlHandler(IgnoreCtrlEvent, TRUE) != FALSE;
+    }
+
+    // Normally we are a GUI process without a console. One with a console (a debug
+    // run from a terminal) gets it back afterwards through a process sharing it; a
+    // console of its own (allocated under a debugger) would be destroyed, so then
+    // no console is borrowed and later stages do the work.
+    DWORD peer;
+    if (ConsolePeer(&peer) && peer == 0) {
+        return;
+    }
+    FreeConsole();
+
+    std::set<HWND> signalled;
+    for (const auto& member : members) {
+        if (member.exited || !AttachConsole(member.processId)) {
+            continue;
+        }
+        HWND console = GetConsoleWindow();
+        if (signalled.insert(console).second) {
+            GenerateConsoleCtrlEvent(ctrlEvent, 0); // 0 = everything attached to this console
+        }
+        FreeConsole();
+    }
+
+    if (peer != 0) {
+        AttachConsole(peer);
+    }
+}
+
+BOOL CALLBACK PostCloseToWindow(HWND hwnd, LPARAM lParam) {
+    auto processIds = reinterpret_cast<const std::set<DWORD>*>(lParam);
+    DWORD processId = 0;
+    GetWindowThreadProcessId(hwnd, &processId);
+    if (processIds->count(processId) && IsWindowVisible(hwnd) && GetWindow(hwnd, GW_OWNER) == NULL) {
+        PostMessageA(hwnd, WM_CLOSE, 0, 0);
+    }
+    return TRUE;
+}
+
+// Ask windowed members (editors, browsers started by a task) to close
+void PostCloseToWindows(const std::vector<Member>& members) {
+    std::set<DWORD> processIds;
+    for (const auto& member : members) {
+        if (!member.exited) {
+            processIds.insert(member.processId);
+        }
+    }
+    if (!processIds.empty()) {
+        EnumWindows(PostCloseToWindow, reinterpret_cast<LPARAM>(&processIds));
+    }
+}
+
+void TerminateMembers(const std::vector<Member>& members, HANDLE hJob) {
+    if (hJob != NULL) {
+        TerminateJobObject(hJob, 1);
+    }
+    // Members outside the job (or if the job could not be assigned)
+    for (const auto& member : members) {
+        if (!member.exited) {
+            TerminateProcess(member.hProcess, 1);
+        }
+    }
+}
+
+} // namespace
+
+int shutdown_tree_cancellable(DWORD rootProcessId, HANDLE hJob, int interruptTimeoutMs,
+        int breakTimeoutMs, int terminateTimeoutMs, ShutdownReportEntry* report, int maxEntries,
+        HANDLE cancelEvent) {
+    if (rootProcessId == 0) {
+        return 0;
+    }
+
+    std::vector<Member> members;
+    CollectMembers(members, rootProcessId, hJob);
+    bool done = WaitForMembers(members, 0, SHUTDOWN_STAGE_ALREADY_EXITED, NULL);
+
+    const struct {
+        int32_t stage;
+        int timeoutMs;
+    } stages[] = {
+        {SHUTDOWN_STAGE_INTERRUPT, interruptTimeoutMs},
+        {SHUTDOWN_STAGE_BREAK, breakTimeoutMs},
+        {SHUTDOWN_STAGE_TERMINATE, terminateTimeoutMs},
+    };
+
+    for (const auto& stage : stages) {
+        if (done || stage.timeoutMs <= 0) {
+            continue;
+        }
+        if (cancelEvent != NULL && WaitForSingleObject(cancelEvent, 0) == WAIT_OBJECT_0) {
+            break;
+        }
+
+        CollectMembers(members, rootProcessId, hJob);
+        switch (stage.stage) {
+            case SHUTDOWN_STAGE_INTERRUPT:
+                SendConsoleCtrl(members, CTRL_C_EVENT);
+                break;
+            case SHUTDOWN_STAGE_BREAK:
+                SendConsoleCtrl(members, CTRL_BREAK_EVENT);
+                PostCloseToWindows(members);
+                break;
+            case SHUTDOWN_STAGE_TERMINATE:
+                TerminateMembers(members, hJob);
+                break;
+        }
+        done = WaitForMembers(members, (DWORD)stage.timeoutMs, stage.stage, cancelEvent);
+    }
+
+    for (size_t i = 0; i < members.size(); i++) {
+        if (report != nullptr && (int)i < maxEntries) {
+            report[i].processId = members[i].processId;
+            report[i].exitCode = members[i].exitCode;
+            report[i].stage = members[i].stage;
+        }
+        CloseHandle(members[i].hProcess);
+    }
+    return (int)members.size();
+}
+
+extern "C" {
+
+// Staged, concurrent shutdown of a process tree (see process_shutdown.h)
+__declspec(dllexport) int shutdown_tree(DWORD rootProcessId, intptr_t jobHandle,
+        int interruptTimeoutMs, int breakTimeoutMs, int terminateTimeoutMs,
+        ShutdownReportEntry* report, int maxEntries) {
+    return shutdown_tree_cancellable(rootProcessId, reinterpret_cast<HANDLE>(jobHandle),
+        interruptTimeoutMs, breakTimeoutMs, terminateTimeoutMs, report, maxEntries, NULL);
+}
+
+// Non-blocking shutdown_tree (process count posted to the async completion callback)
+__declspec(dllexport) int64_t shutdown_tree_async(DWORD rootProcessId, intptr_t jobHandle,
+        int interruptTimeoutMs, int breakTimeoutMs, int terminateTimeoutMs,
+        ShutdownReportEntry* report, int maxEntries) {
+    HANDLE hJob = reinterpret_cast<HANDLE>(jobHandle);
+    return async_submit([=](const AsyncToken& token) -> int64_t {
+        return shutdown_tree_cancellable(rootProcessId, hJob, interruptTimeoutMs, breakTimeoutMs,
+            terminateTimeoutMs, report, maxEntries, token.cancelEvent);
+    });
+}
+
+}
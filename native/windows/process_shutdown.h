@@ -0,0 +1,45 @@
+#ifndef PROCESS_SHUTDOWN_H
+#define PROCESS_SHUTDOWN_H
+
+#include <windows.h>
+#include <stdint.h>
+
+// Stage at which a process was seen to exit (ShutdownReportEntry.stage)
+enum ShutdownStage {
+    SHUTDOWN_STAGE_ALREADY_EXITED = 0, // Gone before any signal was sent
+    SHUTDOWN_STAGE_INTERRUPT = 1,      // Exited after CTRL_C_EVENT
+    SHUTDOWN_STAGE_BREAK = 2,          // Exited after CTRL_BREAK_EVENT / WM_CLOSE
+    SHUTDOWN_STAGE_TERMINATE = 3,      // Had to be terminated
+    SHUTDOWN_STAGE_SURVIVED = 4,       // Still running when the last deadline passed
+};
+
+// One line of the per-process report, filled in tree discovery order (root first)
+struct ShutdownReportEntry {
+    uint32_t processId;
+    int32_t exitCode; // -1 if unknown or still running
+    int32_t stage;    // ShutdownStage
+};
+
+extern "C" {
+    // Staged shutdown of a process tree: Ctrl+C, then Ctrl+Break (and WM_CLOSE for
+    // windowed members), then TerminateJobObject/TerminateProcess. Each stage waits
+    // on every remaining member at once for up to its own timeout; a timeout of 0
+    // skips that stage. jobHandle may be 0, members are then found by parent PID.
+    // Writes up to maxEntries report lines and returns the number of processes seen.
+    __declspec(dllexport) int shutdown_tree(DWORD rootProcessId, intptr_t jobHandle,
+        int interruptTimeoutMs, int breakTimeoutMs, int terminateTimeoutMs,
+        ShutdownReportEntry* report, int maxEntries);
+    // Non-blocking shutdown_tree: the process count is posted to the async completion
+    // callback. report must stay allocated until then; cancelling stops escalation.
+    __declspec(dllexport) int64_t shutdown_tree_async(DWORD rootProcessId, intptr_t jobHandle,
+        int interruptTimeoutMs, int breakTimeoutMs, int terminateTimeoutMs,
+        ShutdownReportEntry* report, int maxEntries);
+}
+
+// Internal: shutdown_tree that also gives up (without escalating further) once
+// cancelEvent is signalled. cancelEvent may be NULL.
+int shutdown_tree_cancellable(DWORD rootProcessId, HANDLE hJob, int interruptTimeoutMs,
+    int breakTimeoutMs, int terminateTimeoutMs, ShutdownReportEntry* report, int maxEntries,
+    HANDLE cancelEvent);
+
+#endif // PROCESS_SHUTDOWN_H
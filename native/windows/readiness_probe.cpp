@@ -0,0 +1,482 @@
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#include "readiness_probe.h"
+#include <stdlib.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+enum AttemptPhase {
+    PHASE_IDLE,
+    PHASE_CONNECTING,
+    PHASE_SENDING,
+    PHASE_RECEIVING,
+};
+
+struct Probe {
+    int64_t id = 0;
+    int32_t kind = PROBE_KIND_TCP;
+    // "localhost" has one address per loopback family; a server may listen on either
+    sockaddr_storage addresses[2] = {};
+    int addressLengths[2] = {};
+    int addressCount = 0;
+    std::string request;  // HTTP request sent on every attempt
+    std::wstring filePath;
+    int32_t expectedStatus = 0;
+    ULONGLONG intervalMs = 1000;
+    ULONGLONG timeoutMs = 1000;
+    int32_t successThreshold = 1;
+    int32_t failureThreshold = 3;
+    bool removed = false;
+
+    // Current attempt (owned by the probe thread)
+    AttemptPhase phase = PHASE_IDLE;
+    // One socket per address while connecting, all at once (a refused loopback connect
+    // takes seconds on Windows); then only the connected one is left
+    SOCKET sockets[2] = {INVALID_SOCKET, INVALID_SOCKET};
+    int connected = 0; // Index of the socket that connected
+    ULONGLONG nextDue = 0;
+    ULONGLONG attemptStart = 0;
+    size_t sent = 0;
+    std::string response;
+
+    int32_t successes = 0;
+    int32_t failures = 0;
+    bool ready = false;
+};
+
+struct PendingEvent {
+    int64_t probeId;
+    int32_t kind;
+    int32_t detail;
+};
+
+std::mutex g_mutex;
+std::map<int64_t, std::shared_ptr<Probe>> g_probes;
+int64_t g_nextProbeId = 1;
+std::atomic<ProbeEventCallback> g_callback(nullptr);
+HANDLE g_thread = NULL;
+SOCKET g_wakeSocket = INVALID_SOCKET; // Loopback UDP socket; a datagram to it ends a poll early
+sockaddr_in g_wakeAddress = {};
+
+bool ParseLiteral(const char* host, int32_t port, sockaddr_storage* address, int* length) {
+    auto v4 = reinterpret_cast<sockaddr_in*>(address);
+    if (inet_pton(AF_INET, host, &v4->sin_addr) == 1) {
+        v4->sin_family = AF_INET;
+        v4->sin_port = htons((u_short)port);
+        *length = sizeof(sockaddr_in);
+        return true;
+    }
+    auto v6 = reinterpret_cast<sockaddr_in6*>(address);
+    if (inet_pton(AF_INET6, host, &v6->sin6_addr) == 1) {
+        v6->sin6_family = AF_INET6;
+        v6->sin6_port = htons((u_short)port);
+        *length = sizeof(sockaddr_in6);
+        return true;
+    }
+    return false;
+}
+
+bool ParseAddress(const char* host, int32_t port, Probe& probe) {
+    if (host == nullptr || host[0] == '\0' || _stricmp(host, "localhost") == 0) {
+        probe.addressCount = 2;
+        return ParseLiteral("127.0.0.1", port, &probe.addresses[0], &probe.addressLengths[0]) &&
+            ParseLiteral("::1", port, &probe.addresses[1], &probe.addressLengths[1]);
+    }
+    probe.addressCount = 1;
+    // Names would need a blocking lookup on the shared thread
+    return ParseLiteral(host, port, &probe.addresses[0], &probe.addressLengths[0]);
+}
+
+std::wstring Utf8ToWide(const char* text) {
+    int length = MultiByteToWideChar(CP_UTF8, 0, text, -1, NULL, 0);
+    if (length <= 1) {
+        return std::wstring();
+    }
+    std::wstring wide(length - 1, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, text, -1, &wide[0], length);
+    return wide;
+}
+
+void Wake() {
+    if (g_wakeSocket != INVALID_SOCKET) {
+        char byte = 0;
+        sendto(g_wakeSocket, &byte, 1, 0, reinterpret_cast<sockaddr*>(&g_wakeAddress), sizeof(g_wakeAddress));
+    }
+}
+
+void CloseSocket(Probe& probe, int index) {
+    if (probe.sockets[index] != INVALID_SOCKET) {
+        closesocket(probe.sockets[index]);
+        probe.sockets[index] = INVALID_SOCKET;
+    }
+}
+
+void CloseAttemptSockets(Probe& probe) {
+    for (int i = 0; i < 2; i++) {
+        CloseSocket(probe, i);
+    }
+}
+
+// Record an attempt result and queue a ready/not-ready transition
+void FinishAttempt(Probe& probe, bool passed, int32_t failure, ULONGLONG now,
+        std::vector<PendingEvent>& events) {
+    CloseAttemptSockets(probe);
+    probe.phase = PHASE_IDLE;
+    probe.response.clear();
+    probe.sent = 0;
+    // Keep the cadence steady regardless of how long the attempt took
+    probe.nextDue = probe.attemptStart + probe.intervalMs;
+    if (probe.nextDue < now) {
+        probe.nextDue = now;
+    }
+
+    if (passed) {
+        probe.failures = 0;
+        probe.successes++;
+        if (!probe.ready && probe.successes >= probe.successThreshold) {
+            probe.ready = true;
+            events.push_back({probe.id, PROBE_EVENT_READY, (int32_t)(now - probe.attemptStart)});
+        }
+    } else {
+        probe.successes = 0;
+        probe.failures++;
+        if (probe.ready && probe.failures >= probe.failureThreshold) {
+            probe.ready = false;
+            events.push_back({probe.id, PROBE_EVENT_NOT_READY, failure});
+        }
+    }
+}
+
+// Start a non-blocking connect to every address; false when none could start
+bool ConnectAll(Probe& probe) {
+    bool started = false;
+    for (int index = 0; index < probe.addressCount; index++) {
+        sockaddr_storage& address = probe.addresses[index];
+        SOCKET s = socket(address.ss_family, SOCK_STREAM, IPPROTO_TCP);
+        if (s == INVALID_SOCKET) {
+            continue;
+        }
+        u_long nonBlocking = 1;
+        ioctlsocket(s, FIONBIO, &nonBlocking);
+        if (connect(s, reinterpret_cast<sockaddr*>(&address), probe.addressLengths[index]) == SOCKET_ERROR &&
+                WSAGetLastError() != WSAEWOULDBLOCK) {
+            closesocket(s);
+            continue;
+        }
+        probe.sockets[index] = s;
+        started = true;
+    }
+    if (started) {
+        probe.phase = PHASE_CONNECTING;
+    }
+    return started;
+}
+
+void BeginAttempt(Probe& probe, ULONGLONG now, std::vector<PendingEvent>& events) {
+    probe.attemptStart = now;
+
+    if (probe.kind == PROBE_KIND_FILE) {
+        bool exists = GetFileAttributesW(probe.filePath.c_str()) != INVALID_FILE_ATTRIBUTES;
+        FinishAttempt(probe, exists, PROBE_FAILURE_MISSING, now, events);
+        return;
+    }
+
+    if (!ConnectAll(probe)) {
+        FinishAttempt(probe, false, PROBE_FAILURE_REFUSED, now, events);
+    }
+}
+
+// "HTTP/1.1 200 OK\r\n" -> 200, 0 if the status line is incomplete or malformed
+int ParseStatus(const std::string& response) {
+    size_t end = response.find("\r\n");
+    if (end == std::string::npos || response.compare(0, 5, "HTTP/") != 0) {
+        return 0;
+    }
+    size_t space = response.find(' ');
+    if (space == std::string::npos || space + 4 > end) {
+        return 0;
+    }
+    return atoi(response.c_str() + space + 1);
+}
+
+// index is the socket the event is for
+void OnSocketReady(Probe& probe, int index, SHORT revents, ULONGLONG now, std::vector<PendingEvent>& events) {
+    switch (probe.phase) {
+        case PHASE_CONNECTING: {
+            int error = 0;
+            int length = sizeof(error);
+            getsockopt(probe.sockets[index], SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &length);
+            if (error != 0 || (revents & (POLLERR | POLLHUP))) {
+                // The other family may still answer
+                CloseSocket(probe, index);
+                if (probe.sockets[0] == INVALID_SOCKET && probe.sockets[1] == INVALID_SOCKET) {
+                    FinishAttempt(probe, false, PROBE_FAILURE_REFUSED, now, events);
+                }
+                break;
+            }
+            probe.connected = index;
+            CloseSocket(probe, 1 - index);
+            if (probe.kind == PROBE_KIND_TCP) {
+                FinishAttempt(probe, true, 0, now, events);
+            } else {
+                probe.phase = PHASE_SENDING;
+            }
+            break;
+        }
+
+        case PHASE_SENDING: {
+            int sent = send(probe.sockets[probe.connected], probe.request.data() + probe.sent,
+                (int)(probe.request.size() - probe.sent), 0);
+            if (sent == SOCKET_ERROR) {
+                if (WSAGetLastError() != WSAEWOULDBLOCK) {
+                    FinishAttempt(probe, false, PROBE_FAILURE_REFUSED, now, events);
+                }
+                break;
+            }
+            probe.sent += sent;
+            if (probe.sent == probe.request.size()) {
+                probe.phase = PHASE_RECEIVING;
+            }
+            break;
+        }
+
+        case PHASE_RECEIVING: {
+            char buffer[512];
+            int received = recv(probe.sockets[probe.connected], buffer, sizeof(buffer), 0);
+            if (received == SOCKET_ERROR && WSAGetLastError() == WSAEWOULDBLOCK) {
+                break;
+            }
+            if (received <= 0) {
+                FinishAttempt(probe, false, PROBE_FAILURE_REFUSED, now, events);
+                break;
+            }
+            // Only the status line matters
+            probe.response.append(buffer, received);
+            int status = ParseStatus(probe.response);
+            if (status == 0) {
+                if (probe.response.size() > 1024) {
+                    FinishAttempt(probe, false, PROBE_FAILURE_BAD_STATUS, now, events);
+                }
+                break;
+            }
+            bool passed = probe.expectedStatus != 0
+                ? status == probe.expectedStatus
+                : status >= 200 && status < 400;
+            FinishAttempt(probe, passed, PROBE_FAILURE_BAD_STATUS, now, events);
+            break;
+        }
+
+        case PHASE_IDLE:
+            break;
+    }
+}
+
+// One thread for every probe: start due attempts, poll all open sockets at once,
+// sleep until the next attempt or deadline
+DWORD WINAPI ProbeThread(LPVOID) {
+    std::vector<WSAPOLLFD> fds;
+    std::vector<std::pair<std::shared_ptr<Probe>, int>> polled; // Probe and socket index per fd
+    std::vector<PendingEvent> events;
+
+    for (;;) {
+        ULONGLONG now = GetTickCount64();
+        ULONGLONG nextWake = now + 60000;
+        fds.clear();
+        polled.clear();
+        events.clear();
+
+        WSAPOLLFD wake = {};
+        wake.fd = g_wakeSocket;
+        wake.events = POLLRDNORM;
+        fds.push_back(wake);
+
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            for (auto it = g_probes.begin(); it != g_probes.end();) {
+                auto probe = it->second;
+                if (probe->removed) {
+                    CloseAttemptSockets(*probe);
+                    it = g_probes.erase(it);
+                    continue;
+                }
+                ++it;
+
+                if (probe->phase != PHASE_IDLE && now >= probe->attemptStart + probe->timeoutMs) {
+                    FinishAttempt(*probe, false, PROBE_FAILURE_TIMEOUT, now, events);
+                }
+                if (probe->phase == PHASE_IDLE && now >= probe->nextDue) {
+                    BeginAttempt(*probe, now, events);
+                }
+
+                if (probe->phase == PHASE_IDLE) {
+                    nextWake = min(nextWake, probe->nextDue);
+                    continue;
+                }
+                nextWake = min(nextWake, probe->attemptStart + probe->timeoutMs);
+                for (int index = 0; index < 2; index++) {
+                    if (probe->sockets[index] == INVALID_SOCKET) {
+                        continue;
+                    }
+                    WSAPOLLFD fd = {};
+                    fd.fd = probe->sockets[index];
+                    fd.events = probe->phase == PHASE_RECEIVING ? POLLRDNORM : POLLWRNORM;
+                    fds.push_back(fd);
+                    polled.push_back({probe, index});
+                }
+            }
+        }
+
+        ProbeEventCallback callback = g_callback.load();
+        for (const auto& event : events) {
+            if (callback != nullptr) {
+                callback(event.probeId, event.kind, event.detail);
+            }
+        }
+        events.clear();
+
+        now = GetTickCount64();
+        int timeout = nextWake > now ? (int)min(nextWake - now, (ULONGLONG)60000) : 0;
+        int count = WSAPoll(fds.data(), (ULONG)fds.size(), timeout);
+        if (count <= 0) {
+            continue;
+        }
+
+        if (fds[0].revents != 0) {
+            char drain[64];
+            while (recv(g_wakeSocket, drain, sizeof(drain), 0) > 0) {
+            }
+        }
+
+        now = GetTickCount64();
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            for (size_t i = 0; i < polled.size(); i++) {
+                Probe& probe = *polled[i].first;
+                int index = polled[i].second;
+                SHORT revents = fds[i + 1].revents;
+                // An earlier event of this pass may have closed the socket or ended the attempt
+                if (revents != 0 && !probe.removed && probe.sockets[index] == fds[i + 1].fd) {
+                    OnSocketReady(probe, index, revents, now, events);
+                }
+            }
+        }
+        for (const auto& event : events) {
+            if (callback != nullptr) {
+                callback(event.probeId, event.kind, event.detail);
+            }
+        }
+    }
+    return 0;
+}
+
+// Set up Winsock, the wake socket and the probe thread on first use (g_mutex held)
+bool EnsureThread() {
+    if (g_thread != NULL) {
+        return true;
+    }
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+        return false;
+    }
+    g_wakeSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (g_wakeSocket == INVALID_SOCKET) {
+        return false;
+    }
+    g_wakeAddress.sin_family = AF_INET;
+    g_wakeAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    g_wakeAddress.sin_port = 0;
+    int length = sizeof(g_wakeAddress);
+    u_long nonBlocking = 1;
+    if (bind(g_wakeSocket, reinterpret_cast<sockaddr*>(&g_wakeAddress), sizeof(g_wakeAddress)) == SOCKET_ERROR ||
+            getsockname(g_wakeSocket, reinterpret_cast<sockaddr*>(&g_wakeAddress), &length) == SOCKET_ERROR ||
+            ioctlsocket(g_wakeSocket, FIONBIO, &nonBlocking) == SOCKET_ERROR) {
+        closesocket(g_wakeSocket);
+        g_wakeSocket = INVALID_SOCKET;
+        return false;
+    }
+    g_thread = CreateThread(NULL, 0, ProbeThread, NULL, 0, NULL);
+    return g_thread != NULL;
+}
+
+} // namespace
+
+extern "C" {
+
+// Register the Dart probe event callback (NULL to detach)
+__declspec(dllexport) void probe_set_callback(ProbeEventCallback callback) {
+    g_callback.store(callback);
+}
+
+// Start a readiness probe (see readiness_probe.h)
+__declspec(dllexport) int64_t probe_start(int32_t kind, const char* host, int32_t port,
+        const char* path, int32_t expectedStatus, int32_t intervalMs, int32_t timeoutMs,
+        int32_t successThreshold, int32_t failureThreshold) {
+    auto probe = std::make_shared<Probe>();
+    probe->kind = kind;
+    probe->expectedStatus = expectedStatus;
+    probe->intervalMs = (ULONGLONG)max(intervalMs, 50);
+    probe->timeoutMs = (ULONGLONG)max(timeoutMs, 50);
+    probe->successThreshold = max(successThreshold, 1);
+    probe->failureThreshold = max(failureThreshold, 1);
+
+    switch (kind) {
+        case PROBE_KIND_TCP:
+        case PROBE_KIND_HTTP:
+            if (port <= 0 || port > 65535 ||
+                    !ParseAddress(host, port, *probe)) {
+                return 0;
+            }
+            if (kind == PROBE_KIND_HTTP) {
+                std::string target = path != nullptr && path[0] == '/' ? path : "/";
+                std::string hostHeader = host != nullptr && host[0] != '\0' ? host : "localhost";
+                if (hostHeader.find(':') != std::string::npos) {
+                    hostHeader = "[" + hostHeader + "]"; // IPv6 literal
+                }
+                probe->request = "GET " + target + " HTTP/1.1\r\nHost: " + hostHeader + ":" +
+                    std::to_string(port) + "\r\nUser-Agent: Marcha-Probe\r\nConnection: close\r\n\r\n";
+            }
+            break;
+        case PROBE_KIND_FILE:
+            if (path == nullptr || path[0] == '\0') {
+                return 0;
+            }
+            probe->filePath = Utf8ToWide(path);
+            break;
+        default:
+            return 0;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        if (!EnsureThread()) {
+            return 0;
+        }
+        probe->id = g_nextProbeId++;
+        probe->nextDue = GetTickCount64();
+        g_probes[probe->id] = probe;
+    }
+    Wake();
+    return probe->id;
+}
+
+// Stop a readiness probe; the probe thread closes its socket on the next pass
+__declspec(dllexport) void probe_stop(int64_t probeId) {
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto it = g_probes.find(probeId);
+        if (it == g_probes.end()) {
+            return;
+        }
+        it->second->removed = true;
+    }
+    Wake();
+}
+
+}
@@ -0,0 +1,45 @@
+#ifndef READINESS_PROBE_H
+#define READINESS_PROBE_H
+
+#include <stdint.h>
+
+// What a probe checks
+enum ProbeKind {
+    PROBE_KIND_TCP = 0,  // A TCP connect to host:port succeeds
+    PROBE_KIND_HTTP = 1, // GET path on host:port answers with the expected status
+    PROBE_KIND_FILE = 2, // The file (or directory) at path exists
+};
+
+// Events posted to the probe callback
+enum ProbeEventKind {
+    PROBE_EVENT_READY = 0,     // successThreshold attempts in a row passed; detail = last attempt in ms
+    PROBE_EVENT_NOT_READY = 1, // A ready probe failed failureThreshold attempts in a row; detail = ProbeFailure
+};
+
+// Why the last attempt of a probe failed
+enum ProbeFailure {
+    PROBE_FAILURE_TIMEOUT = 0,
+    PROBE_FAILURE_REFUSED = 1,    // Connect failed or the connection closed early
+    PROBE_FAILURE_BAD_STATUS = 2, // HTTP answered with another status
+    PROBE_FAILURE_MISSING = 3,    // File probe: nothing at the path
+};
+
+// Called from the probe thread; register a NativeCallable.listener from Dart
+typedef void (*ProbeEventCallback)(int64_t probeId, int32_t kind, int32_t detail);
+
+extern "C" {
+    __declspec(dllexport) void probe_set_callback(ProbeEventCallback callback);
+    // Start probing every intervalMs until probe_stop. host is an IPv4/IPv6 literal or
+    // "localhost" (also NULL), which connects to 127.0.0.1 and ::1 at once and uses
+    // whichever answers; path is the HTTP request path or, for file probes,
+    // the UTF-8 file path. expectedStatus 0 accepts any 2xx/3xx answer.
+    // Every probe of every task runs on one thread multiplexing all sockets.
+    // Returns a probe id, 0 on invalid arguments.
+    __declspec(dllexport) int64_t probe_start(int32_t kind, const char* host, int32_t port,
+        const char* path, int32_t expectedStatus, int32_t intervalMs, int32_t timeoutMs,
+        int32_t successThreshold, int32_t failureThreshold);
+    // Stop a probe. An event already posted may still arrive, so match events by id.
+    __declspec(dllexport) void probe_stop(int64_t probeId);
+}
+
+#endif // READINESS_PROBE_H
@@ -0,0 +1,128 @@
+#include "resource_rules.h"
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+enum RuleState {
+    RULE_CLEAR,      // Below the threshold
+    RULE_PENDING,    // Above the threshold since `since`, not for long enough yet
+    RULE_BREACHED,
+    RULE_RECOVERING, // Breached, below the clear threshold since `since`
+};
+
+struct Rule {
+    int64_t id;
+    int32_t metric;
+    double threshold;
+    double clearThreshold;
+    int64_t sustainMs;
+    RuleState state;
+    int64_t since;
+};
+
+std::mutex g_mutex;
+std::unordered_map<int64_t, std::vector<Rule>> g_subjects;
+int64_t g_nextRuleId = 1;
+
+// Advance one rule by a sample. Returns true if it became breached or recovered.
+bool Step(Rule& rule, double value, int64_t now) {
+    switch (rule.state) {
+    case RULE_CLEAR:
+        if (value <= rule.threshold) return false;
+        rule.state = RULE_PENDING;
+        rule.since = now;
+        // A sustain of 0 breaches on the first sample above
+        if (rule.sustainMs > 0) return false;
+        rule.state = RULE_BREACHED;
+        return true;
+    case RULE_PENDING:
+        if (value <= rule.threshold) {
+            rule.state = RULE_CLEAR;
+            return false;
+        }
+        if (now - rule.since < rule.sustainMs) return false;
+        rule.state = RULE_BREACHED;
+        return true;
+    case RULE_BREACHED:
+        if (value >= rule.clearThreshold) return false;
+        rule.state = RULE_RECOVERING;
+        rule.since = now;
+        if (rule.sustainMs > 0) return false;
+        rule.state = RULE_CLEAR;
+        return true;
+    case RULE_RECOVERING:
+        if (value >= rule.clearThreshold) {
+            rule.state = RULE_BREACHED;
+            return false;
+        }
+        if (now - rule.since < rule.sustainMs) return false;
+        rule.state = RULE_CLEAR;
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+extern "C" {
+
+// Register a threshold rule with hysteresis for a subject
+__declspec(dllexport) int64_t rules_add(int64_t subjectId, int32_t metric, double threshold,
+        double clearThreshold, int32_t sustainMs) {
+    if (metric < 0 || metric >= RULE_METRIC_COUNT || sustainMs < 0 || clearThreshold > threshold) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(g_mutex);
+    Rule rule = {};
+    rule.id = g_nextRuleId++;
+    rule.metric = metric;
+    rule.threshold = threshold;
+    rule.clearThreshold = clearThreshold;
+    rule.sustainMs = sustainMs;
+    rule.state = RULE_CLEAR;
+    g_subjects[subjectId].push_back(rule);
+    return rule.id;
+}
+
+// Forget a subject and its rules
+__declspec(dllexport) void rules_remove_subject(int64_t subjectId) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_subjects.erase(subjectId);
+}
+
+// Run one sample through a subject's rules, reporting state changes
+__declspec(dllexport) int rules_evaluate(int64_t subjectId, int64_t timestampMs,
+        const double* metrics, int32_t metricCount, RuleTransition* out, int32_t maxCount) {
+    if (metrics == nullptr || out == nullptr || maxCount <= 0) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(g_mutex);
+    auto it = g_subjects.find(subjectId);
+    if (it == g_subjects.end()) {
+        return 0;
+    }
+
+    int count = 0;
+    for (Rule& rule : it->second) {
+        if (rule.metric >= metricCount) {
+            continue; // Caller has no value for it - state unchanged
+        }
+        if (count >= maxCount) {
+            break; // The rest advance on the next sample rather than lose a transition
+        }
+        double value = metrics[rule.metric];
+        if (!Step(rule, value, timestampMs)) {
+            continue;
+        }
+        RuleTransition& transition = out[count++];
+        transition.ruleId = rule.id;
+        transition.breached = rule.state == RULE_BREACHED ? 1 : 0;
+        transition.reserved = 0;
+        transition.value = value;
+    }
+    return count;
+}
+
+}
@@ -0,0 +1,39 @@
+#ifndef RESOURCE_RULES_H
+#define RESOURCE_RULES_H
+
+#include <stdint.h>
+
+// Index of a value in the metrics array passed to rules_evaluate
+enum RuleMetric {
+    RULE_METRIC_MEMORY_BYTES = 0,  // Working set of the whole tree
+    RULE_METRIC_CPU_PERCENT = 1,   // Tree CPU since the previous sample (100 = one core)
+    RULE_METRIC_PROCESS_COUNT = 2, // Running processes in the tree
+    RULE_METRIC_COUNT = 3,
+};
+
+// A rule that changed state during rules_evaluate
+struct RuleTransition {
+    int64_t ruleId;
+    int32_t breached; // 1 = held above the threshold for sustainMs, 0 = recovered
+    int32_t reserved;
+    double value;     // The metric in the sample that caused the transition
+};
+
+extern "C" {
+    // Add a rule for a subject (any caller-chosen id, e.g. one per task run). The rule is
+    // breached once the metric stays above threshold for sustainMs, and recovers once it
+    // stays below clearThreshold (<= threshold) for sustainMs - the gap between the two
+    // keeps a value hovering around the threshold from flapping. Returns a rule id, 0 on
+    // invalid arguments.
+    __declspec(dllexport) int64_t rules_add(int64_t subjectId, int32_t metric, double threshold,
+        double clearThreshold, int32_t sustainMs);
+    // Drop every rule of a subject
+    __declspec(dllexport) void rules_remove_subject(int64_t subjectId);
+    // Feed one sample of a subject's metrics (RULE_METRIC_COUNT values, timestamps in ms from
+    // any steady clock) and write the rules that changed state to out. Only the subject's own
+    // rules are touched. Returns the number of transitions written.
+    __declspec(dllexport) int rules_evaluate(int64_t subjectId, int64_t timestampMs,
+        const double* metrics, int32_t metricCount, RuleTransition* out, int32_t maxCount);
+}
+
+#endif // RESOURCE_RULES_H
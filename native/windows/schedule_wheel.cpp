@@ -0,0 +1,490 @@
+#include "schedule_wheel.h"
+#include "task_container.h"
+#include <windows.h>
+#include <time.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Hierarchical timing wheel with one-second ticks: level L slots span 64^L seconds, so
+// four levels cover 194 days and anything further is parked in the top level and
+// re-placed as it comes closer. Adding, removing and each tick are O(1); an entry
+// cascades down at most three times before it fires.
+constexpr int kLevels = 4;
+constexpr int kSlotBits = 6;
+constexpr int kSlots = 1 << kSlotBits;
+constexpr int64_t kWheelSpan = 1LL << (kSlotBits * kLevels);
+constexpr int64_t kMissedGraceSeconds = 60;
+constexpr int64_t kCronRetrySeconds = 3600; // After a next-fire search that came up empty
+
+// Cron fields as bit sets (bit n = value n allowed)
+struct CronSpec {
+    uint64_t minutes;
+    uint32_t hours;
+    uint32_t days;     // 1-31
+    uint16_t months;   // 1-12
+    uint8_t weekdays;  // 0-6, Sunday = 0
+    bool anyDay;       // Day-of-month field was *
+    bool anyWeekday;   // Weekday field was *
+};
+
+struct Schedule {
+    int64_t id;
+    int32_t kind;
+    CronSpec cron;
+    int64_t intervalSeconds;
+    bool utc;
+    int32_t missedFire;
+    std::string input;
+    int32_t containerId;
+    int64_t due; // Unix seconds of the next fire
+    bool retry;  // Cron only: due is when to search again, not a fire
+    int level;
+    int slot;
+    std::list<int64_t>::iterator position;
+};
+
+// A fire handled on the wheel thread, delivered after the lock is dropped
+struct Firing {
+    int64_t id;
+    int32_t containerId;
+    std::string input;
+    bool missed;
+    int64_t late;
+};
+
+std::mutex g_mutex;
+std::condition_variable g_wake;
+std::atomic<ScheduleEventCallback> g_callback(nullptr);
+HANDLE g_thread = NULL;
+std::list<int64_t> g_wheel[kLevels][kSlots];
+std::unordered_map<int64_t, Schedule> g_schedules;
+int64_t g_current = 0; // Last second the wheel processed
+int64_t g_nextId = 1;
+
+int64_t UnixNow() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// === CRON ===
+
+// One field: "*", "*/n", "a", "a-b", "a-b/n", "a/n", comma separated
+bool ParseField(const std::string& field, int minValue, int maxValue, uint64_t* bits) {
+    *bits = 0;
+    std::stringstream parts(field);
+    std::string part;
+    while (std::getline(parts, part, ',')) {
+        if (part.empty()) {
+            return false;
+        }
+        int step = 1;
+        size_t slash = part.find('/');
+        if (slash != std::string::npos) {
+            step = atoi(part.c_str() + slash + 1);
+            if (step <= 0) {
+                return false;
+            }
+            part.resize(slash);
+        }
+        int low, high;
+        if (part == "*") {
+            low = minValue;
+            high = maxValue;
+        } else {
+            size_t dash = part.find('-');
+            char* end = nullptr;
+            low = (int)strtol(part.c_str(), &end, 10);
+            if (end == part.c_str()) {
+                return false;
+            }
+            if (dash != std::string::npos) {
+                high = atoi(part.c_str() + dash + 1);
+            } else {
+                high = slash != std::string::npos ? maxValue : low;
+            }
+        }
+        if (low < minValue || high > maxValue || low > high) {
+            return false;
+        }
+        for (int value = low; value <= high; value += step) {
+            *bits |= 1ULL << value;
+        }
+    }
+    return *bits != 0;
+}
+
+bool ParseCron(const char* expression, CronSpec* spec) {
+    std::string text = expression;
+    if (text == "@hourly") text = "0 * * * *";
+    else if (text == "@daily" || text == "@midnight") text = "0 0 * * *";
+    else if (text == "@weekly") text = "0 0 * * 0";
+    else if (text == "@monthly") text = "0 0 1 * *";
+    else if (text == "@yearly" || text == "@annually") text = "0 0 1 1 *";
+
+    std::stringstream stream(text);
+    std::string fields[5];
+    for (auto& field : fields) {
+        if (!(stream >> field)) {
+            return false;
+        }
+    }
+    std::string extra;
+    if (stream >> extra) {
+        return false;
+    }
+
+    uint64_t minutes, hours, days, months, weekdays;
+    if (!ParseField(fields[0], 0, 59, &minutes) || !ParseField(fields[1], 0, 23, &hours) ||
+        !ParseField(fields[2], 1, 31, &days) || !ParseField(fields[3], 1, 12, &months) ||
+        !ParseField(fields[4], 0, 7, &weekdays)) {
+        return false;
+    }
+    if (weekdays & (1ULL << 7)) {
+        weekdays |= 1; // 7 is Sunday too
+    }
+    spec->minutes = minutes;
+    spec->hours = (uint32_t)hours;
+    spec->days = (uint32_t)days;
+    spec->months = (uint16_t)months;
+    spec->weekdays = (uint8_t)(weekdays & 0x7F);
+    spec->anyDay = fields[2] == "*";
+    spec->anyWeekday = fields[4] == "*";
+    return true;
+}
+
+bool ToTm(int64_t time, bool utc, tm* out) {
+    __time64_t value = time;
+    return (utc ? _gmtime64_s(out, &value) : _localtime64_s(out, &value)) == 0;
+}
+
+// Normalizes out-of-range fields (and DST gaps in local time) like mktime does
+int64_t FromTm(tm* value, bool utc) {
+    value->tm_isdst = -1;
+    return utc ? _mkgmtime64(value) : _mktime64(value);
+}
+
+// Standard cron rule: with both day fields restricted, either one matching is enough
+bool DayMatches(const CronSpec& spec, const tm& value) {
+    bool day = (spec.days >> value.tm_mday) & 1;
+    bool weekday = (spec.weekdays >> value.tm_wday) & 1;
+    if (spec.anyDay) return weekday;
+    if (spec.anyWeekday) return day;
+    return day || weekday;
+}
+
+// First matching minute strictly after `after`, 0 if none within the search bound
+int64_t CronNext(const CronSpec& spec, int64_t after, bool utc) {
+    int64_t time = (after / 60 + 1) * 60;
+    int64_t previous = time;
+    tm value;
+    if (!ToTm(time, utc, &value)) {
+        return 0;
+    }
+    // Skips whole months, days and hours at a time, so a few thousand steps cover years
+    for (int guard = 0; guard < 20000; guard++) {
+        if (!((spec.months >> (value.tm_mon + 1)) & 1)) {
+            value.tm_mon++;
+            value.tm_mday = 1;
+            value.tm_hour = 0;
+            value.tm_min = 0;
+        } else if (!DayMatches(spec, value)) {
+            value.tm_mday++;
+            value.tm_hour = 0;
+            value.tm_min = 0;
+        } else if (!((spec.hours >> value.tm_hour) & 1)) {
+            value.tm_hour++;
+            value.tm_min = 0;
+        } else if (!((spec.minutes >> value.tm_min) & 1)) {
+            value.tm_min++;
+        } else {
+            return time;
+        }
+        value.tm_sec = 0;
+        time = FromTm(&value, utc);
+        if (time <= previous) {
+            // Repeated hour when DST ends: mktime picked the earlier of the two
+            // instants. Step one real minute instead.
+            time = previous + 60;
+        }
+        previous = time;
+        if (!ToTm(time, utc, &value)) {
+            return 0;
+        }
+    }
+    return 0;
+}
+
+// === WHEEL (g_mutex held) ===
+
+void Place(Schedule& schedule, int64_t at) {
+    int64_t delta = at - g_current;
+    if (delta >= kWheelSpan) {
+        at = g_current + kWheelSpan - 1; // Parked; re-placed when it is reached
+        delta = kWheelSpan - 1;
+    }
+    int level = 0;
+    while (level < kLevels - 1 && delta >= (1LL << (kSlotBits * (level + 1)))) {
+        level++;
+    }
+    int slot = (int)((at >> (kSlotBits * level)) & (kSlots - 1));
+    auto& list = g_wheel[level][slot];
+    schedule.level = level;
+    schedule.slot = slot;
+    schedule.position = list.insert(list.end(), schedule.id);
+}
+
+void Unplace(Schedule& schedule) {
+    g_wheel[schedule.level][schedule.slot].erase(schedule.position);
+}
+
+// Due time after a fire at `now`; fires missed in between are not replayed
+int64_t NextDue(const Schedule& schedule, int64_t now) {
+    switch (schedule.kind) {
+    case SCHEDULE_KIND_INTERVAL: {
+        int64_t next = schedule.due + schedule.intervalSeconds;
+        if (next <= now) {
+            next += ((now - next) / schedule.intervalSeconds + 1) * schedule.intervalSeconds;
+        }
+        return next;
+    }
+    case SCHEDULE_KIND_CRON:
+        return CronNext(schedule.cron, schedule.due > now ? schedule.due : now, schedule.utc);
+    default:
+        return 0;
+    }
+}
+
+// Advance the wheel by one second, collecting what fires
+void Tick(int64_t now, std::vector<Firing>& firings) {
+    g_current++;
+
+    // Highest level first, so entries it drops into the current lower slot cascade too
+    for (int level = kLevels - 1; level >= 1; level--) {
+        if ((g_current & ((1LL << (kSlotBits * level)) - 1)) != 0) {
+            continue;
+        }
+        int slot = (int)((g_current >> (kSlotBits * level)) & (kSlots - 1));
+        std::list<int64_t> entries;
+        entries.swap(g_wheel[level][slot]);
+        for (int64_t id : entries) {
+            Schedule& schedule = g_schedules[id];
+            Place(schedule, schedule.due > g_current ? schedule.due : g_current);
+        }
+    }
+
+    std::list<int64_t> entries;
+    entries.swap(g_wheel[0][g_current & (kSlots - 1)]);
+    for (int64_t id : entries) {
+        auto it = g_schedules.find(id);
+        if (it == g_schedules.end()) {
+            continue;
+        }
+        Schedule& schedule = it->second;
+        if (schedule.due > g_current) {
+            Place(schedule, schedule.due); // Was parked beyond the wheel's span
+            continue;
+        }
+        if (schedule.retry) {
+            int64_t next = CronNext(schedule.cron, now, schedule.utc);
+            schedule.retry = next == 0;
+            schedule.due = next != 0 ? next : now + kCronRetrySeconds;
+            Place(schedule, schedule.due);
+            continue;
+        }
+
+        int64_t late = now - schedule.due;
+        bool missed = late > kMissedGraceSeconds && schedule.missedFire == MISSED_FIRE_SKIP;
+        firings.push_back({ id, schedule.containerId, missed ? std::string() : schedule.input,
+            missed, late });
+
+        int64_t next = NextDue(schedule, now);
+        if (next == 0 && schedule.kind == SCHEDULE_KIND_CRON) {
+            // A cron schedule that matched once is never dropped: search again later
+            schedule.retry = true;
+            next = now + kCronRetrySeconds;
+        }
+        if (next == 0) {
+            g_schedules.erase(it);
+            continue;
+        }
+        schedule.due = next;
+        Place(schedule, next);
+    }
+}
+
+// The clock went backwards: re-place everything relative to the new time
+void Rebase(int64_t now) {
+    for (auto& level : g_wheel) {
+        for (auto& slot : level) {
+            slot.clear();
+        }
+    }
+    g_current = now;
+    for (auto& entry : g_schedules) {
+        Place(entry.second, entry.second.due > now ? entry.second.due : now + 1);
+    }
+}
+
+void Deliver(const std::vector<Firing>& firings) {
+    ScheduleEventCallback callback = g_callback.load();
+    for (const Firing& firing : firings) {
+        int32_t kind = SCHEDULE_EVENT_MISSED;
+        if (!firing.missed) {
+            bool written = firing.containerId != 0 && task_container_write(firing.containerId,
+                reinterpret_cast<const uint8_t*>(firing.input.data()), (int)firing.input.size());
+            kind = written ? SCHEDULE_EVENT_WRITTEN : SCHEDULE_EVENT_DUE;
+        }
+        if (callback != nullptr) {
+            int64_t late = firing.late < 0 ? 0 : firing.late;
+            callback(firing.id, kind, (int32_t)(late > INT32_MAX ? INT32_MAX : late));
+        }
+    }
+}
+
+// Wakes once per second while any schedule exists, sleeps otherwise
+DWORD WINAPI WheelThread(LPVOID) {
+    std::unique_lock<std::mutex> lock(g_mutex);
+    for (;;) {
+        if (g_schedules.empty()) {
+            g_wake.wait(lock);
+            continue;
+        }
+
+        int64_t now = UnixNow();
+        if (now < g_current - 1) {
+            Rebase(now);
+        }
+        std::vector<Firing> firings;
+        while (g_current < now) {
+            Tick(now, firings);
+        }
+        if (!firings.empty()) {
+            lock.unlock();
+            Deliver(firings);
+            lock.lock();
+            continue;
+        }
+
+        auto since = std::chrono::system_clock::now().time_since_epoch();
+        auto intoSecond = std::chrono::duration_cast<std::chrono::milliseconds>(since).count() % 1000;
+        g_wake.wait_for(lock, std::chrono::milliseconds(1000 - intoSecond + 1));
+    }
+}
+
+// Start the wheel thread on first use (g_mutex held)
+bool EnsureThread() {
+    if (g_thread != NULL) {
+        return true;
+    }
+    g_current = UnixNow();
+    g_thread = CreateThread(NULL, 0, WheelThread, NULL, 0, NULL);
+    return g_thread != NULL;
+}
+
+} // namespace
+
+extern "C" {
+
+__declspec(dllexport) void schedule_set_callback(ScheduleEventCallback callback) {
+    g_callback.store(callback);
+}
+
+// Add a cron, interval or one-time schedule (see schedule_wheel.h)
+__declspec(dllexport) int64_t schedule_add(int32_t kind, const char* expression, int64_t value,
+        bool utc, int32_t missedFire, const uint8_t* input, int32_t length) {
+    Schedule schedule = {};
+    schedule.kind = kind;
+    schedule.utc = utc;
+    schedule.missedFire = missedFire;
+    if (input != nullptr && length > 0) {
+        schedule.input.assign(reinterpret_cast<const char*>(input), length);
+    }
+
+    int64_t now = UnixNow();
+    switch (kind) {
+    case SCHEDULE_KIND_CRON:
+        if (expression == nullptr || !ParseCron(expression, &schedule.cron)) {
+            return 0;
+        }
+        schedule.due = CronNext(schedule.cron, now, utc);
+        break;
+    case SCHEDULE_KIND_INTERVAL:
+        if (value <= 0) {
+            return 0;
+        }
+        schedule.intervalSeconds = value;
+        schedule.due = now + value;
+        break;
+    case SCHEDULE_KIND_ONCE:
+        schedule.due = value > now ? value : now + 1;
+        break;
+    default:
+        return 0;
+    }
+    if (schedule.due == 0) {
+        return 0; // Cron expression that never matches
+    }
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (!EnsureThread()) {
+        return 0;
+    }
+    if (g_schedules.empty()) {
+        g_current = now; // The idle thread stopped advancing the wheel
+    }
+    schedule.id = g_nextId++;
+    Schedule& stored = g_schedules[schedule.id] = schedule;
+    Place(stored, stored.due > g_current ? stored.due : g_current + 1);
+    g_wake.notify_one();
+    return stored.id;
+}
+
+// Route a schedule's fires to a task container (0 = post them to Dart only)
+__declspec(dllexport) bool schedule_bind(int64_t scheduleId, int32_t containerId) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    auto it = g_schedules.find(scheduleId);
+    if (it == g_schedules.end()) {
+        return false;
+    }
+    it->second.containerId = containerId;
+    return true;
+}
+
+// Next fire time of a schedule
+__declspec(dllexport) int64_t schedule_next(int64_t scheduleId) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    auto it = g_schedules.find(scheduleId);
+    return it != g_schedules.end() && !it->second.retry ? it->second.due : 0;
+}
+
+// Next fire of a cron expression, for previews
+__declspec(dllexport) int64_t schedule_cron_next(const char* expression, int64_t after, bool utc) {
+    CronSpec spec;
+    if (expression == nullptr || !ParseCron(expression, &spec)) {
+        return 0;
+    }
+    return CronNext(spec, after, utc);
+}
+
+// Drop a schedule; a fire already handed to the callback may still arrive
+__declspec(dllexport) void schedule_remove(int64_t scheduleId) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    auto it = g_schedules.find(scheduleId);
+    if (it == g_schedules.end()) {
+        return;
+    }
+    Unplace(it->second);
+    g_schedules.erase(it);
+}
+
+}
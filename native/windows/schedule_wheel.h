@@ -0,0 +1,49 @@
+#ifndef SCHEDULE_WHEEL_H
+#define SCHEDULE_WHEEL_H
+
+#include <stdint.h>
+
+// How a schedule's fire times are computed
+enum ScheduleKind {
+    SCHEDULE_KIND_CRON = 0,     // expression: "min hour day month weekday" or @hourly/@daily/@weekly/@monthly
+    SCHEDULE_KIND_INTERVAL = 1, // value: seconds between fires, the first one value seconds from now
+    SCHEDULE_KIND_ONCE = 2,     // value: Unix time (seconds) of the single fire
+};
+
+// What to do with a fire that is more than a minute late (machine asleep, clock jumped)
+enum MissedFirePolicy {
+    MISSED_FIRE_SKIP = 0, // Drop it and wait for the next regular fire
+    MISSED_FIRE_ONCE = 1, // Fire once now, however many fires were missed
+};
+
+// Events posted to the schedule callback
+enum ScheduleEventKind {
+    SCHEDULE_EVENT_WRITTEN = 0, // The input was written to the bound container
+    SCHEDULE_EVENT_DUE = 1,     // Fired, but no container is bound (or the write failed) - deliver it yourself
+    SCHEDULE_EVENT_MISSED = 2,  // Skipped by MISSED_FIRE_SKIP
+};
+
+// Called from the scheduler thread; register a NativeCallable.listener from Dart.
+// lateSeconds is how far past its due time the fire was handled.
+typedef void (*ScheduleEventCallback)(int64_t scheduleId, int32_t kind, int32_t lateSeconds);
+
+extern "C" {
+    __declspec(dllexport) void schedule_set_callback(ScheduleEventCallback callback);
+    // Add a schedule to the shared timer wheel. Cron fields are matched in local time, or in
+    // UTC when utc is set. input (length bytes) is written to the bound task container on
+    // every fire. Once schedules are dropped after their fire. Returns a schedule id, 0 on an
+    // invalid expression or value.
+    __declspec(dllexport) int64_t schedule_add(int32_t kind, const char* expression, int64_t value,
+        bool utc, int32_t missedFire, const uint8_t* input, int32_t length);
+    // Bind a schedule to the task container its input is written to (0 = none, e.g. while the
+    // task is stopped - fires are then posted as SCHEDULE_EVENT_DUE). Returns false if unknown.
+    __declspec(dllexport) bool schedule_bind(int64_t scheduleId, int32_t containerId);
+    // Unix time (seconds) of the schedule's next fire, 0 if unknown
+    __declspec(dllexport) int64_t schedule_next(int64_t scheduleId);
+    // First fire of a cron expression strictly after `after` (Unix seconds), without adding
+    // a schedule. 0 on an invalid expression or if none is found.
+    __declspec(dllexport) int64_t schedule_cron_next(const char* expression, int64_t after, bool utc);
+    __declspec(dllexport) void schedule_remove(int64_t scheduleId);
+}
+
+#endif // SCHEDULE_WHEEL_H
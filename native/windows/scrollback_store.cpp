@@ -0,0 +1,363 @@
+#include "scrollback_store.h"
+#include <windows.h>
+#include <compressapi.h>
+#include <stdio.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+
+namespace {
+
+const int64_t kDefaultBudget = 64LL * 1024 * 1024;
+const int64_t kMaxSpillBytes = 1024LL * 1024 * 1024; // Past this, evicted blocks are dropped
+
+struct StoredBlock {
+    std::shared_ptr<std::vector<uint8_t>> packed; // Null once spilled or lost
+    uint32_t rawSize = 0;
+    uint32_t packedSize = 0;
+    bool compressed = false;
+    bool pending = false; // Stored raw, queued for the worker to compress
+    int64_t spillOffset = -1;
+    // Spill file I/O runs without g_mutex. Until it ends the block keeps its
+    // extent, and a freed block lingers until then.
+    bool writing = false;
+    int reading = 0;
+    bool freed = false;
+};
+
+std::mutex g_mutex;
+std::map<uint64_t, StoredBlock> g_blocks;
+std::set<uint64_t> g_resident; // Ids ascend with age: begin() is the oldest
+uint64_t g_nextBlockId = 1;
+int64_t g_residentBytes = 0;
+std::atomic<int64_t> g_hotBytes{0};
+std::atomic<int64_t> g_budget{kDefaultBudget};
+
+// The worker compresses queued blocks and spills, so the threads that store
+// blocks (the I/O reactor, feeding screens) only hand them over
+HANDLE g_worker = NULL;
+std::condition_variable g_work;
+std::deque<uint64_t> g_compressQueue;
+bool g_evictDue = false;
+
+HANDLE g_spill = INVALID_HANDLE_VALUE;
+int64_t g_spillEnd = 0;
+std::map<int64_t, int64_t> g_holes; // Free extents below g_spillEnd: offset -> size, coalesced
+
+COMPRESSOR_HANDLE g_compressor = nullptr;     // Worker only
+DECOMPRESSOR_HANDLE g_decompressor = nullptr; // Set before the first block is compressed
+std::mutex g_decompressMutex;                 // The decompressor takes one caller at a time
+
+// Called on the worker before it compresses anything
+void InitCodec() {
+    if (!CreateCompressor(COMPRESS_ALGORITHM_XPRESS_HUFF, nullptr, &g_compressor)) {
+        g_compressor = nullptr;
+    }
+    if (!CreateDecompressor(COMPRESS_ALGORITHM_XPRESS_HUFF, nullptr, &g_decompressor)) {
+        g_decompressor = nullptr;
+    }
+}
+
+// The block compressed, or null if it does not shrink. Worker only.
+std::shared_ptr<std::vector<uint8_t>> Pack(const std::vector<uint8_t>& raw) {
+    if (g_compressor == nullptr || g_decompressor == nullptr) {
+        return nullptr;
+    }
+    auto packed = std::make_shared<std::vector<uint8_t>>(raw.size() + raw.size() / 8 + 1024);
+    SIZE_T packedSize = 0;
+    if (!Compress(g_compressor, raw.data(), raw.size(), packed->data(), packed->size(), &packedSize) ||
+            packedSize >= raw.size()) {
+        return nullptr;
+    }
+    packed->resize(packedSize);
+    packed->shrink_to_fit();
+    return packed;
+}
+
+// Deleted by the system when the process exits
+bool OpenSpill() {
+    if (g_spill != INVALID_HANDLE_VALUE) {
+        return true;
+    }
+    char dir[MAX_PATH];
+    DWORD length = GetTempPathA(MAX_PATH, dir);
+    if (length == 0 || length >= MAX_PATH) {
+        return false;
+    }
+    char path[MAX_PATH + 64];
+    sprintf_s(path, sizeof(path), "%smarcha-scrollback-%lu.bin", dir, GetCurrentProcessId());
+    g_spill = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+        FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+    return g_spill != INVALID_HANDLE_VALUE;
+}
+
+bool SpillIo(bool write, int64_t offset, void* data, DWORD size) {
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = (DWORD)(offset & 0xFFFFFFFF);
+    overlapped.OffsetHigh = (DWORD)(offset >> 32);
+    DWORD done = 0;
+    BOOL ok = write ? WriteFile(g_spill, data, size, &done, &overlapped)
+                    : ReadFile(g_spill, data, size, &done, &overlapped);
+    return ok && done == size;
+}
+
+// Room for size bytes in the spill file: the first hole that fits, else the end.
+// -1 when the file is full. Called with g_mutex held.
+int64_t AllocSpill(int64_t size) {
+    for (auto it = g_holes.begin(); it != g_holes.end(); ++it) {
+        if (it->second >= size) {
+            int64_t offset = it->first;
+            int64_t rest = it->second - size;
+            g_holes.erase(it);
+            if (rest > 0) {
+                g_holes[offset + size] = rest;
+            }
+            return offset;
+        }
+    }
+    if (g_spillEnd + size > kMaxSpillBytes) {
+        return -1;
+    }
+    int64_t offset = g_spillEnd;
+    g_spillEnd += size;
+    return offset;
+}
+
+// Give an extent back, merged with the holes next to it. Called with g_mutex held.
+void FreeSpill(int64_t offset, int64_t size) {
+    auto next = g_holes.lower_bound(offset);
+    if (next != g_holes.end() && offset + size == next->first) {
+        size += next->second;
+        next = g_holes.erase(next);
+    }
+    if (next != g_holes.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            offset = prev->first;
+            size += prev->second;
+            g_holes.erase(prev);
+        }
+    }
+    if (offset + size < g_spillEnd) {
+        g_holes[offset] = size;
+        return;
+    }
+    g_spillEnd = offset;
+    if (g_spillEnd == 0) {
+        // Nothing left on disk: start over at the beginning of the file
+        SetFilePointer(g_spill, 0, nullptr, FILE_BEGIN);
+        SetEndOfFile(g_spill);
+    }
+}
+
+// Drop a freed block once no spill I/O uses it. Called with g_mutex held.
+void Reap(std::map<uint64_t, StoredBlock>::iterator it) {
+    StoredBlock& block = it->second;
+    if (!block.freed || block.writing || block.reading > 0) {
+        return;
+    }
+    if (block.spillOffset >= 0) {
+        FreeSpill(block.spillOffset, block.packedSize);
+    }
+    g_blocks.erase(it);
+}
+
+// Move the oldest resident blocks out until the budget holds. Called on the worker
+// without g_mutex: each block is written unlocked into an extent reserved for it.
+void Evict() {
+    for (;;) {
+        uint64_t id;
+        int64_t offset;
+        std::shared_ptr<std::vector<uint8_t>> packed;
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            if (g_resident.empty() || g_residentBytes + g_hotBytes.load() <= g_budget.load()) {
+                return;
+            }
+            id = *g_resident.begin();
+            g_resident.erase(g_resident.begin());
+            StoredBlock& block = g_blocks[id];
+            g_residentBytes -= block.packedSize;
+            block.pending = false; // Spilled as it is
+            offset = OpenSpill() ? AllocSpill(block.packedSize) : -1;
+            if (offset < 0) {
+                block.packed.reset(); // No room on disk: the block is lost
+                continue;
+            }
+            block.spillOffset = offset;
+            block.writing = true;
+            packed = block.packed; // Still served from memory until the write ends
+        }
+
+        bool written = SpillIo(true, offset, packed->data(), (DWORD)packed->size());
+
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto it = g_blocks.find(id);
+        StoredBlock& block = it->second;
+        block.writing = false;
+        block.packed.reset();
+        if (!written) {
+            FreeSpill(offset, block.packedSize);
+            block.spillOffset = -1;
+        }
+        Reap(it);
+    }
+}
+
+// Compress what put queued, then spill until the budget holds; sleeps until
+// there is more of either
+DWORD WINAPI WorkerThread(LPVOID) {
+    InitCodec();
+    std::unique_lock<std::mutex> lock(g_mutex);
+    for (;;) {
+        g_work.wait(lock, [] { return !g_compressQueue.empty() || g_evictDue; });
+        while (!g_compressQueue.empty()) {
+            uint64_t id = g_compressQueue.front();
+            g_compressQueue.pop_front();
+            auto it = g_blocks.find(id);
+            if (it == g_blocks.end() || !it->second.pending) {
+                continue;
+            }
+            std::shared_ptr<std::vector<uint8_t>> raw = it->second.packed;
+            lock.unlock();
+            std::shared_ptr<std::vector<uint8_t>> packed = Pack(*raw);
+            lock.lock();
+            it = g_blocks.find(id);
+            // Freed or spilled meanwhile
+            if (it == g_blocks.end() || !it->second.pending) {
+                continue;
+            }
+            StoredBlock& block = it->second;
+            block.pending = false;
+            if (packed) {
+                g_residentBytes -= (int64_t)block.packedSize - (int64_t)packed->size();
+                block.packedSize = (uint32_t)packed->size();
+                block.packed = std::move(packed);
+                block.compressed = true;
+            }
+        }
+        g_evictDue = false;
+        lock.unlock();
+        Evict();
+        lock.lock();
+    }
+    return 0;
+}
+
+// Start the worker on first use (g_mutex held)
+bool EnsureWorker() {
+    if (g_worker == NULL) {
+        g_worker = CreateThread(nullptr, 0, WorkerThread, nullptr, 0, nullptr);
+    }
+    return g_worker != NULL;
+}
+
+} // namespace
+
+uint64_t scrollback_store_put(std::vector<uint8_t> data) {
+    if (data.empty() || data.size() > UINT32_MAX) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (!EnsureWorker()) {
+        return 0;
+    }
+    StoredBlock block;
+    block.rawSize = (uint32_t)data.size();
+    block.packedSize = block.rawSize;
+    block.pending = true;
+    block.packed = std::make_shared<std::vector<uint8_t>>(std::move(data));
+
+    uint64_t id = g_nextBlockId++;
+    g_residentBytes += block.packedSize;
+    g_blocks[id] = std::move(block);
+    g_resident.insert(id);
+    g_compressQueue.push_back(id);
+    g_work.notify_one();
+    return id;
+}
+
+bool scrollback_store_get(uint64_t id, std::vector<uint8_t>* data) {
+    if (data == nullptr) {
+        return false;
+    }
+    std::shared_ptr<std::vector<uint8_t>> packed;
+    StoredBlock info;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto it = g_blocks.find(id);
+        if (it == g_blocks.end() || it->second.freed) {
+            return false;
+        }
+        StoredBlock& block = it->second;
+        if (!block.packed && block.spillOffset < 0) {
+            return false;
+        }
+        packed = block.packed;
+        if (!packed) {
+            block.reading++;
+        }
+        info.rawSize = block.rawSize;
+        info.packedSize = block.packedSize;
+        info.compressed = block.compressed;
+        info.spillOffset = block.spillOffset;
+    }
+
+    if (!packed) {
+        // Read back for this call only; the block stays on disk
+        packed = std::make_shared<std::vector<uint8_t>>(info.packedSize);
+        bool read = SpillIo(false, info.spillOffset, packed->data(), info.packedSize);
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            auto it = g_blocks.find(id);
+            it->second.reading--;
+            Reap(it);
+        }
+        if (!read) {
+            return false;
+        }
+    }
+    if (!info.compressed) {
+        data->assign(packed->begin(), packed->end());
+        return true;
+    }
+    data->resize(info.rawSize);
+    SIZE_T rawSize = 0;
+    std::lock_guard<std::mutex> lock(g_decompressMutex);
+    return Decompress(g_decompressor, packed->data(), info.packedSize, data->data(), data->size(), &rawSize) &&
+        rawSize == info.rawSize;
+}
+
+void scrollback_store_free(uint64_t id) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    auto it = g_blocks.find(id);
+    if (it == g_blocks.end() || it->second.freed) {
+        return;
+    }
+    if (g_resident.erase(id) > 0) {
+        g_residentBytes -= it->second.packedSize;
+    }
+    it->second.packed.reset();
+    it->second.freed = true;
+    Reap(it);
+}
+
+void scrollback_store_account(int64_t bytes) {
+    g_hotBytes += bytes;
+}
+
+extern "C" {
+
+__declspec(dllexport) void scrollback_set_budget(int64_t bytes) {
+    g_budget = bytes > 0 ? bytes : 0;
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_evictDue = true;
+    g_work.notify_one();
+}
+
+}
@@ -0,0 +1,30 @@
+#ifndef SCROLLBACK_STORE_H
+#define SCROLLBACK_STORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+// Cold scrollback of every VT screen (vt_screen.h), shared under one memory
+// budget. Blocks are compressed after they are stored; when the resident total
+// goes over the budget the oldest blocks of any screen move to a temporary spill
+// file and are read back only when a snapshot reaches them. Compression and
+// spilling run on the store's own worker thread, never on the caller's.
+
+extern "C" {
+    // Memory that scrollback may keep resident across all screens: uncompressed
+    // hot rows plus compressed blocks. Lower values spill sooner (default 64 MiB).
+    __declspec(dllexport) void scrollback_set_budget(int64_t bytes);
+}
+
+// Internal: used by vt_screen.cpp
+
+// Store a block (taken over as is, compressed later); returns its id, 0 on failure
+uint64_t scrollback_store_put(std::vector<uint8_t> data);
+// The block as it was stored, from memory or the spill file. False if it was lost.
+bool scrollback_store_get(uint64_t id, std::vector<uint8_t>* data);
+void scrollback_store_free(uint64_t id);
+// Uncompressed scrollback bytes that screens keep themselves (a signed delta)
+void scrollback_store_account(int64_t bytes);
+
+#endif // SCROLLBACK_STORE_H
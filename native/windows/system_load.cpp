@@ -0,0 +1,103 @@
+#include "system_load.h"
+#include <windows.h>
+#include <pdh.h>
+#include <mutex>
+
+namespace {
+
+std::mutex g_mutex;
+ULONGLONG g_lastIdle = 0;
+ULONGLONG g_lastTotal = 0;
+
+// Counters without a plain Win32 equivalent; opened on first use
+PDH_HQUERY g_query = NULL;
+PDH_HCOUNTER g_queueCounter = NULL;
+PDH_HCOUNTER g_faultCounter = NULL;
+bool g_queryOpened = false;
+bool g_queryPrimed = false; // Rate counters need two collections
+
+ULONGLONG FileTimeToUll(const FILETIME& time) {
+    return ((ULONGLONG)time.dwHighDateTime << 32) | time.dwLowDateTime;
+}
+
+void OpenQuery() {
+    g_queryOpened = true;
+    if (PdhOpenQueryW(NULL, 0, &g_query) != ERROR_SUCCESS) {
+        g_query = NULL;
+        return;
+    }
+    // English names work regardless of the display language
+    if (PdhAddEnglishCounterW(g_query, L"\\System\\Processor Queue Length", 0, &g_queueCounter) != ERROR_SUCCESS) {
+        g_queueCounter = NULL;
+    }
+    if (PdhAddEnglishCounterW(g_query, L"\\Memory\\Pages Input/sec", 0, &g_faultCounter) != ERROR_SUCCESS) {
+        g_faultCounter = NULL;
+    }
+}
+
+int32_t CounterValue(PDH_HCOUNTER counter) {
+    PDH_FMT_COUNTERVALUE value;
+    if (counter == NULL ||
+            PdhGetFormattedCounterValue(counter, PDH_FMT_LONG, NULL, &value) != ERROR_SUCCESS ||
+            value.CStatus != ERROR_SUCCESS) {
+        return -1;
+    }
+    return (int32_t)value.longValue;
+}
+
+} // namespace
+
+extern "C" {
+
+// Sample CPU, run queue and memory pressure (see system_load.h)
+__declspec(dllexport) bool system_load(SystemLoad* out) {
+    if (out == nullptr) {
+        return false;
+    }
+    ZeroMemory(out, sizeof(*out));
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    out->processorCount = (int32_t)info.dwNumberOfProcessors;
+
+    // Kernel time includes idle time
+    FILETIME idle, kernel, user;
+    if (GetSystemTimes(&idle, &kernel, &user)) {
+        ULONGLONG idleTime = FileTimeToUll(idle);
+        ULONGLONG totalTime = FileTimeToUll(kernel) + FileTimeToUll(user);
+        if (g_lastTotal != 0 && totalTime > g_lastTotal) {
+            ULONGLONG idleDelta = idleTime - g_lastIdle;
+            ULONGLONG totalDelta = totalTime - g_lastTotal;
+            out->cpuBusyPermille = (int32_t)(1000 - (idleDelta * 1000) / totalDelta);
+        }
+        g_lastIdle = idleTime;
+        g_lastTotal = totalTime;
+    }
+
+    MEMORYSTATUSEX memory;
+    memory.dwLength = sizeof(memory);
+    if (GlobalMemoryStatusEx(&memory)) {
+        out->memoryLoadPercent = (int32_t)memory.dwMemoryLoad;
+        out->availableBytes = (int64_t)memory.ullAvailPhys;
+        // The "page file" figures are the commit limit and what is left of it
+        out->commitLimitBytes = (int64_t)memory.ullTotalPageFile;
+        out->commitBytes = (int64_t)(memory.ullTotalPageFile - memory.ullAvailPageFile);
+    }
+
+    if (!g_queryOpened) {
+        OpenQuery();
+    }
+    out->runQueueLength = -1;
+    out->hardFaultsPerSec = -1;
+    if (g_query != NULL && PdhCollectQueryData(g_query) == ERROR_SUCCESS) {
+        out->runQueueLength = CounterValue(g_queueCounter);
+        if (g_queryPrimed) {
+            out->hardFaultsPerSec = CounterValue(g_faultCounter);
+        }
+        g_queryPrimed = true;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,26 @@
+#ifndef SYSTEM_LOAD_H
+#define SYSTEM_LOAD_H
+
+#include <windows.h>
+#include <stdint.h>
+
+// Machine-wide load signals used for launch admission
+struct SystemLoad {
+    int32_t cpuBusyPermille;    // Share of all processors busy since the previous call (0-1000)
+    int32_t processorCount;
+    int32_t runQueueLength;     // Threads ready to run but waiting for a processor (-1 if unknown)
+    int32_t memoryLoadPercent;  // Physical memory in use
+    int64_t availableBytes;     // Physical memory available without paging anything out
+    int64_t commitBytes;        // Committed memory of the whole system
+    int64_t commitLimitBytes;
+    int32_t hardFaultsPerSec;   // Pages read back from disk (-1 until the second call)
+    int32_t reserved;
+};
+
+extern "C" {
+    // Sample system load. CPU busy and the fault rate are averaged over the time since the
+    // previous call, so call it at a steady interval from one place.
+    __declspec(dllexport) bool system_load(SystemLoad* out);
+}
+
+#endif // SYSTEM_LOAD_H
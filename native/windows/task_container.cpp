@@ -0,0 +1,888 @@
+#include "task_container.h"
+#include "conpty.h"
+#include "io_reactor.h"
+#include "path_resolver.h"
+#include "vt_screen.h"
+#include <windows.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct TaskContainer {
+    int id = 0;
+    ConPtyProcess pty;
+    HANDLE hJob = NULL;
+    int outputSource = 0; // Reactor source reading pty.outputRead
+    HANDLE exitWait = NULL;
+    std::mutex consoleMutex; // Guards pty.hpc between the exit callback and close
+    std::atomic<bool> exitPosted{false};
+
+    // Pipe mode: no pseudo console (pty.hpc stays NULL), stdout is read from
+    // pty.outputRead and stderr separately
+    bool pipes = false;
+    HANDLE errorRead = NULL;
+    int errorSource = 0;
+
+    // Prewarmed shells hold their output until a task takes them over
+    std::mutex outputMutex; // Guards everything below
+    bool pooled = false;
+    std::string heldOutput;
+    std::string line; // Visible text of the current output line
+    int escapeState = 0;
+    bool promptSeen = false;
+    std::atomic<bool> promptPosted{false};
+    std::shared_ptr<VtScreen> screen; // Parses the output once attached
+    std::string screenBacklog;        // Output from before the screen was attached
+};
+
+// A prewarmed shell is only reused for an identical launch
+struct PoolRequest {
+    std::string key;
+    std::string commandLine;
+    std::string workingDir;
+    std::wstring environment; // Whole block including the final terminator; empty to inherit
+    int cols = 80;
+    int rows = 24;
+    uint64_t generation = 0; // g_poolGeneration when the shell was requested
+};
+
+const size_t kMaxHeldOutput = 64 * 1024;
+const DWORD kPipeBufferSize = 64 * 1024;
+const DWORD kPipeDrainMs = 2000; // Output still arriving from orphaned descendants
+const DWORD kConsumerDrainMs = 5000; // A full ring waiting for Dart to catch up
+const size_t kMaxLineLength = 512;
+const int kMaxIdleShells = 8; // Across all launch configurations
+
+std::mutex g_mutex;
+std::map<int, std::shared_ptr<TaskContainer>> g_containers;
+int g_nextContainerId = 1;
+std::atomic<ContainerEventCallback> g_callback(nullptr);
+std::atomic<ContainerPromptCallback> g_promptCallback(nullptr);
+
+std::mutex g_poolMutex;
+std::map<std::string, std::deque<int>> g_idleShells;
+std::map<std::string, int> g_pendingShells; // Still starting up
+int g_idleCount = 0;
+int g_pendingCount = 0;
+uint64_t g_poolGeneration = 0; // Bumped by task_container_pool_clear
+
+std::shared_ptr<TaskContainer> FindContainer(int containerId) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    auto it = g_containers.find(containerId);
+    return it != g_containers.end() ? it->second : nullptr;
+}
+
+void CloseConsole(TaskContainer* container) {
+    std::lock_guard<std::mutex> lock(container->consoleMutex);
+    conpty_close_console(&container->pty);
+}
+
+// Track the visible text of the current line, skipping escape sequences.
+// ConPTY repaints with cursor positioning, so CSI H/f starts a new line too.
+void TrackLine(TaskContainer* container, const char* data, DWORD length) {
+    for (DWORD i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)data[i];
+        switch (container->escapeState) {
+        case 0:
+            if (c == 0x1b) {
+                container->escapeState = 1;
+            } else if (c == '\r' || c == '\n') {
+                container->line.clear();
+            } else if (c >= 0x20) {
+                if (container->line.size() >= kMaxLineLength) {
+                    container->line.erase(0, container->line.size() / 2);
+                }
+                container->line.push_back((char)c);
+            }
+            break;
+        case 1: // After ESC
+            container->escapeState = c == '[' ? 2 : c == ']' ? 3 : 0;
+            break;
+        case 2: // CSI parameters until the final byte
+            if (c >= 0x40 && c <= 0x7e) {
+                if (c == 'H' || c == 'f') {
+                    container->line.clear();
+                }
+                container->escapeState = 0;
+            }
+            break;
+        case 3: // OSC until BEL or ST
+            if (c == 0x07) {
+                container->escapeState = 0;
+            } else if (c == 0x1b) {
+                container->escapeState = 1;
+            }
+            break;
+        }
+    }
+}
+
+// cmd.exe ("C:\dir>") and PowerShell ("PS C:\dir> ") prompts: the line ends in
+// '>' after a drive path, and output has paused there
+bool LooksLikePrompt(const std::string& line) {
+    size_t end = line.find_last_not_of(' ');
+    if (end == std::string::npos || end < 3 || line[end] != '>') {
+        return false;
+    }
+    size_t drive = line.rfind(":\\", end);
+    return drive != std::string::npos && drive > 0 && isalpha((unsigned char)line[drive - 1]) &&
+        line.find('>', drive) == end;
+}
+
+void PostOutput(int containerId, const char* data, size_t length) {
+    ContainerEventCallback callback = g_callback.load();
+    if (callback == nullptr || length == 0) {
+        return;
+    }
+    // The listener runs later on the Dart side, so hand over a copy it frees
+    auto chunk = static_cast<uint8_t*>(malloc(length));
+    if (chunk != nullptr) {
+        memcpy(chunk, data, length);
+        callback(containerId, chunk, (int32_t)length);
+    }
+}
+
+void PostPrompt(TaskContainer* container) {
+    if (container->promptPosted.exchange(true)) {
+        return;
+    }
+    ContainerPromptCallback callback = g_promptCallback.load();
+    if (callback != nullptr) {
+        callback(container->id);
+    }
+}
+
+// Output for the attached screen; kept until one is. outputMutex held.
+void FeedScreen(TaskContainer* container, const char* data, size_t length) {
+    if (container->screen) {
+        vt_screen_feed(container->screen.get(), data, length, container->pipes);
+        return;
+    }
+    size_t used = container->screenBacklog.size();
+    size_t room = used < kMaxHeldOutput ? kMaxHeldOutput - used : 0;
+    container->screenBacklog.append(data, length < room ? length : room);
+}
+
+// Pipe output (both streams) only feeds the screen. stderr is not coloured
+// there, so the screen's byte count matches what Dart receives.
+bool FilterPipeOutput(TaskContainer* container, const char* data, DWORD length) {
+    std::lock_guard<std::mutex> lock(container->outputMutex);
+    FeedScreen(container, data, length);
+    return true;
+}
+
+// Terminal output passes through here on the reactor thread: scanned for
+// the first prompt, held back while the shell is pooled, and parsed into
+// the task's screen
+bool FilterTerminalOutput(TaskContainer* container, const char* data, DWORD length) {
+    bool announce = false;
+    {
+        std::lock_guard<std::mutex> lock(container->outputMutex);
+        if (!container->promptSeen) {
+            TrackLine(container, data, length);
+            container->promptSeen = LooksLikePrompt(container->line);
+            announce = container->promptSeen;
+        }
+        if (container->pooled) {
+            // Held until the shell is taken; the banner and first prompt fit easily
+            size_t room = kMaxHeldOutput - container->heldOutput.size();
+            container->heldOutput.append(data, length < room ? length : room);
+            return false;
+        }
+        FeedScreen(container, data, length);
+    }
+    if (announce) {
+        PostPrompt(container);
+    }
+    return true;
+}
+
+// Wait until a source has handed over its last output. A descendant that
+// inherited a pipe keeps it open after the root exits, and a full ring waits
+// for Dart, which may be busy or gone; give either a moment, then stop
+// reading. Once cancelled, only the reactor thread is left to finish the
+// source, so the final wait cannot depend on the consumer.
+void DrainSource(int sourceId, bool pipes) {
+    if (sourceId == 0) {
+        return;
+    }
+    if (!io_reactor_wait(sourceId, pipes ? kPipeDrainMs : kConsumerDrainMs)) {
+        io_reactor_cancel(sourceId);
+    }
+    io_reactor_wait(sourceId, INFINITE);
+}
+
+// Post the exit event once, after the reader has delivered the last output
+void PostExit(TaskContainer* container) {
+    if (container->exitPosted.exchange(true)) {
+        return;
+    }
+    DWORD exitCode = 0;
+    if (!GetExitCodeProcess(container->pty.hProcess, &exitCode)) {
+        exitCode = (DWORD)-1;
+    }
+    ContainerEventCallback callback = g_callback.load();
+    if (callback != nullptr) {
+        callback(container->id, nullptr, (int32_t)exitCode);
+    }
+}
+
+void ForgetIdleShell(int containerId) {
+    std::lock_guard<std::mutex> lock(g_poolMutex);
+    for (auto& entry : g_idleShells) {
+        for (auto it = entry.second.begin(); it != entry.second.end(); ++it) {
+            if (*it == containerId) {
+                entry.second.erase(it);
+                g_idleCount--;
+                return;
+            }
+        }
+    }
+}
+
+DWORD WINAPI CloseWork(LPVOID param) {
+    task_container_close((int)(intptr_t)param);
+    return 0;
+}
+
+void CALLBACK OnRootExit(PVOID context, BOOLEAN) {
+    auto container = FindContainer((int)(intptr_t)context);
+    if (!container) {
+        return;
+    }
+    // ConPTY keeps the output pipe open after the client exits; closing the
+    // console flushes it and lets the reactor see the end of it
+    CloseConsole(container.get());
+    DrainSource(container->outputSource, container->pipes);
+    DrainSource(container->errorSource, container->pipes);
+
+    bool idle;
+    {
+        std::lock_guard<std::mutex> lock(container->outputMutex);
+        idle = container->pooled;
+        container->pooled = false; // No longer takeable
+    }
+    if (idle) {
+        // Nobody is listening for a prewarmed shell; release it without an event.
+        // Closing waits for this callback, so it has to happen elsewhere.
+        container->exitPosted.store(true);
+        ForgetIdleShell(container->id);
+        QueueUserWorkItem(CloseWork, (PVOID)(intptr_t)container->id, WT_EXECUTEDEFAULT);
+        return;
+    }
+    PostExit(container.get());
+}
+
+std::wstring Utf8ToWide(const char* text) {
+    int length = MultiByteToWideChar(CP_UTF8, 0, text, -1, NULL, 0);
+    if (length <= 0) {
+        return std::wstring();
+    }
+    std::wstring wide(length, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, text, -1, &wide[0], length);
+    wide.resize(length - 1);
+    return wide;
+}
+
+// Spawn commandLine with anonymous pipes for stdin, stdout and stderr instead
+// of a pseudo console. Only the child's three ends are inherited, so
+// containers spawned concurrently do not keep each other's pipes open.
+bool SpawnWithPipes(const char* commandLine, const char* application, const char* working_dir,
+        DWORD creationFlags, const void* environment, ConPtyProcess* out, HANDLE* errorRead) {
+    SECURITY_ATTRIBUTES inheritable = { sizeof(SECURITY_ATTRIBUTES), NULL, TRUE };
+    HANDLE inputRead = NULL, inputWrite = NULL;
+    HANDLE outputRead = NULL, outputWrite = NULL;
+    HANDLE errRead = NULL, errWrite = NULL;
+    auto closeAll = [&]() {
+        for (HANDLE h : { inputRead, inputWrite, outputRead, outputWrite, errRead, errWrite }) {
+            if (h != NULL) {
+                CloseHandle(h);
+            }
+        }
+    };
+    // Our ends of the output pipes are read by the reactor, so they are overlapped
+    if (!CreatePipe(&inputRead, &inputWrite, &inheritable, 0) ||
+            !SetHandleInformation(inputWrite, HANDLE_FLAG_INHERIT, 0) ||
+            !io_create_pipe(&outputRead, &outputWrite, true, kPipeBufferSize) ||
+            !io_create_pipe(&errRead, &errWrite, true, kPipeBufferSize)) {
+        closeAll();
+        return false;
+    }
+
+    HANDLE inherited[3] = { inputRead, outputWrite, errWrite };
+    SIZE_T attrSize = 0;
+    InitializeProcThreadAttributeList(NULL, 1, 0, &attrSize);
+    std::vector<BYTE> attrBuffer(attrSize);
+    auto attrList = reinterpret_cast<LPPROC_THREAD_ATTRIBUTE_LIST>(attrBuffer.data());
+    if (!InitializeProcThreadAttributeList(attrList, 1, 0, &attrSize) ||
+            !UpdateProcThreadAttribute(attrList, 0, PROC_THREAD_ATTRIBUTE_HANDLE_LIST,
+                inherited, sizeof(inherited), NULL, NULL)) {
+        closeAll();
+        return false;
+    }
+
+    STARTUPINFOEXW si;
+    ZeroMemory(&si, sizeof(si));
+    si.StartupInfo.cb = sizeof(si);
+    si.StartupInfo.dwFlags = STARTF_USESTDHANDLES;
+    si.StartupInfo.hStdInput = inputRead;
+    si.StartupInfo.hStdOutput = outputWrite;
+    si.StartupInfo.hStdError = errWrite;
+    si.lpAttributeList = attrList;
+
+    PROCESS_INFORMATION pi;
+    ZeroMemory(&pi, sizeof(pi));
+    std::wstring cmd = Utf8ToWide(commandLine);
+    std::wstring dir = working_dir != nullptr ? Utf8ToWide(working_dir) : std::wstring();
+    std::wstring image = application != nullptr ? Utf8ToWide(application) : std::wstring();
+
+    // No console window: the output goes to the pipes only
+    BOOL result = CreateProcessW(image.empty() ? NULL : image.c_str(), &cmd[0], NULL, NULL, TRUE,
+        EXTENDED_STARTUPINFO_PRESENT | CREATE_NO_WINDOW | creationFlags,
+        const_cast<void*>(environment), dir.empty() ? NULL : dir.c_str(), &si.StartupInfo, &pi);
+    DeleteProcThreadAttributeList(attrList);
+
+    // The child has its own copies now
+    CloseHandle(inputRead);
+    CloseHandle(outputWrite);
+    CloseHandle(errWrite);
+    if (!result) {
+        CloseHandle(inputWrite);
+        CloseHandle(outputRead);
+        CloseHandle(errRead);
+        return false;
+    }
+
+    out->inputWrite = inputWrite;
+    out->outputRead = outputRead;
+    out->hProcess = pi.hProcess;
+    out->hThread = pi.hThread;
+    out->processId = pi.dwProcessId;
+    *errorRead = errRead;
+    return true;
+}
+
+int SpawnContainer(const char* commandLine, const char* working_dir,
+        const wchar_t* environment, int cols, int rows, bool pooled,
+        const char* application = nullptr, bool pipes = false) {
+    if (commandLine == nullptr || g_callback.load() == nullptr) {
+        return 0;
+    }
+
+    HANDLE hJob = CreateJobObjectA(NULL, NULL);
+    if (hJob == NULL) {
+        return 0;
+    }
+    JOBOBJECT_EXTENDED_LIMIT_INFORMATION jobInfo = {0};
+    jobInfo.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
+    if (!SetInformationJobObject(hJob, JobObjectExtendedLimitInformation, &jobInfo, sizeof(jobInfo))) {
+        CloseHandle(hJob);
+        return 0;
+    }
+
+    auto container = std::make_shared<TaskContainer>();
+    container->pooled = pooled;
+    container->pipes = pipes;
+    container->promptSeen = pipes; // No prompt to look for
+    DWORD flags = CREATE_SUSPENDED | (environment != nullptr ? CREATE_UNICODE_ENVIRONMENT : 0);
+    bool spawned = pipes
+        ? SpawnWithPipes(commandLine, application, working_dir, flags, environment,
+            &container->pty, &container->errorRead)
+        : conpty_spawn(commandLine, working_dir, (short)cols, (short)rows, flags, &container->pty,
+            environment, application, true);
+    if (!spawned) {
+        CloseHandle(hJob);
+        return 0;
+    }
+
+    // The process has not run a single instruction yet, so nothing can escape the job
+    if (!AssignProcessToJobObject(hJob, container->pty.hProcess)) {
+        TerminateProcess(container->pty.hProcess, 1);
+        conpty_release(&container->pty);
+        if (container->errorRead != NULL) {
+            CloseHandle(container->errorRead);
+        }
+        CloseHandle(hJob);
+        return 0;
+    }
+    container->hJob = hJob;
+
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        container->id = g_nextContainerId++;
+        g_containers[container->id] = container;
+    }
+
+    // The container outlives its sources: both exit paths drain them before
+    // releasing anything
+    TaskContainer* raw = container.get();
+    IoFilter filter;
+    if (pipes) {
+        filter = [raw](const char* data, DWORD length) { return FilterPipeOutput(raw, data, length); };
+    } else {
+        filter = [raw](const char* data, DWORD length) { return FilterTerminalOutput(raw, data, length); };
+    }
+    container->outputSource = io_reactor_add(container->pty.outputRead, container->id, IO_STREAM_OUTPUT, filter);
+    if (pipes) {
+        container->errorSource = io_reactor_add(container->errorRead, container->id, IO_STREAM_ERROR, filter);
+    }
+    if (container->outputSource == 0 || (pipes && container->errorSource == 0)) {
+        task_container_close(container->id);
+        return 0;
+    }
+
+    ResumeThread(container->pty.hThread);
+
+    if (!RegisterWaitForSingleObject(&container->exitWait, container->pty.hProcess, OnRootExit,
+            (PVOID)(intptr_t)container->id, INFINITE, WT_EXECUTEONLYONCE | WT_EXECUTELONGFUNCTION)) {
+        container->exitWait = NULL;
+        task_container_close(container->id);
+        return 0;
+    }
+
+    return container->id;
+}
+
+// Split a command line into arguments the way the C runtime (and
+// CommandLineToArgvW) does: 2n backslashes before a quote are n backslashes
+// and the quote toggles quoting, 2n+1 are n and a literal quote, and ""
+// inside quotes is a literal quote
+std::vector<std::string> SplitCommandLine(const char* commandLine) {
+    std::vector<std::string> args;
+    const char* p = commandLine;
+    for (;;) {
+        while (*p == ' ' || *p == '\t') {
+            p++;
+        }
+        if (*p == '\0') {
+            break;
+        }
+        std::string arg;
+        bool quoted = false;
+        while (*p != '\0' && (quoted || (*p != ' ' && *p != '\t'))) {
+            size_t backslashes = 0;
+            while (*p == '\\') {
+                backslashes++;
+                p++;
+            }
+            if (*p == '"') {
+                arg.append(backslashes / 2, '\\');
+                if (backslashes % 2 == 1) {
+                    arg.push_back('"');
+                    p++;
+                } else if (quoted && p[1] == '"') {
+                    arg.push_back('"');
+                    p += 2;
+                } else {
+                    quoted = !quoted;
+                    p++;
+                }
+            } else {
+                arg.append(backslashes, '\\');
+                if (*p != '\0' && (quoted || (*p != ' ' && *p != '\t'))) {
+                    arg.push_back(*p++);
+                }
+            }
+        }
+        args.push_back(arg);
+    }
+    return args;
+}
+
+// Append arg so that SplitCommandLine gives it back unchanged
+void AppendQuoted(std::string& commandLine, const std::string& arg) {
+    if (!commandLine.empty()) {
+        commandLine.push_back(' ');
+    }
+    if (!arg.empty() && arg.find_first_of(" \t\n\v\"") == std::string::npos) {
+        commandLine += arg;
+        return;
+    }
+    commandLine.push_back('"');
+    size_t backslashes = 0;
+    for (char c : arg) {
+        if (c == '\\') {
+            backslashes++;
+            continue;
+        }
+        // Backslashes only need doubling in front of a quote
+        commandLine.append(c == '"' ? backslashes * 2 + 1 : backslashes, '\\');
+        backslashes = 0;
+        commandLine.push_back(c);
+    }
+    commandLine.append(backslashes * 2, '\\'); // Before the closing quote
+    commandLine.push_back('"');
+}
+
+// Resolve the image CreateProcess would start: relative paths against the task's
+// working directory, bare names in CreateProcess's search order
+std::string ResolveImage(const std::string& name, const char* working_dir) {
+    bool hasPath = name.find_first_of("\\/") != std::string::npos;
+    bool absolute = name.size() > 1 && (name[1] == ':' || (name[0] == '\\' && name[1] == '\\'));
+    if (hasPath && !absolute && working_dir != nullptr) {
+        return resolve_image_path(std::string(working_dir) + "\\" + name);
+    }
+    return resolve_image_path(name);
+}
+
+// Batch files can only run under cmd.exe, whose quoting rules differ
+bool IsBatchFile(const std::string& path) {
+    size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos) {
+        return false;
+    }
+    std::string ext = path.substr(dot);
+    return _stricmp(ext.c_str(), ".bat") == 0 || _stricmp(ext.c_str(), ".cmd") == 0;
+}
+
+// Resolve the image of a direct launch and build its exactly quoted command
+// line. False if there is nothing to start without the shell.
+bool BuildDirectLaunch(const char* command, const char* const* arguments, int argumentCount,
+        const char* working_dir, std::string* image, std::string* commandLine) {
+    std::vector<std::string> argv = SplitCommandLine(command);
+    if (argv.empty()) {
+        return false;
+    }
+    for (int i = 0; i < argumentCount; i++) {
+        argv.push_back(arguments[i] != nullptr ? arguments[i] : "");
+    }
+
+    *image = ResolveImage(argv[0], working_dir);
+    if (image->empty() || IsBatchFile(*image)) {
+        return false;
+    }
+    commandLine->clear();
+    for (const std::string& arg : argv) {
+        AppendQuoted(*commandLine, arg);
+    }
+    return true;
+}
+
+std::string PoolKey(const char* commandLine, const char* working_dir, const std::wstring& environment) {
+    std::string key(commandLine);
+    key.push_back('\0');
+    if (working_dir != nullptr) {
+        key.append(working_dir);
+    }
+    key.push_back('\0');
+    key.append(reinterpret_cast<const char*>(environment.data()), environment.size() * sizeof(wchar_t));
+    return key;
+}
+
+// Copy a UTF-16 environment block up to and including its double terminator
+std::wstring CopyEnvironment(const wchar_t* environment) {
+    if (environment == nullptr) {
+        return std::wstring();
+    }
+    const wchar_t* end = environment;
+    while (end[0] != L'\0' || end[1] != L'\0') {
+        end++;
+    }
+    return std::wstring(environment, end + 2);
+}
+
+// Close a prewarmed shell nobody took; no exit is reported for it
+void DiscardShell(int containerId) {
+    auto container = FindContainer(containerId);
+    if (container) {
+        container->exitPosted.store(true);
+        task_container_close_async(containerId);
+    }
+}
+
+DWORD WINAPI PrewarmWork(LPVOID param) {
+    std::unique_ptr<PoolRequest> request(static_cast<PoolRequest*>(param));
+    int id = SpawnContainer(request->commandLine.c_str(),
+        request->workingDir.empty() ? nullptr : request->workingDir.c_str(),
+        request->environment.empty() ? nullptr : request->environment.c_str(),
+        request->cols, request->rows, true);
+
+    {
+        std::lock_guard<std::mutex> lock(g_poolMutex);
+        // The pool was cleared while this shell started: it is not wanted anymore
+        if (request->generation == g_poolGeneration) {
+            g_pendingShells[request->key]--;
+            g_pendingCount--;
+            if (id != 0) {
+                g_idleShells[request->key].push_back(id);
+                g_idleCount++;
+            }
+            return 0;
+        }
+    }
+    if (id != 0) {
+        DiscardShell(id);
+    }
+    return 0;
+}
+
+// Start enough prewarmed shells in the background to keep poolSize idle
+void Refill(const PoolRequest& request, int poolSize) {
+    std::lock_guard<std::mutex> lock(g_poolMutex);
+    int have = (int)g_idleShells[request.key].size() + g_pendingShells[request.key];
+    int missing = poolSize - have;
+    int room = kMaxIdleShells - g_idleCount - g_pendingCount;
+    for (int i = 0; i < missing && i < room; i++) {
+        auto work = new PoolRequest(request);
+        work->generation = g_poolGeneration;
+        if (!QueueUserWorkItem(PrewarmWork, work, WT_EXECUTELONGFUNCTION)) {
+            delete work;
+            break;
+        }
+        g_pendingShells[request.key]++;
+        g_pendingCount++;
+    }
+}
+
+// Take over an idle shell: flush the output it held back and announce its
+// prompt if it already printed one. Fails if the shell is exiting.
+bool Adopt(TaskContainer* container) {
+    bool prompt;
+    {
+        std::lock_guard<std::mutex> lock(container->outputMutex);
+        if (!container->pooled) {
+            return false;
+        }
+        container->pooled = false;
+        PostOutput(container->id, container->heldOutput.data(), container->heldOutput.size());
+        FeedScreen(container, container->heldOutput.data(), container->heldOutput.size());
+        container->heldOutput.clear();
+        container->heldOutput.shrink_to_fit();
+        prompt = container->promptSeen;
+    }
+    if (prompt) {
+        PostPrompt(container);
+    }
+    return true;
+}
+
+} // namespace
+
+extern "C" {
+
+// Register the Dart container event callback (NULL to detach)
+__declspec(dllexport) void task_container_set_callback(ContainerEventCallback callback) {
+    g_callback.store(callback);
+}
+
+// Start a contained process in a pseudo console
+__declspec(dllexport) int task_container_spawn(const char* commandLine, const char* working_dir,
+        const wchar_t* environment, int cols, int rows) {
+    return SpawnContainer(commandLine, working_dir, environment, cols, rows, false);
+}
+
+// Start an executable directly, without a shell, with an exact argument vector
+__declspec(dllexport) int task_container_exec(const char* command, const char* const* arguments,
+        int argumentCount, const char* working_dir, const wchar_t* environment, int cols, int rows) {
+    if (command == nullptr || (arguments == nullptr && argumentCount > 0)) {
+        return 0;
+    }
+    std::string image, commandLine;
+    if (!BuildDirectLaunch(command, arguments, argumentCount, working_dir, &image, &commandLine)) {
+        return 0;
+    }
+    return SpawnContainer(commandLine.c_str(), working_dir, environment, cols, rows, false, image.c_str());
+}
+
+// Start a process with plain pipes instead of a pseudo console
+__declspec(dllexport) int task_container_spawn_pipes(const char* commandLine, const char* working_dir,
+        const wchar_t* environment, int direct) {
+    if (commandLine == nullptr) {
+        return 0;
+    }
+    if (!direct) {
+        return SpawnContainer(commandLine, working_dir, environment, 0, 0, false, nullptr, true);
+    }
+    std::string image, quoted;
+    if (!BuildDirectLaunch(commandLine, nullptr, 0, working_dir, &image, &quoted)) {
+        return 0;
+    }
+    return SpawnContainer(quoted.c_str(), working_dir, environment, 0, 0, false, image.c_str(), true);
+}
+
+// Register the Dart prompt callback (NULL to detach)
+__declspec(dllexport) void task_container_set_prompt_callback(ContainerPromptCallback callback) {
+    g_promptCallback.store(callback);
+}
+
+// Take a prewarmed shell for this launch if one is idle, else spawn one, and
+// top the pool back up in the background
+__declspec(dllexport) int task_container_acquire(const char* commandLine, const char* working_dir,
+        const wchar_t* environment, int cols, int rows, int poolSize) {
+    if (commandLine == nullptr || poolSize <= 0) {
+        return task_container_spawn(commandLine, working_dir, environment, cols, rows);
+    }
+
+    PoolRequest request;
+    request.environment = CopyEnvironment(environment);
+    request.key = PoolKey(commandLine, working_dir, request.environment);
+    request.commandLine = commandLine;
+    request.workingDir = working_dir != nullptr ? working_dir : "";
+    request.cols = cols;
+    request.rows = rows;
+
+    int id = 0;
+    for (;;) {
+        int candidate = 0;
+        {
+            std::lock_guard<std::mutex> lock(g_poolMutex);
+            auto& idle = g_idleShells[request.key];
+            if (!idle.empty()) {
+                candidate = idle.front();
+                idle.pop_front();
+                g_idleCount--;
+            }
+        }
+        if (candidate == 0) {
+            break;
+        }
+        auto container = FindContainer(candidate);
+        if (container && Adopt(container.get())) {
+            task_container_resize(candidate, cols, rows);
+            id = candidate;
+            break;
+        }
+    }
+    if (id == 0) {
+        id = task_container_spawn(commandLine, working_dir, environment, cols, rows);
+    }
+
+    Refill(request, poolSize);
+    return id;
+}
+
+// Close every idle prewarmed shell; those still starting are closed once they are up
+__declspec(dllexport) void task_container_pool_clear() {
+    std::map<std::string, std::deque<int>> idle;
+    {
+        std::lock_guard<std::mutex> lock(g_poolMutex);
+        idle.swap(g_idleShells);
+        g_idleCount = 0;
+        g_pendingShells.clear();
+        g_pendingCount = 0;
+        g_poolGeneration++;
+    }
+    for (auto& entry : idle) {
+        for (int id : entry.second) {
+            DiscardShell(id);
+        }
+    }
+}
+
+__declspec(dllexport) int task_container_pid(int containerId) {
+    auto container = FindContainer(containerId);
+    return container ? (int)container->pty.processId : 0;
+}
+
+// Duplicate the job handle so the caller's lifetime is independent of the container's
+__declspec(dllexport) intptr_t task_container_job(int containerId) {
+    auto container = FindContainer(containerId);
+    if (!container) {
+        return 0;
+    }
+    HANDLE duplicate = NULL;
+    if (!DuplicateHandle(GetCurrentProcess(), container->hJob, GetCurrentProcess(), &duplicate,
+            0, FALSE, DUPLICATE_SAME_ACCESS)) {
+        return 0;
+    }
+    return reinterpret_cast<intptr_t>(duplicate);
+}
+
+__declspec(dllexport) bool task_container_write(int containerId, const uint8_t* data, int length) {
+    auto container = FindContainer(containerId);
+    if (!container || data == nullptr || length <= 0) {
+        return false;
+    }
+    return conpty_write(&container->pty, reinterpret_cast<const char*>(data), (DWORD)length);
+}
+
+// Parse the container's output into a screen from now on, starting with what
+// it printed before (the screen's output count restarts at zero)
+__declspec(dllexport) bool task_container_attach_screen(int containerId, int screenId) {
+    auto container = FindContainer(containerId);
+    auto screen = vt_screen_get(screenId);
+    if (!container || !screen) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(container->outputMutex);
+    container->screen = screen;
+    vt_screen_reset_output(screen.get());
+    vt_screen_feed(screen.get(), container->screenBacklog.data(), container->screenBacklog.size(), container->pipes);
+    container->screenBacklog.clear();
+    container->screenBacklog.shrink_to_fit();
+    return true;
+}
+
+__declspec(dllexport) bool task_container_resize(int containerId, int cols, int rows) {
+    auto container = FindContainer(containerId);
+    if (!container || cols <= 0 || rows <= 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(container->consoleMutex);
+    if (container->pty.hpc == NULL) {
+        return false;
+    }
+    COORD size = { (short)cols, (short)rows };
+    return SUCCEEDED(ResizePseudoConsole(container->pty.hpc, size));
+}
+
+// Kill everything in the job and release the container
+__declspec(dllexport) void task_container_close(int containerId) {
+    std::shared_ptr<TaskContainer> container;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto it = g_containers.find(containerId);
+        if (it == g_containers.end()) {
+            return;
+        }
+        container = it->second;
+        g_containers.erase(it);
+    }
+
+    // Output still unread is dropped: a running OnRootExit then finishes its
+    // drain without waiting for Dart to make room in a full ring
+    io_reactor_cancel(container->outputSource);
+    io_reactor_cancel(container->errorSource);
+
+    // Waits for a running OnRootExit; one that has not started finds nothing
+    if (container->exitWait != NULL) {
+        UnregisterWaitEx(container->exitWait, INVALID_HANDLE_VALUE);
+    }
+
+    TerminateJobObject(container->hJob, 1);
+    WaitForSingleObject(container->pty.hProcess, 1000);
+    CloseConsole(container.get());
+    for (int source : { container->outputSource, container->errorSource }) {
+        DrainSource(source, container->pipes);
+        io_reactor_remove(source);
+    }
+    PostExit(container.get());
+
+    conpty_release(&container->pty);
+    if (container->errorRead != NULL) {
+        CloseHandle(container->errorRead);
+    }
+    CloseHandle(container->hJob);
+}
+
+// task_container_close on a worker thread, for callers that must not block
+__declspec(dllexport) void task_container_close_async(int containerId) {
+    if (!QueueUserWorkItem(CloseWork, (PVOID)(intptr_t)containerId, WT_EXECUTELONGFUNCTION)) {
+        task_container_close(containerId);
+    }
+}
+
+__declspec(dllexport) void task_container_free_output(uint8_t* data) {
+    free(data);
+}
+
+}
@@ -0,0 +1,70 @@
+#ifndef TASK_CONTAINER_H
+#define TASK_CONTAINER_H
+
+#include <windows.h>
+#include <stdint.h>
+
+// Output and exit events of a task container, called from native threads
+// (register a NativeCallable.listener from Dart).
+// data != NULL: length bytes of terminal output; release with task_container_free_output.
+//   Only a prewarmed shell's held-back output comes this way - everything else is
+//   read by the I/O reactor and arrives in its batches (io_reactor.h).
+// data == NULL: the root process exited with exit code `length`; no more events follow,
+//   and every batch with the container's output was posted before it.
+typedef void (*ContainerEventCallback)(int32_t containerId, uint8_t* data, int32_t length);
+// Called once per container when its shell first shows a cmd.exe or PowerShell prompt.
+typedef void (*ContainerPromptCallback)(int32_t containerId);
+
+extern "C" {
+    __declspec(dllexport) void task_container_set_callback(ContainerEventCallback callback);
+    // Start commandLine (UTF-8) in a pseudo console, created suspended and resumed only
+    // after it is assigned to a fresh job object, so every descendant is contained.
+    // environment is an optional UTF-16 environment block (NULL to inherit ours).
+    // Returns a container id, 0 on failure (including a failed job assignment).
+    __declspec(dllexport) int task_container_spawn(const char* commandLine, const char* working_dir,
+        const wchar_t* environment, int cols, int rows);
+    // Start an executable directly, without cmd.exe. command (UTF-8) is split with the
+    // C runtime rules, arguments are appended verbatim, and the whole argv is re-quoted
+    // so the child's C runtime parses exactly that argv. The image is resolved through
+    // PATH/PATHEXT (relative paths against working_dir). Returns 0 if it cannot be
+    // found or is a batch file, which needs the shell.
+    __declspec(dllexport) int task_container_exec(const char* command, const char* const* arguments,
+        int argumentCount, const char* working_dir, const wchar_t* environment, int cols, int rows);
+    // Start commandLine with anonymous pipes instead of a pseudo console, for tasks that
+    // need no terminal: nothing is re-rendered and stdout and stderr stay apart (reactor
+    // streams IO_STREAM_OUTPUT and IO_STREAM_ERROR). With direct != 0 commandLine is
+    // resolved and re-quoted like task_container_exec (0 if that is not possible);
+    // otherwise it is run verbatim.
+    __declspec(dllexport) int task_container_spawn_pipes(const char* commandLine, const char* working_dir,
+        const wchar_t* environment, int direct);
+    __declspec(dllexport) void task_container_set_prompt_callback(ContainerPromptCallback callback);
+    // Like task_container_spawn, but takes an idle prewarmed shell started with the same
+    // command line, directory and environment when there is one (its held-back output is
+    // delivered first), and keeps poolSize such shells starting in the background.
+    // poolSize 0 spawns directly.
+    __declspec(dllexport) int task_container_acquire(const char* commandLine, const char* working_dir,
+        const wchar_t* environment, int cols, int rows, int poolSize);
+    // Close all idle prewarmed shells (in the background), and those still starting as
+    // soon as they are up.
+    __declspec(dllexport) void task_container_pool_clear();
+    __declspec(dllexport) int task_container_pid(int containerId);
+    // A duplicate of the container's job handle, owned by the caller
+    // (close it with terminate_job or CloseHandle). 0 if unknown.
+    __declspec(dllexport) intptr_t task_container_job(int containerId);
+    __declspec(dllexport) bool task_container_write(int containerId, const uint8_t* data, int length);
+    __declspec(dllexport) bool task_container_resize(int containerId, int cols, int rows);
+    // Parse the container's output into a native screen (vt_screen.h) on the reactor
+    // thread, starting with everything it printed so far. Pipe output is fed with line
+    // feeds as new lines. Resets the screen's output byte count.
+    __declspec(dllexport) bool task_container_attach_screen(int containerId, int screenId);
+    // Terminate the job, close the pseudo console and release the container. Output
+    // not read yet is dropped. Posts the exit event if the root process had not exited yet.
+    __declspec(dllexport) void task_container_close(int containerId);
+    // The same on a worker thread: returns at once, and the exit event (if still due)
+    // follows once the container is released. Closing waits for the process to die
+    // and for its output to drain, so this is the one to call from the UI thread.
+    __declspec(dllexport) void task_container_close_async(int containerId);
+    __declspec(dllexport) void task_container_free_output(uint8_t* data);
+}
+
+#endif // TASK_CONTAINER_H
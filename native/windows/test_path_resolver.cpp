@@ -0,0 +1,119 @@
+// test_path_resolver.cpp
+// Tests marcha_native.dll's cached PATH/PATHEXT executable resolution against a
+// temporary directory put first on PATH
+// Compile: cl /EHsc test_path_resolver.cpp /link kernel32.lib
+// Usage:   test_path_resolver.exe [path\to\marcha_native.dll]
+
+#include <windows.h>
+#include <stdio.h>
+#include <string>
+
+typedef int (*ResolveExecutableFn)(const char* name, char* buffer, int maxLength);
+typedef int (*IsExecutableAvailableFn)(const char* name);
+typedef void (*InvalidateExecutableCacheFn)();
+
+static ResolveExecutableFn g_resolve;
+static IsExecutableAvailableFn g_available;
+static InvalidateExecutableCacheFn g_invalidate;
+
+static std::string Resolve(const std::string& name) {
+    char buffer[MAX_PATH * 2];
+    int length = g_resolve(name.c_str(), buffer, sizeof(buffer));
+    return length > 0 ? std::string(buffer, length) : std::string();
+}
+
+static bool Expect(const char* name, const std::string& query, const std::string& expected) {
+    std::string actual = Resolve(query);
+    bool ok = _stricmp(actual.c_str(), expected.c_str()) == 0;
+    printf("[%s] %s: \"%s\" -> \"%s\"", ok ? "PASS" : "FAIL", name, query.c_str(), actual.c_str());
+    if (!ok) {
+        printf(" (expected \"%s\")", expected.c_str());
+    }
+    printf("\n");
+    return ok;
+}
+
+// The resolver notices directory changes through a watcher thread, so give it a moment
+static bool ExpectEventually(const char* name, const std::string& query, const std::string& expected) {
+    for (int i = 0; i < 30 && _stricmp(Resolve(query).c_str(), expected.c_str()) != 0; i++) {
+        Sleep(100);
+    }
+    return Expect(name, query, expected);
+}
+
+static void Touch(const std::string& path) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    CloseHandle(file);
+}
+
+int main(int argc, char* argv[]) {
+    const char* dllPath = argc > 1 ? argv[1] : "marcha_native.dll";
+    HMODULE dll = LoadLibraryA(dllPath);
+    if (!dll) {
+        printf("[FAIL] Could not load %s: error %lu\n", dllPath, GetLastError());
+        return 1;
+    }
+    g_resolve = (ResolveExecutableFn)GetProcAddress(dll, "resolve_executable");
+    g_available = (IsExecutableAvailableFn)GetProcAddress(dll, "is_executable_available");
+    g_invalidate = (InvalidateExecutableCacheFn)GetProcAddress(dll, "invalidate_executable_cache");
+    if (!g_resolve || !g_available || !g_invalidate) {
+        printf("[FAIL] Missing path resolver exports\n");
+        return 1;
+    }
+
+    char tempDir[MAX_PATH];
+    GetTempPathA(MAX_PATH, tempDir);
+    std::string dir = std::string(tempDir) + "marcha_path_test_" + std::to_string(GetCurrentProcessId());
+    CreateDirectoryA(dir.c_str(), NULL);
+    Touch(dir + "\\marcha_tool.exe");
+    Touch(dir + "\\marcha_pick.exe");
+    Touch(dir + "\\marcha_pick.com");
+    Touch(dir + "\\marcha_script.cmd");
+
+    char oldPath[32767];
+    DWORD oldLength = GetEnvironmentVariableA("PATH", oldPath, sizeof(oldPath));
+    SetEnvironmentVariableA("PATH", (dir + ";" + std::string(oldPath, oldLength)).c_str());
+
+    char systemDir[MAX_PATH];
+    GetSystemDirectoryA(systemDir, MAX_PATH);
+
+    bool allPassed = true;
+    allPassed &= Expect("system directory", "cmd", std::string(systemDir) + "\\cmd.exe");
+    allPassed &= Expect("PATH directory", "marcha_tool", dir + "\\marcha_tool.exe");
+    allPassed &= Expect("PATHEXT order (.COM before .EXE)", "marcha_pick", dir + "\\marcha_pick.com");
+    allPassed &= Expect("script through PATHEXT", "marcha_script", dir + "\\marcha_script.cmd");
+    allPassed &= Expect("explicit extension", "marcha_tool.exe", dir + "\\marcha_tool.exe");
+    allPassed &= Expect("explicit path", dir + "\\marcha_tool", dir + "\\marcha_tool.exe");
+    allPassed &= Expect("quoted path", "\"" + dir + "\\marcha_tool.exe\"", dir + "\\marcha_tool.exe");
+    allPassed &= Expect("not found", "marcha_missing_tool", "");
+
+    bool available = g_available("marcha_tool") == 1 && g_available("marcha_missing_tool") == 0;
+    printf("[%s] is_executable_available\n", available ? "PASS" : "FAIL");
+    allPassed &= available;
+
+    char small[8];
+    bool tooSmall = g_resolve("marcha_tool", small, sizeof(small)) == 0;
+    printf("[%s] buffer too small returns 0\n", tooSmall ? "PASS" : "FAIL");
+    allPassed &= tooSmall;
+
+    // A cached miss must not outlive the file appearing, nor a hit its removal
+    allPassed &= Expect("before the file exists", "marcha_late", "");
+    Touch(dir + "\\marcha_late.exe");
+    allPassed &= ExpectEventually("file added to a PATH directory", "marcha_late", dir + "\\marcha_late.exe");
+    DeleteFileA((dir + "\\marcha_late.exe").c_str());
+    allPassed &= ExpectEventually("file removed from a PATH directory", "marcha_late", "");
+
+    // A changed PATH is picked up without invalidation
+    SetEnvironmentVariableA("PATH", std::string(oldPath, oldLength).c_str());
+    allPassed &= Expect("PATH changed", "marcha_tool", "");
+    g_invalidate();
+
+    DeleteFileA((dir + "\\marcha_tool.exe").c_str());
+    DeleteFileA((dir + "\\marcha_pick.exe").c_str());
+    DeleteFileA((dir + "\\marcha_pick.com").c_str());
+    DeleteFileA((dir + "\\marcha_script.cmd").c_str());
+    RemoveDirectoryA(dir.c_str());
+
+    printf("\n%s\n", allPassed ? "ALL PASSED" : "SOME TESTS FAILED");
+    return allPassed ? 0 : 1;
+}
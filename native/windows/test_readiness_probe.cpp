@@ -0,0 +1,161 @@
+// test_readiness_probe.cpp
+// Tests marcha_native.dll's readiness probes against loopback listeners, including
+// "localhost" with a server bound to only one of 127.0.0.1 and ::1
+// Compile: cl /EHsc test_readiness_probe.cpp /link ws2_32.lib kernel32.lib
+// Usage:   test_readiness_probe.exe [path\to\marcha_native.dll]
+
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef void (*ProbeEventCallback)(int64_t probeId, int32_t kind, int32_t detail);
+typedef void (*ProbeSetCallbackFn)(ProbeEventCallback callback);
+typedef int64_t (*ProbeStartFn)(int32_t kind, const char* host, int32_t port, const char* path,
+    int32_t expectedStatus, int32_t intervalMs, int32_t timeoutMs, int32_t successThreshold,
+    int32_t failureThreshold);
+typedef void (*ProbeStopFn)(int64_t probeId);
+
+static const int32_t kKindTcp = 0;
+static const int32_t kKindHttp = 1;
+static const int32_t kEventReady = 0;
+
+static ProbeStartFn g_start;
+static ProbeStopFn g_stop;
+static volatile LONG64 g_readyProbe = 0;
+
+static void OnProbeEvent(int64_t probeId, int32_t kind, int32_t) {
+    if (kind == kEventReady) {
+        InterlockedExchange64(&g_readyProbe, probeId);
+    }
+}
+
+// A listener on the loopback address of one family; port receives the bound port
+static SOCKET Listen(int family, int* port) {
+    SOCKET s = socket(family, SOCK_STREAM, IPPROTO_TCP);
+    if (s == INVALID_SOCKET) {
+        return INVALID_SOCKET;
+    }
+    sockaddr_storage address = {};
+    int length;
+    if (family == AF_INET6) {
+        auto v6 = reinterpret_cast<sockaddr_in6*>(&address);
+        v6->sin6_family = AF_INET6;
+        v6->sin6_addr = in6addr_loopback;
+        length = sizeof(sockaddr_in6);
+    } else {
+        auto v4 = reinterpret_cast<sockaddr_in*>(&address);
+        v4->sin_family = AF_INET;
+        v4->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        length = sizeof(sockaddr_in);
+    }
+    if (bind(s, reinterpret_cast<sockaddr*>(&address), length) == SOCKET_ERROR ||
+            getsockname(s, reinterpret_cast<sockaddr*>(&address), &length) == SOCKET_ERROR ||
+            listen(s, 8) == SOCKET_ERROR) {
+        closesocket(s);
+        return INVALID_SOCKET;
+    }
+    *port = ntohs(family == AF_INET6
+        ? reinterpret_cast<sockaddr_in6*>(&address)->sin6_port
+        : reinterpret_cast<sockaddr_in*>(&address)->sin_port);
+    return s;
+}
+
+// Answer every HTTP connection to the listener with 200 until it is closed
+static DWORD WINAPI ServeHttp(LPVOID parameter) {
+    SOCKET listener = (SOCKET)parameter;
+    for (;;) {
+        SOCKET client = accept(listener, NULL, NULL);
+        if (client == INVALID_SOCKET) {
+            return 0;
+        }
+        char buffer[1024];
+        recv(client, buffer, sizeof(buffer), 0);
+        const char* answer = "HTTP/1.1 200 OK\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        send(client, answer, (int)strlen(answer), 0);
+        closesocket(client);
+    }
+}
+
+// Whether the probe reports ready within waitMs
+static bool WaitReady(int64_t probeId, DWORD waitMs) {
+    ULONGLONG deadline = GetTickCount64() + waitMs;
+    while (GetTickCount64() < deadline) {
+        if (InterlockedCompareExchange64(&g_readyProbe, 0, 0) == probeId) {
+            return true;
+        }
+        Sleep(20);
+    }
+    return false;
+}
+
+// Probe host:port with the default 1 s timeout and expect ready (or not) within 5 s
+static bool Expect(const char* name, int32_t kind, const char* host, int port, bool ready) {
+    InterlockedExchange64(&g_readyProbe, 0);
+    int64_t probeId = g_start(kind, host, port, "/", 0, 250, 1000, 1, 3);
+    if (probeId == 0) {
+        printf("[FAIL] %s: probe_start failed\n", name);
+        return false;
+    }
+    bool actual = WaitReady(probeId, 5000);
+    g_stop(probeId);
+    bool ok = actual == ready;
+    printf("[%s] %s: %s\n", ok ? "PASS" : "FAIL", name, actual ? "ready" : "not ready");
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    const char* dllPath = argc > 1 ? argv[1] : "marcha_native.dll";
+    HMODULE dll = LoadLibraryA(dllPath);
+    if (!dll) {
+        printf("[FAIL] Could not load %s: error %lu\n", dllPath, GetLastError());
+        return 1;
+    }
+    auto setCallback = (ProbeSetCallbackFn)GetProcAddress(dll, "probe_set_callback");
+    g_start = (ProbeStartFn)GetProcAddress(dll, "probe_start");
+    g_stop = (ProbeStopFn)GetProcAddress(dll, "probe_stop");
+    if (!setCallback || !g_start || !g_stop) {
+        printf("[FAIL] Missing probe exports\n");
+        return 1;
+    }
+    setCallback(OnProbeEvent);
+
+    WSADATA data;
+    WSAStartup(MAKEWORD(2, 2), &data);
+
+    bool allPassed = true;
+
+    int port4 = 0;
+    SOCKET listener4 = Listen(AF_INET, &port4);
+    if (listener4 == INVALID_SOCKET) {
+        printf("[FAIL] Could not listen on 127.0.0.1\n");
+        return 1;
+    }
+    allPassed &= Expect("localhost, listener on 127.0.0.1 only", kKindTcp, "localhost", port4, true);
+    allPassed &= Expect("127.0.0.1 literal", kKindTcp, "127.0.0.1", port4, true);
+
+    int port6 = 0;
+    SOCKET listener6 = Listen(AF_INET6, &port6);
+    if (listener6 == INVALID_SOCKET) {
+        printf("[SKIP] IPv6 loopback is not available\n");
+    } else {
+        // The IPv4 connect to this port is refused, which takes longer than the timeout
+        allPassed &= Expect("localhost, listener on ::1 only", kKindTcp, "localhost", port6, true);
+        allPassed &= Expect("NULL host, listener on ::1 only", kKindTcp, NULL, port6, true);
+        allPassed &= Expect("::1 literal", kKindTcp, "::1", port6, true);
+        HANDLE server = CreateThread(NULL, 0, ServeHttp, (LPVOID)listener6, 0, NULL);
+        allPassed &= Expect("HTTP on localhost, listener on ::1 only", kKindHttp, "localhost", port6, true);
+        closesocket(listener6);
+        WaitForSingleObject(server, 5000);
+        CloseHandle(server);
+        allPassed &= Expect("localhost, listener closed", kKindTcp, "localhost", port6, false);
+    }
+    closesocket(listener4);
+
+    setCallback(NULL);
+    WSACleanup();
+    printf("\n%s\n", allPassed ? "ALL PASSED" : "SOME TESTS FAILED");
+    return allPassed ? 0 : 1;
+}
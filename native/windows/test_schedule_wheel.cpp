@@ -0,0 +1,163 @@
+// test_schedule_wheel.cpp
+// Tests marcha_native.dll's cron parsing and next-fire computation, including the
+// local-time DST transitions of this machine's time zone
+// Compile: cl /EHsc test_schedule_wheel.cpp /link kernel32.lib
+// Usage:   test_schedule_wheel.exe [path\to\marcha_native.dll]
+
+#include <windows.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+typedef int64_t (*ScheduleCronNextFn)(const char* expression, int64_t after, bool utc);
+
+static ScheduleCronNextFn g_cronNext;
+
+static bool Expect(const char* expression, int64_t after, int64_t expected) {
+    int64_t next = g_cronNext(expression, after, true);
+    bool ok = next == expected;
+    printf("[%s] \"%s\" after %lld: %lld", ok ? "PASS" : "FAIL", expression, (long long)after, (long long)next);
+    if (!ok) {
+        printf(" (expected %lld)", (long long)expected);
+    }
+    printf("\n");
+    return ok;
+}
+
+static bool LocalTime(int64_t time, tm* value) {
+    __time64_t t = time;
+    return _localtime64_s(value, &t) == 0;
+}
+
+static const char* Describe(int64_t time) {
+    static char text[64];
+    tm value;
+    if (!LocalTime(time, &value)) {
+        return "?";
+    }
+    strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &value);
+    text[sizeof(text) - 1] = '\0';
+    snprintf(text + strlen(text), sizeof(text) - strlen(text), value.tm_isdst > 0 ? " DST" : "");
+    return text;
+}
+
+// First instant in the next year where DST turns on (toDst) or off, 0 if none
+static int64_t FindTransition(int64_t from, bool toDst) {
+    tm value;
+    if (!LocalTime(from, &value)) {
+        return 0;
+    }
+    int previous = value.tm_isdst > 0;
+    for (int64_t time = from + 3600; time < from + 366LL * 86400; time += 3600) {
+        if (!LocalTime(time, &value)) {
+            return 0;
+        }
+        int current = value.tm_isdst > 0;
+        if (current != previous && current == (toDst ? 1 : 0)) {
+            // Narrow the hour down to the minute
+            int64_t low = time - 3600;
+            while (time - low > 60) {
+                int64_t middle = low + (time - low) / 120 * 60;
+                LocalTime(middle, &value);
+                if ((value.tm_isdst > 0) == toDst) {
+                    time = middle;
+                } else {
+                    low = middle;
+                }
+            }
+            return time;
+        }
+        previous = current;
+    }
+    return 0;
+}
+
+// Every search from around the transition must find a later fire, on a matching minute
+static bool CheckAcross(const char* name, const char* expression, int minuteStep, int64_t transition) {
+    bool ok = true;
+    for (int64_t after = transition - 3 * 3600; after <= transition + 3 * 3600 && ok; after += 5 * 60) {
+        int64_t next = g_cronNext(expression, after, false);
+        tm value;
+        if (next <= after || !LocalTime(next, &value) || value.tm_min % minuteStep != 0 ||
+                next - after > 2 * 3600) {
+            printf("[FAIL] %s: \"%s\" after %s", name, expression, Describe(after));
+            printf(" gave %s (%lld)\n", next != 0 ? Describe(next) : "nothing", (long long)next);
+            ok = false;
+        }
+    }
+    if (ok) {
+        printf("[PASS] %s: \"%s\" around %s\n", name, expression, Describe(transition));
+    }
+    return ok;
+}
+
+// A daily fire in the hour the transition repeats or skips still comes within two days
+static bool CheckDaily(const char* name, int64_t transition, int hourOffset) {
+    tm value;
+    LocalTime(transition, &value);
+    char expression[32];
+    snprintf(expression, sizeof(expression), "30 %d * * *", (value.tm_hour + hourOffset + 24) % 24);
+    int64_t after = transition - 2 * 3600;
+    bool ok = true;
+    for (int i = 0; i < 3 && ok; i++) {
+        int64_t next = g_cronNext(expression, after, false);
+        ok = next > after && next - after <= 49 * 3600;
+        printf("[%s] %s: \"%s\" after %s", ok ? "PASS" : "FAIL", name, expression, Describe(after));
+        printf(" -> %s\n", next != 0 ? Describe(next) : "nothing");
+        after = next;
+    }
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    const char* dllPath = argc > 1 ? argv[1] : "marcha_native.dll";
+    HMODULE dll = LoadLibraryA(dllPath);
+    if (!dll) {
+        printf("[FAIL] Could not load %s: error %lu\n", dllPath, GetLastError());
+        return 1;
+    }
+    g_cronNext = (ScheduleCronNextFn)GetProcAddress(dll, "schedule_cron_next");
+    if (!g_cronNext) {
+        printf("[FAIL] Missing schedule_cron_next export\n");
+        return 1;
+    }
+
+    bool allPassed = true;
+
+    // UTC: 1767225600 is Thursday 2026-01-01 00:00
+    allPassed &= Expect("*/15 * * * *", 1767226050, 1767226500);    // 00:07:30 -> 00:15
+    allPassed &= Expect("0 0 * * 0", 1767225600, 1767484800);       // Sunday 01-04
+    allPassed &= Expect("0 0 * * 7", 1767225600, 1767484800);       // 7 is Sunday too
+    allPassed &= Expect("0 12 1 * 1", 1767268800, 1767614400);      // Day or weekday: Monday 01-05
+    allPassed &= Expect("0 0 29 2 *", 1767225600, 1835395200);      // Next leap day, 2028
+    allPassed &= Expect("59 23 31 * *", 1769904000, 1775001540);    // Skips February
+    allPassed &= Expect("@hourly", 1767226050, 1767229200);
+    allPassed &= Expect("@yearly", 1798761599, 1798761600);         // Over the year boundary
+    allPassed &= Expect("0 0 * * *", 1798761600, 1798848000);       // Strictly after
+
+    // Invalid expressions
+    allPassed &= Expect("61 * * * *", 1767225600, 0);
+    allPassed &= Expect("* * *", 1767225600, 0);
+    allPassed &= Expect("* * * * * *", 1767225600, 0);
+    allPassed &= Expect("*/0 * * * *", 1767225600, 0);
+    allPassed &= Expect("5-1 * * * *", 1767225600, 0);
+    allPassed &= Expect("0 0 31 2 *", 1767225600, 0);               // Never matches
+
+    // Local time across this zone's DST transitions
+    int64_t now = (int64_t)time(NULL);
+    int64_t fallBack = FindTransition(now, false);
+    int64_t springForward = FindTransition(now, true);
+    if (fallBack == 0 || springForward == 0) {
+        printf("[SKIP] DST transitions: this time zone has none\n");
+    } else {
+        allPassed &= CheckAcross("fall back", "*/20 * * * *", 20, fallBack);
+        allPassed &= CheckAcross("fall back", "*/7 * * * *", 7, fallBack);
+        allPassed &= CheckDaily("fall back", fallBack, 0);        // The repeated hour
+        allPassed &= CheckAcross("spring forward", "*/20 * * * *", 20, springForward);
+        allPassed &= CheckDaily("spring forward", springForward, -1); // The skipped hour
+    }
+
+    printf("\n%s\n", allPassed ? "ALL PASSED" : "SOME TESTS FAILED");
+    return allPassed ? 0 : 1;
+}
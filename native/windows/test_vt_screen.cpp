@@ -0,0 +1,264 @@
+// test_vt_screen.cpp
+// Tests marcha_native.dll's VT screen: SGR (':' sub-parameters too), scroll regions,
+// the alternate screen, UTF-8 split across writes, character widths, scrollback and
+// the screen-state sync
+// Compile: cl /EHsc test_vt_screen.cpp /link kernel32.lib
+// Usage:   test_vt_screen.exe [path\to\marcha_native.dll]
+
+#include <windows.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+
+struct VtFrame {
+    int64_t frame;
+    int32_t cols;
+    int32_t rows;
+    int32_t full;
+    int32_t rowsSent;
+};
+
+typedef int (*VtScreenCreateFn)(int cols, int rows, int maxLines);
+typedef void (*VtScreenFreeFn)(int screenId);
+typedef void (*VtScreenWriteFn)(int screenId, const uint8_t* data, int length);
+typedef uint8_t* (*VtScreenSnapshotFn)(int screenId, int maxLines, int32_t* length, int64_t* outputBytes);
+typedef uint8_t* (*VtScreenSyncFn)(int screenId, int64_t since, VtFrame* frame, int32_t* length);
+typedef void (*FreeOutputFn)(uint8_t* data);
+
+static VtScreenCreateFn g_create;
+static VtScreenFreeFn g_free;
+static VtScreenWriteFn g_write;
+static VtScreenSnapshotFn g_snapshot;
+static VtScreenSyncFn g_sync;
+static FreeOutputFn g_freeOutput;
+
+static void Write(int id, const char* text) {
+    g_write(id, reinterpret_cast<const uint8_t*>(text), (int)strlen(text));
+}
+
+static std::string Snapshot(int id, int maxLines) {
+    int32_t length = 0;
+    uint8_t* data = g_snapshot(id, maxLines, &length, nullptr);
+    if (data == nullptr) {
+        return std::string();
+    }
+    std::string text(reinterpret_cast<char*>(data), length);
+    g_freeOutput(data);
+    return text;
+}
+
+static std::string Sync(int id, int64_t since, VtFrame* frame) {
+    int32_t length = 0;
+    uint8_t* data = g_sync(id, since, frame, &length);
+    if (data == nullptr) {
+        return std::string();
+    }
+    std::string text(reinterpret_cast<char*>(data), length);
+    g_freeOutput(data);
+    return text;
+}
+
+// Escape sequences made readable for failure output
+static std::string Visible(const std::string& text) {
+    std::string out;
+    for (unsigned char c : text) {
+        if (c == 0x1b) {
+            out += "\\e";
+        } else if (c == '\r') {
+            out += "\\r";
+        } else if (c == '\n') {
+            out += "\\n";
+        } else {
+            out += (char)c;
+        }
+    }
+    return out;
+}
+
+static bool Check(const char* name, bool ok, const std::string& actual) {
+    printf("[%s] %s%s%s\n", ok ? "PASS" : "FAIL", name, ok ? "" : ": ", ok ? "" : Visible(actual).c_str());
+    return ok;
+}
+
+static bool Expect(const char* name, const std::string& actual, const std::string& expected) {
+    bool ok = actual == expected;
+    if (!ok) {
+        printf("       expected %s\n", Visible(expected).c_str());
+    }
+    return Check(name, ok, actual);
+}
+
+static bool Contains(const char* name, const std::string& actual, const std::string& part) {
+    bool ok = actual.find(part) != std::string::npos;
+    if (!ok) {
+        printf("       missing %s\n", Visible(part).c_str());
+    }
+    return Check(name, ok, actual);
+}
+
+static bool TestPlainText() {
+    int id = g_create(10, 3, 100);
+    Write(id, "hello");
+    bool ok = Expect("plain text and cursor", Snapshot(id, 100), "hello\r\n\r\n\x1b[1;6H\x1b[0m");
+    g_free(id);
+    return ok;
+}
+
+static bool TestSgr() {
+    int id = g_create(20, 2, 100);
+    Write(id, "a\x1b[1;31mb\x1b[0mc\x1b[38;5;208;48;5;17md\x1b[4;7me\x1b[m");
+    std::string text = Snapshot(id, 100);
+    bool ok = Contains("SGR bold + red", text, "a\x1b[0;1;38;5;1mb");
+    ok &= Contains("SGR reset", text, "\x1b[0mc");
+    ok &= Contains("SGR 256 colours", text, "\x1b[0;38;5;208;48;5;17md");
+    ok &= Contains("SGR underline + inverse keeps colours", text, "\x1b[0;4;7;38;5;208;48;5;17me");
+    g_free(id);
+    return ok;
+}
+
+static bool TestSgrSubParameters() {
+    int id = g_create(20, 2, 100);
+    // ':' separates sub-parameters: an empty colour space id, then r:g:b
+    Write(id, "\x1b[38:2::255:0:0mr\x1b[4:3mu\x1b[4:0;48:5:17mb\x1b[38:2:0:0:255md\x1b[m");
+    std::string text = Snapshot(id, 100);
+    bool ok = Contains("SGR 38:2::r:g:b", text, "\x1b[0;38;5;196mr");
+    ok &= Contains("SGR 4:3 is an underline style, not italic", text, "\x1b[0;4;38;5;196mu");
+    ok &= Contains("SGR 4:0 then 48:5:n", text, "\x1b[0;38;5;196;48;5;17mb");
+    ok &= Contains("SGR 38:2:r:g:b without colour space", text, "\x1b[0;38;5;21;48;5;17md");
+    g_free(id);
+    return ok;
+}
+
+static bool TestScrollRegion() {
+    int id = g_create(10, 4, 100);
+    // A line feed at the bottom of rows 2-3 scrolls only those rows, and nothing
+    // reaches the scrollback
+    Write(id, "1\r\n2\r\n3\r\n4\x1b[2;3r\x1b[3;1H\n");
+    bool ok = Expect("scroll region", Snapshot(id, 100), "1\r\n3\r\n\r\n4\x1b[2;3r\x1b[3;1H\x1b[0m");
+    // Reverse index at the top of the region scrolls it down
+    Write(id, "\x1b[2;1H\x1bMx");
+    ok &= Expect("reverse index in region", Snapshot(id, 100), "1\r\nx\r\n3\r\n4\x1b[2;3r\x1b[2;2H\x1b[0m");
+    g_free(id);
+    return ok;
+}
+
+static bool TestAlternateScreen() {
+    int id = g_create(10, 2, 100);
+    Write(id, "main\x1b[?1049h\x1b[Halt");
+    std::string text = Snapshot(id, 100);
+    bool ok = Expect("alternate screen", text, "main\r\n\x1b[0m\x1b[?1049h\x1b[1;1Halt\x1b[2;1H\x1b[1;4H\x1b[0m");
+    Write(id, "\x1b[?1049l");
+    ok &= Expect("back to the primary screen", Snapshot(id, 100), "main\r\n\x1b[1;5H\x1b[0m");
+    g_free(id);
+    return ok;
+}
+
+static bool TestSplitUtf8() {
+    int id = g_create(10, 1, 100);
+    // Euro sign cut after two bytes, then a four-byte emoji fed one byte per write
+    Write(id, "\xE2\x82");
+    Write(id, "\xAC");
+    const char* emoji = "\xF0\x9F\x98\x80";
+    for (int i = 0; i < 4; i++) {
+        g_write(id, reinterpret_cast<const uint8_t*>(emoji + i), 1);
+    }
+    bool ok = Expect("UTF-8 split across writes", Snapshot(id, 100), "\xE2\x82\xAC\xF0\x9F\x98\x80\x1b[1;4H\x1b[0m");
+    // A lead byte cut short by another one is a replacement character
+    Write(id, "\r\xE2\x82\xE2\x82\xAC");
+    ok &= Expect("truncated UTF-8", Snapshot(id, 100), "\xEF\xBF\xBD\xE2\x82\xAC\x1b[1;3H\x1b[0m");
+    g_free(id);
+    return ok;
+}
+
+static bool TestWideAndCombining() {
+    int id = g_create(6, 3, 100);
+    // U+4E2D takes two cells; the cursor lands after both
+    Write(id, "\xE4\xB8\xAD" "a");
+    bool ok = Expect("wide character", Snapshot(id, 100), "\xE4\xB8\xAD" "a\r\n\r\n\x1b[1;4H\x1b[0m");
+    // One that would start in the last column wraps first
+    Write(id, "\r\nabcde\xE4\xB8\xAD");
+    ok &= Expect("wide character wraps", Snapshot(id, 100),
+        "\xE4\xB8\xAD" "a\r\nabcde\r\n\xE4\xB8\xAD\x1b[3;3H\x1b[0m");
+    // Combining acute accents join the cell before, wide or not
+    Write(id, "\x1b[2J\x1b[He\xCC\x81x\xE4\xB8\xAD\xCC\x81y");
+    ok &= Expect("combining marks", Snapshot(id, 100),
+        "e\xCC\x81x\xE4\xB8\xAD\xCC\x81y\r\n\r\n\x1b[1;6H\x1b[0m");
+    // Writing over the right half of a wide character blanks the left half
+    Write(id, "\x1b[1;4Hb");
+    ok &= Expect("overwritten wide character", Snapshot(id, 100),
+        "e\xCC\x81x by\r\n\r\n\x1b[1;5H\x1b[0m");
+    g_free(id);
+    return ok;
+}
+
+static bool TestScrollback() {
+    int id = g_create(10, 2, 100);
+    Write(id, "a\r\nb\r\nc\r\nd");
+    bool ok = Expect("scrollback", Snapshot(id, 100), "a\r\nb\r\nc\r\nd\x1b[2;2H\x1b[0m");
+    ok &= Expect("scrollback limited", Snapshot(id, 1), "b\r\nc\r\nd\x1b[2;2H\x1b[0m");
+    g_free(id);
+    return ok;
+}
+
+static bool TestSync() {
+    int id = g_create(10, 3, 100);
+    Write(id, "one\r\ntwo");
+    VtFrame frame = {};
+    std::string patch = Sync(id, 0, &frame);
+    bool ok = Check("sync from nothing is full", frame.full == 1 && frame.rowsSent == 3, patch);
+
+    int64_t since = frame.frame;
+    patch = Sync(id, since, &frame);
+    ok &= Check("idle sync sends no rows", frame.full == 0 && frame.rowsSent == 0 && frame.frame == since, patch);
+
+    Write(id, "\r\x1b[Ktoo");
+    patch = Sync(id, since, &frame);
+    ok &= Check("sync sends the changed row", frame.full == 0 && frame.rowsSent == 1 &&
+        patch.find("\x1b[2;1Htoo\x1b[K") != std::string::npos, patch);
+
+    since = frame.frame;
+    Write(id, "\r\nthree\r\nfour");
+    patch = Sync(id, since, &frame);
+    ok &= Check("sync scrolls instead of redrawing", frame.full == 0 &&
+        patch.find("\x1b[r\x1b[1S") != std::string::npos, patch);
+
+    patch = Sync(id, 12345, &frame);
+    ok &= Check("unknown frame is full", frame.full == 1, patch);
+    g_free(id);
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    const char* dllPath = argc > 1 ? argv[1] : "marcha_native.dll";
+    HMODULE dll = LoadLibraryA(dllPath);
+    if (!dll) {
+        printf("[FAIL] Could not load %s: error %lu\n", dllPath, GetLastError());
+        return 1;
+    }
+
+    g_create = (VtScreenCreateFn)GetProcAddress(dll, "vt_screen_create");
+    g_free = (VtScreenFreeFn)GetProcAddress(dll, "vt_screen_free");
+    g_write = (VtScreenWriteFn)GetProcAddress(dll, "vt_screen_write");
+    g_snapshot = (VtScreenSnapshotFn)GetProcAddress(dll, "vt_screen_snapshot");
+    g_sync = (VtScreenSyncFn)GetProcAddress(dll, "vt_screen_sync");
+    g_freeOutput = (FreeOutputFn)GetProcAddress(dll, "task_container_free_output");
+    if (!g_create || !g_free || !g_write || !g_snapshot || !g_sync || !g_freeOutput) {
+        printf("[FAIL] Missing vt_screen exports\n");
+        return 1;
+    }
+
+    bool allPassed = true;
+    allPassed &= TestPlainText();
+    allPassed &= TestSgr();
+    allPassed &= TestSgrSubParameters();
+    allPassed &= TestScrollRegion();
+    allPassed &= TestAlternateScreen();
+    allPassed &= TestSplitUtf8();
+    allPassed &= TestWideAndCombining();
+    allPassed &= TestScrollback();
+    allPassed &= TestSync();
+
+    printf("\n%s\n", allPassed ? "ALL PASSED" : "SOME TESTS FAILED");
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,1396 @@
+#include "vt_screen.h"
+#include "scrollback_store.h"
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+// One character cell: 8 bytes
+enum VtFlags : uint8_t {
+    VT_BOLD = 1,
+    VT_DIM = 2,
+    VT_ITALIC = 4,
+    VT_UNDERLINE = 8,
+    VT_INVERSE = 16,
+    VT_DEFAULT_FG = 32, // fg is ignored
+    VT_DEFAULT_BG = 64, // bg is ignored
+};
+
+// A cell's ch is a code point, kWideTail or a cluster id (kCluster)
+struct VtCell {
+    uint32_t ch;
+    uint8_t fg; // 256-colour palette index
+    uint8_t bg;
+    uint8_t flags;
+    uint8_t reserved;
+
+    bool SameStyle(const VtCell& other) const {
+        return fg == other.fg && bg == other.bg && flags == other.flags;
+    }
+};
+
+typedef std::vector<VtCell> Row;
+
+const VtCell kBlank = { ' ', 0, 0, VT_DEFAULT_FG | VT_DEFAULT_BG, 0 };
+
+// The right half of a wide character: the cell after it
+const uint32_t kWideTail = 0;
+
+// A character with combining marks is kept once, in a table shared by all screens
+// (frozen scrollback refers to it too), and its cells hold kCluster | index
+const uint32_t kCluster = 0x80000000;
+const uint32_t kClusterWide = 0x40000000; // The base character is wide
+const uint32_t kClusterIndex = 0x3FFFFFFF;
+const size_t kMaxClusters = 65536;     // Past this, further marks are dropped
+const size_t kMaxClusterLength = 16;   // Code points per cell, base included
+const size_t kMaxParams = 16;
+
+// Scrollback beyond the newest kHotLines rows is frozen kBlockLines at a time
+// into compressed blocks (scrollback_store.h)
+const size_t kHotLines = 1024;
+const size_t kBlockLines = 256;
+
+struct ColdBlock {
+    uint64_t id;
+    size_t lines;
+};
+
+// Frames a viewer may acknowledge and still get a diff (vt_screen_sync)
+const size_t kSyncFrames = 64;
+
+struct SyncFrame {
+    uint64_t frame;
+    uint64_t scrollTotal;
+};
+
+// Character widths, after wcwidth: combining marks and other zero-width characters,
+// then East Asian wide and fullwidth characters and emoji (Unicode 15)
+struct CharRange {
+    uint32_t first;
+    uint32_t last;
+};
+
+const CharRange kZeroWidth[] = {
+    { 0x0300, 0x036F }, { 0x0483, 0x0489 }, { 0x0591, 0x05BD }, { 0x05BF, 0x05BF },
+    { 0x05C1, 0x05C2 }, { 0x05C4, 0x05C5 }, { 0x05C7, 0x05C7 }, { 0x0610, 0x061A },
+    { 0x064B, 0x065F }, { 0x0670, 0x0670 }, { 0x06D6, 0x06DC }, { 0x06DF, 0x06E4 },
+    { 0x06E7, 0x06E8 }, { 0x06EA, 0x06ED }, { 0x0711, 0x0711 }, { 0x0730, 0x074A },
+    { 0x07A6, 0x07B0 }, { 0x07EB, 0x07F3 }, { 0x0816, 0x0819 }, { 0x081B, 0x0823 },
+    { 0x0825, 0x0827 }, { 0x0829, 0x082D }, { 0x0859, 0x085B }, { 0x0898, 0x089F },
+    { 0x08CA, 0x08E1 }, { 0x08E3, 0x0902 }, { 0x093A, 0x093A }, { 0x093C, 0x093C },
+    { 0x0941, 0x0948 }, { 0x094D, 0x094D }, { 0x0951, 0x0957 }, { 0x0962, 0x0963 },
+    { 0x0981, 0x0981 }, { 0x09BC, 0x09BC }, { 0x09C1, 0x09C4 }, { 0x09CD, 0x09CD },
+    { 0x09E2, 0x09E3 }, { 0x0A01, 0x0A02 }, { 0x0A3C, 0x0A3C }, { 0x0A41, 0x0A51 },
+    { 0x0A70, 0x0A71 }, { 0x0A75, 0x0A75 }, { 0x0A81, 0x0A82 }, { 0x0ABC, 0x0ABC },
+    { 0x0AC1, 0x0AC8 }, { 0x0ACD, 0x0ACD }, { 0x0AE2, 0x0AE3 }, { 0x0B01, 0x0B01 },
+    { 0x0B3C, 0x0B3C }, { 0x0B3F, 0x0B3F }, { 0x0B41, 0x0B44 }, { 0x0B4D, 0x0B4D },
+    { 0x0B55, 0x0B56 }, { 0x0B62, 0x0B63 }, { 0x0B82, 0x0B82 }, { 0x0BC0, 0x0BC0 },
+    { 0x0BCD, 0x0BCD }, { 0x0C00, 0x0C00 }, { 0x0C04, 0x0C04 }, { 0x0C3C, 0x0C3C },
+    { 0x0C3E, 0x0C40 }, { 0x0C46, 0x0C56 }, { 0x0C62, 0x0C63 }, { 0x0CBC, 0x0CBC },
+    { 0x0CCC, 0x0CCD }, { 0x0CE2, 0x0CE3 }, { 0x0D00, 0x0D01 }, { 0x0D3B, 0x0D3C },
+    { 0x0D41, 0x0D44 }, { 0x0D4D, 0x0D4D }, { 0x0D62, 0x0D63 }, { 0x0DCA, 0x0DCA },
+    { 0x0DD2, 0x0DD6 }, { 0x0E31, 0x0E31 }, { 0x0E34, 0x0E3A }, { 0x0E47, 0x0E4E },
+    { 0x0EB1, 0x0EB1 }, { 0x0EB4, 0x0EBC }, { 0x0EC8, 0x0ECE }, { 0x0F18, 0x0F19 },
+    { 0x0F35, 0x0F35 }, { 0x0F37, 0x0F37 }, { 0x0F39, 0x0F39 }, { 0x0F71, 0x0F7E },
+    { 0x0F80, 0x0F84 }, { 0x0F86, 0x0F87 }, { 0x0F8D, 0x0FBC }, { 0x0FC6, 0x0FC6 },
+    { 0x102D, 0x1030 }, { 0x1032, 0x1037 }, { 0x1039, 0x103A }, { 0x103D, 0x103E },
+    { 0x1058, 0x1059 }, { 0x105E, 0x1060 }, { 0x1071, 0x1074 }, { 0x1082, 0x1082 },
+    { 0x1085, 0x1086 }, { 0x108D, 0x108D }, { 0x109D, 0x109D }, { 0x1160, 0x11FF },
+    { 0x135D, 0x135F }, { 0x1712, 0x1714 }, { 0x1732, 0x1733 }, { 0x1752, 0x1753 },
+    { 0x1772, 0x1773 }, { 0x17B4, 0x17B5 }, { 0x17B7, 0x17BD }, { 0x17C6, 0x17C6 },
+    { 0x17C9, 0x17D3 }, { 0x17DD, 0x17DD }, { 0x180B, 0x180F }, { 0x1885, 0x1886 },
+    { 0x18A9, 0x18A9 }, { 0x1920, 0x1922 }, { 0x1927, 0x1928 }, { 0x1932, 0x1932 },
+    { 0x1939, 0x193B }, { 0x1A17, 0x1A18 }, { 0x1A1B, 0x1A1B }, { 0x1A56, 0x1A56 },
+    { 0x1A58, 0x1A60 }, { 0x1A62, 0x1A62 }, { 0x1A65, 0x1A6C }, { 0x1A73, 0x1A7F },
+    { 0x1AB0, 0x1ACE }, { 0x1B00, 0x1B03 }, { 0x1B34, 0x1B34 }, { 0x1B36, 0x1B3A },
+    { 0x1B3C, 0x1B3C }, { 0x1B42, 0x1B42 }, { 0x1B6B, 0x1B73 }, { 0x1B80, 0x1B81 },
+    { 0x1BA2, 0x1BA5 }, { 0x1BA8, 0x1BA9 }, { 0x1BAB, 0x1BAD }, { 0x1BE6, 0x1BE6 },
+    { 0x1BE8, 0x1BE9 }, { 0x1BED, 0x1BED }, { 0x1BEF, 0x1BF1 }, { 0x1C2C, 0x1C33 },
+    { 0x1C36, 0x1C37 }, { 0x1CD0, 0x1CD2 }, { 0x1CD4, 0x1CE0 }, { 0x1CE2, 0x1CE8 },
+    { 0x1CED, 0x1CED }, { 0x1CF4, 0x1CF4 }, { 0x1CF8, 0x1CF9 }, { 0x1DC0, 0x1DFF },
+    { 0x200B, 0x200F }, { 0x202A, 0x202E }, { 0x2060, 0x2064 }, { 0x20D0, 0x20F0 },
+    { 0x2CEF, 0x2CF1 }, { 0x2D7F, 0x2D7F }, { 0x2DE0, 0x2DFF }, { 0x302A, 0x302D },
+    { 0x3099, 0x309A }, { 0xA66F, 0xA672 }, { 0xA674, 0xA67D }, { 0xA69E, 0xA69F },
+    { 0xA6F0, 0xA6F1 }, { 0xA802, 0xA802 }, { 0xA806, 0xA806 }, { 0xA80B, 0xA80B },
+    { 0xA825, 0xA826 }, { 0xA8C4, 0xA8C5 }, { 0xA8E0, 0xA8F1 }, { 0xA8FF, 0xA8FF },
+    { 0xA926, 0xA92D }, { 0xA947, 0xA951 }, { 0xA980, 0xA982 }, { 0xA9B3, 0xA9B3 },
+    { 0xA9B6, 0xA9B9 }, { 0xA9BC, 0xA9BD }, { 0xA9E5, 0xA9E5 }, { 0xAA29, 0xAA2E },
+    { 0xAA31, 0xAA32 }, { 0xAA35, 0xAA36 }, { 0xAA43, 0xAA43 }, { 0xAA4C, 0xAA4C },
+    { 0xAA7C, 0xAA7C }, { 0xAAB0, 0xAAB0 }, { 0xAAB2, 0xAAB4 }, { 0xAAB7, 0xAAB8 },
+    { 0xAABE, 0xAABF }, { 0xAAC1, 0xAAC1 }, { 0xAAEC, 0xAAED }, { 0xAAF6, 0xAAF6 },
+    { 0xABE5, 0xABE5 }, { 0xABE8, 0xABE8 }, { 0xABED, 0xABED }, { 0xD7B0, 0xD7FF },
+    { 0xFB1E, 0xFB1E }, { 0xFE00, 0xFE0F }, { 0xFE20, 0xFE2F }, { 0xFEFF, 0xFEFF },
+    { 0x101FD, 0x101FD }, { 0x10376, 0x1037A }, { 0x10A01, 0x10A0F }, { 0x10A38, 0x10A3F },
+    { 0x10AE5, 0x10AE6 }, { 0x10D24, 0x10D27 }, { 0x10EAB, 0x10EAC }, { 0x10F46, 0x10F50 },
+    { 0x11001, 0x11001 }, { 0x11038, 0x11046 }, { 0x1107F, 0x11081 }, { 0x110B3, 0x110B6 },
+    { 0x110B9, 0x110BA }, { 0x11100, 0x11102 }, { 0x11127, 0x1112B }, { 0x1112D, 0x11134 },
+    { 0x11173, 0x11173 }, { 0x11180, 0x11181 }, { 0x111B6, 0x111BE }, { 0x1D167, 0x1D169 },
+    { 0x1D17B, 0x1D182 }, { 0x1D185, 0x1D18B }, { 0x1D1AA, 0x1D1AD }, { 0x1D242, 0x1D244 },
+    { 0x1E000, 0x1E02A }, { 0x1E8D0, 0x1E8D6 }, { 0x1E944, 0x1E94A }, { 0x1F3FB, 0x1F3FF },
+    { 0xE0001, 0xE0001 }, { 0xE0020, 0xE007F }, { 0xE0100, 0xE01EF },
+};
+
+const CharRange kWide[] = {
+    { 0x1100, 0x115F }, { 0x231A, 0x231B }, { 0x2329, 0x232A }, { 0x23E9, 0x23EC },
+    { 0x23F0, 0x23F0 }, { 0x23F3, 0x23F3 }, { 0x25FD, 0x25FE }, { 0x2614, 0x2615 },
+    { 0x2648, 0x2653 }, { 0x267F, 0x267F }, { 0x2693, 0x2693 }, { 0x26A1, 0x26A1 },
+    { 0x26AA, 0x26AB }, { 0x26BD, 0x26BE }, { 0x26C4, 0x26C5 }, { 0x26CE, 0x26CE },
+    { 0x26D4, 0x26D4 }, { 0x26EA, 0x26EA }, { 0x26F2, 0x26F3 }, { 0x26F5, 0x26F5 },
+    { 0x26FA, 0x26FA }, { 0x26FD, 0x26FD }, { 0x2705, 0x2705 }, { 0x270A, 0x270B },
+    { 0x2728, 0x2728 }, { 0x274C, 0x274C }, { 0x274E, 0x274E }, { 0x2753, 0x2755 },
+    { 0x2757, 0x2757 }, { 0x2795, 0x2797 }, { 0x27B0, 0x27B0 }, { 0x27BF, 0x27BF },
+    { 0x2B1B, 0x2B1C }, { 0x2B50, 0x2B50 }, { 0x2B55, 0x2B55 }, { 0x2E80, 0x303E },
+    { 0x3041, 0x33FF }, { 0x3400, 0x4DBF }, { 0x4E00, 0x9FFF }, { 0xA000, 0xA4CF },
+    { 0xA960, 0xA97F }, { 0xAC00, 0xD7A3 }, { 0xF900, 0xFAFF }, { 0xFE10, 0xFE19 },
+    { 0xFE30, 0xFE6F }, { 0xFF00, 0xFF60 }, { 0xFFE0, 0xFFE6 }, { 0x16FE0, 0x16FE4 },
+    { 0x17000, 0x18CFF }, { 0x1B000, 0x1B2FF }, { 0x1F004, 0x1F004 }, { 0x1F0CF, 0x1F0CF },
+    { 0x1F18E, 0x1F18E }, { 0x1F191, 0x1F19A }, { 0x1F200, 0x1F202 }, { 0x1F210, 0x1F23B },
+    { 0x1F240, 0x1F248 }, { 0x1F250, 0x1F251 }, { 0x1F260, 0x1F265 }, { 0x1F300, 0x1F320 },
+    { 0x1F32D, 0x1F335 }, { 0x1F337, 0x1F37C }, { 0x1F37E, 0x1F393 }, { 0x1F3A0, 0x1F3CA },
+    { 0x1F3CF, 0x1F3D3 }, { 0x1F3E0, 0x1F3F0 }, { 0x1F3F4, 0x1F3F4 }, { 0x1F3F8, 0x1F43E },
+    { 0x1F440, 0x1F440 }, { 0x1F442, 0x1F4FC }, { 0x1F4FF, 0x1F53D }, { 0x1F54B, 0x1F54E },
+    { 0x1F550, 0x1F567 }, { 0x1F57A, 0x1F57A }, { 0x1F595, 0x1F596 }, { 0x1F5A4, 0x1F5A4 },
+    { 0x1F5FB, 0x1F64F }, { 0x1F680, 0x1F6C5 }, { 0x1F6CC, 0x1F6CC }, { 0x1F6D0, 0x1F6D2 },
+    { 0x1F6D5, 0x1F6D7 }, { 0x1F6DC, 0x1F6DF }, { 0x1F6EB, 0x1F6EC }, { 0x1F6F4, 0x1F6FC },
+    { 0x1F7E0, 0x1F7EB }, { 0x1F7F0, 0x1F7F0 }, { 0x1F90C, 0x1F93A }, { 0x1F93C, 0x1F945 },
+    { 0x1F947, 0x1F9FF }, { 0x1FA70, 0x1FAFF }, { 0x20000, 0x2FFFD }, { 0x30000, 0x3FFFD },
+};
+
+bool InTable(const CharRange* table, size_t count, uint32_t ch) {
+    if (ch < table[0].first || ch > table[count - 1].last) {
+        return false;
+    }
+    size_t low = 0;
+    size_t high = count;
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        if (ch > table[middle].last) {
+            low = middle + 1;
+        } else if (ch < table[middle].first) {
+            high = middle;
+        } else {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Columns a printable character takes: 0 (joins the one before), 1 or 2
+int CharWidth(uint32_t ch) {
+    if (ch < 0x300) {
+        return 1;
+    }
+    if (InTable(kZeroWidth, sizeof(kZeroWidth) / sizeof(kZeroWidth[0]), ch)) {
+        return 0;
+    }
+    return InTable(kWide, sizeof(kWide) / sizeof(kWide[0]), ch) ? 2 : 1;
+}
+
+enum ParserState {
+    STATE_GROUND,
+    STATE_ESCAPE,
+    STATE_CHARSET, // ESC ( and friends: one more byte
+    STATE_CSI,
+    STATE_STRING,  // OSC, DCS, APC, PM, SOS: skipped up to BEL or ST
+    STATE_STRING_ESCAPE,
+};
+
+} // namespace
+
+struct VtScreen {
+    std::mutex mutex;
+    int cols = 80;
+    int rows = 24;
+    int maxLines = 10000;
+    std::vector<Row> lines;    // The visible screen
+    std::vector<Row> altLines; // The other buffer (primary while alt is set)
+    bool alt = false;
+    std::deque<Row> hot;        // Newest scrollback rows, trailing blanks trimmed
+    std::deque<ColdBlock> cold; // Older scrollback, oldest first
+    size_t coldLines = 0;
+
+    int x = 0;
+    int y = 0;
+    bool wrapPending = false; // Last column written; the next character wraps
+    int top = 0;              // Scroll region
+    int bottom = 23;
+    VtCell pen = kBlank;
+    int savedX = 0;
+    int savedY = 0;
+    VtCell savedPen = kBlank;
+    bool autowrap = true;
+    bool lineFeedNewline = false; // LNM
+    bool cursorVisible = true;
+
+    int state = STATE_GROUND;
+    std::vector<int> params; // -1 = omitted
+    uint32_t subParams = 0;  // Bit i: params[i] followed a ':' (kMaxParams <= 32)
+    char prefix = 0;         // CSI private marker (?, >, <, =)
+    uint32_t codepoint = 0;
+    int utf8Remaining = 0;
+
+    int64_t outputBytes = 0;
+
+    // Screen-state sync: rows remember the frame they last changed in and move
+    // with whole-screen scrolls, which are counted
+    std::vector<uint64_t> versions;
+    uint64_t frame = 0;        // Last frame cut
+    bool changed = false;      // Since then
+    uint64_t scrollTotal = 0;
+    std::deque<SyncFrame> frames; // Recent frames, oldest first
+
+    ~VtScreen();
+};
+
+namespace {
+
+std::mutex g_mutex;
+std::map<int, std::shared_ptr<VtScreen>> g_screens;
+int g_nextScreenId = 1;
+
+std::mutex g_clusterMutex;
+std::vector<std::u32string> g_clusters;
+std::map<std::u32string, uint32_t> g_clusterIds;
+
+int Clamp(int value, int low, int high) {
+    return value < low ? low : value > high ? high : value;
+}
+
+// Rows first..last changed
+void Touch(VtScreen& s, int first, int last) {
+    s.changed = true;
+    for (int row = first; row <= last; row++) {
+        s.versions[row] = s.frame + 1;
+    }
+}
+
+// Erased cells take the current background
+VtCell Erased(const VtScreen& s) {
+    VtCell cell = kBlank;
+    cell.bg = s.pen.bg;
+    cell.flags = VT_DEFAULT_FG | (s.pen.flags & VT_DEFAULT_BG);
+    return cell;
+}
+
+bool IsBlank(const VtCell& cell) {
+    return cell.ch == ' ' && (cell.flags & VT_DEFAULT_BG) && !(cell.flags & (VT_INVERSE | VT_UNDERLINE));
+}
+
+Row Trimmed(const Row& row) {
+    size_t length = row.size();
+    while (length > 0 && IsBlank(row[length - 1])) {
+        length--;
+    }
+    return Row(row.begin(), row.begin() + length);
+}
+
+int64_t RowBytes(const Row& row) {
+    return (int64_t)(row.size() * sizeof(VtCell));
+}
+
+// A block holds its rows back to back, each as a uint32_t cell count and the cells
+void Freeze(VtScreen& s) {
+    std::vector<uint8_t> data;
+    int64_t bytes = 0;
+    for (size_t i = 0; i < kBlockLines; i++) {
+        const Row& row = s.hot[i];
+        uint32_t count = (uint32_t)row.size();
+        size_t at = data.size();
+        data.resize(at + sizeof(count) + count * sizeof(VtCell));
+        memcpy(&data[at], &count, sizeof(count));
+        if (count > 0) {
+            memcpy(&data[at + sizeof(count)], row.data(), count * sizeof(VtCell));
+        }
+        bytes += RowBytes(row);
+    }
+    s.hot.erase(s.hot.begin(), s.hot.begin() + kBlockLines);
+    scrollback_store_account(-bytes);
+    uint64_t id = scrollback_store_put(std::move(data));
+    if (id != 0) {
+        s.cold.push_back({ id, kBlockLines });
+        s.coldLines += kBlockLines;
+    }
+}
+
+// The rows of a frozen block; none if the store lost it
+std::vector<Row> Thaw(const ColdBlock& block) {
+    std::vector<Row> rows;
+    std::vector<uint8_t> data;
+    if (!scrollback_store_get(block.id, &data)) {
+        return rows;
+    }
+    size_t at = 0;
+    while (at + sizeof(uint32_t) <= data.size()) {
+        uint32_t count;
+        memcpy(&count, &data[at], sizeof(count));
+        at += sizeof(count);
+        if (count * sizeof(VtCell) > data.size() - at) {
+            break;
+        }
+        Row row(count);
+        if (count > 0) {
+            memcpy(row.data(), &data[at], count * sizeof(VtCell));
+        }
+        at += count * sizeof(VtCell);
+        rows.push_back(std::move(row));
+    }
+    return rows;
+}
+
+size_t ScrollbackLines(const VtScreen& s) {
+    return s.coldLines + s.hot.size();
+}
+
+void ClearScrollback(VtScreen& s) {
+    for (const ColdBlock& block : s.cold) {
+        scrollback_store_free(block.id);
+    }
+    s.cold.clear();
+    s.coldLines = 0;
+    int64_t bytes = 0;
+    for (const Row& row : s.hot) {
+        bytes += RowBytes(row);
+    }
+    s.hot.clear();
+    scrollback_store_account(-bytes);
+}
+
+void PushScrollback(VtScreen& s, const Row& row) {
+    Row trimmed = Trimmed(row);
+    scrollback_store_account(RowBytes(trimmed));
+    s.hot.push_back(std::move(trimmed));
+    if (s.hot.size() >= kHotLines + kBlockLines) {
+        Freeze(s);
+    }
+    // Whole blocks go once the rest still holds maxLines
+    while (!s.cold.empty() && ScrollbackLines(s) - s.cold.front().lines >= (size_t)s.maxLines) {
+        scrollback_store_free(s.cold.front().id);
+        s.coldLines -= s.cold.front().lines;
+        s.cold.pop_front();
+    }
+    while (s.cold.empty() && s.hot.size() > (size_t)s.maxLines) {
+        scrollback_store_account(-RowBytes(s.hot.front()));
+        s.hot.pop_front();
+    }
+}
+
+// Lines leaving the top of the whole primary screen go to the scrollback,
+// unless they are deleted (keep false)
+void ScrollUp(VtScreen& s, int count, bool keep) {
+    count = Clamp(count, 0, s.bottom - s.top + 1);
+    keep = keep && s.top == 0 && !s.alt;
+    bool whole = s.top == 0 && s.bottom == s.rows - 1;
+    for (int i = 0; i < count; i++) {
+        if (keep) {
+            PushScrollback(s, s.lines[0]);
+        }
+        s.lines.erase(s.lines.begin() + s.top);
+        s.lines.insert(s.lines.begin() + s.bottom, Row(s.cols, Erased(s)));
+        if (whole) {
+            s.versions.erase(s.versions.begin());
+            s.versions.push_back(s.frame + 1);
+        }
+    }
+    if (whole) {
+        s.changed = true;
+        s.scrollTotal += count;
+    } else {
+        Touch(s, s.top, s.bottom);
+    }
+}
+
+void ScrollDown(VtScreen& s, int count) {
+    count = Clamp(count, 0, s.bottom - s.top + 1);
+    for (int i = 0; i < count; i++) {
+        s.lines.erase(s.lines.begin() + s.bottom);
+        s.lines.insert(s.lines.begin() + s.top, Row(s.cols, Erased(s)));
+    }
+    Touch(s, s.top, s.bottom);
+}
+
+void LineFeed(VtScreen& s, bool newline) {
+    if (s.y == s.bottom) {
+        ScrollUp(s, 1, true);
+    } else if (s.y < s.rows - 1) {
+        s.y++;
+    }
+    if (newline) {
+        s.x = 0;
+    }
+    s.wrapPending = false;
+}
+
+// Columns the cell's character takes (a wide tail is part of the one before)
+int CellWidth(uint32_t ch) {
+    if (ch & kCluster) {
+        return ch & kClusterWide ? 2 : 1;
+    }
+    return ch == kWideTail ? 0 : CharWidth(ch);
+}
+
+// Character ch with mark appended, as a cluster id; ch itself if the table is full
+uint32_t Combined(uint32_t ch, uint32_t mark) {
+    std::lock_guard<std::mutex> lock(g_clusterMutex);
+    std::u32string text;
+    if (ch & kCluster) {
+        text = g_clusters[ch & kClusterIndex];
+    } else {
+        text = (char32_t)ch;
+    }
+    if (text.size() >= kMaxClusterLength) {
+        return ch;
+    }
+    text += (char32_t)mark;
+    auto it = g_clusterIds.find(text);
+    if (it != g_clusterIds.end()) {
+        return it->second;
+    }
+    if (g_clusters.size() >= kMaxClusters) {
+        return ch;
+    }
+    uint32_t id = kCluster | (CharWidth(text[0]) == 2 ? kClusterWide : 0) | (uint32_t)g_clusters.size();
+    g_clusters.push_back(text);
+    g_clusterIds[text] = id;
+    return id;
+}
+
+// A zero-width character joins the one left of the cursor (the one under it once
+// the last column is written); with nothing there it is dropped
+void Combine(VtScreen& s, uint32_t mark) {
+    int x = s.wrapPending ? s.x : s.x - 1;
+    if (x < 0) {
+        return;
+    }
+    Row& row = s.lines[s.y];
+    if (row[x].ch == kWideTail) {
+        if (x == 0) {
+            return;
+        }
+        x--;
+    }
+    row[x].ch = Combined(row[x].ch, mark);
+    Touch(s, s.y, s.y);
+}
+
+// Write a cell on the cursor row; overwriting half of a wide character blanks the other
+void Place(VtScreen& s, int x, const VtCell& cell) {
+    Row& row = s.lines[s.y];
+    if (row[x].ch == kWideTail && x > 0) {
+        row[x - 1].ch = ' ';
+    }
+    if (x + 1 < s.cols && row[x + 1].ch == kWideTail) {
+        row[x + 1].ch = ' ';
+    }
+    row[x] = cell;
+}
+
+void Print(VtScreen& s, uint32_t ch) {
+    int width = CharWidth(ch);
+    if (width == 0) {
+        Combine(s, ch);
+        return;
+    }
+    if (s.wrapPending) {
+        s.wrapPending = false;
+        if (s.autowrap) {
+            s.x = 0;
+            LineFeed(s, false);
+        }
+    }
+    // A wide character does not start in the last column: it wraps first
+    if (width == 2 && s.x == s.cols - 1 && s.autowrap && s.cols > 1) {
+        s.x = 0;
+        LineFeed(s, false);
+    }
+    VtCell cell = s.pen;
+    cell.ch = ch;
+    Place(s, s.x, cell);
+    if (width == 2 && s.x < s.cols - 1) {
+        cell.ch = kWideTail;
+        Place(s, ++s.x, cell);
+    }
+    Touch(s, s.y, s.y);
+    if (s.x == s.cols - 1) {
+        s.wrapPending = true;
+    } else {
+        s.x++;
+    }
+}
+
+void EraseCells(VtScreen& s, int row, int from, int to) {
+    VtCell cell = Erased(s);
+    for (int i = Clamp(from, 0, s.cols); i < Clamp(to, 0, s.cols); i++) {
+        s.lines[row][i] = cell;
+    }
+    Touch(s, row, row);
+}
+
+void EraseRows(VtScreen& s, int from, int to) {
+    for (int row = from; row < to; row++) {
+        EraseCells(s, row, 0, s.cols);
+    }
+}
+
+void SaveCursor(VtScreen& s) {
+    s.savedX = s.x;
+    s.savedY = s.y;
+    s.savedPen = s.pen;
+}
+
+void RestoreCursor(VtScreen& s) {
+    s.x = Clamp(s.savedX, 0, s.cols - 1);
+    s.y = Clamp(s.savedY, 0, s.rows - 1);
+    s.pen = s.savedPen;
+    s.wrapPending = false;
+}
+
+void SetAlternate(VtScreen& s, bool on) {
+    if (on == s.alt) {
+        return;
+    }
+    std::swap(s.lines, s.altLines);
+    s.alt = on;
+    if (on) {
+        s.lines.assign(s.rows, Row(s.cols, kBlank));
+    }
+    Touch(s, 0, s.rows - 1);
+}
+
+void Reset(VtScreen& s) {
+    SetAlternate(s, false);
+    s.lines.assign(s.rows, Row(s.cols, kBlank));
+    s.x = s.y = 0;
+    s.wrapPending = false;
+    s.top = 0;
+    s.bottom = s.rows - 1;
+    s.pen = kBlank;
+    s.autowrap = true;
+    s.lineFeedNewline = false;
+    s.cursorVisible = true;
+    Touch(s, 0, s.rows - 1);
+}
+
+// Truecolour is approximated on the 6x6x6 cube
+uint8_t Rgb(int r, int g, int b) {
+    auto level = [](int c) { return (Clamp(c, 0, 255) * 5 + 127) / 255; };
+    return (uint8_t)(16 + 36 * level(r) + 6 * level(g) + level(b));
+}
+
+int Param(const VtScreen& s, size_t index, int fallback) {
+    return index < s.params.size() && s.params[index] > 0 ? s.params[index] : fallback;
+}
+
+int RawParam(const VtScreen& s, size_t index) {
+    return index < s.params.size() && s.params[index] > 0 ? s.params[index] : 0;
+}
+
+// 38/48 with ';': ;5;n or ;2;r;g;b. Returns how many extra parameters were used.
+size_t ExtendedColor(const VtScreen& s, size_t index, uint8_t* color) {
+    int kind = RawParam(s, index + 1);
+    if (kind == 5) {
+        *color = (uint8_t)RawParam(s, index + 2);
+        return 2;
+    }
+    if (kind == 2) {
+        *color = Rgb(RawParam(s, index + 2), RawParam(s, index + 3), RawParam(s, index + 4));
+        return 4;
+    }
+    return 1;
+}
+
+// How many ':' sub-parameters follow params[index]
+size_t SubParams(const VtScreen& s, size_t index) {
+    size_t count = 0;
+    while (index + count + 1 < s.params.size() && (s.subParams >> (index + count + 1) & 1)) {
+        count++;
+    }
+    return count;
+}
+
+// An SGR parameter with count sub-parameters: 38/48 as :5:n, :2:r:g:b or
+// :2:colourspace:r:g:b, and underline styles as 4:n. Others are skipped whole.
+void SgrGroup(VtScreen& s, size_t index, size_t count) {
+    VtCell& pen = s.pen;
+    int p = s.params[index];
+    if (p == 4) {
+        if (RawParam(s, index + 1) == 0) {
+            pen.flags &= ~VT_UNDERLINE;
+        } else {
+            pen.flags |= VT_UNDERLINE;
+        }
+        return;
+    }
+    if (p != 38 && p != 48) {
+        return;
+    }
+    uint8_t color;
+    int kind = RawParam(s, index + 1);
+    if (kind == 5 && count >= 2) {
+        color = (uint8_t)RawParam(s, index + 2);
+    } else if (kind == 2 && count >= 4) {
+        size_t rgb = index + (count >= 5 ? 3 : 2);
+        color = Rgb(RawParam(s, rgb), RawParam(s, rgb + 1), RawParam(s, rgb + 2));
+    } else {
+        return;
+    }
+    if (p == 38) {
+        pen.fg = color;
+        pen.flags &= ~VT_DEFAULT_FG;
+    } else {
+        pen.bg = color;
+        pen.flags &= ~VT_DEFAULT_BG;
+    }
+}
+
+void Sgr(VtScreen& s) {
+    if (s.params.empty()) {
+        s.params.push_back(0);
+    }
+    VtCell& pen = s.pen;
+    for (size_t i = 0; i < s.params.size(); i++) {
+        size_t sub = SubParams(s, i);
+        if (sub > 0) {
+            SgrGroup(s, i, sub);
+            i += sub;
+            continue;
+        }
+        int p = s.params[i] < 0 ? 0 : s.params[i];
+        if (p == 0) {
+            pen = kBlank;
+        } else if (p == 1) {
+            pen.flags |= VT_BOLD;
+        } else if (p == 2) {
+            pen.flags |= VT_DIM;
+        } else if (p == 3) {
+            pen.flags |= VT_ITALIC;
+        } else if (p == 4) {
+            pen.flags |= VT_UNDERLINE;
+        } else if (p == 7) {
+            pen.flags |= VT_INVERSE;
+        } else if (p == 22) {
+            pen.flags &= ~(VT_BOLD | VT_DIM);
+        } else if (p == 23) {
+            pen.flags &= ~VT_ITALIC;
+        } else if (p == 24) {
+            pen.flags &= ~VT_UNDERLINE;
+        } else if (p == 27) {
+            pen.flags &= ~VT_INVERSE;
+        } else if (p >= 30 && p <= 37) {
+            pen.fg = (uint8_t)(p - 30);
+            pen.flags &= ~VT_DEFAULT_FG;
+        } else if (p == 38) {
+            i += ExtendedColor(s, i, &pen.fg);
+            pen.flags &= ~VT_DEFAULT_FG;
+        } else if (p == 39) {
+            pen.flags |= VT_DEFAULT_FG;
+        } else if (p >= 40 && p <= 47) {
+            pen.bg = (uint8_t)(p - 40);
+            pen.flags &= ~VT_DEFAULT_BG;
+        } else if (p == 48) {
+            i += ExtendedColor(s, i, &pen.bg);
+            pen.flags &= ~VT_DEFAULT_BG;
+        } else if (p == 49) {
+            pen.flags |= VT_DEFAULT_BG;
+        } else if (p >= 90 && p <= 97) {
+            pen.fg = (uint8_t)(p - 90 + 8);
+            pen.flags &= ~VT_DEFAULT_FG;
+        } else if (p >= 100 && p <= 107) {
+            pen.bg = (uint8_t)(p - 100 + 8);
+            pen.flags &= ~VT_DEFAULT_BG;
+        }
+    }
+}
+
+void PrivateMode(VtScreen& s, bool set) {
+    for (int mode : s.params) {
+        switch (mode) {
+        case 7:
+            s.autowrap = set;
+            break;
+        case 25:
+            s.cursorVisible = set;
+            break;
+        case 47:
+        case 1047:
+            SetAlternate(s, set);
+            break;
+        case 1049:
+            if (set) {
+                SaveCursor(s);
+                SetAlternate(s, true);
+            } else {
+                SetAlternate(s, false);
+                RestoreCursor(s);
+            }
+            break;
+        }
+    }
+}
+
+void Csi(VtScreen& s, char final) {
+    if (s.prefix == '?') {
+        if (final == 'h' || final == 'l') {
+            PrivateMode(s, final == 'h');
+        }
+        return;
+    }
+    if (s.prefix != 0) {
+        return; // Device queries and the like
+    }
+    int n = Param(s, 0, 1);
+    if (final != 'm') {
+        s.wrapPending = false;
+    }
+    switch (final) {
+    case 'A':
+        s.y = Clamp(s.y - n, s.y >= s.top ? s.top : 0, s.rows - 1);
+        break;
+    case 'B':
+        s.y = Clamp(s.y + n, 0, s.y <= s.bottom ? s.bottom : s.rows - 1);
+        break;
+    case 'C':
+        s.x = Clamp(s.x + n, 0, s.cols - 1);
+        break;
+    case 'D':
+        s.x = Clamp(s.x - n, 0, s.cols - 1);
+        break;
+    case 'E':
+        s.y = Clamp(s.y + n, 0, s.rows - 1);
+        s.x = 0;
+        break;
+    case 'F':
+        s.y = Clamp(s.y - n, 0, s.rows - 1);
+        s.x = 0;
+        break;
+    case 'G':
+    case '`':
+        s.x = Clamp(n - 1, 0, s.cols - 1);
+        break;
+    case 'd':
+        s.y = Clamp(n - 1, 0, s.rows - 1);
+        break;
+    case 'H':
+    case 'f':
+        s.y = Clamp(Param(s, 0, 1) - 1, 0, s.rows - 1);
+        s.x = Clamp(Param(s, 1, 1) - 1, 0, s.cols - 1);
+        break;
+    case 'J':
+        switch (RawParam(s, 0)) {
+        case 0:
+            EraseCells(s, s.y, s.x, s.cols);
+            EraseRows(s, s.y + 1, s.rows);
+            break;
+        case 1:
+            EraseRows(s, 0, s.y);
+            EraseCells(s, s.y, 0, s.x + 1);
+            break;
+        case 2:
+            EraseRows(s, 0, s.rows);
+            break;
+        case 3:
+            ClearScrollback(s);
+            break;
+        }
+        break;
+    case 'K':
+        switch (RawParam(s, 0)) {
+        case 0:
+            EraseCells(s, s.y, s.x, s.cols);
+            break;
+        case 1:
+            EraseCells(s, s.y, 0, s.x + 1);
+            break;
+        case 2:
+            EraseCells(s, s.y, 0, s.cols);
+            break;
+        }
+        break;
+    case 'L':
+    case 'M':
+        if (s.y >= s.top && s.y <= s.bottom) {
+            int savedTop = s.top;
+            s.top = s.y; // Lines move only below the cursor
+            if (final == 'L') {
+                ScrollDown(s, n);
+            } else {
+                ScrollUp(s, n, false);
+            }
+            s.top = savedTop;
+            s.x = 0;
+        }
+        break;
+    case '@': {
+        Row& row = s.lines[s.y];
+        n = Clamp(n, 0, s.cols - s.x);
+        row.insert(row.begin() + s.x, n, Erased(s));
+        row.resize(s.cols);
+        Touch(s, s.y, s.y);
+        break;
+    }
+    case 'P': {
+        Row& row = s.lines[s.y];
+        n = Clamp(n, 0, s.cols - s.x);
+        row.erase(row.begin() + s.x, row.begin() + s.x + n);
+        row.resize(s.cols, Erased(s));
+        Touch(s, s.y, s.y);
+        break;
+    }
+    case 'X':
+        EraseCells(s, s.y, s.x, s.x + n);
+        break;
+    case 'S':
+        ScrollUp(s, n, true);
+        break;
+    case 'T':
+        ScrollDown(s, n);
+        break;
+    case 'm':
+        Sgr(s);
+        break;
+    case 'r': {
+        int first = Param(s, 0, 1) - 1;
+        int last = Param(s, 1, s.rows) - 1;
+        if (first < last && last < s.rows) {
+            s.top = first;
+            s.bottom = last;
+        } else {
+            s.top = 0;
+            s.bottom = s.rows - 1;
+        }
+        s.x = s.y = 0;
+        break;
+    }
+    case 's':
+        SaveCursor(s);
+        break;
+    case 'u':
+        RestoreCursor(s);
+        break;
+    case 'h':
+    case 'l':
+        for (int mode : s.params) {
+            if (mode == 20) {
+                s.lineFeedNewline = final == 'h';
+            }
+        }
+        break;
+    }
+}
+
+void Escape(VtScreen& s, char ch) {
+    s.state = STATE_GROUND;
+    switch (ch) {
+    case '[':
+        s.state = STATE_CSI;
+        s.params.clear();
+        s.subParams = 0;
+        s.prefix = 0;
+        break;
+    case ']':
+    case 'P':
+    case 'X':
+    case '^':
+    case '_':
+        s.state = STATE_STRING;
+        break;
+    case '(':
+    case ')':
+    case '*':
+    case '+':
+        s.state = STATE_CHARSET;
+        break;
+    case '7':
+        SaveCursor(s);
+        break;
+    case '8':
+        RestoreCursor(s);
+        break;
+    case 'D':
+        LineFeed(s, false);
+        break;
+    case 'E':
+        LineFeed(s, true);
+        break;
+    case 'M':
+        if (s.y == s.top) {
+            ScrollDown(s, 1);
+        } else if (s.y > 0) {
+            s.y--;
+        }
+        s.wrapPending = false;
+        break;
+    case 'c':
+        Reset(s);
+        break;
+    }
+}
+
+// C0 controls run in every state but the string ones
+void Control(VtScreen& s, unsigned char ch, bool newline) {
+    switch (ch) {
+    case 0x08:
+        if (s.x > 0) {
+            s.x--;
+        }
+        s.wrapPending = false;
+        break;
+    case 0x09:
+        s.x = Clamp((s.x / 8 + 1) * 8, 0, s.cols - 1);
+        break;
+    case 0x0A:
+    case 0x0B:
+    case 0x0C:
+        LineFeed(s, newline || s.lineFeedNewline);
+        break;
+    case 0x0D:
+        s.x = 0;
+        s.wrapPending = false;
+        break;
+    case 0x18:
+    case 0x1A:
+        s.state = STATE_GROUND;
+        break;
+    case 0x1B:
+        s.state = STATE_ESCAPE;
+        break;
+    }
+}
+
+void CsiByte(VtScreen& s, unsigned char ch) {
+    if (ch >= '0' && ch <= '9') {
+        if (s.params.empty()) {
+            s.params.push_back(-1);
+        }
+        int& p = s.params.back();
+        p = p < 0 ? ch - '0' : (p > 9999 ? p : p * 10 + (ch - '0'));
+    } else if (ch == ';' || ch == ':') {
+        if (s.params.empty()) {
+            s.params.push_back(-1);
+        }
+        if (s.params.size() < kMaxParams) {
+            if (ch == ':') {
+                s.subParams |= 1u << s.params.size();
+            }
+            s.params.push_back(-1);
+        }
+    } else if (ch >= '<' && ch <= '?') {
+        if (s.params.empty()) {
+            s.prefix = (char)ch;
+        }
+    } else if (ch >= 0x40 && ch <= 0x7E) {
+        s.state = STATE_GROUND;
+        Csi(s, (char)ch);
+    }
+    // Intermediates (0x20-0x2F) are ignored
+}
+
+void Put(VtScreen& s, unsigned char ch, bool newline) {
+    if (s.state == STATE_STRING) {
+        if (ch == 0x07 || ch == 0x18 || ch == 0x1A) {
+            s.state = STATE_GROUND;
+        } else if (ch == 0x1B) {
+            s.state = STATE_STRING_ESCAPE;
+        }
+        return;
+    }
+    if (s.state == STATE_STRING_ESCAPE) {
+        s.state = ch == '\\' ? STATE_GROUND : STATE_STRING;
+        return;
+    }
+    if (ch < 0x20 || ch == 0x7F) {
+        s.utf8Remaining = 0;
+        if (ch != 0x7F) {
+            Control(s, ch, newline);
+        }
+        return;
+    }
+    switch (s.state) {
+    case STATE_ESCAPE:
+        Escape(s, (char)ch);
+        return;
+    case STATE_CHARSET:
+        s.state = STATE_GROUND;
+        return;
+    case STATE_CSI:
+        CsiByte(s, ch);
+        return;
+    }
+
+    // Ground: UTF-8
+    if (ch < 0x80) {
+        s.utf8Remaining = 0;
+        Print(s, ch);
+    } else if (ch < 0xC0) {
+        if (s.utf8Remaining == 0) {
+            Print(s, 0xFFFD);
+            return;
+        }
+        s.codepoint = (s.codepoint << 6) | (ch & 0x3F);
+        if (--s.utf8Remaining == 0) {
+            Print(s, s.codepoint);
+        }
+    } else {
+        if (s.utf8Remaining != 0) {
+            Print(s, 0xFFFD);
+        }
+        s.utf8Remaining = ch < 0xE0 ? 1 : ch < 0xF0 ? 2 : 3;
+        s.codepoint = ch & (ch < 0xE0 ? 0x1F : ch < 0xF0 ? 0x0F : 0x07);
+    }
+}
+
+void Feed(VtScreen& s, const char* data, size_t length, bool newline) {
+    for (size_t i = 0; i < length; i++) {
+        Put(s, (unsigned char)data[i], newline);
+    }
+}
+
+void Resize(VtScreen& s, int cols, int rows) {
+    if (cols == s.cols && rows == s.rows) {
+        return;
+    }
+    // Keep the cursor row on screen: lines above it go to the scrollback
+    int dropTop = s.y - (rows - 1);
+    for (int i = 0; i < dropTop; i++) {
+        if (!s.alt) {
+            PushScrollback(s, s.lines.front());
+        }
+        s.lines.erase(s.lines.begin());
+        s.altLines.erase(s.altLines.begin());
+    }
+    if (dropTop > 0) {
+        s.y -= dropTop;
+    }
+    for (std::vector<Row>* buffer : { &s.lines, &s.altLines }) {
+        buffer->resize(rows, Row(cols, kBlank));
+        for (Row& row : *buffer) {
+            row.resize(cols, kBlank);
+        }
+    }
+    s.cols = cols;
+    s.rows = rows;
+    s.top = 0;
+    s.bottom = rows - 1;
+    s.x = Clamp(s.x, 0, cols - 1);
+    s.y = Clamp(s.y, 0, rows - 1);
+    s.wrapPending = false;
+    s.versions.assign(rows, 0);
+    Touch(s, 0, rows - 1);
+}
+
+void AppendUtf8(std::string& out, uint32_t ch) {
+    if (ch < 0x80) {
+        out += (char)ch;
+    } else if (ch < 0x800) {
+        out += (char)(0xC0 | (ch >> 6));
+        out += (char)(0x80 | (ch & 0x3F));
+    } else if (ch < 0x10000) {
+        out += (char)(0xE0 | (ch >> 12));
+        out += (char)(0x80 | ((ch >> 6) & 0x3F));
+        out += (char)(0x80 | (ch & 0x3F));
+    } else {
+        out += (char)(0xF0 | (ch >> 18));
+        out += (char)(0x80 | ((ch >> 12) & 0x3F));
+        out += (char)(0x80 | ((ch >> 6) & 0x3F));
+        out += (char)(0x80 | (ch & 0x3F));
+    }
+}
+
+void AppendChar(std::string& out, uint32_t ch) {
+    if (!(ch & kCluster)) {
+        AppendUtf8(out, ch);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_clusterMutex);
+    size_t index = ch & kClusterIndex;
+    if (index >= g_clusters.size()) {
+        out += ' ';
+        return;
+    }
+    for (char32_t c : g_clusters[index]) {
+        AppendUtf8(out, c);
+    }
+}
+
+// A wide character at row[i] with its tail after it
+bool WideAt(const Row& row, size_t i) {
+    return i + 1 < row.size() && row[i + 1].ch == kWideTail && CellWidth(row[i].ch) == 2;
+}
+
+void AppendStyle(std::string& out, const VtCell& cell) {
+    char buffer[16];
+    out += "\x1b[0";
+    if (cell.flags & VT_BOLD) out += ";1";
+    if (cell.flags & VT_DIM) out += ";2";
+    if (cell.flags & VT_ITALIC) out += ";3";
+    if (cell.flags & VT_UNDERLINE) out += ";4";
+    if (cell.flags & VT_INVERSE) out += ";7";
+    if (!(cell.flags & VT_DEFAULT_FG)) {
+        sprintf_s(buffer, sizeof(buffer), ";38;5;%u", cell.fg);
+        out += buffer;
+    }
+    if (!(cell.flags & VT_DEFAULT_BG)) {
+        sprintf_s(buffer, sizeof(buffer), ";48;5;%u", cell.bg);
+        out += buffer;
+    }
+    out += 'm';
+}
+
+void AppendRow(std::string& out, const Row& row, int cols, VtCell& style) {
+    Row trimmed = Trimmed(row);
+    size_t length = trimmed.size() < (size_t)cols ? trimmed.size() : (size_t)cols;
+    for (size_t i = 0; i < length; i++) {
+        // The viewer advances two columns for a wide character itself. A half left
+        // without the other (erased, cut by a resize) is shown as a blank.
+        uint32_t ch = trimmed[i].ch;
+        if (ch == kWideTail) {
+            if (i > 0 && WideAt(trimmed, i - 1)) {
+                continue;
+            }
+            ch = ' ';
+        } else if (CellWidth(ch) == 2 && !WideAt(trimmed, i)) {
+            ch = ' ';
+        }
+        if (!trimmed[i].SameStyle(style)) {
+            style = trimmed[i];
+            AppendStyle(out, style);
+        }
+        AppendChar(out, ch);
+    }
+}
+
+std::string Render(VtScreen& s, int maxLines) {
+    std::string out;
+    VtCell style = kBlank;
+    const std::vector<Row>& primary = s.alt ? s.altLines : s.lines;
+    size_t total = ScrollbackLines(s);
+    size_t skip = total - (total < (size_t)maxLines ? total : (size_t)maxLines);
+    for (const ColdBlock& block : s.cold) {
+        if (skip >= block.lines) {
+            skip -= block.lines;
+            continue;
+        }
+        std::vector<Row> rows = Thaw(block);
+        for (size_t i = skip; i < rows.size(); i++) {
+            AppendRow(out, rows[i], s.cols, style);
+            out += "\r\n";
+        }
+        skip = 0;
+    }
+    for (size_t i = skip; i < s.hot.size(); i++) {
+        AppendRow(out, s.hot[i], s.cols, style);
+        out += "\r\n";
+    }
+    for (int row = 0; row < s.rows; row++) {
+        AppendRow(out, primary[row], s.cols, style);
+        if (row < s.rows - 1) {
+            out += "\r\n";
+        }
+    }
+    char buffer[48];
+    if (s.alt) {
+        out += "\x1b[0m\x1b[?1049h";
+        style = kBlank;
+        for (int row = 0; row < s.rows; row++) {
+            sprintf_s(buffer, sizeof(buffer), "\x1b[%d;1H", row + 1);
+            out += buffer;
+            AppendRow(out, s.lines[row], s.cols, style);
+        }
+    }
+    if (s.top != 0 || s.bottom != s.rows - 1) {
+        sprintf_s(buffer, sizeof(buffer), "\x1b[%d;%dr", s.top + 1, s.bottom + 1);
+        out += buffer;
+    }
+    sprintf_s(buffer, sizeof(buffer), "\x1b[%d;%dH", s.y + 1, s.x + 1);
+    out += buffer;
+    AppendStyle(out, s.pen);
+    if (!s.autowrap) {
+        out += "\x1b[?7l";
+    }
+    if (!s.cursorVisible) {
+        out += "\x1b[?25l";
+    }
+    return out;
+}
+
+// What changed since frame `since` as a VT patch for a viewer's terminal at that
+// frame: a scroll, the changed rows and the cursor. Everything if the frame is unknown.
+std::string Sync(VtScreen& s, uint64_t since, VtFrame* info) {
+    if (s.changed || s.frames.empty()) {
+        s.changed = false;
+        s.frame++;
+        s.frames.push_back({ s.frame, s.scrollTotal });
+        if (s.frames.size() > kSyncFrames) {
+            s.frames.pop_front();
+        }
+    }
+    bool full = true;
+    uint64_t scroll = 0;
+    for (const SyncFrame& known : s.frames) {
+        if (known.frame == since) {
+            full = false;
+            scroll = s.scrollTotal - known.scrollTotal;
+        }
+    }
+    if (scroll >= (uint64_t)s.rows) {
+        full = true;
+    }
+
+    std::string out = "\x1b[0m";
+    char buffer[48];
+    if (full) {
+        out += "\x1b[r\x1b[H\x1b[2J";
+    } else if (scroll > 0) {
+        sprintf_s(buffer, sizeof(buffer), "\x1b[r\x1b[%dS", (int)scroll);
+        out += buffer;
+    }
+    VtCell style = kBlank;
+    int sent = 0;
+    for (int row = 0; row < s.rows; row++) {
+        if (!full && s.versions[row] <= since) {
+            continue;
+        }
+        sprintf_s(buffer, sizeof(buffer), "\x1b[%d;1H", row + 1);
+        out += buffer;
+        AppendRow(out, s.lines[row], s.cols, style);
+        if (!style.SameStyle(kBlank)) {
+            out += "\x1b[0m";
+            style = kBlank;
+        }
+        if (!full) {
+            out += "\x1b[K";
+        }
+        sent++;
+    }
+    sprintf_s(buffer, sizeof(buffer), "\x1b[%d;%dH\x1b[?25%c", s.y + 1, s.x + 1,
+        s.cursorVisible ? 'h' : 'l');
+    out += buffer;
+
+    if (info != nullptr) {
+        info->frame = (int64_t)s.frame;
+        info->cols = s.cols;
+        info->rows = s.rows;
+        info->full = full ? 1 : 0;
+        info->rowsSent = sent;
+    }
+    return out;
+}
+
+// malloc'ed copy for Dart, released with task_container_free_output
+uint8_t* Copied(const std::string& text, int32_t* length) {
+    auto data = static_cast<uint8_t*>(malloc(text.size() > 0 ? text.size() : 1));
+    if (data == nullptr) {
+        return nullptr;
+    }
+    memcpy(data, text.data(), text.size());
+    if (length != nullptr) {
+        *length = (int32_t)text.size();
+    }
+    return data;
+}
+
+} // namespace
+
+VtScreen::~VtScreen() {
+    ClearScrollback(*this);
+}
+
+std::shared_ptr<VtScreen> vt_screen_get(int screenId) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    auto it = g_screens.find(screenId);
+    return it != g_screens.end() ? it->second : nullptr;
+}
+
+void vt_screen_feed(VtScreen* screen, const char* data, size_t length, bool newline) {
+    std::lock_guard<std::mutex> lock(screen->mutex);
+    Feed(*screen, data, length, newline);
+    screen->outputBytes += length;
+}
+
+void vt_screen_reset_output(VtScreen* screen) {
+    std::lock_guard<std::mutex> lock(screen->mutex);
+    screen->outputBytes = 0;
+}
+
+extern "C" {
+
+__declspec(dllexport) int vt_screen_create(int cols, int rows, int maxLines) {
+    if (cols <= 0 || rows <= 0) {
+        return 0;
+    }
+    auto screen = std::make_shared<VtScreen>();
+    screen->cols = cols;
+    screen->rows = rows;
+    screen->maxLines = maxLines > 0 ? maxLines : 0;
+    screen->bottom = rows - 1;
+    screen->lines.assign(rows, Row(cols, kBlank));
+    screen->altLines.assign(rows, Row(cols, kBlank));
+    screen->versions.assign(rows, 0);
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+    int id = g_nextScreenId++;
+    g_screens[id] = screen;
+    return id;
+}
+
+__declspec(dllexport) void vt_screen_free(int screenId) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_screens.erase(screenId);
+}
+
+__declspec(dllexport) void vt_screen_write(int screenId, const uint8_t* data, int length) {
+    auto screen = vt_screen_get(screenId);
+    if (screen == nullptr || data == nullptr || length <= 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(screen->mutex);
+    Feed(*screen, reinterpret_cast<const char*>(data), (size_t)length, false);
+}
+
+__declspec(dllexport) void vt_screen_resize(int screenId, int cols, int rows) {
+    auto screen = vt_screen_get(screenId);
+    if (screen == nullptr || cols <= 0 || rows <= 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(screen->mutex);
+    Resize(*screen, cols, rows);
+}
+
+__declspec(dllexport) uint8_t* vt_screen_snapshot(int screenId, int maxLines, int32_t* length,
+        int64_t* outputBytes) {
+    auto screen = vt_screen_get(screenId);
+    if (screen == nullptr) {
+        return nullptr;
+    }
+    std::string text;
+    {
+        std::lock_guard<std::mutex> lock(screen->mutex);
+        text = Render(*screen, maxLines);
+        if (outputBytes != nullptr) {
+            *outputBytes = screen->outputBytes;
+        }
+    }
+    return Copied(text, length);
+}
+
+__declspec(dllexport) uint8_t* vt_screen_sync(int screenId, int64_t since, VtFrame* frame,
+        int32_t* length) {
+    auto screen = vt_screen_get(screenId);
+    if (screen == nullptr) {
+        return nullptr;
+    }
+    std::string patch;
+    {
+        std::lock_guard<std::mutex> lock(screen->mutex);
+        patch = Sync(*screen, since > 0 ? (uint64_t)since : 0, frame);
+    }
+    return Copied(patch, length);
+}
+
+}
@@ -0,0 +1,56 @@
+#ifndef VT_SCREEN_H
+#define VT_SCREEN_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <memory>
+
+// A terminal screen kept natively: a VT/xterm parser over a grid of compact cells
+// plus trimmed scrollback rows, the older ones frozen into compressed blocks
+// (scrollback_store.h). Task container output is fed to it on the reactor
+// thread, so a task whose pane is hidden is parsed here and nowhere else.
+
+// A frame of the screen-state sync (vt_screen_sync)
+struct VtFrame {
+    int64_t frame;    // Pass back as `since` once the viewer applied the patch
+    int32_t cols;     // Screen size the patch is for
+    int32_t rows;
+    int32_t full;     // The patch clears and redraws the whole screen
+    int32_t rowsSent; // Rows the patch redraws
+};
+
+extern "C" {
+    // A blank screen of cols x rows keeping up to maxLines of scrollback. Returns a
+    // screen id (0 on failure), released with vt_screen_free.
+    __declspec(dllexport) int vt_screen_create(int cols, int rows, int maxLines);
+    // Drop the screen; a task container it is attached to keeps it until it closes.
+    __declspec(dllexport) void vt_screen_free(int screenId);
+    // Feed text written by the app itself (status lines etc.); not counted as output.
+    __declspec(dllexport) void vt_screen_write(int screenId, const uint8_t* data, int length);
+    // Resize without reflow: rows are cut or padded, lines pushed off the top go to
+    // the scrollback.
+    __declspec(dllexport) void vt_screen_resize(int screenId, int cols, int rows);
+    // The last maxLines of scrollback plus the screen, rendered as UTF-8 with SGR
+    // sequences and ending with the cursor position, for a fresh xterm to replay.
+    // *outputBytes is how much task output (see task_container_attach_screen) it contains.
+    // malloc'ed; release with task_container_free_output. NULL if unknown.
+    __declspec(dllexport) uint8_t* vt_screen_snapshot(int screenId, int maxLines, int32_t* length,
+        int64_t* outputBytes);
+    // Screen-state sync for remote viewers (as in mosh): a VT patch that brings a
+    // terminal showing frame `since` (0 for none) to the current frame, so its size
+    // follows visible change rather than output volume. Frames older than the last
+    // few dozen get a full redraw. malloc'ed; release with task_container_free_output.
+    __declspec(dllexport) uint8_t* vt_screen_sync(int screenId, int64_t since, VtFrame* frame,
+        int32_t* length);
+}
+
+// Internal: fed by the task container the screen is attached to
+struct VtScreen;
+
+std::shared_ptr<VtScreen> vt_screen_get(int screenId);
+// Task output; newline treats a bare line feed as CR LF (pipe mode)
+void vt_screen_feed(VtScreen* screen, const char* data, size_t length, bool newline);
+// Start counting task output from zero (a new run attached)
+void vt_screen_reset_output(VtScreen* screen);
+
+#endif // VT_SCREEN_H